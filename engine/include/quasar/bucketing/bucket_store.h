@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace quasar {
+
+// Hand -> bucket maps for many boards in one memory-mapped file. Boards are
+// stored once per suit-isomorphism class; each board holds one bucket id per
+// colex hand index (quasar/eval/hand_index.h), so a lookup is a directory
+// search for the board plus one array read. Layout (little-endian):
+//   BucketStoreHeader (32 bytes)
+//   num_boards blocks of kNumPloHands ids (uint16 or uint32), 64-byte aligned
+//   directory: num_boards BucketStoreEntry sorted by board key (at dir_offset)
+// Hands that collide with the board or were not bucketed hold kNoBucket.
+// `bucket_version` identifies the clustering run; consumers (packers, nets)
+// should refuse stores whose version they were not trained with.
+constexpr char kBucketStoreMagic[4] = {'Q', 'B', 'K', 'T'};
+constexpr uint16_t kBucketStoreFormat = 1;
+constexpr uint32_t kNoBucket = 0xFFFFFFFFu;
+
+struct BucketStoreHeader {
+  char magic[4];
+  uint16_t format;
+  uint16_t id_bytes;  // 2 or 4
+  uint32_t bucket_version;
+  uint32_t num_boards;
+  uint64_t dir_offset;
+  uint32_t hands_per_board;  // kNumPloHands
+  uint32_t reserved;
+};
+
+struct BucketStoreEntry {
+  uint64_t board_key;  // canonical board card mask
+  uint64_t offset;     // byte offset of the board's id block
+};
+
+// Canonical form of a board under the 24 suit permutations: the smallest
+// card bitmask over all relabelings. Writes the chosen relabeling to
+// suit_map (old suit -> new suit; the first minimizing permutation, so the
+// choice is deterministic). Returns 0 for an invalid board.
+uint64_t canonical_board(const int32_t* board, int len, int suit_map[4]);
+
+// Streams per-board maps to disk; call finish() once after the last board.
+class BucketStoreWriter {
+ public:
+  BucketStoreWriter() = default;
+  ~BucketStoreWriter();
+  BucketStoreWriter(const BucketStoreWriter&) = delete;
+  BucketStoreWriter& operator=(const BucketStoreWriter&) = delete;
+
+  // id_bytes 2 stores ids < 0xFFFF (kNoBucket becomes 0xFFFF).
+  bool open(const std::string& path, uint32_t bucket_version, int id_bytes = 2);
+
+  // `labels` has kNumPloHands ids indexed by the colex index of the hand as
+  // dealt on `board` (kNoBucket for hands without a bucket). Hands are
+  // relabeled into the canonical board's suits before writing. Returns false
+  // for an invalid board, a board whose class was already added, or an id
+  // that does not fit id_bytes.
+  bool add_board(const int32_t* board, int len, const uint32_t* labels);
+
+  // Writes the directory and header; false on I/O errors.
+  bool finish();
+
+ private:
+  FILE* f_ = nullptr;
+  uint32_t bucket_version_ = 0;
+  int id_bytes_ = 2;
+  uint64_t offset_ = 0;
+  std::vector<BucketStoreEntry> entries_;
+  std::unordered_set<uint64_t> keys_;
+  std::vector<unsigned char> block_;
+};
+
+// Read-only mmap view of a store. Lookups are thread-safe.
+class BucketStore {
+ public:
+  // nullptr if the file is missing, truncated or has another magic/format.
+  static std::unique_ptr<BucketStore> open(const std::string& path);
+  ~BucketStore();
+  BucketStore(const BucketStore&) = delete;
+  BucketStore& operator=(const BucketStore&) = delete;
+
+  uint32_t bucket_version() const { return header_.bucket_version; }
+  int id_bytes() const { return header_.id_bytes; }
+  size_t num_boards() const { return header_.num_boards; }
+
+  // Canonical cards (ascending) of the i-th stored board; returns the card
+  // count (0 if i is out of range).
+  int board(size_t i, int32_t* cards) const;
+
+  // Bucket of `hand` (4 cards) on `board`, or kNoBucket if the board is not
+  // stored or the hand is invalid or collides with it.
+  uint32_t bucket_of(const int32_t* board, int len, const int32_t* hand) const;
+
+  // Same for n hands ([n, 4]) on one board: one directory search.
+  void buckets_of(const int32_t* board, int len, const int32_t* hands, size_t n, uint32_t* out) const;
+
+ private:
+  BucketStore() = default;
+  // Directory search; returns the board's id block or nullptr.
+  const unsigned char* find(const int32_t* board, int len, int suit_map[4]) const;
+  uint32_t lookup(const unsigned char* block, const int suit_map[4], uint64_t board_mask,
+                  const int32_t* hand) const;
+
+  BucketStoreHeader header_{};
+  const unsigned char* base_ = nullptr;
+  size_t size_ = 0;
+  const BucketStoreEntry* dir_ = nullptr;
+};
+
+}  // namespace quasar
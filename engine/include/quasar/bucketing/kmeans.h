@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace quasar {
+
+class ThreadPool;
+
+struct KMeansConfig {
+  int k = 50;
+  int iters = 50;           // Lloyd iterations, or mini-batch steps
+  size_t batch_size = 0;    // 0: full-batch Lloyd; else mini-batch k-means (Sculley)
+  bool plus_plus = true;    // k-means++ seeding (O(N K D)); false: K distinct random points
+  uint64_t seed = 42;
+};
+
+struct KMeansResult {
+  int k = 0;
+  int dim = 0;
+  std::vector<float> centers;   // [k, dim]
+  std::vector<int32_t> labels;  // [n] nearest center of every point
+  double inertia = 0.0;         // sum of squared distances to the assigned center
+  int iterations = 0;
+};
+
+// Clusters n points of dimension d (row-major float32) on `pool`
+// (default_thread_pool() when null). Distances are computed in blocks of
+// points against blocks of eight centers (AVX2/FMA with -march=native).
+// Results depend only on the inputs and cfg.seed, not on the thread count.
+// k is clamped to n. Returns false for empty input or d <= 0.
+bool kmeans_fit(const float* x, size_t n, int d, const KMeansConfig& cfg, KMeansResult& out,
+                ThreadPool* pool = nullptr);
+
+// Nearest-center labels (ties go to the lower index) and, when `dist2` is not
+// null, the squared distance to it.
+void kmeans_assign(const float* x, size_t n, int d, const float* centers, int k, int32_t* labels,
+                   float* dist2 = nullptr, ThreadPool* pool = nullptr);
+
+// Writes <dir>/labels.npy (int32 [n]) and <dir>/centers.npy (float32 [k, d]),
+// creating `dir` if needed.
+bool save_kmeans(const KMeansResult& result, const std::string& dir);
+
+}  // namespace quasar
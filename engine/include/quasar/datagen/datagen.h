@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace quasar {
+
+class BucketStore;
+
+// Self-play data generation (docs/DESIGN.md, "Data Generation"): heads-up
+// river records of (dense query, target values) written to fixed-size
+// shards. Record i depends only on (seed, i), so output is identical for any
+// thread count and a resumed run reproduces the records it skipped.
+constexpr char kShardMagic[4] = {'Q', 'S', 'H', 'D'};
+constexpr uint16_t kShardFormat = 2;
+constexpr int kDatagenPlayers = 2;
+
+// Shard file header (64 bytes, little-endian). Format 2 is columnar: a query
+// column of count * players * input_size floats
+// ([PLAYER_ACT, POSITION, S2PR, BOARD[5], RANGE[K]] per seat) at
+// query_offset, then a target column of count * players * K floats at
+// target_offset, each 64-byte aligned, so readers map each column as one
+// [count, players, width] array.
+struct ShardHeader {
+  char magic[4];
+  uint16_t format;
+  uint16_t players;
+  uint32_t K;
+  uint32_t input_size;      // floats per seat in a query (8 + K)
+  uint32_t count;           // records in this shard
+  uint32_t bucket_version;
+  uint64_t first_record;    // global index of the first record
+  uint64_t seed;
+  uint64_t query_offset;    // byte offset of the query column
+  uint64_t target_offset;   // byte offset of the target column
+  uint8_t reserved[8];
+};
+static_assert(sizeof(ShardHeader) == 64, "ShardHeader must stay 64 bytes");
+
+// Column offsets and file size of a shard holding `count` records.
+inline uint64_t shard_query_offset() { return sizeof(ShardHeader); }
+inline uint64_t shard_target_offset(uint64_t count, uint64_t players, uint64_t input_size) {
+  return (shard_query_offset() + count * players * input_size * sizeof(float) + 63) / 64 * 64;
+}
+inline uint64_t shard_bytes(uint64_t count, uint64_t players, uint64_t input_size, uint64_t K) {
+  return shard_target_offset(count, players, input_size) + count * players * K * sizeof(float);
+}
+
+struct DatagenConfig {
+  int K = 1000;                      // buckets per seat
+  uint64_t seed = 1;
+  uint64_t num_records = 0;          // total across all shards
+  uint32_t records_per_shard = 4096;
+  int threads = 0;                   // solver threads (<= 0: hardware concurrency)
+  size_t max_pending = 0;            // records buffered ahead of the writer (0: 4 per thread)
+  double max_s2pr = 10.0;            // S2PR is drawn uniformly from [0, max_s2pr]
+  uint32_t bucket_version = 0;       // recorded in shards (the store's when one is given)
+  // Hand -> bucket map; boards are drawn from its directory and ids >= K are
+  // treated as unbucketed. Without a store, boards are uniform and hands are
+  // bucketed by strength percentile (K equal-count buckets per board).
+  const BucketStore* buckets = nullptr;
+};
+
+// One record: query [players, 8 + K] and target [players, K].
+struct DatagenRecord {
+  std::vector<float> query;
+  std::vector<float> target;
+};
+
+// Builds record `index`: a board, seat to act and S2PR, one random belief
+// over the K buckets per seat (buckets without hands on the board are
+// zero), and each seat's per-bucket showdown value against the other seat's
+// belief (river_showdown_values averaged over the bucket's hands, in pot
+// units). False if the store cannot bucket the drawn board.
+bool generate_record(const DatagenConfig& cfg, uint64_t index, DatagenRecord& out);
+
+struct DatagenStats {
+  uint64_t resumed = 0;   // records found in complete shards on disk
+  uint64_t written = 0;   // records generated by this run
+  uint64_t skipped = 0;   // indices whose record could not be built (zero-filled)
+  size_t shards = 0;      // complete shards after the run
+};
+
+// Generates records [0, num_records) into out_dir as shard-NNNNNN.qshd plus
+// manifest.json. Workers build records in parallel while the calling thread
+// writes them in index order; workers stop claiming indices once
+// max_pending records are waiting, so memory stays bounded when the disk is
+// slower than the solver. Complete shards already in out_dir that match the
+// config are kept and generation resumes after them; a trailing short shard
+// is rebuilt, and files without the shard magic are written over. Shards and
+// the manifest are written to a temporary name and renamed, so an
+// interrupted run leaves only complete files. Every shard in out_dir is
+// checked before anything is written; returns false (with a message in
+// *error) on I/O errors, a damaged shard, a shard from a different
+// configuration (records_per_shard included) or one holding records past
+// num_records.
+bool run_datagen(const DatagenConfig& cfg, const std::string& out_dir, DatagenStats* stats = nullptr,
+                 std::string* error = nullptr);
+
+}  // namespace quasar
@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "quasar/engine/compact_state.h"
+#include "quasar/engine/discretize.h"
+#include "quasar/engine/plo_legal.h"
+
+namespace quasar {
+
+// Bet/raise sizes offered on one street, as pot fractions (bets: fraction of
+// pot; raises: fraction of pot-after-call added to the current bet, the pot
+// raise being 1.0).
+struct StreetActionSpec {
+  std::vector<double> bet_fracs{0.33, 0.5, 0.75, 1.0};
+  std::vector<double> raise_fracs{0.33, 0.5, 0.75, 1.0};
+  // Bets + raises allowed per street (CompactPublicState::num_raises); at the
+  // cap only fold/check/call remain. -1 = unlimited.
+  int raise_cap = -1;
+  bool include_min = true;
+  bool include_all_in = true;
+};
+
+struct ActionAbstractionConfig {
+  std::array<StreetActionSpec, 4> streets;  // preflop, flop, turn, river
+
+  // Same sizes on every street, no cap: reproduces discretize_actions().
+  static ActionAbstractionConfig from_discretization(const DiscretizationConfig& d);
+  // PLO defaults (docs/LEARNINGS_PLO.md): flop {50,100,200%} + all-in with a
+  // raise cap of 4; turn/river {100%} + all-in, cap 3; preflop pot + all-in, cap 4.
+  static ActionAbstractionConfig plo_default();
+};
+
+// Compiled action abstraction. At build time each (street, stack-to-pot
+// ratio, to-call/pot ratio, raise count) cell gets its sorted, deduplicated
+// fraction lists with sizes that always clamp to the all-in level pruned away.
+// Per node, actions() is an O(1) cell lookup plus one pass over the cell's
+// fractions; targets come out in ascending order, so deduplication only
+// compares neighbours. Produces the same action set as discretize_actions()
+// for the equivalent config. Immutable after construction; share freely
+// across threads.
+class ActionAbstraction {
+ public:
+  explicit ActionAbstraction(const ActionAbstractionConfig& cfg);
+
+  // Bets/raises/all-ins for s.player_to_act (check/fold/call are not
+  // included, as with discretize_actions). `la` must be the legality of `s`.
+  void actions(const CompactPublicState& s, const ChipLegalSummary& la, std::vector<ChipAction>& out) const;
+
+  // Quantization, exposed for tests and diagnostics.
+  static constexpr int kSprSteps = 4;     // SPR buckets per unit of stack/pot
+  static constexpr int kFacingSteps = 8;  // buckets per unit of to-call/pot
+  int spr_bucket(Chips stack, Chips pot) const { return spr_bucket_inv(stack, pot > 0 ? 1.0 / pot : 0.0); }
+  int facing_bucket(Chips to_call, Chips pot) const { return facing_bucket_inv(to_call, pot > 0 ? 1.0 / pot : 0.0); }
+  size_t num_cells() const { return cells_.size(); }
+
+ private:
+  struct Cell {
+    uint32_t bet_off = 0, raise_off = 0;
+    uint16_t bet_len = 0, raise_len = 0;
+    bool include_min = true;
+    bool include_all_in = true;
+    bool allow_raise = true;
+  };
+  const Cell& cell(int street, int spr_b, int facing_b, int raises) const;
+  // inv_pot = 1 / pot, or 0 for an empty pot.
+  int spr_bucket_inv(Chips stack, double inv_pot) const;
+  int facing_bucket_inv(Chips to_call, double inv_pot) const;
+
+  int spr_buckets_ = 1;     // last bucket = deep (no pruning)
+  int facing_buckets_ = 1;  // last bucket = facing >= 1 pot
+  std::array<int, 4> raise_buckets_{};
+  std::array<uint32_t, 4> street_off_{};
+  std::vector<Cell> cells_;
+  std::vector<double> fracs_;
+};
+
+}  // namespace quasar
@@ -0,0 +1,54 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "quasar/engine/compact_state.h"
+#include "quasar/engine/plo_legal.h"
+
+namespace quasar {
+
+// Everything apply_action() overwrites, so undo_action() restores the parent
+// without copying the state.
+struct ActionUndo {
+  int8_t player = -1;
+  int8_t player_to_act = 0;
+  int8_t street = 0;
+  uint8_t num_raises = 0;
+  uint16_t folded_mask = 0;
+  uint16_t acted_mask = 0;
+  bool terminal = false;
+  bool street_advanced = false;
+  Chips stack = 0;
+  Chips committed_total = 0;
+  Chips committed_on_street = 0;
+  Chips last_raise_size = 0;
+  Chips pot = 0;
+  Chips current_bet = 0;
+  Hash128 hash;
+  // Only filled when the action closed the betting round.
+  std::array<Chips, kMaxPlayers> prev_on_street{};
+};
+
+// Applies `a` for s.player_to_act in place. Amount semantics follow Action:
+// bet/raise/all-in carry the target level on this street (for all-in, the
+// pot-limit maximum from discretization), clamped to the stack; a target at
+// or below the current bet acts as a call. Call and check/fold ignore it.
+// Maintains pot, current bet, last raise size (only a full raise reopens the
+// minimum), acted/folded masks and to-act.
+//
+// When the round closes the state moves to the next street (on-street
+// commitments reset, first live seat after the button acts) or becomes
+// terminal: one player left, river closed, or fewer than two seats with
+// chips. Board cards are a chance event and are left to the caller.
+//
+// Cost is O(1) apart from the to-act scan and, if update_hash, the rehash;
+// traversals that do not need keys can pass false and rehash on demand.
+// Returns false (state untouched) if the state is terminal.
+bool apply_action(CompactPublicState& s, const ChipAction& a, ActionUndo& undo, bool update_hash = true);
+bool apply_action(CompactPublicState& s, const Action& a, ActionUndo& undo, bool update_hash = true);
+
+// Reverts the apply_action() that produced `undo`. Undo records must be
+// replayed in LIFO order.
+void undo_action(CompactPublicState& s, const ActionUndo& undo);
+
+}  // namespace quasar
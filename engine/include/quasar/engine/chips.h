@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+namespace quasar {
+
+// Exact fixed-point chip amounts. PublicState/Action keep `double` amounts in
+// arbitrary chip units for the JSON/CLI surface; legality, discretization,
+// state hashing and CompactPublicState work in integer centi-units so that
+// comparisons and deduplication are exact (no epsilons) and equal amounts
+// always produce equal keys.
+using Chips = int64_t;
+
+constexpr Chips kChipsPerUnit = 100;
+
+// Nearest integer, halves away from zero (as llround, but inline: this runs on
+// every state hash, legality query and sizing).
+inline Chips round_to_chips(double v) { return static_cast<Chips>(v < 0.0 ? v - 0.5 : v + 0.5); }
+
+// Rounds to the nearest centi-unit.
+inline Chips to_chips(double x) { return round_to_chips(x * static_cast<double>(kChipsPerUnit)); }
+// f * amount, rounded to the nearest chip (pot-fraction sizing).
+inline Chips chips_fraction(double f, Chips amount) { return round_to_chips(f * static_cast<double>(amount)); }
+inline double from_chips(Chips c) { return static_cast<double>(c) / static_cast<double>(kChipsPerUnit); }
+
+}  // namespace quasar
@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "quasar/engine/chips.h"
+#include "quasar/engine/public_state.h"
+#include "quasar/util/hash.h"
+
+namespace quasar {
+
+constexpr int kMaxPlayers = 9;
+
+// Heap-free PublicState for tree nodes, caches and batch buffers: per-player
+// fields live in fixed arrays, the board is packed into one word and the
+// canonical hash (state_hash.h) is computed once at construction. Amounts are
+// exact Chips (chips.h); conversion from PublicState rounds to the nearest
+// centi-unit. Copying a node is a flat memcpy-sized copy.
+//
+// Fields must not be modified without calling rehash() afterwards;
+// apply_action()/undo_action() (apply_action.h) keep everything in sync.
+struct CompactPublicState {
+  int8_t num_players = 2;
+  int8_t player_to_act = 0;
+  int8_t button = 0;
+  int8_t street = 0;
+  uint8_t board_len = 0;      // number of cards packed (original order)
+  uint32_t board_packed = 0;  // 6 bits per card, value card+1; 0 = empty
+
+  Chips sb = 1 * kChipsPerUnit;
+  Chips bb = 2 * kChipsPerUnit;
+  Chips ante = 0;
+  Chips last_raise_size = 0;
+  std::array<Chips, kMaxPlayers> stacks{};
+  std::array<Chips, kMaxPlayers> committed_total{};
+  std::array<Chips, kMaxPlayers> committed_on_street{};
+
+  // Cached/derived for O(1) legality: sum of committed_total and max of
+  // committed_on_street.
+  Chips pot = 0;
+  Chips current_bet = 0;
+
+  // Betting history not representable in PublicState (zero when built from
+  // one): seats that folded, seats that acted since the last raise on this
+  // street, raises on this street, and whether betting is over.
+  uint16_t folded_mask = 0;
+  uint16_t acted_mask = 0;
+  uint8_t num_raises = 0;
+  bool terminal = false;
+
+  // == hash_public_state(to_public_state()) while the history fields are zero.
+  Hash128 hash;
+
+  // Returns false (leaving `out` unspecified) if the state has more than
+  // kMaxPlayers seats, more than 5 board entries or vector sizes that differ
+  // from num_players.
+  static bool from_public_state(const PublicState& s, CompactPublicState& out);
+  PublicState to_public_state() const;
+  // Reuses the vectors' capacity in `out`.
+  void to_public_state(PublicState& out) const;
+
+  int board_card(int i) const { return static_cast<int>((board_packed >> (6 * i)) & 0x3F) - 1; }
+  void set_board_card(int i, int card) {
+    const uint32_t shift = 6u * static_cast<uint32_t>(i);
+    board_packed = (board_packed & ~(0x3Fu << shift)) | (static_cast<uint32_t>(card + 1) << shift);
+  }
+
+  // Recomputes pot, current_bet and hash from the fields.
+  void rehash();
+};
+
+}  // namespace quasar
@@ -13,10 +13,27 @@ struct DiscretizationConfig {
   bool include_all_in = true;
 };
 
-// Generate a discrete set of actions from legal bounds.
+// Generate a discrete set of actions from legal bounds. Targets are computed
+// and deduplicated in exact chips (chips.h).
 std::vector<Action> discretize_actions(const PublicState& s,
                                        const LegalActionSummary& la,
                                        const DiscretizationConfig& cfg);
 
+// Same, writing into `out` (cleared first) so callers can reuse its capacity.
+void discretize_actions(const PublicState& s,
+                        const LegalActionSummary& la,
+                        const DiscretizationConfig& cfg,
+                        std::vector<Action>& out);
+
+// Exact-chip variants over the integer legality summary.
+void discretize_actions_chips(const PublicState& s,
+                              const ChipLegalSummary& la,
+                              const DiscretizationConfig& cfg,
+                              std::vector<ChipAction>& out);
+void discretize_actions_chips(const CompactPublicState& s,
+                              const ChipLegalSummary& la,
+                              const DiscretizationConfig& cfg,
+                              std::vector<ChipAction>& out);
+
 }  // namespace quasar
 
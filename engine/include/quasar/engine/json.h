@@ -1,25 +1,50 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "quasar/engine/public_state.h"
 #include "quasar/engine/plo_legal.h"
 #include "quasar/engine/rules.h"
 #include "quasar/engine/discretize.h"
+#include "quasar/engine/solve_one.h"
 
 namespace quasar {
 
+// A spot request (docs/SPOT_JSON.md): public state plus solve config.
+struct SpotRequest {
+  PublicState state;
+  SolveOneConfig config;
+};
+
+// Single-pass parser for a spot JSON object: fills state and config (config
+// fields not present keep their defaults). Keys are matched by position in
+// the document, so nested objects never shadow top-level keys; unknown keys
+// are skipped. Reuses `out`'s vector capacity. Returns false on malformed
+// JSON or if stacks/committed_* are missing or differ in length.
+bool parse_spot_json(std::string_view json, SpotRequest& out);
+
+// Newline-delimited stream of spot objects: one entry per non-blank line
+// (existing entries in `out` are reused). Returns the number of lines parsed
+// successfully; `ok`, if given, gets the per-line result.
+size_t parse_spot_ndjson(std::string_view text, std::vector<SpotRequest>& out,
+                         std::vector<bool>* ok = nullptr);
+
 // Parse a minimal JSON spot description into PublicState (best-effort).
-bool parse_public_state_from_json(const std::string& json, PublicState& s);
+bool parse_public_state_from_json(std::string_view json, PublicState& s);
 
-// Optional config parsing
-bool parse_rules_from_json(const std::string& json, BettingRules& rules);
-DiscretizationConfig parse_discretization_from_json(const std::string& json,
+// Optional config parsing; keys not present keep the given values.
+bool parse_rules_from_json(std::string_view json, BettingRules& rules);
+DiscretizationConfig parse_discretization_from_json(std::string_view json,
                                                     const DiscretizationConfig& def = DiscretizationConfig{});
 
+// Full solve config: rules, discretization and the optional
+// {"solver": {"iters", "win_prob", "call_k"}} block.
+bool parse_solve_config_from_json(std::string_view json, SolveOneConfig& cfg);
+
 // Assemble the CLI-style JSON response with legal summary and a uniform
 // distribution over the provided discrete actions plus check/fold/call as
 // applicable.
-// Assemble response with uniform distribution over [check/fold/call]+discrete
 std::string assemble_response_json(const LegalActionSummary& la,
                                    const std::vector<Action>& discrete);
 
@@ -28,4 +53,13 @@ std::string assemble_response_json(const LegalActionSummary& la,
                                    const std::vector<Action>& actions,
                                    const std::vector<double>& probs);
 
+// Same output appended to `out`: no allocation once `out` has grown to the
+// response size, so serving loops can reuse one buffer. Numbers use the
+// shortest round-trip form (util/format.h).
+void append_response_json(std::string& out, const LegalActionSummary& la,
+                          const std::vector<Action>& discrete);
+void append_response_json(std::string& out, const LegalActionSummary& la,
+                          const std::vector<Action>& actions,
+                          const std::vector<double>& probs);
+
 }  // namespace quasar
@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 
+#include "quasar/engine/chips.h"
+#include "quasar/engine/compact_state.h"
 #include "quasar/engine/public_state.h"
 #include "quasar/engine/types.h"
 #include "quasar/engine/rules.h"
@@ -16,6 +18,12 @@ struct Action {
   double amount = 0.0;
 };
 
+// Action with an exact chip amount (same meaning as Action::amount).
+struct ChipAction {
+  ActionType type;
+  Chips amount = 0;
+};
+
 struct RaiseBounds {
   // Legal raise/bet target range [min_to, max_to], if any
   double min_to = 0.0;
@@ -32,15 +40,40 @@ struct LegalActionSummary {
   std::vector<Action> suggestions;
 };
 
+// Integer-chip counterparts (chips.h) of RaiseBounds / LegalActionSummary.
+struct ChipRaiseBounds {
+  Chips min_to = 0;
+  Chips max_to = 0;
+};
+
+struct ChipLegalSummary {
+  bool can_check = false;
+  bool can_fold = false;
+  Chips call_amount = 0;
+  std::optional<ChipRaiseBounds> bet_bounds;
+  std::optional<ChipRaiseBounds> raise_bounds;
+};
+
 // Compute pot-limit legal action information for the player_to_act.
 // Assumes PublicState fields are well-formed (sizes match num_players).
+// All comparisons are done in exact chips; amounts are returned in the
+// state's units, rounded to the nearest centi-unit.
 LegalActionSummary compute_legal_actions(const PublicState& s, const BettingRules& rules = BettingRules{});
+// O(1) in the number of players (uses the cached pot/current bet); a terminal
+// state has no legal actions.
+LegalActionSummary compute_legal_actions(const CompactPublicState& s, const BettingRules& rules = BettingRules{});
+
+// Exact-chip legality, used by the double API above.
+ChipLegalSummary compute_legal_actions_chips(const PublicState& s, const BettingRules& rules = BettingRules{});
+ChipLegalSummary compute_legal_actions_chips(const CompactPublicState& s, const BettingRules& rules = BettingRules{});
 
 // Utility helpers exported for tests/CLI
 double pot_after_call(const PublicState& s, int player);
 double min_raise_size(const PublicState& s);
 
-// Small JSON serialization helpers for CLI
+// Small JSON serialization helpers for CLI. append_json appends to `out`
+// (reusing its capacity); to_json returns a fresh string.
+void append_json(std::string& out, const LegalActionSummary& la);
 std::string to_json(const LegalActionSummary& la);
 
 }  // namespace quasar
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "quasar/engine/solve_one.h"
+
+namespace quasar {
+
+// Struct-of-arrays view over N spots with a padded seat dimension P, as
+// handed over from NumPy without copies. All arrays are row-major and
+// caller-owned; optional arrays may be null.
+struct SpotBatchView {
+  size_t n = 0;
+  int players = 0;                             // P (2..kMaxPlayers)
+  const double* stacks = nullptr;              // [n, P]
+  const double* committed_total = nullptr;     // [n, P]
+  const double* committed_on_street = nullptr; // [n, P]
+  const int32_t* to_act = nullptr;             // [n]
+  const int32_t* board = nullptr;              // [n, 5] padded with -1 (null: no board)
+  const int32_t* button = nullptr;             // [n] (null: 0)
+  const int32_t* street = nullptr;             // [n] (null: from the board card count)
+  const int32_t* num_players = nullptr;        // [n] seats used per row (null: P)
+  const double* last_raise_size = nullptr;     // [n] (null: 0)
+  double sb = 1.0, bb = 2.0, ante = 0.0;       // shared by all spots
+};
+
+// Padded per-spot outputs, caller-owned. Rows hold `max_actions` slots;
+// unused slots have type -1 and zero amount/probability. A row whose spot is
+// invalid (bad seat count or to_act) or whose actions do not fit has
+// num_actions 0. The action arrays and num_actions are required; the
+// legal-summary arrays are optional, and min/max_to are NaN when no bet or
+// raise is available.
+struct ActionBatchOut {
+  int max_actions = 0;
+  int32_t* types = nullptr;         // [n, max_actions] ActionType
+  double* amounts = nullptr;        // [n, max_actions]
+  double* probabilities = nullptr;  // [n, max_actions]
+  int32_t* num_actions = nullptr;   // [n]
+  double* call_amount = nullptr;    // [n]
+  uint8_t* can_check = nullptr;     // [n]
+  uint8_t* can_fold = nullptr;      // [n]
+  double* min_to = nullptr;         // [n] bet or raise lower bound
+  double* max_to = nullptr;         // [n]
+};
+
+// Upper bound on actions solve_one returns under `cfg` (fold/check/call plus
+// every discretized size); a safe max_actions for ActionBatchOut.
+int max_solve_actions(const SolveOneConfig& cfg);
+
+// Solves every spot in parallel on `pool` (default_thread_pool() when null)
+// with one workspace per worker, writing straight into `out`. No per-spot
+// heap allocation once the workers' workspaces are warm.
+void solve_batch(const SpotBatchView& spots, const SolveOneConfig& cfg,
+                 const ActionBatchOut& out, ThreadPool* pool = nullptr);
+
+}  // namespace quasar
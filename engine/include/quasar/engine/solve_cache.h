@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+
+#include "quasar/engine/compact_state.h"
+#include "quasar/engine/public_state.h"
+#include "quasar/engine/solve_one.h"
+#include "quasar/engine/state_hash.h"
+#include "quasar/util/sharded_lru.h"
+
+namespace quasar {
+
+// Cache key: canonical state hash (state_hash.h) combined with the config hash.
+Hash128 solve_cache_key(const PublicState& s, const SolveOneConfig& cfg);
+// Uses the state's precomputed hash; equal to the PublicState overload.
+Hash128 solve_cache_key(const CompactPublicState& s, const SolveOneConfig& cfg);
+
+struct SolveCacheConfig {
+  size_t capacity = 1 << 16;  // cached results
+  int shards = 16;
+};
+
+// Thread-safe memoization of solve_one. Results are immutable and shared, so
+// a hit costs one hash, one shard lock and a refcount increment.
+class SolveCache {
+ public:
+  explicit SolveCache(const SolveCacheConfig& cfg = SolveCacheConfig{});
+
+  std::shared_ptr<const SolveOneResult> solve(const PublicState& s, const SolveOneConfig& cfg);
+  // Compact states skip state hashing; the PublicState is only rebuilt on a miss.
+  std::shared_ptr<const SolveOneResult> solve(const CompactPublicState& s, const SolveOneConfig& cfg);
+  // Same, with a key already computed by solve_cache_key.
+  std::shared_ptr<const SolveOneResult> solve(const Hash128& key, const PublicState& s, const SolveOneConfig& cfg);
+
+  CacheStats stats() const { return cache_.stats(); }
+  void clear() { cache_.clear(); }
+
+ private:
+  ShardedLruCache<Hash128, std::shared_ptr<const SolveOneResult>, Hash128Hasher> cache_;
+};
+
+}  // namespace quasar
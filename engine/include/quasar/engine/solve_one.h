@@ -1,9 +1,11 @@
 #pragma once
+#include <cstddef>
 #include <vector>
 
 #include "quasar/engine/plo_legal.h"
 #include "quasar/engine/rules.h"
 #include "quasar/engine/discretize.h"
+#include "quasar/solver/cfr.h"
 
 namespace quasar {
 
@@ -25,4 +27,36 @@ struct SolveOneResult {
 
 SolveOneResult solve_one(const PublicState& s, const SolveOneConfig& cfg);
 
+// Caller-owned scratch for repeated solves. Once its vectors have grown to
+// steady-state capacity, solve_one(s, cfg, ws) performs no heap allocation.
+// Results are left in ws.legal, ws.actions and ws.probabilities. One
+// workspace per thread.
+struct SolveWorkspace {
+  LegalActionSummary legal;
+  std::vector<Action> actions;        // expanded list including check/fold/call
+  std::vector<double> probabilities;  // same order as actions
+  // Scratch
+  std::vector<Action> discrete;
+  std::vector<double> utils;
+  CFRWorkspace cfr;
+};
+
+void solve_one(const PublicState& s, const SolveOneConfig& cfg, SolveWorkspace& ws);
+
+class ThreadPool;
+
+// Solve a batch of spots in parallel; results are in input order. Uses
+// default_thread_pool() when `pool` is null.
+std::vector<SolveOneResult> solve_many(const PublicState* states, size_t n,
+                                       const SolveOneConfig& cfg,
+                                       ThreadPool* pool = nullptr);
+std::vector<SolveOneResult> solve_many(const std::vector<PublicState>& states,
+                                       const SolveOneConfig& cfg,
+                                       ThreadPool* pool = nullptr);
+// Per-spot configs: cfgs[i] applies to states[i]. Throws std::invalid_argument
+// if the sizes differ.
+std::vector<SolveOneResult> solve_many(const std::vector<PublicState>& states,
+                                       const std::vector<SolveOneConfig>& cfgs,
+                                       ThreadPool* pool = nullptr);
+
 }  // namespace quasar
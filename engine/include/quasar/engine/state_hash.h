@@ -0,0 +1,51 @@
+#pragma once
+#include "quasar/engine/chips.h"
+#include "quasar/engine/public_state.h"
+#include "quasar/engine/solve_one.h"
+#include "quasar/util/hash.h"
+
+namespace quasar {
+
+// Flat view over public-state fields so differently laid out states
+// (PublicState, CompactPublicState) share one canonical hash. Amounts are in
+// exact chips (chips.h).
+struct PublicStateView {
+  int num_players = 0;
+  int player_to_act = 0;
+  int button = 0;
+  int street = 0;
+  const int* board = nullptr;  // may contain -1 padding
+  int board_len = 0;
+  Chips sb = 0;
+  Chips bb = 0;
+  Chips ante = 0;
+  const Chips* stacks = nullptr;
+  int stacks_len = 0;
+  const Chips* committed_total = nullptr;
+  int committed_total_len = 0;
+  const Chips* committed_on_street = nullptr;
+  int committed_on_street_len = 0;
+  Chips last_raise_size = 0;
+  // Betting history (CompactPublicState only); hashed only when set so plain
+  // PublicStates keep their keys.
+  uint32_t folded_mask = 0;
+  uint32_t acted_mask = 0;
+  int num_raises = 0;
+  bool terminal = false;
+};
+
+// Canonical hashes: representations of the same spot hash equally (board
+// padding (-1) is ignored, flop order is sorted and amounts are compared in
+// exact chips, so 0.1 + 0.2 and 0.3 hash alike). Config
+// fields that cannot affect the result (eval params with cfr_iters == 0) are
+// left out.
+Hash128 hash_public_state(const PublicStateView& v);
+Hash128 hash_public_state(const PublicState& s);
+Hash128 hash_solve_config(const SolveOneConfig& cfg);
+
+// Order-dependent combination of two digests (state, config) into one key.
+inline Hash128 combine_hashes(const Hash128& a, const Hash128& b) {
+  return Hash128{hash_combine(a.lo, b.lo), hash_combine(a.hi ^ 0x8cb92ba72f3d8dd7ULL, b.hi)};
+}
+
+}  // namespace quasar
@@ -0,0 +1,119 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "quasar/engine/compact_state.h"
+#include "quasar/engine/json.h"
+#include "quasar/engine/solve_one.h"
+
+namespace quasar {
+
+// Binary wire format (docs/SPOT_JSON.md, "Binary wire format"): the same
+// spots and results as the JSON interface in fixed-size little-endian
+// records, so a batch is one contiguous buffer that is encoded and decoded
+// with memcpy. Layout:
+//   WireHeader (16 bytes) followed by `count` records of `record_bytes` each.
+// Records are WireSpot (kind kWireSpots) or WireResult (kind kWireResults).
+// Readers reject other magics, versions and record sizes, so any layout
+// change must bump kWireVersion.
+constexpr char kWireMagic[4] = {'Q', 'W', 'I', 'R'};
+constexpr uint16_t kWireVersion = 1;
+constexpr uint16_t kWireSpots = 1;
+constexpr uint16_t kWireResults = 2;
+constexpr int kWireMaxFracs = 8;     // discretization pot_fracs per spot
+constexpr int kWireMaxActions = 16;  // actions per result
+
+struct WireHeader {
+  char magic[4];
+  uint16_t version;
+  uint16_t kind;
+  uint32_t count;
+  uint32_t record_bytes;
+};
+
+// WireSpot::flags
+constexpr uint8_t kWireIncludeMin = 1 << 0;
+constexpr uint8_t kWireIncludePotRaise = 1 << 1;
+constexpr uint8_t kWireIncludeAllIn = 1 << 2;
+constexpr uint8_t kWireMinBetOneChip = 1 << 3;
+
+// One spot request: PublicState plus SolveOneConfig. Per-player arrays are
+// valid up to num_players, pot_fracs up to num_fracs; board is padded with -1.
+struct WireSpot {
+  double sb, bb, ante, last_raise_size;
+  double stacks[kMaxPlayers];
+  double committed_total[kMaxPlayers];
+  double committed_on_street[kMaxPlayers];
+  double pot_fracs[kWireMaxFracs];
+  double win_prob, call_k;
+  int32_t cfr_iters;
+  int8_t num_players, player_to_act, button, street;
+  int8_t board[5];
+  uint8_t num_fracs;
+  uint8_t flags;
+  uint8_t reserved;
+};
+
+// WireResult::flags
+constexpr uint8_t kWireOk = 1 << 0;  // clear: the spot was invalid, the rest is zero
+constexpr uint8_t kWireCanCheck = 1 << 1;
+constexpr uint8_t kWireCanFold = 1 << 2;
+constexpr uint8_t kWireHasBet = 1 << 3;
+constexpr uint8_t kWireHasRaise = 1 << 4;
+
+// One solve result: legal summary (without suggestions) plus the action
+// list and probabilities, valid up to num_actions.
+struct WireResult {
+  double call_amount;
+  double bet_min_to, bet_max_to;      // valid with kWireHasBet
+  double raise_min_to, raise_max_to;  // valid with kWireHasRaise
+  double amounts[kWireMaxActions];
+  double probabilities[kWireMaxActions];
+  int8_t types[kWireMaxActions];  // ActionType
+  uint8_t num_actions;
+  uint8_t flags;
+  uint8_t reserved[6];
+};
+
+static_assert(sizeof(WireHeader) == 16, "wire layout");
+static_assert(sizeof(WireSpot) == 344, "wire layout");
+static_assert(sizeof(WireResult) == 320, "wire layout");
+
+// Record conversion. Encoders return false if the input does not fit the
+// fixed layout (too many players, fractions or actions); decode_spot returns
+// false on out-of-range counts or to_act.
+bool encode_spot(const PublicState& s, const SolveOneConfig& cfg, WireSpot& out);
+bool decode_spot(const WireSpot& w, SpotRequest& out);
+bool encode_result(const LegalActionSummary& la, const std::vector<Action>& actions,
+                   const std::vector<double>& probs, WireResult& out);
+void decode_result(const WireResult& w, SolveOneResult& out);
+
+// Batch buffers. Writers replace `out`; an entry that does not fit, or whose
+// `ok` flag (if given) is false, is written as an all-zero record, which
+// decodes as invalid. Readers return false if the header or total size is
+// wrong; otherwise `out` holds `count` entries and `ok` (if given) the
+// per-record decode result.
+void write_spot_batch(const SpotRequest* reqs, size_t n, std::string& out,
+                      const std::vector<bool>* ok = nullptr);
+bool read_spot_batch(std::string_view buf, std::vector<SpotRequest>& out,
+                     std::vector<bool>* ok = nullptr);
+void write_result_batch(const SolveOneResult* results, size_t n, std::string& out);
+bool read_result_batch(std::string_view buf, std::vector<SolveOneResult>& out,
+                       std::vector<bool>* ok = nullptr);
+
+// True if `buf` starts with the wire magic (JSON text never does).
+bool is_wire_buffer(std::string_view buf);
+
+// Solves every spot in a spot batch on `pool` (default_thread_pool() when
+// null) and writes the matching result batch. Returns false if `spots` is
+// not a valid spot batch. With a `deadline`, each record checks it before
+// solving; once it has passed the remaining records are left zeroed and
+// *expired (if given) is set, so a late batch stops occupying the pool.
+bool solve_wire_batch(std::string_view spots, std::string& results, ThreadPool* pool = nullptr,
+                      const std::chrono::steady_clock::time_point* deadline = nullptr, bool* expired = nullptr);
+
+}  // namespace quasar
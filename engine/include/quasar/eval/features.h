@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace quasar {
+
+class ThreadPool;
+
+// Per-hand bucketing features, one float32 row per hand:
+//   kFeatEhs           equity vs one uniformly random opponent hand over all
+//                      runouts (ties count half)
+//   kFeatEhs2          E[HS^2]: mean over runouts of the squared river equity
+//   kFeatCategory      current made-hand category (high card 0 .. straight
+//                      flush 8) divided by 8
+//   kFeatNut           fraction of runouts on which no opponent hand beats it
+//   kFeatFlushDraw     1 if a two-card board suit plus two hole cards of that
+//                      suit can still make a flush (flop/turn only)
+//   kFeatStraightOuts  ranks that would give a straight not yet held, / 13
+enum HandFeature : int {
+  kFeatEhs = 0,
+  kFeatEhs2,
+  kFeatCategory,
+  kFeatNut,
+  kFeatFlushDraw,
+  kFeatStraightOuts,
+  kHandFeatureDim
+};
+
+// Fills out[n, kHandFeatureDim] for `n` hands ([n, 4] card indices) on a 3-,
+// 4- or 5-card board. Each river is scored once for every hand at the same
+// time: the hands are sorted by best_plo_river_key and the opponent hands
+// that are beaten, tied or beat each hand (excluding those that share one of
+// its cards) are counted by inclusion-exclusion over card-subset counters.
+// Turn and flop runouts are split across `pool` (default_thread_pool() when
+// null). Rows of hands that collide with the board or are invalid are zero.
+// Returns false if the board is not 3..5 distinct cards in 0..51.
+bool plo_hand_features(const int32_t* board, int board_len, const int32_t* hands, size_t n, float* out,
+                       ThreadPool* pool = nullptr);
+
+}  // namespace quasar
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+
+namespace quasar {
+
+// Number of distinct 4-card PLO hands, C(52, 4).
+constexpr uint32_t kNumPloHands = 270725;
+
+namespace detail {
+
+struct Binomials {
+  uint32_t c[53][5] = {};
+  constexpr Binomials() {
+    for (int n = 0; n <= 52; ++n) {
+      c[n][0] = 1;
+      for (int k = 1; k <= 4; ++k) c[n][k] = n == 0 ? 0 : c[n - 1][k - 1] + c[n - 1][k];
+    }
+  }
+};
+
+inline constexpr Binomials kBinom{};
+
+}  // namespace detail
+
+// C(n, k) for 0 <= n <= 52, 0 <= k <= 4.
+constexpr uint32_t binom52(int n, int k) { return detail::kBinom.c[n][k]; }
+
+// Colexicographic index of a hand given as four distinct cards in ascending
+// order a < b < c < d: C(a,1) + C(b,2) + C(c,3) + C(d,4). Dense in
+// [0, kNumPloHands), so per-hand tables can be flat arrays.
+constexpr uint32_t plo_hand_index_sorted(int a, int b, int c, int d) {
+  return binom52(a, 1) + binom52(b, 2) + binom52(c, 3) + binom52(d, 4);
+}
+
+// Same for four distinct cards in any order.
+inline uint32_t plo_hand_index(const int32_t* cards) {
+  int s[4] = {cards[0], cards[1], cards[2], cards[3]};
+  for (int i = 1; i < 4; ++i) {
+    for (int j = i; j > 0 && s[j - 1] > s[j]; --j) {
+      const int t = s[j];
+      s[j] = s[j - 1];
+      s[j - 1] = t;
+    }
+  }
+  return plo_hand_index_sorted(s[0], s[1], s[2], s[3]);
+}
+
+// Inverse of plo_hand_index; writes the cards in ascending order.
+inline void plo_hand_from_index(uint32_t index, int32_t* cards) {
+  int x = 52;
+  for (int k = 4; k >= 1; --k) {
+    do --x;
+    while (binom52(x, k) > index);
+    cards[k - 1] = x;
+    index -= binom52(x, k);
+  }
+}
+
+}  // namespace quasar
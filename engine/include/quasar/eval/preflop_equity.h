@@ -0,0 +1,129 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace quasar {
+
+class ThreadPool;
+
+// All-in preflop equities between suit-isomorphism classes of PLO starting
+// hands (16432 classes of the 270725 hands), built offline and memory-mapped
+// at runtime. A class is named by its canonical hand: the smallest card
+// bitmask over the 24 suit relabelings. For classes A and B,
+//   equity(A, B) = mean over disjoint (a in A, b in B, 5-card board) of
+//                  a's showdown share (1 win, 0.5 tie, 0 loss)
+//   overlap(A, B) = disjoint (a, b) pairs / (|A| |B|)
+// so equity(B, A) = 1 - equity(A, B) and overlap is symmetric; both are
+// stored as upper triangles (diagonal included). Layout (little-endian):
+//   PreflopEquityHeader (64 bytes)
+//   classes: num_classes uint64 canonical masks, ascending (at classes_offset)
+//   equity:  n(n+1)/2 uint16, round(equity * 65534) (at equity_offset)
+//   overlap: n(n+1)/2 uint8, overlap * 255 rounded, at least 1 when nonzero
+//            (at overlap_offset)
+// Row i of a triangle holds columns j >= i; sections are 64-byte aligned.
+constexpr char kPreflopEquityMagic[4] = {'Q', 'P', 'E', 'Q'};
+constexpr uint16_t kPreflopEquityFormat = 1;
+constexpr uint32_t kNumPreflopClasses = 16432;
+
+struct PreflopEquityHeader {
+  char magic[4];
+  uint16_t format;
+  uint16_t reserved0;
+  uint32_t num_classes;
+  uint32_t boards;          // boards sampled per class row
+  uint64_t seed;
+  uint64_t classes_offset;
+  uint64_t equity_offset;
+  uint64_t overlap_offset;
+  uint8_t reserved[16];
+};
+static_assert(sizeof(PreflopEquityHeader) == 64, "PreflopEquityHeader must stay 64 bytes");
+
+// Canonical mask of a 4-card hand, or 0 if a card is invalid or repeated.
+uint64_t canonical_hand(const int32_t* hand);
+
+// Canonical masks of every class, ascending (kNumPreflopClasses entries).
+std::vector<uint64_t> preflop_classes();
+
+struct PreflopEquityConfig {
+  uint32_t boards = 4096;        // boards sampled per class row
+  uint64_t seed = 1;
+  // Classes to tabulate, as card masks of any member hand; empty for all.
+  // Subset tables hold the same entries as the full table for the same
+  // seed, so they are useful for tests and for spot checks.
+  std::vector<uint64_t> classes;
+};
+
+// Builds the table into `path` (written to path + ".tmp" and renamed). Row A
+// fixes A's canonical hand a, samples `boards` boards from the other 48
+// cards, and scores a on each board against every member of each class
+// B >= A that misses a and the board with one RiverBoardEvaluator; wins and
+// ties are pooled over boards, so equity(A, B) is a ratio estimate with
+// standard error around 0.5 / sqrt(boards). Boards depend only on (seed, A),
+// so the output is the same for any pool size. Rows are split across `pool`
+// (default_thread_pool() when null). Returns false (with a message in
+// *error) on invalid classes or I/O errors.
+bool build_preflop_equity(const PreflopEquityConfig& cfg, const std::string& path, std::string* error = nullptr,
+                          ThreadPool* pool = nullptr);
+
+// Read-only mmap view of a table. Lookups are thread-safe.
+class PreflopEquityTable {
+ public:
+  // nullptr if the file is missing, truncated or has another magic/format.
+  static std::unique_ptr<PreflopEquityTable> open(const std::string& path);
+  ~PreflopEquityTable();
+  PreflopEquityTable(const PreflopEquityTable&) = delete;
+  PreflopEquityTable& operator=(const PreflopEquityTable&) = delete;
+
+  size_t num_classes() const { return header_.num_classes; }
+  uint32_t boards() const { return header_.boards; }
+  uint64_t seed() const { return header_.seed; }
+  uint64_t class_mask(size_t i) const { return classes_[i]; }
+
+  // Row of a hand's class (4 cards), or -1 if invalid or not tabulated.
+  int class_of(const int32_t* hand) const;
+
+  // equity(i, j) and overlap(i, j) as defined above. Equity is NaN when the
+  // classes share no disjoint pair.
+  float class_equity(size_t i, size_t j) const;
+  float class_overlap(size_t i, size_t j) const;
+
+  // Equity of `hand` against `villain` (class level), NaN if either is not
+  // tabulated or they share a card.
+  float equity(const int32_t* hand, const int32_t* villain) const;
+
+  // Per-class weights [num_classes] from per-hand weights [kNumPloHands]
+  // (indexed by plo_hand_index); hands of untabulated classes are dropped.
+  void class_weights(const float* hand_weights, double* out) const;
+
+  // Equity of each class against a villain range given as class weights:
+  // out[i] = sum_j v[j] overlap(i, j) equity(i, j) / sum_j v[j] overlap(i, j),
+  // NaN where the denominator is 0. Overlap weighting makes the result exact
+  // for suit-symmetric ranges; within a class, weights are treated as
+  // uniform. Hero classes are split across `pool` (default_thread_pool() when
+  // null).
+  void class_vs_range(const double* villain, float* out, ThreadPool* pool = nullptr) const;
+
+  // Equity of the hero range against the villain range, both per-hand
+  // weights [kNumPloHands], with the same overlap weighting over class
+  // pairs. NaN if no hero/villain weight can meet. Cost is quadratic in the
+  // number of classes either range touches.
+  double range_vs_range(const float* hero, const float* villain, ThreadPool* pool = nullptr) const;
+
+ private:
+  PreflopEquityTable() = default;
+  size_t tri(size_t i, size_t j) const;  // i <= j
+
+  PreflopEquityHeader header_{};
+  const unsigned char* base_ = nullptr;
+  size_t size_ = 0;
+  const uint64_t* classes_ = nullptr;
+  const uint16_t* equity_ = nullptr;
+  const uint8_t* overlap_ = nullptr;
+  std::vector<int32_t> row_of_hand_;  // [kNumPloHands], -1 if untabulated
+};
+
+}  // namespace quasar
@@ -1,15 +1,21 @@
 #pragma once
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace quasar {
 
+class ThreadPool;
+
 // Utility to extract rank/suit from 0..51 index (2..A ranks -> 0..12)
 inline int card_rank(int c) { return c % 13; }
 inline int card_suit(int c) { return c / 13; }
 
 // Evaluate a 5-card hand strength key (higher is better).
-// Cards are 0..51 using rank/suit mapping above.
+// Cards are 0..51 using rank/suit mapping above. Key layout: category (0 =
+// high card .. 8 = straight flush) in bits 60..63, then the five tie-break
+// ranks in 4-bit fields, most significant first (bits 16..19 down to 0..3).
+// Does not allocate.
 uint64_t eval_5card(const std::array<int, 5>& cards);
 
 // Best 5-card hand key for PLO river: exactly 2 from 4 hole + 3 from 5 board.
@@ -20,5 +26,36 @@ int compare_plo_river(const std::array<int, 4>& holeA,
                       const std::array<int, 4>& holeB,
                       const std::array<int, 5>& board);
 
+// Per-board PLO river evaluator for scoring many hands on one board. The
+// constructor tabulates, for every pair of hole ranks, the best non-flush key
+// over the ten board triples (and the best flush key when the board has a
+// three-card suit), so key() is six table lookups instead of sixty 5-card
+// evaluations. key() equals best_plo_river_key for any hole that does not
+// share a card with the board.
+class RiverBoardEvaluator {
+ public:
+  explicit RiverBoardEvaluator(const std::array<int, 5>& board);
+
+  uint64_t key(const int32_t* hole) const;  // 4 cards
+  uint64_t board_mask() const { return board_mask_; }
+
+ private:
+  uint64_t board_mask_ = 0;
+  int flush_suit_ = -1;
+  std::array<uint64_t, 169> best_{};        // by hole ranks r1 * 13 + r2
+  std::array<uint64_t, 169> flush_best_{};  // both hole cards in flush_suit_
+};
+
+// Batch river keys for `n` hands ([n, 4] row-major card indices) on a full
+// board, in parallel on `pool` (default_thread_pool() when null). Hands with
+// a card outside 0..51, a repeated card or a board card get key 0.
+void plo_river_keys(const std::array<int, 5>& board, const int32_t* hands, size_t n,
+                    uint64_t* keys, ThreadPool* pool = nullptr);
+
+// out[i] = 1 if hand i shares a card with the board (board entries < 0 are
+// padding, so flop and turn boards work) or holds an invalid/repeated card.
+void board_collision_mask(const int32_t* board, int board_len, const int32_t* hands, size_t n,
+                          uint8_t* out, ThreadPool* pool = nullptr);
+
 }  // namespace quasar
 
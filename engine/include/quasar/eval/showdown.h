@@ -0,0 +1,22 @@
+#pragma once
+#include <array>
+
+namespace quasar {
+
+// Pot-normalized river showdown value of every PLO hand against weighted
+// opponent ranges. For hand h and range r,
+//   values[r][h] = (W - L) / (2 T)
+// where W, L and T are the opponent weight h beats, loses to, and in total,
+// over opponent hands sharing no card with h or the board: +0.5 wins the
+// opponent's half of the pot, -0.5 loses one's own. weights[r] and values[r]
+// are indexed by plo_hand_index ([kNumPloHands]); weights of hands that meet
+// the board are ignored, and such hands (and hands facing no opponent
+// weight) get value 0.
+//
+// One pass over the hands sorted by key with card-removal counters, as in
+// plo_hand_features; single-threaded, with per-thread scratch reused across
+// calls, so callers parallelize over boards.
+void river_showdown_values(const std::array<int, 5>& board, const float* const* weights, float* const* values,
+                           int ranges);
+
+}  // namespace quasar
@@ -0,0 +1,72 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+#include "quasar/nn/value_net.h"
+
+namespace quasar {
+
+struct BatchingConfig {
+  int max_batch = 256;    // flush once this many batch items are queued
+  int max_wait_us = 200;  // or after the first item has waited this long
+};
+
+struct BatchingStats {
+  uint64_t calls = 0;    // compute_values_into calls served
+  uint64_t batches = 0;  // calls forwarded to the wrapped net
+  uint64_t items = 0;    // batch items forwarded
+};
+
+// Micro-batching decorator for dense value nets shared by many solver
+// threads. Concurrent compute_values_into calls with the same player count
+// are coalesced into one forward pass on the wrapped net: the first caller
+// becomes the leader, waits up to max_wait_us for others to queue, runs the
+// combined batch and hands every follower its slice. Callers block until
+// their own rows are written. If the wrapped net throws, every caller in that
+// batch rethrows the exception. Sparse queries are forwarded unbatched. Does
+// not take ownership of `inner`.
+class BatchingValueNet final : public IValueNet {
+ public:
+  BatchingValueNet(IValueNet* inner, const BatchingConfig& cfg = BatchingConfig{});
+
+  int input_size() const override { return inner_->input_size(); }
+  int output_size() const override { return inner_->output_size(); }
+  bool is_sparse() const override { return inner_->is_sparse(); }
+
+  std::vector<float> compute_values(const std::vector<float>& queries, int batch, int players) override;
+  void compute_values_into(const float* queries, int batch, int players, float* out) override;
+  bool compute_values_sparse(const SparseQueries& q, float* out) override;
+
+  BatchingStats stats() const;
+
+ private:
+  struct Pending {
+    const float* queries;
+    float* out;
+    int batch;
+    int players;
+    bool done;
+    std::exception_ptr error;  // set with done if the batch's forward threw
+  };
+
+  // Leader only, without the lock: runs the taken calls (`items` rows in
+  // total) through the wrapped net.
+  void forward(const float* queries, int batch, int players, float* out, int items);
+
+  IValueNet* inner_;
+  BatchingConfig cfg_;
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<Pending*> queue_;
+  int queued_items_ = 0;
+  bool leader_active_ = false;
+  BatchingStats stats_;
+  // Leader-only scratch (one leader at a time)
+  std::vector<Pending*> taken_;
+  std::vector<float> in_, out_;
+};
+
+}  // namespace quasar
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "quasar/nn/value_net.h"
+#include "quasar/util/hash.h"
+#include "quasar/util/sharded_lru.h"
+
+namespace quasar {
+
+struct ValueCacheConfig {
+  size_t capacity = 1 << 16;  // cached batch items (all players of one query)
+  // If nonzero, bounds the cached values' total size in bytes instead, so the
+  // footprint does not depend on players * output_size.
+  size_t capacity_bytes = 0;
+  int shards = 16;
+  // Quantization steps applied before hashing. Range mass within
+  // range_quantum and S2PR (scaled by 100 in the slice) within s2pr_quantum
+  // share a cache entry.
+  float range_quantum = 1e-4f;
+  float s2pr_quantum = 1e-2f;
+};
+
+// Caching decorator for dense value nets. Each batch item is keyed by its
+// canonical board (flop cards sorted), per-player act/position/S2PR geometry
+// and a hash of the quantized range vectors; misses are forwarded to the
+// wrapped net in one compacted batch. Entries are immutable and shared, so a
+// hit copies one pointer under the shard lock and the values after it is
+// released. Thread-safe if the wrapped net is.
+// Does not take ownership of `inner`.
+class CachedValueNet final : public IValueNet {
+ public:
+  CachedValueNet(IValueNet* inner, const ValueCacheConfig& cfg = ValueCacheConfig{});
+
+  int input_size() const override { return inner_->input_size(); }
+  int output_size() const override { return inner_->output_size(); }
+  bool is_sparse() const override { return inner_->is_sparse(); }
+
+  std::vector<float> compute_values(const std::vector<float>& queries, int batch, int players) override;
+  void compute_values_into(const float* queries, int batch, int players, float* out) override;
+  bool compute_values_sparse(const SparseQueries& q, float* out) override;
+
+  CacheStats stats() const { return cache_.stats(); }
+  void clear() { cache_.clear(); }
+
+  // Key for one batch item ([players, input_size] floats); exposed for tests.
+  Hash128 item_key(const float* item, int players) const;
+
+ private:
+  IValueNet* inner_;
+  ValueCacheConfig cfg_;
+  ShardedLruCache<Hash128, std::shared_ptr<const std::vector<float>>, Hash128Hasher> cache_;
+};
+
+}  // namespace quasar
@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+
+#include "quasar/nn/value_net.h"
+
+namespace quasar {
+
+// Dependency-free CPU forward for DenseTransformerNet
+// (python/quasar/models/dense_transformer.py), loaded from the binary weight
+// file written by `export_native_weights`. See docs/DESIGN.md for the layout.
+struct NativeValueNetOptions {
+  // Quantize linear-layer weights to int8 (symmetric, per output row) at load.
+  // Activations, biases and layer norms stay in fp32.
+  bool int8_weights = false;
+};
+
+// Returns nullptr if the file is missing, has an unknown version, or its size
+// does not match the dimensions in its header. Instances keep scratch buffers
+// between calls and are not thread-safe; use one per thread.
+IValueNet* load_native_value_net(const std::string& path,
+                                 const NativeValueNetOptions& opts = NativeValueNetOptions{});
+
+}  // namespace quasar
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace quasar {
+
+// Per-player value-net query slice (docs/DESIGN.md, "Packing Schema"):
+//   [PLAYER_ACT, POSITION, S2PR, BOARD[5], RANGE[K]]
+// Sparse queries carry the same public prefix and replace RANGE[K] with
+// (indices, values, mask) over at most M_max populated buckets.
+constexpr int kSlicePlayerAct = 0;
+constexpr int kSlicePosition = 1;
+constexpr int kSliceS2PR = 2;
+constexpr int kSliceBoard = 3;
+constexpr int kSliceBoardCards = 5;
+constexpr int kSlicePublicSize = 8;  // offset of RANGE[K] in a dense slice
+
+inline int dense_slice_size(int K) { return kSlicePublicSize + K; }
+
+}  // namespace quasar
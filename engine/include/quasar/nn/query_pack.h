@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "quasar/nn/query_layout.h"
+
+namespace quasar {
+
+class ThreadPool;
+
+// Bucket card mask bit that marks a bucket impossible on every board (an
+// invalid or repeated card); the packer always zeroes such buckets.
+constexpr uint64_t kImpossibleBucket = uint64_t{1} << 63;
+
+// Dense value-net queries for `batch` states of `players` seats, as handed
+// over from NumPy or built by the solver. All arrays are row-major and
+// caller-owned; optional arrays may be null.
+struct DenseQueryBatch {
+  int batch = 0;
+  int players = 0;
+  int K = 0;                              // RANGE[K] length
+  const int32_t* player_act = nullptr;    // [batch] acting seat
+  const int32_t* positions = nullptr;     // [batch, players] (null: seat index)
+  const double* s2pr = nullptr;           // [batch] unscaled stack-to-pot ratio
+  const int32_t* board = nullptr;         // [batch, 5] padded with -1 (null: no board)
+  const float* ranges = nullptr;          // [batch, players, K] (null: zeros)
+  // Card mask per bucket (bits 0..51, plus kImpossibleBucket). A bucket whose
+  // mask meets the board is zeroed. [K] shared by every seat, or
+  // [players, K] when masks_per_player is set; null disables zeroing.
+  const uint64_t* bucket_masks = nullptr;
+  bool masks_per_player = false;
+};
+
+// S2PR feature: np.clip(s2pr, -0.5, s2pr + 0.5) * 100 as in
+// packing.clamp_s2pr (the upper bound wins when the bounds cross, s2pr < -1),
+// rounded to float.
+inline float scale_s2pr(double s2pr) {
+  const double lo = s2pr < -0.5 ? -0.5 : s2pr;
+  return static_cast<float>((lo < s2pr + 0.5 ? lo : s2pr + 0.5) * 100.0);
+}
+
+// Card masks for [n, 4] hands, one bucket per hand: kImpossibleBucket for a
+// hand with an out-of-range or repeated card.
+void hand_card_masks(const int32_t* hands, size_t n, uint64_t* out);
+
+// Writes [batch, players, dense_slice_size(K)] floats into `out`: the
+// [PLAYER_ACT, POSITION, S2PR, BOARD[5], RANGE[K]] slice of every seat, with
+// impossible buckets zeroed. Every float of `out` is written. States are
+// split across `pool` (default_thread_pool() when null); no allocation.
+void pack_dense_queries(const DenseQueryBatch& q, float* out, ThreadPool* pool = nullptr);
+
+}  // namespace quasar
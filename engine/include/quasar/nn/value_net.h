@@ -1,9 +1,26 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace quasar {
 
+// Sparse value-net batch (docs/LEARNINGS_PLO.md section 3). All arrays are
+// row-major and caller-owned:
+//   pub:     [batch, players, kSlicePublicSize]  public prefix of the slice
+//   indices: [batch, players, m_max] populated bucket ids (padding arbitrary)
+//   values:  [batch, players, m_max] range mass at those buckets
+//   mask:    [batch, players, m_max] 1 for populated entries, 0 for padding
+struct SparseQueries {
+  const float* pub = nullptr;
+  const int32_t* indices = nullptr;
+  const float* values = nullptr;
+  const float* mask = nullptr;
+  int batch = 0;
+  int players = 0;
+  int m_max = 0;
+};
+
 class IValueNet {
  public:
   virtual ~IValueNet() = default;
@@ -15,10 +32,23 @@ class IValueNet {
   virtual std::vector<float> compute_values(const std::vector<float>& queries,
                                             int batch,
                                             int players) = 0;
+
+  // Same contract as compute_values, but reads batch*players*input_size floats
+  // from `queries` and writes batch*players*output_size floats into the
+  // caller-owned `out` buffer. Implementations should avoid per-call heap
+  // allocation on this path; the default forwards to the vector overload.
+  virtual void compute_values_into(const float* queries, int batch, int players, float* out);
+
+  // Sparse query: writes [batch, players, m_max] CFVs aligned with
+  // q.indices into `out` (0 where mask is 0). Sparse models run natively; the
+  // default scatters into the dense slice layout (input_size == 8 + K,
+  // output_size == K) and gathers the outputs back. Returns false if the net
+  // cannot serve sparse queries.
+  virtual bool compute_values_sparse(const SparseQueries& q, float* out);
 };
 
 // Factory: returns nullptr if TorchScript is not enabled/available.
-IValueNet* load_torchscript_value_net(const std::string& path);
+// `max_batch` sizes the persistent input/mask buffers; larger batches grow them.
+IValueNet* load_torchscript_value_net(const std::string& path, int max_batch = 256);
 
 }  // namespace quasar
-
@@ -0,0 +1,140 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "quasar/engine/solve_cache.h"
+
+namespace quasar {
+
+// Framed request/response protocol spoken by quasar_server. Every frame is a
+// 12-byte header of three little-endian u32 words followed by `length` bytes:
+//   request:  length, id, deadline_ms  + spot JSON (docs/SPOT_JSON.md)
+//   response: length, id, status       + response JSON (empty unless kOk)
+// A request body that is a binary spot batch (quasar/engine/wire.h) is
+// answered with the matching result batch instead; its spots are solved
+// across the worker pool. A batch counts one per record toward max_in_flight
+// (so one larger than max_in_flight is always kOverloaded), and its deadline
+// is checked before each record: a batch that runs past it is answered with
+// kDeadlineExceeded and its remaining records are skipped.
+// `id` is echoed back unchanged; responses on one connection may arrive out
+// of request order. deadline_ms == 0 means no deadline; otherwise it counts
+// from when the server read the frame, and a request still queued past it is
+// answered with kDeadlineExceeded instead of being solved.
+constexpr size_t kFrameHeaderBytes = 12;
+
+enum class ServerStatus : uint32_t {
+  kOk = 0,
+  kInvalidRequest = 1,    // payload did not parse as a spot
+  kOverloaded = 2,        // admission limit reached; retry later
+  kDeadlineExceeded = 3,
+  kFrameTooLarge = 4,     // the connection is closed after this reply
+};
+
+struct SolveServerConfig {
+  std::string unix_path;      // listen on this Unix socket when non-empty
+  int tcp_port = 0;           // otherwise 127.0.0.1:tcp_port (0 picks a free port)
+  int workers = 0;            // solver threads; <= 0 uses hardware concurrency
+  size_t max_in_flight = 1024;       // queued + running spots before kOverloaded
+  size_t max_frame_bytes = 1 << 20;  // larger requests get kFrameTooLarge
+  size_t cache_capacity = SolveCacheConfig{}.capacity;  // 0 disables the result cache
+};
+
+struct ServerStats {
+  uint64_t connections = 0;
+  uint64_t requests = 0;   // frames read
+  uint64_t solved = 0;
+  uint64_t invalid = 0;
+  uint64_t overloaded = 0;
+  uint64_t expired = 0;
+};
+
+class ThreadPool;
+
+// Long-lived solve service: one acceptor thread, one reader thread per
+// connection, and a fixed ThreadPool running solve_one (through a shared
+// SolveCache unless disabled). Readers apply admission control before
+// queueing, so an overloaded server answers immediately instead of growing
+// its queue.
+class SolveServer {
+ public:
+  explicit SolveServer(const SolveServerConfig& cfg = SolveServerConfig{});
+  ~SolveServer();
+
+  SolveServer(const SolveServer&) = delete;
+  SolveServer& operator=(const SolveServer&) = delete;
+
+  // Binds, listens and starts serving. Returns false if the socket cannot be
+  // set up (a stale Unix socket file at unix_path is replaced).
+  bool start();
+  // Stops accepting, disconnects clients and waits for queued work to drain.
+  // Removes the Unix socket file. Idempotent.
+  void stop();
+
+  // Bound TCP port (after start, TCP mode only).
+  int port() const { return port_; }
+  ServerStats stats() const;
+
+ private:
+  struct Connection;
+  struct Session;
+
+  void accept_loop();
+  void read_loop(const std::shared_ptr<Connection>& conn);
+  void handle(const std::shared_ptr<Connection>& conn, uint32_t id,
+              std::chrono::steady_clock::time_point deadline, bool has_deadline,
+              const std::string& payload);
+
+  SolveServerConfig cfg_;
+  std::unique_ptr<SolveCache> cache_;
+  std::unique_ptr<ThreadPool> pool_;
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::atomic<bool> stopping_{false};
+  std::atomic<size_t> in_flight_{0};
+  std::thread acceptor_;
+  std::mutex sessions_mu_;
+  std::list<std::unique_ptr<Session>> sessions_;
+
+  std::atomic<uint64_t> connections_{0}, requests_{0}, solved_{0}, invalid_{0}, overloaded_{0}, expired_{0};
+};
+
+struct ServerResponse {
+  uint32_t id = 0;
+  ServerStatus status = ServerStatus::kOk;
+  std::string body;
+};
+
+// Blocking client for the framed protocol. Requests may be pipelined with
+// send() and collected with recv().
+class SolveClient {
+ public:
+  SolveClient() = default;
+  ~SolveClient() { close(); }
+
+  SolveClient(const SolveClient&) = delete;
+  SolveClient& operator=(const SolveClient&) = delete;
+
+  bool connect_unix(const std::string& path);
+  bool connect_tcp(int port);  // 127.0.0.1
+  void close();
+  bool connected() const { return fd_ >= 0; }
+
+  bool send(uint32_t id, std::string_view payload, uint32_t deadline_ms = 0);
+  bool recv(ServerResponse& out);
+  // send + recv of one request with a fresh id.
+  bool call(std::string_view payload, ServerResponse& out, uint32_t deadline_ms = 0);
+
+ private:
+  int fd_ = -1;
+  uint32_t next_id_ = 1;
+};
+
+}  // namespace quasar
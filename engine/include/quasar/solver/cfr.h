@@ -16,5 +16,16 @@ struct CFRResult {
 // action_utils: utility per action for the acting player (higher is better).
 CFRResult cfr_onestep(const std::vector<double>& action_utils, const CFRConfig& cfg = {});
 
+// Reusable buffers for the allocation-free variant below.
+struct CFRWorkspace {
+  std::vector<double> regrets;
+  std::vector<double> strategy;
+  std::vector<double> strategy_sum;  // normalized average strategy on return
+};
+
+// Same as above, but leaves the average strategy in ws.strategy_sum and the
+// final regrets in ws.regrets. No heap traffic once ws has grown to size.
+void cfr_onestep(const std::vector<double>& action_utils, const CFRConfig& cfg, CFRWorkspace& ws);
+
 }  // namespace quasar
 
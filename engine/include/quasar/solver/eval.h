@@ -15,5 +15,12 @@ std::vector<double> evaluate_simple_river(const PublicState& s,
                                           const std::vector<Action>& actions,
                                           const SolveOneConfig::SimpleEvalConfig& cfg);
 
+// Same, writing into `utils` (cleared first).
+void evaluate_simple_river(const PublicState& s,
+                           const LegalActionSummary& la,
+                           const std::vector<Action>& actions,
+                           const SolveOneConfig::SimpleEvalConfig& cfg,
+                           std::vector<double>& utils);
+
 }  // namespace quasar
 
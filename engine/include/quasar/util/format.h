@@ -0,0 +1,131 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace quasar {
+
+// Allocation-free number formatting for JSON output (appends to a reusable
+// buffer). Doubles use the shortest representation that round-trips, which
+// is locale-independent and matches iostream output for short values such as
+// 0.25 or 7.5. -0.0 prints as 0.
+
+constexpr size_t kMaxNumberChars = 32;
+
+// Writes `v` at `p` (room for kMaxNumberChars) and returns the end.
+inline char* write_int(char* p, long long v) {
+  return std::to_chars(p, p + kMaxNumberChars, v).ptr;
+}
+
+inline char* write_double(char* p, double v) {
+  // Fast path: values with at most 4 decimals (chip amounts, 0.25-style
+  // probabilities) print as fixed point with the fewest digits for which
+  // m / 10^k == v, i.e. the shortest fixed form that round-trips. Whole
+  // numbers print as integers (1000000, not 1e+06).
+  const double a = v < 0.0 ? -v : v;
+  if (a < 1.0e11) {
+    static constexpr double kPow10[] = {1.0, 10.0, 100.0, 1000.0, 10000.0};
+    for (int k = 0; k <= 4; ++k) {
+      const long long m = static_cast<long long>(a * kPow10[k] + 0.5);
+      if (static_cast<double>(m) / kPow10[k] != a) continue;
+      char tmp[24];
+      char* const e = tmp + sizeof(tmp);
+      char* t = e;
+      long long q = m;
+      for (int d = 0; d < k; ++d) {
+        *--t = static_cast<char>('0' + q % 10);
+        q /= 10;
+      }
+      if (k > 0) *--t = '.';
+      do {
+        *--t = static_cast<char>('0' + q % 10);
+        q /= 10;
+      } while (q > 0);
+      if (v < 0.0 && m != 0) *--t = '-';
+      const size_t n = static_cast<size_t>(e - t);
+      std::memcpy(p, t, n);
+      return p + n;
+    }
+  }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  return std::to_chars(p, p + kMaxNumberChars, v).ptr;
+#else
+  // Shortest %g precision that round-trips.
+  int n = 0;
+  for (int prec = 15; prec <= 17; ++prec) {
+    n = std::snprintf(p, kMaxNumberChars, "%.*g", prec, v);
+    if (std::strtod(p, nullptr) == v) break;
+  }
+  return p + n;
+#endif
+}
+
+inline void append_int(std::string& out, long long v) {
+  char buf[kMaxNumberChars];
+  out.append(buf, static_cast<size_t>(write_int(buf, v) - buf));
+}
+
+inline void append_double(std::string& out, double v) {
+  char buf[kMaxNumberChars];
+  out.append(buf, static_cast<size_t>(write_double(buf, v) - buf));
+}
+
+// Appends to a std::string through a raw cursor: capacity checks are inline
+// and the string only grows (geometrically) when needed, so serializing into
+// a reused buffer costs memcpy-level time. The string is trimmed to the
+// written length on destruction.
+class StringAppender {
+ public:
+  explicit StringAppender(std::string& out) : out_(out) {
+    const size_t n = out_.size();
+    out_.resize(std::max<size_t>(out_.capacity(), n + 256));
+    cur_ = &out_[0] + n;
+    end_ = &out_[0] + out_.size();
+  }
+  ~StringAppender() { out_.resize(static_cast<size_t>(cur_ - out_.data())); }
+  StringAppender(const StringAppender&) = delete;
+  StringAppender& operator=(const StringAppender&) = delete;
+
+  template <size_t N>
+  void lit(const char (&s)[N]) {
+    ensure(N - 1);
+    std::memcpy(cur_, s, N - 1);
+    cur_ += N - 1;
+  }
+  void str(const char* s) {
+    const size_t n = std::strlen(s);
+    ensure(n);
+    std::memcpy(cur_, s, n);
+    cur_ += n;
+  }
+  void ch(char c) {
+    ensure(1);
+    *cur_++ = c;
+  }
+  void num(double v) {
+    ensure(kMaxNumberChars);
+    cur_ = write_double(cur_, v);
+  }
+  void integer(long long v) {
+    ensure(kMaxNumberChars);
+    cur_ = write_int(cur_, v);
+  }
+
+ private:
+  void ensure(size_t k) {
+    if (static_cast<size_t>(end_ - cur_) >= k) return;
+    const size_t used = static_cast<size_t>(cur_ - out_.data());
+    out_.resize(std::max(out_.size() * 2, used + k));
+    cur_ = &out_[0] + used;
+    end_ = &out_[0] + out_.size();
+  }
+
+  std::string& out_;
+  char* cur_;
+  char* end_;
+};
+
+}  // namespace quasar
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace quasar {
+
+// Small non-cryptographic hashing helpers for cache keys.
+
+// splitmix64 finalizer: full-avalanche 64-bit mix.
+inline uint64_t mix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+inline uint64_t hash_combine(uint64_t seed, uint64_t v) {
+  return mix64(seed ^ (v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+inline uint64_t hash_double(uint64_t seed, double d) {
+  if (d == 0.0) d = 0.0;  // fold -0.0 into +0.0
+  uint64_t bits = 0;
+  std::memcpy(&bits, &d, sizeof(bits));
+  return hash_combine(seed, bits);
+}
+
+// 128-bit key built from two independently seeded 64-bit streams; collisions
+// are negligible for cache sizes we use, so keys are compared by value only.
+struct Hash128 {
+  uint64_t lo = 0;
+  uint64_t hi = 0;
+  bool operator==(const Hash128& o) const { return lo == o.lo && hi == o.hi; }
+  bool operator!=(const Hash128& o) const { return !(*this == o); }
+};
+
+struct Hash128Hasher {
+  size_t operator()(const Hash128& h) const { return static_cast<size_t>(h.lo); }
+};
+
+class Hasher128 {
+ public:
+  explicit Hasher128(uint64_t seed = 0) : lo_(mix64(seed ^ 0x51ed2701f3a5c7b9ULL)), hi_(mix64(seed ^ 0x2545f4914f6cdd1dULL)) {}
+  // Cheap multiply-rotate absorption per word; digest() applies full mixing.
+  void add(uint64_t v) {
+    lo_ = rotl(lo_ ^ v, 27) * 0x9e3779b97f4a7c15ULL;
+    hi_ = rotl(hi_ + v, 31) * 0xc2b2ae3d27d4eb4fULL;
+  }
+  void add_double(double d) {
+    if (d == 0.0) d = 0.0;
+    uint64_t bits = 0;
+    std::memcpy(&bits, &d, sizeof(bits));
+    add(bits);
+  }
+  Hash128 digest() const { return Hash128{mix64(lo_ ^ hi_), mix64(hi_ + 0x165667b19e3779f9ULL)}; }
+
+ private:
+  static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+  uint64_t lo_;
+  uint64_t hi_;
+};
+
+}  // namespace quasar
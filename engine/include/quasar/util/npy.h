@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace quasar {
+
+// Minimal NumPy .npy (format 1.0) writer for C-order little-endian arrays, so
+// engine artifacts load with np.load / np.load(mmap_mode="r") directly.
+// Returns false if the file cannot be written.
+bool write_npy(const std::string& path, const float* data, const std::vector<size_t>& shape);
+bool write_npy(const std::string& path, const int32_t* data, const std::vector<size_t>& shape);
+bool write_npy(const std::string& path, const uint64_t* data, const std::vector<size_t>& shape);
+
+}  // namespace quasar
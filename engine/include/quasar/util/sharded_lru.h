@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace quasar {
+
+struct CacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t insertions = 0;
+  uint64_t evictions = 0;
+  size_t size = 0;
+  double hit_rate() const {
+    const uint64_t n = hits + misses;
+    return n ? static_cast<double>(hits) / static_cast<double>(n) : 0.0;
+  }
+};
+
+// Bounded, thread-safe LRU cache split into independently locked shards.
+// Capacity is divided evenly across shards; each shard evicts its own least
+// recently used entries until the cost of what it holds fits (every entry
+// costs 1 unless put() says otherwise; the newest entry is always kept).
+// Values are copied out on hit, so large values should be held by shared_ptr.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache {
+ public:
+  explicit ShardedLruCache(size_t capacity, int num_shards = 16)
+      : shards_(static_cast<size_t>(num_shards > 0 ? num_shards : 1)) {
+    const size_t per = (capacity + shards_.size() - 1) / shards_.size();
+    for (auto& s : shards_) s.capacity = per > 0 ? per : 1;
+  }
+
+  bool get(const Key& key, Value& out) {
+    Shard& s = shard_for(key);
+    std::lock_guard<std::mutex> lock(s.mu);
+    auto it = s.index.find(key);
+    if (it == s.index.end()) {
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    s.lru.splice(s.lru.begin(), s.lru, it->second);
+    out = it->second->value;
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void put(const Key& key, Value value, size_t cost = 1) {
+    Shard& s = shard_for(key);
+    std::lock_guard<std::mutex> lock(s.mu);
+    auto it = s.index.find(key);
+    if (it != s.index.end()) {
+      s.used -= it->second->cost;
+      it->second->value = std::move(value);
+      it->second->cost = cost;
+      s.used += cost;
+      s.lru.splice(s.lru.begin(), s.lru, it->second);
+    } else {
+      s.lru.push_front(Entry{key, std::move(value), cost});
+      s.index.emplace(key, s.lru.begin());
+      s.used += cost;
+      insertions_.fetch_add(1, std::memory_order_relaxed);
+    }
+    while (s.used > s.capacity && s.lru.size() > 1) {
+      s.used -= s.lru.back().cost;
+      s.index.erase(s.lru.back().key);
+      s.lru.pop_back();
+      evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void clear() {
+    for (auto& s : shards_) {
+      std::lock_guard<std::mutex> lock(s.mu);
+      s.index.clear();
+      s.lru.clear();
+      s.used = 0;
+    }
+  }
+
+  CacheStats stats() const {
+    CacheStats st;
+    st.hits = hits_.load(std::memory_order_relaxed);
+    st.misses = misses_.load(std::memory_order_relaxed);
+    st.insertions = insertions_.load(std::memory_order_relaxed);
+    st.evictions = evictions_.load(std::memory_order_relaxed);
+    for (auto& s : shards_) {
+      std::lock_guard<std::mutex> lock(s.mu);
+      st.size += s.index.size();
+    }
+    return st;
+  }
+
+ private:
+  struct Entry {
+    Key key;
+    Value value;
+    size_t cost;
+  };
+  struct Shard {
+    mutable std::mutex mu;
+    size_t capacity = 1;
+    size_t used = 0;       // total cost of the entries held
+    std::list<Entry> lru;  // front = most recent
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+  };
+
+  Shard& shard_for(const Key& key) {
+    const uint64_t h = static_cast<uint64_t>(Hash{}(key));
+    return shards_[static_cast<size_t>((h >> 32) ^ h) % shards_.size()];
+  }
+
+  std::vector<Shard> shards_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> insertions_{0};
+  std::atomic<uint64_t> evictions_{0};
+};
+
+}  // namespace quasar
@@ -0,0 +1,46 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace quasar {
+
+// Fixed-size worker pool. Tasks run in FIFO order; parallel_for splits an
+// index range across the workers and the calling thread, so it is safe to
+// call from inside a task.
+class ThreadPool {
+ public:
+  // num_threads <= 0 uses std::thread::hardware_concurrency().
+  explicit ThreadPool(int num_threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int size() const { return static_cast<int>(workers_.size()); }
+
+  void submit(std::function<void()> task);
+
+  // Calls fn(i) for every i in [0, n), claiming `grain` indices at a time,
+  // and returns once all calls finished. The first exception thrown by fn is
+  // rethrown here after the remaining indices have been processed.
+  void parallel_for(size_t n, const std::function<void(size_t)>& fn, size_t grain = 1);
+
+ private:
+  void worker_loop();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+};
+
+// Lazily constructed process-wide pool sized to the hardware.
+ThreadPool& default_thread_pool();
+
+}  // namespace quasar
@@ -1,16 +1,44 @@
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "quasar/bucketing/bucket_store.h"
+#include "quasar/bucketing/kmeans.h"
 #include "quasar/engine/version.h"
 #include "quasar/engine/public_state.h"
 #include "quasar/engine/plo_legal.h"
 #include "quasar/engine/json.h"
 #include "quasar/engine/discretize.h"
+#include "quasar/engine/solve_batch.h"
 #include "quasar/engine/solve_one.h"
+#include "quasar/engine/wire.h"
+#include "quasar/eval/features.h"
+#include "quasar/eval/hand_index.h"
+#include "quasar/eval/preflop_equity.h"
+#include "quasar/eval/river.h"
+#include "quasar/nn/query_pack.h"
+#include "quasar/util/thread_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
 
 namespace py = pybind11;
 using namespace quasar;
 
+template <typename T>
+using CArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+// Checks a C-contiguous input array's shape: [d0] when d1 < 0, else [d0, d1].
+template <typename T>
+static const T* checked(const CArray<T>& a, const char* name, py::ssize_t d0, py::ssize_t d1 = -1) {
+  const bool ok = d1 < 0 ? (a.ndim() == 1 && a.shape(0) == d0)
+                         : (a.ndim() == 2 && a.shape(0) == d0 && a.shape(1) == d1);
+  if (!ok) throw py::value_error(std::string("unexpected shape for ") + name);
+  return a.data();
+}
+
 PYBIND11_MODULE(quasar_engine_py, m) {
   m.doc() = "QuasarPLO C++ engine bindings (minimal)";
 
@@ -36,66 +64,390 @@ PYBIND11_MODULE(quasar_engine_py, m) {
       .def("amount_to_call", &PublicState::amount_to_call);
 
   m.def("solve_one_move_json", [](const std::string& json) {
-    PublicState s;
-    parse_public_state_from_json(json, s);
-    BettingRules rules;
-    parse_rules_from_json(json, rules);
-    DiscretizationConfig cfg = parse_discretization_from_json(json);
-    SolveOneConfig so_cfg;
-    so_cfg.rules = rules;
-    so_cfg.discretization = cfg;
-    // parse optional solver.iters
-    int cfr_iters = 0;
-    auto spos = json.find("\"solver\"");
-    if (spos != std::string::npos) {
-      auto tpos = json.find("\"iters\"", spos);
-      if (tpos != std::string::npos) {
-        auto colon = json.find(':', tpos);
-        if (colon != std::string::npos) cfr_iters = static_cast<int>(std::strtod(json.c_str() + colon + 1, nullptr));
-      }
-      auto find_num = [&](const char* key, double defv) {
-        auto kpos = json.find(std::string("\"") + key + "\"", spos);
-        if (kpos == std::string::npos) return defv;
-        kpos = json.find(':', kpos);
-        if (kpos == std::string::npos) return defv;
-        return std::strtod(json.c_str() + kpos + 1, nullptr);
-      };
-      so_cfg.eval.win_prob = find_num("win_prob", so_cfg.eval.win_prob);
-      so_cfg.eval.call_k = find_num("call_k", so_cfg.eval.call_k);
-    }
-    so_cfg.cfr_iters = cfr_iters;
-    auto res = solve_one(s, so_cfg);
+    SpotRequest req;
+    parse_spot_json(json, req);
+    auto res = solve_one(req.state, req.config);
     return assemble_response_json(res.legal, res.actions, res.probabilities);
   }, "Parse a spot JSON and return a JSON summary of legal actions and a strategy (uniform by default, CFR if requested)");
 
+  // Batch JSON API: solves all spots on the engine thread pool with the GIL
+  // released; responses are returned in input order.
+  m.def("solve_many_json", [](const std::vector<std::string>& jsons, int threads) {
+    std::vector<std::string> out(jsons.size());
+    {
+      py::gil_scoped_release release;
+      std::vector<PublicState> states(jsons.size());
+      std::vector<SolveOneConfig> cfgs(jsons.size());
+      SpotRequest req;
+      for (size_t i = 0; i < jsons.size(); ++i) {
+        parse_spot_json(jsons[i], req);
+        states[i] = req.state;
+        cfgs[i] = req.config;
+      }
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      auto results = solve_many(states, cfgs, pool.get());
+      for (size_t i = 0; i < results.size(); ++i) {
+        out[i] = assemble_response_json(results[i].legal, results[i].actions, results[i].probabilities);
+      }
+    }
+    return out;
+  }, py::arg("jsons"), py::arg("threads") = 0,
+     "Solve a list of spot JSON strings in parallel (GIL released); threads=0 uses the shared pool");
+
+  // Binary wire format (quasar/engine/wire.h): one bytes object per batch.
+  m.def("encode_spot_batch", [](const std::vector<std::string>& jsons) {
+    std::vector<SpotRequest> reqs(jsons.size());
+    std::vector<bool> ok(jsons.size());
+    for (size_t i = 0; i < jsons.size(); ++i) ok[i] = parse_spot_json(jsons[i], reqs[i]);
+    std::string out;
+    write_spot_batch(reqs.data(), reqs.size(), out, &ok);
+    return py::bytes(out);
+  }, py::arg("jsons"), "Encode spot JSON strings into one binary spot batch (malformed ones as invalid records)");
+
+  m.def("solve_wire_batch", [](py::bytes spots, int threads) {
+    char* data = nullptr;
+    Py_ssize_t size = 0;
+    if (PyBytes_AsStringAndSize(spots.ptr(), &data, &size) != 0) throw py::error_already_set();
+    std::string out;
+    bool ok = false;
+    {
+      py::gil_scoped_release release;
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      ok = solve_wire_batch(std::string_view(data, static_cast<size_t>(size)), out, pool.get());
+    }
+    if (!ok) throw py::value_error("not a binary spot batch");
+    return py::bytes(out);
+  }, py::arg("spots"), py::arg("threads") = 0,
+     "Solve a binary spot batch (GIL released) and return the binary result batch");
+
+  // NumPy batch API: N spots as arrays (seat dimension padded to P), solved in
+  // parallel with the GIL released straight into padded output arrays.
+  // Inputs that are already C-contiguous with the right dtype are not copied.
+  m.def("solve_batch", [](CArray<double> stacks, CArray<double> committed_total,
+                          CArray<double> committed_on_street, CArray<int32_t> to_act,
+                          std::optional<CArray<int32_t>> board, std::optional<CArray<int32_t>> button,
+                          std::optional<CArray<int32_t>> street, std::optional<CArray<int32_t>> num_players,
+                          std::optional<CArray<double>> last_raise_size, double sb, double bb, double ante,
+                          const std::string& config_json, int threads) {
+    if (stacks.ndim() != 2) throw py::value_error("stacks must be [N, P]");
+    const py::ssize_t n = stacks.shape(0), P = stacks.shape(1);
+    SpotBatchView v;
+    v.n = static_cast<size_t>(n);
+    v.players = static_cast<int>(P);
+    v.stacks = stacks.data();
+    v.committed_total = checked(committed_total, "committed_total", n, P);
+    v.committed_on_street = checked(committed_on_street, "committed_on_street", n, P);
+    v.to_act = checked(to_act, "to_act", n);
+    if (board) v.board = checked(*board, "board", n, 5);
+    if (button) v.button = checked(*button, "button", n);
+    if (street) v.street = checked(*street, "street", n);
+    if (num_players) v.num_players = checked(*num_players, "num_players", n);
+    if (last_raise_size) v.last_raise_size = checked(*last_raise_size, "last_raise_size", n);
+    v.sb = sb;
+    v.bb = bb;
+    v.ante = ante;
+    SolveOneConfig cfg;
+    if (!config_json.empty()) parse_solve_config_from_json(config_json, cfg);
+
+    const py::ssize_t A = max_solve_actions(cfg);
+    py::array_t<int32_t> types({n, A}), nact(n);
+    py::array_t<double> amounts({n, A}), probs({n, A}), call(n), min_to(n), max_to(n);
+    py::array_t<bool> can_check(n), can_fold(n);
+    ActionBatchOut out;
+    out.max_actions = static_cast<int>(A);
+    out.types = types.mutable_data();
+    out.amounts = amounts.mutable_data();
+    out.probabilities = probs.mutable_data();
+    out.num_actions = nact.mutable_data();
+    out.call_amount = call.mutable_data();
+    out.can_check = reinterpret_cast<uint8_t*>(can_check.mutable_data());
+    out.can_fold = reinterpret_cast<uint8_t*>(can_fold.mutable_data());
+    out.min_to = min_to.mutable_data();
+    out.max_to = max_to.mutable_data();
+    {
+      py::gil_scoped_release release;
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      solve_batch(v, cfg, out, pool.get());
+    }
+    py::dict res;
+    res["types"] = types;
+    res["amounts"] = amounts;
+    res["probs"] = probs;
+    res["num_actions"] = nact;
+    res["call_amount"] = call;
+    res["can_check"] = can_check;
+    res["can_fold"] = can_fold;
+    res["min_to"] = min_to;
+    res["max_to"] = max_to;
+    return res;
+  }, py::arg("stacks"), py::arg("committed_total"), py::arg("committed_on_street"), py::arg("to_act"),
+     py::arg("board") = py::none(), py::arg("button") = py::none(), py::arg("street") = py::none(),
+     py::arg("num_players") = py::none(), py::arg("last_raise_size") = py::none(),
+     py::arg("sb") = 1.0, py::arg("bb") = 2.0, py::arg("ante") = 0.0,
+     py::arg("config_json") = "", py::arg("threads") = 0,
+     "Solve N spots given as NumPy arrays (GIL released); returns a dict of padded NumPy arrays");
+
+  // River evaluation over [N, 4] hand arrays, multithreaded with the GIL
+  // released. Keys order hands by strength (0 for impossible hands).
+  m.def("river_keys", [](CArray<int32_t> board, CArray<int32_t> hands, int threads) {
+    if (hands.ndim() != 2 || hands.shape(1) != 4) throw py::value_error("hands must be [N, 4]");
+    const py::ssize_t n = hands.shape(0);
+    const int32_t* b = checked(board, "board", 5);
+    std::array<int, 5> full{};
+    for (int k = 0; k < 5; ++k) {
+      if (b[k] < 0 || b[k] >= 52) throw py::value_error("river_keys needs a full 5-card board");
+      full[k] = b[k];
+    }
+    py::array_t<uint64_t> keys(n);
+    uint64_t* out = keys.mutable_data();
+    const int32_t* h = hands.data();
+    {
+      py::gil_scoped_release release;
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      plo_river_keys(full, h, static_cast<size_t>(n), out, pool.get());
+    }
+    return keys;
+  }, py::arg("board"), py::arg("hands"), py::arg("threads") = 0,
+     "Best PLO river key per hand ([N] uint64; 0 where the hand collides with the board or is invalid)");
+
+  m.def("board_collision_mask", [](CArray<int32_t> board, CArray<int32_t> hands, int threads) {
+    if (hands.ndim() != 2 || hands.shape(1) != 4) throw py::value_error("hands must be [N, 4]");
+    if (board.ndim() != 1) throw py::value_error("board must be 1-D");
+    const py::ssize_t n = hands.shape(0);
+    py::array_t<bool> mask(n);
+    uint8_t* out = reinterpret_cast<uint8_t*>(mask.mutable_data());
+    const int32_t* b = board.data();
+    const int board_len = static_cast<int>(board.shape(0));
+    const int32_t* h = hands.data();
+    {
+      py::gil_scoped_release release;
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      board_collision_mask(b, board_len, h, static_cast<size_t>(n), out, pool.get());
+    }
+    return mask;
+  }, py::arg("board"), py::arg("hands"), py::arg("threads") = 0,
+     "[N] bool: hand shares a card with the board (-1 entries are padding) or is invalid");
+
+  // Dense value-net query packing (quasar/nn/query_pack.h).
+  m.def("hand_card_masks", [](CArray<int32_t> hands) {
+    if (hands.ndim() != 2 || hands.shape(1) != 4) throw py::value_error("hands must be [N, 4]");
+    py::array_t<uint64_t> masks(hands.shape(0));
+    hand_card_masks(hands.data(), static_cast<size_t>(hands.shape(0)), masks.mutable_data());
+    return masks;
+  }, py::arg("hands"), "[N] uint64 card masks for [N, 4] hands (bit 63 marks an invalid hand)");
+
+  m.def("pack_dense", [](CArray<int32_t> player_act, std::optional<CArray<int32_t>> positions, CArray<double> s2pr,
+                         std::optional<CArray<int32_t>> board, CArray<float> ranges,
+                         std::optional<CArray<uint64_t>> bucket_masks, std::optional<py::array_t<float>> out,
+                         int threads) {
+    if (ranges.ndim() != 3) throw py::value_error("ranges must be [B, P, K]");
+    const py::ssize_t B = ranges.shape(0), P = ranges.shape(1), K = ranges.shape(2);
+    DenseQueryBatch q;
+    q.batch = static_cast<int>(B);
+    q.players = static_cast<int>(P);
+    q.K = static_cast<int>(K);
+    q.player_act = checked(player_act, "player_act", B);
+    if (positions) q.positions = checked(*positions, "positions", B, P);
+    q.s2pr = checked(s2pr, "s2pr", B);
+    if (board) q.board = checked(*board, "board", B, 5);
+    q.ranges = ranges.data();
+    if (bucket_masks) {
+      q.masks_per_player = bucket_masks->ndim() == 2;
+      q.bucket_masks = q.masks_per_player ? checked(*bucket_masks, "bucket_masks", P, K)
+                                          : checked(*bucket_masks, "bucket_masks", K);
+    }
+    const py::ssize_t S = dense_slice_size(q.K);
+    py::array_t<float> dst = out ? *out : py::array_t<float>({B, P, S});
+    if (dst.ndim() != 3 || dst.shape(0) != B || dst.shape(1) != P || dst.shape(2) != S ||
+        !(dst.flags() & py::array::c_style)) {
+      throw py::value_error("out must be a C-contiguous float32 [B, P, 8 + K] array");
+    }
+    float* o = dst.mutable_data();
+    {
+      py::gil_scoped_release release;
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      pack_dense_queries(q, o, pool.get());
+    }
+    return dst;
+  }, py::arg("player_act"), py::arg("positions"), py::arg("s2pr"), py::arg("board"), py::arg("ranges"),
+     py::arg("bucket_masks") = py::none(), py::arg("out").noconvert() = py::none(), py::arg("threads") = 0,
+     "Pack [B, P, 8 + K] dense query slices (GIL released); writes into `out` when given");
+
+  m.def("hand_features", [](CArray<int32_t> board, CArray<int32_t> hands, int threads) {
+    if (hands.ndim() != 2 || hands.shape(1) != 4) throw py::value_error("hands must be [N, 4]");
+    if (board.ndim() != 1) throw py::value_error("board must be 1-D");
+    const py::ssize_t n = hands.shape(0);
+    py::array_t<float> out({n, static_cast<py::ssize_t>(kHandFeatureDim)});
+    float* dst = out.mutable_data();
+    const int32_t* b = board.data();
+    const int board_len = static_cast<int>(board.shape(0));
+    const int32_t* h = hands.data();
+    bool ok = false;
+    {
+      py::gil_scoped_release release;
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      ok = plo_hand_features(b, board_len, h, static_cast<size_t>(n), dst, pool.get());
+    }
+    if (!ok) throw py::value_error("board must be 3..5 distinct cards in 0..51");
+    return out;
+  }, py::arg("board"), py::arg("hands"), py::arg("threads") = 0,
+     "[N, 6] float32 (EHS, E[HS^2], category/8, nut share, flush draw, straight outs/13); GIL released");
+
+  // Native k-means over an [N, D] float32 feature matrix (GIL released).
+  // Writes labels.npy / centers.npy into out_dir when it is non-empty.
+  m.def("kmeans", [](CArray<float> x, int k, int iters, uint64_t seed, size_t batch_size, bool plus_plus,
+                     int threads, const std::string& out_dir) {
+    if (x.ndim() != 2) throw py::value_error("x must be [N, D]");
+    const py::ssize_t n = x.shape(0), d = x.shape(1);
+    KMeansConfig cfg;
+    cfg.k = k;
+    cfg.iters = iters;
+    cfg.seed = seed;
+    cfg.batch_size = batch_size;
+    cfg.plus_plus = plus_plus;
+    KMeansResult res;
+    bool ok = false;
+    const float* data = x.data();
+    {
+      py::gil_scoped_release release;
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      ok = kmeans_fit(data, static_cast<size_t>(n), static_cast<int>(d), cfg, res, pool.get());
+      if (ok && !out_dir.empty() && !save_kmeans(res, out_dir)) {
+        ok = false;
+      }
+    }
+    if (!ok) throw py::value_error(out_dir.empty() ? "kmeans needs N > 0, D > 0 and k > 0"
+                                                   : "kmeans failed or could not write " + out_dir);
+    py::array_t<int32_t> labels(n);
+    std::copy(res.labels.begin(), res.labels.end(), labels.mutable_data());
+    py::array_t<float> centers({static_cast<py::ssize_t>(res.k), d});
+    std::copy(res.centers.begin(), res.centers.end(), centers.mutable_data());
+    return py::make_tuple(labels, centers, res.inertia);
+  }, py::arg("x"), py::arg("k"), py::arg("iters") = 50, py::arg("seed") = 42, py::arg("batch_size") = 0,
+     py::arg("plus_plus") = true, py::arg("threads") = 0, py::arg("out_dir") = "",
+     "k-means++ / mini-batch k-means on [N, D] float32 (GIL released); returns (labels, centers, inertia)");
+
+  m.def("kmeans_assign", [](CArray<float> x, CArray<float> centers, int threads) {
+    if (x.ndim() != 2 || centers.ndim() != 2 || centers.shape(1) != x.shape(1)) {
+      throw py::value_error("x must be [N, D] and centers [K, D]");
+    }
+    const py::ssize_t n = x.shape(0);
+    py::array_t<int32_t> labels(n);
+    int32_t* out = labels.mutable_data();
+    const float* xd = x.data();
+    const float* cd = centers.data();
+    const int d = static_cast<int>(x.shape(1)), k = static_cast<int>(centers.shape(0));
+    {
+      py::gil_scoped_release release;
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      kmeans_assign(xd, static_cast<size_t>(n), d, cd, k, out, nullptr, pool.get());
+    }
+    return labels;
+  }, py::arg("x"), py::arg("centers"), py::arg("threads") = 0,
+     "Nearest-center labels for [N, D] float32 points (GIL released)");
+
+  // Memory-mapped hand -> bucket store (quasar/bucketing/bucket_store.h).
+  py::class_<BucketStore>(m, "BucketStore")
+      .def(py::init([](const std::string& path) {
+        auto s = BucketStore::open(path);
+        if (!s) throw py::value_error("not a readable bucket store: " + path);
+        return s;
+      }), py::arg("path"))
+      .def_property_readonly("bucket_version", &BucketStore::bucket_version)
+      .def_property_readonly("id_bytes", &BucketStore::id_bytes)
+      .def_property_readonly("num_boards", &BucketStore::num_boards)
+      .def("bucket_of", [](const BucketStore& s, const std::vector<int32_t>& board, const std::vector<int32_t>& hand) {
+        if (hand.size() != 4) throw py::value_error("hand must have 4 cards");
+        return s.bucket_of(board.data(), static_cast<int>(board.size()), hand.data());
+      }, py::arg("board"), py::arg("hand"), "Bucket id, or NO_BUCKET")
+      .def("buckets_of", [](const BucketStore& s, const std::vector<int32_t>& board, CArray<int32_t> hands) {
+        if (hands.ndim() != 2 || hands.shape(1) != 4) throw py::value_error("hands must be [N, 4]");
+        py::array_t<uint32_t> out(hands.shape(0));
+        s.buckets_of(board.data(), static_cast<int>(board.size()), hands.data(),
+                     static_cast<size_t>(hands.shape(0)), out.mutable_data());
+        return out;
+      }, py::arg("board"), py::arg("hands"), "[N] uint32 bucket ids (NO_BUCKET where missing)");
+  m.attr("NO_BUCKET") = kNoBucket;
+
+  m.def("write_bucket_store", [](const std::string& path, uint32_t bucket_version,
+                                 const std::vector<std::vector<int32_t>>& boards, CArray<uint32_t> labels,
+                                 int id_bytes) {
+    if (labels.ndim() != 2 || labels.shape(0) != static_cast<py::ssize_t>(boards.size()) ||
+        labels.shape(1) != static_cast<py::ssize_t>(kNumPloHands)) {
+      throw py::value_error("labels must be [len(boards), 270725]");
+    }
+    BucketStoreWriter w;
+    bool ok = w.open(path, bucket_version, id_bytes);
+    for (size_t b = 0; ok && b < boards.size(); ++b) {
+      ok = w.add_board(boards[b].data(), static_cast<int>(boards[b].size()),
+                       labels.data() + b * static_cast<size_t>(kNumPloHands));
+    }
+    ok = w.finish() && ok;
+    if (!ok) throw py::value_error("could not write bucket store (invalid or duplicate board, id too large, or I/O error)");
+  }, py::arg("path"), py::arg("bucket_version"), py::arg("boards"), py::arg("labels"), py::arg("id_bytes") = 2,
+     "Write per-board labels (indexed by colex hand index) to a bucket store");
+
+  // Preflop class-vs-class equity table (quasar/eval/preflop_equity.h).
+  py::class_<PreflopEquityTable>(m, "PreflopEquityTable")
+      .def(py::init([](const std::string& path) {
+        auto t = PreflopEquityTable::open(path);
+        if (!t) throw py::value_error("not a readable preflop equity table: " + path);
+        return t;
+      }), py::arg("path"))
+      .def_property_readonly("num_classes", &PreflopEquityTable::num_classes)
+      .def_property_readonly("boards", &PreflopEquityTable::boards)
+      .def_property_readonly("seed", &PreflopEquityTable::seed)
+      .def("class_of", [](const PreflopEquityTable& t, const std::vector<int32_t>& hand) {
+        if (hand.size() != 4) throw py::value_error("hand must have 4 cards");
+        return t.class_of(hand.data());
+      }, py::arg("hand"), "Row of the hand's class, or -1")
+      .def("equity", [](const PreflopEquityTable& t, const std::vector<int32_t>& hand,
+                        const std::vector<int32_t>& villain) {
+        if (hand.size() != 4 || villain.size() != 4) throw py::value_error("hands must have 4 cards");
+        return t.equity(hand.data(), villain.data());
+      }, py::arg("hand"), py::arg("villain"), "All-in equity of hand vs villain (NaN if they share a card)")
+      .def("range_vs_range", [](const PreflopEquityTable& t, CArray<float> hero, CArray<float> villain, int threads) {
+        const float* h = checked(hero, "hero", kNumPloHands);
+        const float* v = checked(villain, "villain", kNumPloHands);
+        py::gil_scoped_release release;
+        std::unique_ptr<ThreadPool> pool;
+        if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+        return t.range_vs_range(h, v, pool.get());
+      }, py::arg("hero"), py::arg("villain"), py::arg("threads") = 0,
+         "Hero equity for per-hand weights [270725] (colex hand index); NaN if the ranges never meet");
+
+  m.def("build_preflop_equity", [](const std::string& path, uint32_t boards, uint64_t seed,
+                                   std::vector<uint64_t> classes, int threads) {
+    PreflopEquityConfig cfg;
+    cfg.boards = boards;
+    cfg.seed = seed;
+    cfg.classes = std::move(classes);
+    std::string error;
+    bool ok;
+    {
+      py::gil_scoped_release release;
+      std::unique_ptr<ThreadPool> pool;
+      if (threads > 0) pool = std::make_unique<ThreadPool>(threads);
+      ok = build_preflop_equity(cfg, path, &error, pool.get());
+    }
+    if (!ok) throw py::value_error(error);
+  }, py::arg("path"), py::arg("boards") = 4096, py::arg("seed") = 1, py::arg("classes") = std::vector<uint64_t>{},
+     py::arg("threads") = 0, "Build a preflop equity table (classes: member card masks; empty for all)");
+
   // Structured solve_one API: returns (actions, probs, legal_dict)
   m.def("solve_one_move", [](const std::string& json) {
-    PublicState s;
-    parse_public_state_from_json(json, s);
-    BettingRules rules;
-    parse_rules_from_json(json, rules);
-    DiscretizationConfig cfg = parse_discretization_from_json(json);
-    SolveOneConfig so_cfg;
-    so_cfg.rules = rules;
-    so_cfg.discretization = cfg;
-    auto spos = json.find("\"solver\"");
-    if (spos != std::string::npos) {
-      auto tpos = json.find("\"iters\"", spos);
-      if (tpos != std::string::npos) {
-        auto colon = json.find(':', tpos);
-        if (colon != std::string::npos) so_cfg.cfr_iters = static_cast<int>(std::strtod(json.c_str() + colon + 1, nullptr));
-      }
-      auto find_num = [&](const char* key, double defv) {
-        auto kpos = json.find(std::string("\"") + key + "\"", spos);
-        if (kpos == std::string::npos) return defv;
-        kpos = json.find(':', kpos);
-        if (kpos == std::string::npos) return defv;
-        return std::strtod(json.c_str() + kpos + 1, nullptr);
-      };
-      so_cfg.eval.win_prob = find_num("win_prob", so_cfg.eval.win_prob);
-      so_cfg.eval.call_k = find_num("call_k", so_cfg.eval.call_k);
-    }
-    auto res = solve_one(s, so_cfg);
+    SpotRequest req;
+    parse_spot_json(json, req);
+    auto res = solve_one(req.state, req.config);
     py::list py_actions;
     for (auto& a : res.actions) {
       py::dict d;
@@ -0,0 +1,161 @@
+#include "quasar/engine/action_abstraction.h"
+
+#include <algorithm>
+
+namespace quasar {
+
+namespace {
+
+// Largest SPR at which pruning can still apply: bets never exceed the pot
+// (threshold min(1, SPR)) and raises never exceed pot-after-call (threshold
+// (SPR - r) / (1 + r) with r = to-call/pot < 1 in the finest facing bucket).
+constexpr int kMaxPrunedSpr = 3;
+
+std::vector<double> sorted_unique(std::vector<double> v) {
+  std::sort(v.begin(), v.end());
+  v.erase(std::unique(v.begin(), v.end()), v.end());
+  return v;
+}
+
+// Sorted fractions below `thr` plus the first one at or above it (all larger
+// ones clamp to the same top target).
+void append_pruned(const std::vector<double>& sorted, double thr, std::vector<double>& pool) {
+  for (double f : sorted) {
+    pool.push_back(f);
+    if (f >= thr) break;
+  }
+}
+
+}  // namespace
+
+ActionAbstractionConfig ActionAbstractionConfig::from_discretization(const DiscretizationConfig& d) {
+  ActionAbstractionConfig c;
+  for (auto& st : c.streets) {
+    st.bet_fracs = d.pot_fracs;
+    st.raise_fracs = d.pot_fracs;
+    if (d.include_pot_raise) st.raise_fracs.push_back(1.0);
+    st.raise_cap = -1;
+    st.include_min = d.include_min;
+    st.include_all_in = d.include_all_in;
+  }
+  return c;
+}
+
+ActionAbstractionConfig ActionAbstractionConfig::plo_default() {
+  ActionAbstractionConfig c;
+  auto spec = [](std::vector<double> fracs, int cap) {
+    StreetActionSpec s;
+    s.bet_fracs = fracs;
+    s.raise_fracs = fracs;
+    s.raise_cap = cap;
+    s.include_min = false;
+    s.include_all_in = true;
+    return s;
+  };
+  c.streets[0] = spec({1.0}, 4);
+  c.streets[1] = spec({0.5, 1.0, 2.0}, 4);
+  c.streets[2] = spec({1.0}, 3);
+  c.streets[3] = spec({1.0}, 3);
+  return c;
+}
+
+ActionAbstraction::ActionAbstraction(const ActionAbstractionConfig& cfg) {
+  spr_buckets_ = kMaxPrunedSpr * kSprSteps + 1;
+  facing_buckets_ = kFacingSteps + 1;
+  uint32_t total = 0;
+  for (int st = 0; st < 4; ++st) {
+    const int cap = cfg.streets[st].raise_cap;
+    raise_buckets_[st] = cap >= 0 ? cap + 1 : 1;
+    street_off_[st] = total;
+    total += static_cast<uint32_t>(spr_buckets_ * facing_buckets_ * raise_buckets_[st]);
+  }
+  cells_.resize(total);
+
+  for (int st = 0; st < 4; ++st) {
+    const StreetActionSpec& spec = cfg.streets[st];
+    const std::vector<double> bets = sorted_unique(spec.bet_fracs);
+    const std::vector<double> raises = sorted_unique(spec.raise_fracs);
+    for (int sb = 0; sb < spr_buckets_; ++sb) {
+      const bool deep = sb == spr_buckets_ - 1;
+      const double spr_hi = static_cast<double>(sb + 1) / kSprSteps;  // exclusive upper bound
+      for (int fb = 0; fb < facing_buckets_; ++fb) {
+        const double r_lo = static_cast<double>(fb) / kFacingSteps;
+        const double bet_thr = deep ? 1.0 : std::min(1.0, spr_hi);
+        const double raise_thr = deep ? 1.0 : std::min(1.0, (spr_hi - r_lo) / (1.0 + r_lo));
+        // Fraction lists depend only on (street, spr, facing); share them
+        // across raise-count buckets.
+        const uint32_t bet_off = static_cast<uint32_t>(fracs_.size());
+        append_pruned(bets, bet_thr, fracs_);
+        const uint32_t raise_off = static_cast<uint32_t>(fracs_.size());
+        append_pruned(raises, raise_thr, fracs_);
+        const uint32_t end = static_cast<uint32_t>(fracs_.size());
+        for (int rb = 0; rb < raise_buckets_[st]; ++rb) {
+          Cell& c = cells_[street_off_[st] + (static_cast<uint32_t>(sb * facing_buckets_ + fb)) * raise_buckets_[st] + rb];
+          c.bet_off = bet_off;
+          c.bet_len = static_cast<uint16_t>(raise_off - bet_off);
+          c.raise_off = raise_off;
+          c.raise_len = static_cast<uint16_t>(end - raise_off);
+          c.include_min = spec.include_min;
+          c.include_all_in = spec.include_all_in;
+          c.allow_raise = spec.raise_cap < 0 || rb < spec.raise_cap;
+        }
+      }
+    }
+  }
+}
+
+// A quotient that lands a rounding error below a bucket edge only places an
+// SPR exactly on that edge one bucket low; the pruning thresholds hold with
+// equality there, so this stays exact.
+int ActionAbstraction::spr_bucket_inv(Chips stack, double inv_pot) const {
+  if (inv_pot <= 0.0) return spr_buckets_ - 1;
+  const double q = static_cast<double>(stack) * inv_pot * kSprSteps;
+  return q >= spr_buckets_ - 1 ? spr_buckets_ - 1 : std::max(0, static_cast<int>(q));
+}
+
+int ActionAbstraction::facing_bucket_inv(Chips to_call, double inv_pot) const {
+  if (inv_pot <= 0.0) return to_call > 0 ? facing_buckets_ - 1 : 0;
+  const double q = static_cast<double>(to_call) * inv_pot * kFacingSteps;
+  return q >= facing_buckets_ - 1 ? facing_buckets_ - 1 : std::max(0, static_cast<int>(q));
+}
+
+const ActionAbstraction::Cell& ActionAbstraction::cell(int street, int spr_b, int facing_b, int raises) const {
+  const int st = std::min(std::max(street, 0), 3);
+  const int rb = std::min(raises, raise_buckets_[st] - 1);
+  return cells_[street_off_[st] + static_cast<uint32_t>(spr_b * facing_buckets_ + facing_b) * raise_buckets_[st] + rb];
+}
+
+void ActionAbstraction::actions(const CompactPublicState& s, const ChipLegalSummary& la,
+                                std::vector<ChipAction>& out) const {
+  out.clear();
+  const int p = s.player_to_act;
+  if (p < 0 || p >= s.num_players) return;
+  const Chips stack = s.stacks[p];
+  const Chips to_call = std::max<Chips>(0, s.current_bet - s.committed_on_street[p]);
+  const double inv_pot = s.pot > 0 ? 1.0 / static_cast<double>(s.pot) : 0.0;
+  const Cell& c = cell(s.street, spr_bucket_inv(stack, inv_pot), facing_bucket_inv(to_call, inv_pot), s.num_raises);
+  if (!c.allow_raise) return;
+
+  // Write through a raw pointer into storage sized for the worst case; no
+  // per-action capacity checks or reloads of members through `out`.
+  const bool with_min = c.include_min, with_all_in = c.include_all_in;
+  auto emit = [&](ActionType t, const ChipRaiseBounds& b, Chips base, Chips scale, uint32_t off, uint16_t len) {
+    out.resize(static_cast<size_t>(len) + 2);
+    ChipAction* o = out.data();
+    ChipAction* const start = o;
+    const double* f = fracs_.data() + off;
+    if (with_min) *o++ = {t, b.min_to};
+    for (uint16_t i = 0; i < len; ++i) {
+      const Chips to = std::clamp(base + chips_fraction(f[i], scale), b.min_to, b.max_to);
+      if (o != start && o[-1].amount == to) continue;
+      *o++ = {t, to};
+    }
+    if (with_all_in && b.max_to > b.min_to) *o++ = {ActionType::kAllIn, b.max_to};
+    out.resize(static_cast<size_t>(o - start));
+  };
+  // Bet and raise bounds are mutually exclusive.
+  if (la.bet_bounds) emit(ActionType::kBet, *la.bet_bounds, 0, s.pot, c.bet_off, c.bet_len);
+  else if (la.raise_bounds) emit(ActionType::kRaise, *la.raise_bounds, s.current_bet, s.pot + to_call, c.raise_off, c.raise_len);
+}
+
+}  // namespace quasar
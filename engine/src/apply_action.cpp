@@ -0,0 +1,145 @@
+#include "quasar/engine/apply_action.h"
+
+#include <algorithm>
+
+namespace quasar {
+
+namespace {
+
+inline bool has_bit(uint16_t m, int i) { return (m >> i) & 1u; }
+
+// Seat can still make betting decisions.
+inline bool can_act(const CompactPublicState& s, int i) {
+  return !has_bit(s.folded_mask, i) && s.stacks[i] > 0;
+}
+
+// Next seat after `from` (clockwise) that still owes a decision this round,
+// or -1 if the round is closed.
+int next_to_act(const CompactPublicState& s, int from) {
+  const int n = s.num_players;
+  int with_chips = 0;
+  for (int i = 0; i < n; ++i) with_chips += can_act(s, i) ? 1 : 0;
+  for (int k = 1; k <= n; ++k) {
+    const int i = (from + k) % n;
+    if (!can_act(s, i)) continue;
+    const bool matched = s.committed_on_street[i] == s.current_bet;
+    if (matched && (has_bit(s.acted_mask, i) || with_chips <= 1)) continue;
+    return i;
+  }
+  return -1;
+}
+
+// Closes the round: next street or terminal.
+void close_round(CompactPublicState& s, ActionUndo& undo) {
+  const int n = s.num_players;
+  int live = 0, with_chips = 0;
+  for (int i = 0; i < n; ++i) {
+    live += has_bit(s.folded_mask, i) ? 0 : 1;
+    with_chips += can_act(s, i) ? 1 : 0;
+  }
+  if (live <= 1 || s.street >= 3 || with_chips <= 1) {
+    s.terminal = true;
+    return;
+  }
+  undo.street_advanced = true;
+  undo.prev_on_street = s.committed_on_street;
+  ++s.street;
+  s.committed_on_street.fill(0);
+  s.current_bet = 0;
+  s.last_raise_size = 0;
+  s.acted_mask = 0;
+  s.num_raises = 0;
+  s.player_to_act = static_cast<int8_t>(next_to_act(s, s.button));
+}
+
+}  // namespace
+
+bool apply_action(CompactPublicState& s, const ChipAction& a, ActionUndo& undo, bool update_hash) {
+  const int p = s.player_to_act;
+  if (s.terminal || p < 0 || p >= s.num_players) return false;
+
+  undo.player = static_cast<int8_t>(p);
+  undo.player_to_act = s.player_to_act;
+  undo.street = s.street;
+  undo.num_raises = s.num_raises;
+  undo.folded_mask = s.folded_mask;
+  undo.acted_mask = s.acted_mask;
+  undo.terminal = s.terminal;
+  undo.street_advanced = false;
+  undo.stack = s.stacks[p];
+  undo.committed_total = s.committed_total[p];
+  undo.committed_on_street = s.committed_on_street[p];
+  undo.last_raise_size = s.last_raise_size;
+  undo.pot = s.pot;
+  undo.current_bet = s.current_bet;
+  undo.hash = s.hash;
+
+  auto pay = [&](Chips amount) {
+    amount = std::min(std::max<Chips>(0, amount), s.stacks[p]);
+    s.stacks[p] -= amount;
+    s.committed_total[p] += amount;
+    s.committed_on_street[p] += amount;
+    s.pot += amount;
+  };
+
+  switch (a.type) {
+    case ActionType::kFold:
+      s.folded_mask = static_cast<uint16_t>(s.folded_mask | (1u << p));
+      break;
+    case ActionType::kCheck:
+      break;
+    case ActionType::kCall:
+      pay(s.current_bet - s.committed_on_street[p]);
+      break;
+    case ActionType::kBet:
+    case ActionType::kRaise:
+    case ActionType::kAllIn: {
+      pay(std::max(a.amount, s.current_bet) - s.committed_on_street[p]);
+      const Chips raise_by = s.committed_on_street[p] - s.current_bet;
+      if (raise_by > 0) {
+        const Chips min_r = s.last_raise_size > 0 ? s.last_raise_size : s.bb;
+        if (raise_by >= min_r) s.last_raise_size = raise_by;  // full raise reopens
+        s.current_bet = s.committed_on_street[p];
+        s.acted_mask = 0;
+        if (s.num_raises < 255) ++s.num_raises;
+      }
+      break;
+    }
+  }
+  s.acted_mask = static_cast<uint16_t>(s.acted_mask | (1u << p));
+
+  int live = 0;
+  for (int i = 0; i < s.num_players; ++i) live += has_bit(s.folded_mask, i) ? 0 : 1;
+  const int next = live <= 1 ? -1 : next_to_act(s, p);
+  if (next >= 0) {
+    s.player_to_act = static_cast<int8_t>(next);
+  } else {
+    close_round(s, undo);
+  }
+  if (update_hash) s.rehash();
+  return true;
+}
+
+bool apply_action(CompactPublicState& s, const Action& a, ActionUndo& undo, bool update_hash) {
+  return apply_action(s, ChipAction{a.type, to_chips(a.amount)}, undo, update_hash);
+}
+
+void undo_action(CompactPublicState& s, const ActionUndo& undo) {
+  const int p = undo.player;
+  if (undo.street_advanced) s.committed_on_street = undo.prev_on_street;
+  s.player_to_act = undo.player_to_act;
+  s.street = undo.street;
+  s.num_raises = undo.num_raises;
+  s.folded_mask = undo.folded_mask;
+  s.acted_mask = undo.acted_mask;
+  s.terminal = undo.terminal;
+  s.stacks[p] = undo.stack;
+  s.committed_total[p] = undo.committed_total;
+  s.committed_on_street[p] = undo.committed_on_street;
+  s.last_raise_size = undo.last_raise_size;
+  s.pot = undo.pot;
+  s.current_bet = undo.current_bet;
+  s.hash = undo.hash;
+}
+
+}  // namespace quasar
@@ -2,9 +2,15 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
+#include "quasar/engine/action_abstraction.h"
 #include "quasar/engine/json.h"
+#include "quasar/engine/solve_batch.h"
+#include "quasar/engine/solve_cache.h"
 #include "quasar/engine/solve_one.h"
+#include "quasar/engine/wire.h"
+#include "quasar/util/thread_pool.h"
 
 using namespace std::chrono;
 
@@ -21,10 +27,19 @@ int main(int argc, char** argv) {
   }
   const std::string json = slurp(argv[1]);
   int iters = (argc > 2 ? std::atoi(argv[2]) : 10000);
-  quasar::PublicState s;
-  quasar::parse_public_state_from_json(json, s);
-  quasar::BettingRules rules; quasar::parse_rules_from_json(json, rules);
-  quasar::SolveOneConfig cfg; cfg.rules = rules; cfg.discretization = quasar::parse_discretization_from_json(json);
+  quasar::SpotRequest req;
+  quasar::parse_spot_json(json, req);
+  const quasar::PublicState& s = req.state;
+  const quasar::SolveOneConfig& cfg = req.config;
+  const quasar::BettingRules& rules = cfg.rules;
+
+  // Parsing (single pass into a reused request)
+  quasar::SpotRequest scratch;
+  auto tp0 = high_resolution_clock::now();
+  for (int i = 0; i < iters; ++i) quasar::parse_spot_json(json, scratch);
+  auto tp1 = high_resolution_clock::now();
+  std::cout << "parse_spot_json latency: " << static_cast<double>(duration_cast<nanoseconds>(tp1 - tp0).count()) / iters
+            << " ns" << std::endl;
 
   // Warmup
   for (int i = 0; i < 100; ++i) (void)quasar::solve_one(s, cfg);
@@ -35,6 +50,115 @@ int main(int argc, char** argv) {
   auto us = duration_cast<microseconds>(t1 - t0).count();
   double per_call_us = static_cast<double>(us) / iters;
   std::cout << "solve_one latency: " << per_call_us << " us (avg over " << iters << ")" << std::endl;
+
+  // Allocation-free path with a reused workspace
+  quasar::SolveWorkspace ws;
+  for (int i = 0; i < 100; ++i) quasar::solve_one(s, cfg, ws);
+  auto tw0 = high_resolution_clock::now();
+  for (int i = 0; i < iters; ++i) quasar::solve_one(s, cfg, ws);
+  auto tw1 = high_resolution_clock::now();
+  double ws_us = static_cast<double>(duration_cast<nanoseconds>(tw1 - tw0).count()) / iters / 1000.0;
+  std::cout << "solve_one workspace latency: " << ws_us << " us" << std::endl;
+
+  // Response serialization into a reused buffer
+  std::string out;
+  auto ts0 = high_resolution_clock::now();
+  for (int i = 0; i < iters; ++i) {
+    out.clear();
+    quasar::append_response_json(out, ws.legal, ws.actions, ws.probabilities);
+  }
+  auto ts1 = high_resolution_clock::now();
+  std::cout << "response serialize latency: " << static_cast<double>(duration_cast<nanoseconds>(ts1 - ts0).count()) / iters
+            << " ns (" << out.size() << " bytes)" << std::endl;
+
+  // Binary wire records: decode a spot + encode its result, vs the JSON pair above
+  quasar::WireSpot wspot;
+  quasar::WireResult wres;
+  quasar::encode_spot(s, cfg, wspot);
+  auto tb0 = high_resolution_clock::now();
+  for (int i = 0; i < iters; ++i) {
+    quasar::decode_spot(wspot, scratch);
+    quasar::encode_result(ws.legal, ws.actions, ws.probabilities, wres);
+  }
+  auto tb1 = high_resolution_clock::now();
+  std::cout << "wire decode+encode latency: " << static_cast<double>(duration_cast<nanoseconds>(tb1 - tb0).count()) / iters
+            << " ns (" << sizeof(wspot) + sizeof(wres) << " bytes)" << std::endl;
+
+  // Memoized path: every call after the first is a cache hit
+  quasar::SolveCache cache;
+  (void)cache.solve(s, cfg);
+  auto tc0 = high_resolution_clock::now();
+  for (int i = 0; i < iters; ++i) (void)cache.solve(s, cfg);
+  auto tc1 = high_resolution_clock::now();
+  double hit_ns = static_cast<double>(duration_cast<nanoseconds>(tc1 - tc0).count()) / iters;
+  std::cout << "solve_one cached hit: " << hit_ns << " ns (hit rate " << cache.stats().hit_rate() << ")" << std::endl;
+
+  // Per-node action generation: discretization vs compiled abstraction table
+  quasar::CompactPublicState cs;
+  if (quasar::CompactPublicState::from_public_state(s, cs)) {
+    const quasar::ChipLegalSummary la = quasar::compute_legal_actions_chips(cs, rules);
+    const quasar::ActionAbstraction table(quasar::ActionAbstractionConfig::from_discretization(cfg.discretization));
+    std::vector<quasar::ChipAction> acts;
+    size_t sink = 0;
+    auto td0 = high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) { quasar::discretize_actions_chips(cs, la, cfg.discretization, acts); sink += acts.size(); }
+    auto td1 = high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) { table.actions(cs, la, acts); sink += acts.size(); }
+    auto td2 = high_resolution_clock::now();
+    std::cout << "actions per node: discretize " << static_cast<double>(duration_cast<nanoseconds>(td1 - td0).count()) / iters
+              << " ns, table " << static_cast<double>(duration_cast<nanoseconds>(td2 - td1).count()) / iters
+              << " ns (" << sink / (2 * static_cast<size_t>(iters)) << " actions)" << std::endl;
+  }
+
+  // Batch throughput on the shared pool
+  std::vector<quasar::PublicState> batch(iters, s);
+  (void)quasar::solve_many(batch, cfg);
+  auto t2 = high_resolution_clock::now();
+  auto results = quasar::solve_many(batch, cfg);
+  auto t3 = high_resolution_clock::now();
+  double batch_us = static_cast<double>(duration_cast<microseconds>(t3 - t2).count());
+  std::cout << "solve_many throughput: " << (batch_us > 0 ? iters / batch_us * 1e6 : 0.0) << " spots/s ("
+            << quasar::default_thread_pool().size() << " threads, " << results.size() << " spots)" << std::endl;
+
+  // Same batch through the array API (padded outputs, per-worker workspaces)
+  const int P = s.num_players;
+  std::vector<double> bstacks(static_cast<size_t>(iters) * P), btotal(bstacks.size()), bstreet(bstacks.size());
+  std::vector<int32_t> to_act(iters, s.player_to_act), board(static_cast<size_t>(iters) * 5, -1);
+  for (int i = 0; i < iters; ++i) {
+    const size_t row = static_cast<size_t>(i) * P;
+    for (int p = 0; p < P; ++p) {
+      bstacks[row + p] = s.stacks[p];
+      btotal[row + p] = s.committed_total[p];
+      bstreet[row + p] = s.committed_on_street[p];
+    }
+    for (size_t k = 0; k < s.board.size() && k < 5; ++k) board[static_cast<size_t>(i) * 5 + k] = s.board[k];
+  }
+  quasar::SpotBatchView view;
+  view.n = static_cast<size_t>(iters);
+  view.players = P;
+  view.stacks = bstacks.data();
+  view.committed_total = btotal.data();
+  view.committed_on_street = bstreet.data();
+  view.to_act = to_act.data();
+  view.board = board.data();
+  view.sb = s.sb;
+  view.bb = s.bb;
+  view.ante = s.ante;
+  const int A = quasar::max_solve_actions(cfg);
+  std::vector<int32_t> types(static_cast<size_t>(iters) * A), nact(iters);
+  std::vector<double> amounts(types.size()), probs(types.size());
+  quasar::ActionBatchOut bout;
+  bout.max_actions = A;
+  bout.types = types.data();
+  bout.amounts = amounts.data();
+  bout.probabilities = probs.data();
+  bout.num_actions = nact.data();
+  quasar::solve_batch(view, cfg, bout);
+  auto t4 = high_resolution_clock::now();
+  quasar::solve_batch(view, cfg, bout);
+  auto t5 = high_resolution_clock::now();
+  double arr_us = static_cast<double>(duration_cast<microseconds>(t5 - t4).count());
+  std::cout << "solve_batch throughput: " << (arr_us > 0 ? iters / arr_us * 1e6 : 0.0) << " spots/s" << std::endl;
   return 0;
 }
 
@@ -0,0 +1,250 @@
+#include "quasar/bucketing/bucket_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "quasar/eval/hand_index.h"
+
+namespace quasar {
+
+namespace {
+
+constexpr uint64_t kDataStart = 64;  // header padded to one cache line
+
+// The 24 suit permutations in lexicographic order.
+struct SuitPerms {
+  std::array<std::array<int, 4>, 24> p{};
+  SuitPerms() {
+    std::array<int, 4> s{0, 1, 2, 3};
+    for (auto& row : p) {
+      row = s;
+      std::next_permutation(s.begin(), s.end());
+    }
+  }
+};
+
+const SuitPerms& suit_perms() {
+  static const SuitPerms perms;
+  return perms;
+}
+
+inline int relabel(int card, const int suit_map[4]) { return suit_map[card / 13] * 13 + card % 13; }
+
+inline uint64_t block_bytes(int id_bytes) {
+  const uint64_t raw = static_cast<uint64_t>(kNumPloHands) * id_bytes;
+  return (raw + 63) / 64 * 64;
+}
+
+// Cards of a valid hand as a mask, or 0 if out of range or repeated.
+inline uint64_t hand_mask(const int32_t* h) {
+  uint64_t m = 0;
+  for (int k = 0; k < 4; ++k) {
+    if (h[k] < 0 || h[k] >= 52 || (m >> h[k] & 1)) return 0;
+    m |= uint64_t{1} << h[k];
+  }
+  return m;
+}
+
+}  // namespace
+
+uint64_t canonical_board(const int32_t* board, int len, int suit_map[4]) {
+  if (len < 3 || len > 5) return 0;
+  uint64_t seen = 0;
+  for (int k = 0; k < len; ++k) {
+    if (board[k] < 0 || board[k] >= 52 || (seen >> board[k] & 1)) return 0;
+    seen |= uint64_t{1} << board[k];
+  }
+  uint64_t best = ~uint64_t{0};
+  for (const auto& p : suit_perms().p) {
+    uint64_t m = 0;
+    for (int k = 0; k < len; ++k) m |= uint64_t{1} << relabel(board[k], p.data());
+    if (m < best) {
+      best = m;
+      std::copy(p.begin(), p.end(), suit_map);
+    }
+  }
+  return best;
+}
+
+// ---- writer ---------------------------------------------------------------
+
+BucketStoreWriter::~BucketStoreWriter() {
+  if (f_) std::fclose(f_);
+}
+
+bool BucketStoreWriter::open(const std::string& path, uint32_t bucket_version, int id_bytes) {
+  if (f_ || (id_bytes != 2 && id_bytes != 4)) return false;
+  f_ = std::fopen(path.c_str(), "wb");
+  if (!f_) return false;
+  bucket_version_ = bucket_version;
+  id_bytes_ = id_bytes;
+  entries_.clear();
+  keys_.clear();
+  // Zero header until finish(): an unfinished file fails the magic check.
+  const unsigned char zeros[kDataStart] = {0};
+  offset_ = kDataStart;
+  return std::fwrite(zeros, 1, sizeof(zeros), f_) == sizeof(zeros);
+}
+
+bool BucketStoreWriter::add_board(const int32_t* board, int len, const uint32_t* labels) {
+  if (!f_) return false;
+  int suit_map[4];
+  const uint64_t key = canonical_board(board, len, suit_map);
+  if (key == 0) return false;
+  if (keys_.count(key)) return false;
+  uint64_t bmask = 0;
+  for (int k = 0; k < len; ++k) bmask |= uint64_t{1} << board[k];
+  const uint32_t limit = id_bytes_ == 2 ? 0xFFFFu : kNoBucket;
+  block_.assign(block_bytes(id_bytes_), 0xFF);  // every id starts as "no bucket"
+  // Nested a < b < c < d loops visit hands in colex index order.
+  uint32_t i = 0;
+  for (int d = 3; d < 52; ++d) {
+    for (int c = 2; c < d; ++c) {
+      for (int b = 1; b < c; ++b) {
+        for (int a = 0; a < b; ++a, ++i) {
+          const uint32_t id = labels[i];
+          if (id == kNoBucket) continue;
+          if (id >= limit) return false;
+          const int32_t h[4] = {relabel(a, suit_map), relabel(b, suit_map), relabel(c, suit_map),
+                                relabel(d, suit_map)};
+          if ((uint64_t{1} << a | uint64_t{1} << b | uint64_t{1} << c | uint64_t{1} << d) & bmask) continue;
+          const uint32_t j = plo_hand_index(h);
+          if (id_bytes_ == 2) {
+            const uint16_t v = static_cast<uint16_t>(id);
+            std::memcpy(&block_[j * 2u], &v, 2);
+          } else {
+            std::memcpy(&block_[j * 4u], &id, 4);
+          }
+        }
+      }
+    }
+  }
+  if (std::fwrite(block_.data(), 1, block_.size(), f_) != block_.size()) return false;
+  keys_.insert(key);
+  entries_.push_back({key, offset_});
+  offset_ += block_.size();
+  return true;
+}
+
+bool BucketStoreWriter::finish() {
+  if (!f_) return false;
+  std::sort(entries_.begin(), entries_.end(),
+            [](const BucketStoreEntry& a, const BucketStoreEntry& b) { return a.board_key < b.board_key; });
+  BucketStoreHeader h{};
+  std::memcpy(h.magic, kBucketStoreMagic, sizeof(h.magic));
+  h.format = kBucketStoreFormat;
+  h.id_bytes = static_cast<uint16_t>(id_bytes_);
+  h.bucket_version = bucket_version_;
+  h.num_boards = static_cast<uint32_t>(entries_.size());
+  h.dir_offset = offset_;
+  h.hands_per_board = kNumPloHands;
+  const size_t dir_bytes = entries_.size() * sizeof(BucketStoreEntry);
+  bool ok = (dir_bytes == 0 || std::fwrite(entries_.data(), 1, dir_bytes, f_) == dir_bytes) &&
+            std::fseek(f_, 0, SEEK_SET) == 0 && std::fwrite(&h, sizeof(h), 1, f_) == 1;
+  ok = std::fclose(f_) == 0 && ok;
+  f_ = nullptr;
+  return ok;
+}
+
+// ---- reader ---------------------------------------------------------------
+
+std::unique_ptr<BucketStore> BucketStore::open(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return nullptr;
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kDataStart) {
+    ::close(fd);
+    return nullptr;
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return nullptr;
+  std::unique_ptr<BucketStore> s(new BucketStore());
+  s->base_ = static_cast<const unsigned char*>(p);
+  s->size_ = size;
+  BucketStoreHeader& h = s->header_;
+  std::memcpy(&h, s->base_, sizeof(h));
+  if (std::memcmp(h.magic, kBucketStoreMagic, sizeof(h.magic)) != 0 || h.format != kBucketStoreFormat ||
+      (h.id_bytes != 2 && h.id_bytes != 4) || h.hands_per_board != kNumPloHands ||
+      h.dir_offset % 8 != 0 || h.dir_offset > size ||
+      (size - h.dir_offset) / sizeof(BucketStoreEntry) < h.num_boards) {
+    return nullptr;
+  }
+  s->dir_ = reinterpret_cast<const BucketStoreEntry*>(s->base_ + h.dir_offset);
+  const uint64_t bytes = block_bytes(h.id_bytes);
+  for (uint32_t i = 0; i < h.num_boards; ++i) {
+    const BucketStoreEntry& e = s->dir_[i];
+    if (e.offset < kDataStart || e.offset > h.dir_offset || h.dir_offset - e.offset < bytes ||
+        (i > 0 && s->dir_[i - 1].board_key >= e.board_key)) {
+      return nullptr;
+    }
+  }
+  return s;
+}
+
+BucketStore::~BucketStore() {
+  if (base_) ::munmap(const_cast<unsigned char*>(base_), size_);
+}
+
+const unsigned char* BucketStore::find(const int32_t* board, int len, int suit_map[4]) const {
+  const uint64_t key = canonical_board(board, len, suit_map);
+  if (key == 0) return nullptr;
+  const BucketStoreEntry* end = dir_ + header_.num_boards;
+  const BucketStoreEntry* e = std::lower_bound(
+      dir_, end, key, [](const BucketStoreEntry& a, uint64_t k) { return a.board_key < k; });
+  return e != end && e->board_key == key ? base_ + e->offset : nullptr;
+}
+
+uint32_t BucketStore::lookup(const unsigned char* block, const int suit_map[4], uint64_t board_mask,
+                             const int32_t* hand) const {
+  const uint64_t m = hand_mask(hand);
+  if (m == 0 || (m & board_mask)) return kNoBucket;
+  int32_t h[4];
+  for (int k = 0; k < 4; ++k) h[k] = relabel(hand[k], suit_map);
+  const uint32_t j = plo_hand_index(h);
+  if (header_.id_bytes == 2) {
+    uint16_t v;
+    std::memcpy(&v, block + j * 2u, 2);
+    return v == 0xFFFF ? kNoBucket : v;
+  }
+  uint32_t v;
+  std::memcpy(&v, block + j * 4u, 4);
+  return v;
+}
+
+int BucketStore::board(size_t i, int32_t* cards) const {
+  if (i >= header_.num_boards) return 0;
+  const uint64_t key = dir_[i].board_key;
+  int n = 0;
+  for (int c = 0; c < 52; ++c) {
+    if (key >> c & 1) cards[n++] = c;
+  }
+  return n;
+}
+
+uint32_t BucketStore::bucket_of(const int32_t* board, int len, const int32_t* hand) const {
+  uint32_t out = kNoBucket;
+  buckets_of(board, len, hand, 1, &out);
+  return out;
+}
+
+void BucketStore::buckets_of(const int32_t* board, int len, const int32_t* hands, size_t n, uint32_t* out) const {
+  int suit_map[4];
+  const unsigned char* block = find(board, len, suit_map);
+  if (!block) {
+    std::fill(out, out + n, kNoBucket);
+    return;
+  }
+  uint64_t bmask = 0;
+  for (int k = 0; k < len; ++k) bmask |= uint64_t{1} << board[k];
+  for (size_t i = 0; i < n; ++i) out[i] = lookup(block, suit_map, bmask, hands + i * 4);
+}
+
+}  // namespace quasar
@@ -0,0 +1,366 @@
+#include "quasar/bucketing/kmeans.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <random>
+
+#include "quasar/util/npy.h"
+#include "quasar/util/thread_pool.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define QUASAR_KMEANS_AVX2 1
+#endif
+
+namespace quasar {
+
+namespace {
+
+constexpr int kLanes = 8;             // centers per block
+constexpr size_t kPointBlock = 256;   // points per assignment task
+constexpr int kCenterTile = 64;       // center blocks kept hot per pass over a point block
+constexpr size_t kSumChunk = 4096;    // fixed chunking for deterministic sums
+
+// Centers transposed into blocks of eight: t[(b * d + j) * 8 + l] is
+// coordinate j of center b * 8 + l. Padding lanes have an infinite norm.
+struct PackedCenters {
+  int k = 0, d = 0, blocks = 0;
+  std::vector<float> t;
+  std::vector<float> norm;  // squared norms, [blocks * 8]
+};
+
+void pack_centers(const float* c, int k, int d, PackedCenters& p) {
+  p.k = k;
+  p.d = d;
+  p.blocks = (k + kLanes - 1) / kLanes;
+  p.t.assign(static_cast<size_t>(p.blocks) * d * kLanes, 0.f);
+  p.norm.assign(static_cast<size_t>(p.blocks) * kLanes, std::numeric_limits<float>::infinity());
+  for (int i = 0; i < k; ++i) {
+    const float* ci = c + static_cast<size_t>(i) * d;
+    const int b = i / kLanes, l = i % kLanes;
+    float s = 0.f;
+    for (int j = 0; j < d; ++j) {
+      p.t[(static_cast<size_t>(b) * d + j) * kLanes + l] = ci[j];
+      s += ci[j] * ci[j];
+    }
+    p.norm[i] = s;
+  }
+}
+
+constexpr int kPoints = 4;  // points sharing each center-block load
+
+// Running per-lane minimum of ||c||^2 - 2 x.c over center blocks [b0, b1)
+// for kPoints points; lane l of block b is center b * 8 + l. Strict
+// comparisons keep the lowest center index on ties.
+struct LaneBest {
+  float best[kPoints][kLanes];
+  int32_t arg[kPoints][kLanes];
+};
+
+inline void scan_blocks(const float* const* xs, const PackedCenters& p, int b0, int b1, LaneBest& lb) {
+  const int d = p.d;
+#ifdef QUASAR_KMEANS_AVX2
+  const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256 two = _mm256_set1_ps(2.f);
+  __m256 bv[kPoints];
+  __m256i iv[kPoints];
+  for (int q = 0; q < kPoints; ++q) {
+    bv[q] = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    iv[q] = _mm256_setzero_si256();
+  }
+  for (int b = b0; b < b1; ++b) {
+    const float* t = p.t.data() + static_cast<size_t>(b) * d * kLanes;
+    __m256 acc[kPoints];
+    for (int q = 0; q < kPoints; ++q) acc[q] = _mm256_setzero_ps();
+    for (int j = 0; j < d; ++j) {
+      const __m256 tv = _mm256_loadu_ps(t + j * kLanes);
+      for (int q = 0; q < kPoints; ++q) acc[q] = _mm256_fmadd_ps(_mm256_set1_ps(xs[q][j]), tv, acc[q]);
+    }
+    const __m256 norm = _mm256_loadu_ps(p.norm.data() + static_cast<size_t>(b) * kLanes);
+    const __m256i idx = _mm256_add_epi32(_mm256_set1_epi32(b * kLanes), lane_ids);
+    for (int q = 0; q < kPoints; ++q) {
+      const __m256 sc = _mm256_fnmadd_ps(two, acc[q], norm);
+      const __m256 lt = _mm256_cmp_ps(sc, bv[q], _CMP_LT_OQ);
+      bv[q] = _mm256_blendv_ps(bv[q], sc, lt);
+      iv[q] = _mm256_blendv_epi8(iv[q], idx, _mm256_castps_si256(lt));
+    }
+  }
+  for (int q = 0; q < kPoints; ++q) {
+    _mm256_storeu_ps(lb.best[q], bv[q]);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lb.arg[q]), iv[q]);
+  }
+#else
+  for (int q = 0; q < kPoints; ++q) {
+    for (int l = 0; l < kLanes; ++l) {
+      lb.best[q][l] = std::numeric_limits<float>::infinity();
+      lb.arg[q][l] = 0;
+    }
+  }
+  for (int b = b0; b < b1; ++b) {
+    const float* t = p.t.data() + static_cast<size_t>(b) * d * kLanes;
+    const float* norm = p.norm.data() + static_cast<size_t>(b) * kLanes;
+    for (int q = 0; q < kPoints; ++q) {
+      float acc[kLanes] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+      for (int j = 0; j < d; ++j) {
+        const float xj = xs[q][j];
+        for (int l = 0; l < kLanes; ++l) acc[l] += xj * t[j * kLanes + l];
+      }
+      for (int l = 0; l < kLanes; ++l) {
+        const float sc = norm[l] - 2.f * acc[l];
+        const bool lt = sc < lb.best[q][l];
+        lb.best[q][l] = lt ? sc : lb.best[q][l];
+        lb.arg[q][l] = lt ? b * kLanes + l : lb.arg[q][l];
+      }
+    }
+  }
+#endif
+}
+
+void assign_packed(const float* x, size_t n, const PackedCenters& p, int32_t* labels, float* dist2,
+                   ThreadPool& pool) {
+  const int d = p.d;
+  const size_t num_blocks = (n + kPointBlock - 1) / kPointBlock;
+  auto assign_block = [&](size_t blk) {
+    const size_t i0 = blk * kPointBlock;
+    const size_t i1 = std::min(n, i0 + kPointBlock);
+    float best[kPointBlock];
+    int32_t arg[kPointBlock];
+    std::fill(best, best + (i1 - i0), std::numeric_limits<float>::infinity());
+    std::fill(arg, arg + (i1 - i0), 0);
+    LaneBest lb;
+    for (int b0 = 0; b0 < p.blocks; b0 += kCenterTile) {
+      const int b1 = std::min(p.blocks, b0 + kCenterTile);
+      for (size_t i = i0; i < i1; i += kPoints) {
+        const float* xs[kPoints];
+        for (int q = 0; q < kPoints; ++q) xs[q] = x + std::min(i + q, i1 - 1) * d;  // pad with the last point
+        scan_blocks(xs, p, b0, b1, lb);
+        for (int q = 0; q < kPoints && i + q < i1; ++q) {
+          // Reduce lanes (lowest index on ties); tiles only add higher indices.
+          float bd = best[i + q - i0];
+          int32_t bi = arg[i + q - i0];
+          for (int l = 0; l < kLanes; ++l) {
+            const float sc = lb.best[q][l];
+            const int32_t ci = lb.arg[q][l];
+            if (sc < bd || (sc == bd && ci < bi && ci >= b0 * kLanes)) {
+              bd = sc;
+              bi = ci;
+            }
+          }
+          best[i + q - i0] = bd;
+          arg[i + q - i0] = bi;
+        }
+      }
+    }
+    for (size_t i = i0; i < i1; ++i) {
+      labels[i] = arg[i - i0];
+      if (dist2) {
+        const float* xi = x + i * d;
+        float xn = 0.f;
+        for (int j = 0; j < d; ++j) xn += xi[j] * xi[j];
+        dist2[i] = std::max(0.f, xn + best[i - i0]);
+      }
+    }
+  };
+  pool.parallel_for(num_blocks, assign_block, 1);
+}
+
+inline float sq_dist(const float* a, const float* b, int d) {
+  float s = 0.f;
+  for (int j = 0; j < d; ++j) {
+    const float t = a[j] - b[j];
+    s += t * t;
+  }
+  return s;
+}
+
+// Uniform double in [0, 1) from the generator's raw output, identical on
+// every standard library (unlike std::uniform_real_distribution).
+inline double uniform01(std::mt19937_64& rng) { return static_cast<double>(rng() >> 11) * 0x1.0p-53; }
+
+void seed_plus_plus(const float* x, size_t n, int d, int k, std::mt19937_64& rng, float* centers,
+                    ThreadPool& pool) {
+  std::vector<float> mind(n);
+  const size_t chunks = (n + kSumChunk - 1) / kSumChunk;
+  std::vector<double> chunk_sum(chunks);
+  size_t pick = static_cast<size_t>(rng() % n);
+  for (int c = 0; c < k; ++c) {
+    const float* cc = x + pick * d;
+    std::copy(cc, cc + d, centers + static_cast<size_t>(c) * d);
+    if (c + 1 == k) break;
+    auto update = [&](size_t ch) {
+      const size_t i1 = std::min(n, (ch + 1) * kSumChunk);
+      double s = 0.0;
+      for (size_t i = ch * kSumChunk; i < i1; ++i) {
+        const float dd = sq_dist(x + i * d, cc, d);
+        if (c == 0 || dd < mind[i]) mind[i] = dd;
+        s += mind[i];
+      }
+      chunk_sum[ch] = s;
+    };
+    pool.parallel_for(chunks, update, 1);
+    double total = 0.0;
+    for (double s : chunk_sum) total += s;
+    if (!(total > 0.0)) {  // every point already coincides with a center
+      pick = static_cast<size_t>(rng() % n);
+      continue;
+    }
+    double r = uniform01(rng) * total;
+    size_t ch = 0;
+    while (ch + 1 < chunks && r >= chunk_sum[ch]) r -= chunk_sum[ch++];
+    const size_t i1 = std::min(n, (ch + 1) * kSumChunk);
+    pick = i1 - 1;
+    for (size_t i = ch * kSumChunk; i < i1; ++i) {
+      if (r < mind[i]) {
+        pick = i;
+        break;
+      }
+      r -= mind[i];
+    }
+  }
+}
+
+void seed_random(const float* x, size_t n, int d, int k, std::mt19937_64& rng, float* centers) {
+  std::vector<size_t> idx(n);
+  for (size_t i = 0; i < n; ++i) idx[i] = i;
+  for (int c = 0; c < k; ++c) {
+    const size_t j = c + static_cast<size_t>(rng() % (n - c));
+    std::swap(idx[c], idx[j]);
+    std::copy(x + idx[c] * d, x + idx[c] * d + d, centers + static_cast<size_t>(c) * d);
+  }
+}
+
+// Lloyd update: per-cluster means, summed in point order so the result does
+// not depend on scheduling. Empty clusters take the points farthest from
+// their current center.
+void update_centers(const float* x, size_t n, int d, int k, const int32_t* labels, const float* dist2,
+                    float* centers, ThreadPool& pool) {
+  std::vector<size_t> offset(static_cast<size_t>(k) + 1, 0);
+  for (size_t i = 0; i < n; ++i) ++offset[labels[i] + 1];
+  for (int c = 0; c < k; ++c) offset[c + 1] += offset[c];
+  std::vector<size_t> order(n);
+  std::vector<size_t> fill(offset.begin(), offset.end() - 1);
+  for (size_t i = 0; i < n; ++i) order[fill[labels[i]]++] = i;
+
+  auto mean = [&](size_t c) {
+    const size_t a = offset[c], b = offset[c + 1];
+    if (a == b) return;
+    double sum[64];
+    std::vector<double> big;
+    double* s = sum;
+    if (d > 64) {
+      big.assign(d, 0.0);
+      s = big.data();
+    } else {
+      std::fill(sum, sum + d, 0.0);
+    }
+    for (size_t q = a; q < b; ++q) {
+      const float* xi = x + order[q] * d;
+      for (int j = 0; j < d; ++j) s[j] += xi[j];
+    }
+    const double inv = 1.0 / static_cast<double>(b - a);
+    for (int j = 0; j < d; ++j) centers[c * d + j] = static_cast<float>(s[j] * inv);
+  };
+  pool.parallel_for(static_cast<size_t>(k), mean, 16);
+
+  std::vector<int> empty;
+  for (int c = 0; c < k; ++c) {
+    if (offset[c] == offset[c + 1]) empty.push_back(c);
+  }
+  if (empty.empty()) return;
+  std::vector<size_t> far(n);
+  for (size_t i = 0; i < n; ++i) far[i] = i;
+  const size_t m = std::min(empty.size(), n);
+  std::partial_sort(far.begin(), far.begin() + m, far.end(), [&](size_t a, size_t b) {
+    return dist2[a] != dist2[b] ? dist2[a] > dist2[b] : a < b;
+  });
+  for (size_t e = 0; e < m; ++e) {
+    std::copy(x + far[e] * d, x + far[e] * d + d, centers + static_cast<size_t>(empty[e]) * d);
+  }
+}
+
+}  // namespace
+
+void kmeans_assign(const float* x, size_t n, int d, const float* centers, int k, int32_t* labels,
+                   float* dist2, ThreadPool* pool) {
+  if (n == 0 || k <= 0 || d <= 0) return;
+  PackedCenters p;
+  pack_centers(centers, k, d, p);
+  assign_packed(x, n, p, labels, dist2, pool ? *pool : default_thread_pool());
+}
+
+bool kmeans_fit(const float* x, size_t n, int d, const KMeansConfig& cfg, KMeansResult& out,
+                ThreadPool* pool) {
+  if (n == 0 || d <= 0 || cfg.k <= 0) return false;
+  ThreadPool& tp = pool ? *pool : default_thread_pool();
+  const int k = static_cast<int>(std::min<size_t>(static_cast<size_t>(cfg.k), n));
+  out.k = k;
+  out.dim = d;
+  out.centers.assign(static_cast<size_t>(k) * d, 0.f);
+  out.labels.assign(n, -1);
+  out.iterations = 0;
+  std::mt19937_64 rng(cfg.seed);
+  if (cfg.plus_plus) {
+    seed_plus_plus(x, n, d, k, rng, out.centers.data(), tp);
+  } else {
+    seed_random(x, n, d, k, rng, out.centers.data());
+  }
+
+  std::vector<float> dist2(n);
+  PackedCenters p;
+  bool converged = false;  // labels and dist2 already match the centers
+  if (cfg.batch_size > 0) {
+    const size_t b = std::min(cfg.batch_size, n);
+    std::vector<size_t> idx(b);
+    std::vector<float> xb(b * d);
+    std::vector<int32_t> lb(b);
+    std::vector<double> counts(k, 0.0);
+    for (int it = 0; it < cfg.iters; ++it) {
+      for (size_t q = 0; q < b; ++q) {
+        idx[q] = static_cast<size_t>(rng() % n);
+        std::copy(x + idx[q] * d, x + idx[q] * d + d, xb.data() + q * d);
+      }
+      pack_centers(out.centers.data(), k, d, p);
+      assign_packed(xb.data(), b, p, lb.data(), nullptr, tp);
+      // Per-center learning rate 1 / (points seen), applied in sample order.
+      for (size_t q = 0; q < b; ++q) {
+        float* c = out.centers.data() + static_cast<size_t>(lb[q]) * d;
+        const double eta = 1.0 / (counts[lb[q]] += 1.0);
+        const float* xq = xb.data() + q * d;
+        for (int j = 0; j < d; ++j) c[j] += static_cast<float>(eta * (xq[j] - c[j]));
+      }
+      ++out.iterations;
+    }
+  } else {
+    std::vector<int32_t> prev(n, -1);
+    for (int it = 0; it < cfg.iters; ++it) {
+      pack_centers(out.centers.data(), k, d, p);
+      assign_packed(x, n, p, out.labels.data(), dist2.data(), tp);
+      if (out.labels == prev) {
+        converged = true;
+        break;
+      }
+      update_centers(x, n, d, k, out.labels.data(), dist2.data(), out.centers.data(), tp);
+      prev.swap(out.labels);
+      ++out.iterations;
+    }
+  }
+  if (!converged) {
+    pack_centers(out.centers.data(), k, d, p);
+    assign_packed(x, n, p, out.labels.data(), dist2.data(), tp);
+  }
+  out.inertia = 0.0;
+  for (size_t i = 0; i < n; ++i) out.inertia += dist2[i];
+  return true;
+}
+
+bool save_kmeans(const KMeansResult& result, const std::string& dir) {
+  if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) return false;
+  return write_npy(dir + "/labels.npy", result.labels.data(), {result.labels.size()}) &&
+         write_npy(dir + "/centers.npy", result.centers.data(),
+                   {static_cast<size_t>(result.k), static_cast<size_t>(result.dim)});
+}
+
+}  // namespace quasar
@@ -1,6 +1,7 @@
 #include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -8,18 +9,12 @@
 #include "quasar/engine/plo_legal.h"
 #include "quasar/engine/json.h"
 #include "quasar/engine/discretize.h"
+#include "quasar/engine/solve_cache.h"
 #include "quasar/engine/solve_one.h"
+#include "quasar/engine/wire.h"
+#include "quasar/util/thread_pool.h"
 
-// Minimal JSON reader for a known schema using a tiny hand-rolled parser.
-// Expected keys:
-// - street: "preflop"|"flop"|"turn"|"river"
-// - sb, bb, ante: numbers
-// - to_act, button: integers
-// - stacks: [..]
-// - committed_total: [..]
-// - committed_on_street: [..]
-// - last_raise_size: number (optional)
-// - board: [..] (optional)
+// Spot JSON schema: docs/SPOT_JSON.md (parsed by quasar::parse_spot_json).
 
 static std::string slurp(const std::string& path) {
   std::ifstream ifs(path);
@@ -28,106 +23,178 @@ static std::string slurp(const std::string& path) {
   return buffer.str();
 }
 
-static std::string get_string(const std::string& s, const std::string& key) {
-  auto pos = s.find("\"" + key + "\"");
-  if (pos == std::string::npos) return "";
-  pos = s.find(':', pos);
-  if (pos == std::string::npos) return "";
-  auto start = s.find('"', pos + 1);
-  if (start == std::string::npos) return "";
-  auto end = s.find('"', start + 1);
-  if (end == std::string::npos) return "";
-  return s.substr(start + 1, end - start - 1);
+static void solve_and_print(const std::string& input) {
+  quasar::SpotRequest req;
+  quasar::parse_spot_json(input, req);
+  auto res = quasar::solve_one(req.state, req.config);
+  std::cout << quasar::assemble_response_json(res.legal, res.actions, res.probabilities) << std::endl;
 }
 
-static double get_number(const std::string& s, const std::string& key, double def = 0.0) {
-  auto pos = s.find("\"" + key + "\"");
-  if (pos == std::string::npos) return def;
-  pos = s.find(':', pos);
-  if (pos == std::string::npos) return def;
-  char* end = nullptr;
-  const char* start = s.c_str() + pos + 1;
-  double val = std::strtod(start, &end);
-  if (start == end) return def;
-  return val;
+// NDJSON serving loop: one spot object per stdin line, one response line per
+// request (flushed), until EOF. Blank lines are ignored; unparsable lines
+// answer {"error":"invalid spot"} so responses stay paired with requests.
+// The parse request, solve workspace, result cache and output buffer live
+// for the whole stream.
+static int run_stream(size_t cache_capacity) {
+  quasar::SpotRequest req;
+  quasar::SolveWorkspace ws;
+  std::unique_ptr<quasar::SolveCache> cache;
+  if (cache_capacity > 0) {
+    quasar::SolveCacheConfig cc;
+    cc.capacity = cache_capacity;
+    cc.shards = 1;
+    cache = std::make_unique<quasar::SolveCache>(cc);
+  }
+  std::string line, out;
+  while (std::getline(std::cin, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+    out.clear();
+    if (!quasar::parse_spot_json(line, req)) {
+      out += "{\"error\":\"invalid spot\"}";
+    } else if (cache) {
+      const auto res = cache->solve(req.state, req.config);
+      quasar::append_response_json(out, res->legal, res->actions, res->probabilities);
+    } else {
+      quasar::solve_one(req.state, req.config, ws);
+      quasar::append_response_json(out, ws.legal, ws.actions, ws.probabilities);
+    }
+    out += '\n';
+    std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+    std::cout.flush();
+  }
+  return 0;
 }
 
-static int get_int(const std::string& s, const std::string& key, int def = 0) {
-  return static_cast<int>(get_number(s, key, def));
+// Binary batch modes (quasar/engine/wire.h). stdin/stdout carry raw bytes.
+static std::string read_stdin() {
+  std::stringstream buf;
+  buf << std::cin.rdbuf();
+  return buf.str();
 }
 
-static std::vector<double> get_number_array(const std::string& s, const std::string& key) {
-  std::vector<double> out;
-  auto pos = s.find("\"" + key + "\"");
-  if (pos == std::string::npos) return out;
-  pos = s.find('[', pos);
-  if (pos == std::string::npos) return out;
-  auto end = s.find(']', pos);
-  if (end == std::string::npos) return out;
-  std::string arr = s.substr(pos + 1, end - pos - 1);
-  std::stringstream ss(arr);
-  while (ss.good()) {
-    std::string tok;
-    std::getline(ss, tok, ',');
-    if (tok.empty()) continue;
-    out.push_back(std::atof(tok.c_str()));
+static void write_stdout(const std::string& bytes) {
+  std::cout.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  std::cout.flush();
+}
+
+// Spot batch on stdin -> result batch on stdout.
+static int run_binary(quasar::ThreadPool* pool) {
+  std::string results;
+  if (!quasar::solve_wire_batch(read_stdin(), results, pool)) {
+    std::cerr << "quasar_cli: stdin is not a spot batch\n";
+    return 1;
   }
-  return out;
+  write_stdout(results);
+  return 0;
 }
 
-static std::vector<int> get_int_array(const std::string& s, const std::string& key) {
-  std::vector<int> out;
-  auto nums = get_number_array(s, key);
-  out.reserve(nums.size());
-  for (double d : nums) out.push_back(static_cast<int>(d));
-  return out;
+// Spot JSON files -> spot batch on stdout. A file that does not parse is
+// reported and encoded as an invalid (all-zero) record.
+static int run_encode(const std::vector<std::string>& paths) {
+  std::vector<quasar::SpotRequest> reqs(paths.size());
+  std::vector<bool> ok(paths.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    ok[i] = quasar::parse_spot_json(slurp(paths[i]), reqs[i]);
+    if (!ok[i]) std::cerr << "quasar_cli: " << paths[i] << " is not a valid spot\n";
+  }
+  std::string out;
+  quasar::write_spot_batch(reqs.data(), reqs.size(), out, &ok);
+  write_stdout(out);
+  return 0;
 }
 
+// Result batch on stdin -> one response JSON line per record.
+static int run_decode() {
+  std::vector<quasar::SolveOneResult> results;
+  std::vector<bool> ok;
+  if (!quasar::read_result_batch(read_stdin(), results, &ok)) {
+    std::cerr << "quasar_cli: stdin is not a result batch\n";
+    return 1;
+  }
+  std::string line;
+  for (size_t i = 0; i < results.size(); ++i) {
+    line.clear();
+    if (ok[i]) {
+      quasar::append_response_json(line, results[i].legal, results[i].actions, results[i].probabilities);
+    } else {
+      line += "{\"error\":\"invalid spot\"}";
+    }
+    line += '\n';
+    std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+  }
+  std::cout.flush();
+  return 0;
+}
+
+// Usage:
+//   quasar_cli [spot.json]                 one spot from file or stdin
+//   quasar_cli [--threads N] a.json b.json  batch: one response line per file, in order
+//   quasar_cli --stream [--cache N]         NDJSON on stdin -> one response line each
+//                                           (N cached results, default 65536; 0 disables)
+//   quasar_cli --binary [--threads N]       binary spot batch on stdin -> result batch on stdout
+//   quasar_cli --encode a.json b.json       spot JSON files -> binary spot batch on stdout
+//   quasar_cli --decode                     binary result batch on stdin -> response JSON lines
 int main(int argc, char** argv) {
   std::ios::sync_with_stdio(false);
   std::cin.tie(nullptr);
 
-  std::string input;
-  if (argc > 1) {
-    input = slurp(argv[1]);
-  } else {
-    std::stringstream buf;
-    buf << std::cin.rdbuf();
-    input = buf.str();
+  int threads = 0;
+  bool stream = false;
+  enum class Binary { kNone, kSolve, kEncode, kDecode } binary = Binary::kNone;
+  long cache_capacity = static_cast<long>(quasar::SolveCacheConfig{}.capacity);
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::atoi(argv[++i]);
+    } else if (arg == "--stream") {
+      stream = true;
+    } else if (arg == "--binary") {
+      binary = Binary::kSolve;
+    } else if (arg == "--encode") {
+      binary = Binary::kEncode;
+    } else if (arg == "--decode") {
+      binary = Binary::kDecode;
+    } else if (arg == "--cache" && i + 1 < argc) {
+      cache_capacity = std::atol(argv[++i]);
+    } else {
+      paths.push_back(arg);
+    }
   }
+  if (stream) return run_stream(cache_capacity > 0 ? static_cast<size_t>(cache_capacity) : 0);
+  if (binary == Binary::kEncode) return run_encode(paths);
+  if (binary == Binary::kDecode) return run_decode();
+  std::unique_ptr<quasar::ThreadPool> pool;
+  if (threads > 0) pool = std::make_unique<quasar::ThreadPool>(threads);
+  if (binary == Binary::kSolve) return run_binary(pool.get());
 
-  quasar::PublicState s;
-  quasar::parse_public_state_from_json(input, s);
-  quasar::BettingRules rules;
-  quasar::parse_rules_from_json(input, rules);
-  auto la = quasar::compute_legal_actions(s, rules);
-  quasar::DiscretizationConfig cfg = quasar::parse_discretization_from_json(input);
-  quasar::SolveOneConfig so_cfg;
-  so_cfg.rules = rules;
-  so_cfg.discretization = cfg;
-  // Optional solver config: {"solver": {"type":"cfr", "iters":N}}
-  int cfr_iters = 0;
-  auto spos = input.find("\"solver\"");
-  if (spos != std::string::npos) {
-    auto tpos = input.find("\"iters\"", spos);
-    if (tpos != std::string::npos) {
-      // crude parse of number after iters:
-      auto colon = input.find(':', tpos);
-      if (colon != std::string::npos) cfr_iters = static_cast<int>(std::strtod(input.c_str() + colon + 1, nullptr));
+  if (paths.size() <= 1) {
+    std::string input;
+    if (!paths.empty()) {
+      input = slurp(paths[0]);
+    } else {
+      input = read_stdin();
     }
-    // parse win_prob and call_k
-    auto find_num = [&](const char* key, double defv) {
-      auto kpos = input.find(std::string("\"") + key + "\"", spos);
-      if (kpos == std::string::npos) return defv;
-      kpos = input.find(':', kpos);
-      if (kpos == std::string::npos) return defv;
-      return std::strtod(input.c_str() + kpos + 1, nullptr);
-    };
-    so_cfg.eval.win_prob = find_num("win_prob", so_cfg.eval.win_prob);
-    so_cfg.eval.call_k = find_num("call_k", so_cfg.eval.call_k);
+    solve_and_print(input);
+    return 0;
   }
-  so_cfg.cfr_iters = cfr_iters;
-  auto res = quasar::solve_one(s, so_cfg);
-  std::cout << quasar::assemble_response_json(res.legal, res.actions, res.probabilities) << std::endl;
+
+  std::vector<quasar::PublicState> states(paths.size());
+  std::vector<quasar::SolveOneConfig> cfgs(paths.size());
+  quasar::SpotRequest req;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    quasar::parse_spot_json(slurp(paths[i]), req);
+    states[i] = req.state;
+    cfgs[i] = req.config;
+  }
+  auto results = quasar::solve_many(states, cfgs, pool.get());
+  std::string line;
+  for (const auto& res : results) {
+    line.clear();
+    quasar::append_response_json(line, res.legal, res.actions, res.probabilities);
+    line += '\n';
+    std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+  }
+  std::cout.flush();
   return 0;
 }
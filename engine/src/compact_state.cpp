@@ -0,0 +1,104 @@
+#include "quasar/engine/compact_state.h"
+
+#include "quasar/engine/state_hash.h"
+
+#include <algorithm>
+
+namespace quasar {
+
+bool CompactPublicState::from_public_state(const PublicState& s, CompactPublicState& out) {
+  const size_t n = s.stacks.size();
+  if (n > static_cast<size_t>(kMaxPlayers) || static_cast<size_t>(s.num_players) != n) return false;
+  if (s.committed_total.size() != n || s.committed_on_street.size() != n) return false;
+  if (s.board.size() > 5) return false;
+  out.num_players = static_cast<int8_t>(s.num_players);
+  out.player_to_act = static_cast<int8_t>(s.player_to_act);
+  out.button = static_cast<int8_t>(s.button);
+  out.street = static_cast<int8_t>(s.street);
+  out.board_len = static_cast<uint8_t>(s.board.size());
+  out.board_packed = 0;
+  for (size_t i = 0; i < s.board.size(); ++i) {
+    const int c = s.board[i];
+    out.set_board_card(static_cast<int>(i), (c >= 0 && c < 52) ? c : -1);
+  }
+  out.sb = to_chips(s.sb);
+  out.bb = to_chips(s.bb);
+  out.ante = to_chips(s.ante);
+  out.last_raise_size = to_chips(s.last_raise_size);
+  out.stacks.fill(0);
+  out.committed_total.fill(0);
+  out.committed_on_street.fill(0);
+  for (size_t i = 0; i < n; ++i) {
+    out.stacks[i] = to_chips(s.stacks[i]);
+    out.committed_total[i] = to_chips(s.committed_total[i]);
+    out.committed_on_street[i] = to_chips(s.committed_on_street[i]);
+  }
+  out.folded_mask = 0;
+  out.acted_mask = 0;
+  out.num_raises = 0;
+  out.terminal = false;
+  out.rehash();
+  return true;
+}
+
+void CompactPublicState::to_public_state(PublicState& out) const {
+  out.num_players = num_players;
+  out.player_to_act = player_to_act;
+  out.button = button;
+  out.street = street;
+  out.board.resize(board_len);
+  for (int i = 0; i < board_len; ++i) out.board[i] = board_card(i);
+  out.sb = from_chips(sb);
+  out.bb = from_chips(bb);
+  out.ante = from_chips(ante);
+  out.last_raise_size = from_chips(last_raise_size);
+  out.stacks.resize(num_players);
+  out.committed_total.resize(num_players);
+  out.committed_on_street.resize(num_players);
+  for (int i = 0; i < num_players; ++i) {
+    out.stacks[i] = from_chips(stacks[i]);
+    out.committed_total[i] = from_chips(committed_total[i]);
+    out.committed_on_street[i] = from_chips(committed_on_street[i]);
+  }
+}
+
+PublicState CompactPublicState::to_public_state() const {
+  PublicState s;
+  to_public_state(s);
+  return s;
+}
+
+void CompactPublicState::rehash() {
+  pot = 0;
+  current_bet = 0;
+  for (int i = 0; i < num_players; ++i) {
+    pot += committed_total[i];
+    current_bet = std::max(current_bet, committed_on_street[i]);
+  }
+  int board[5];
+  for (int i = 0; i < board_len; ++i) board[i] = board_card(i);
+  PublicStateView v;
+  v.num_players = num_players;
+  v.player_to_act = player_to_act;
+  v.button = button;
+  v.street = street;
+  v.board = board;
+  v.board_len = board_len;
+  v.sb = sb;
+  v.bb = bb;
+  v.ante = ante;
+  v.stacks = stacks.data();
+  v.stacks_len = num_players;
+  v.committed_total = committed_total.data();
+  v.committed_total_len = num_players;
+  v.committed_on_street = committed_on_street.data();
+  v.committed_on_street_len = num_players;
+  v.last_raise_size = last_raise_size;
+  v.folded_mask = folded_mask;
+  v.acted_mask = acted_mask;
+  v.num_raises = num_raises;
+  v.terminal = terminal;
+  hash = hash_public_state(v);
+}
+
+}  // namespace quasar
@@ -0,0 +1,457 @@
+#include "quasar/datagen/datagen.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "quasar/bucketing/bucket_store.h"
+#include "quasar/eval/hand_index.h"
+#include "quasar/eval/showdown.h"
+#include "quasar/nn/query_pack.h"
+
+namespace quasar {
+
+namespace {
+
+inline uint64_t mix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+// Portable draws from raw engine output (std distributions differ across
+// standard libraries, and records must not).
+struct RecordRng {
+  std::mt19937_64 eng;
+  explicit RecordRng(uint64_t seed) : eng(seed) {}
+  double uniform() { return static_cast<double>(eng() >> 11) * 0x1.0p-53; }
+  uint64_t below(uint64_t n) { return eng() % n; }
+  double normal() {
+    const double u1 = 1.0 - uniform();
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * uniform());
+  }
+};
+
+// Every PLO hand in colex index order ([kNumPloHands, 4]).
+const std::vector<int32_t>& all_hands() {
+  static const std::vector<int32_t> hands = [] {
+    std::vector<int32_t> h(static_cast<size_t>(kNumPloHands) * 4);
+    for (uint32_t i = 0; i < kNumPloHands; ++i) plo_hand_from_index(i, h.data() + i * 4);
+    return h;
+  }();
+  return hands;
+}
+
+// Per-thread buffers reused across records.
+struct RecordScratch {
+  std::vector<uint32_t> bucket;  // per hand index, kNoBucket if none
+  std::vector<uint32_t> count;   // hands per bucket
+  std::vector<float> ranges;     // [players, K]
+  std::vector<float> weights[kDatagenPlayers];
+  std::vector<float> values[kDatagenPlayers];
+  std::vector<double> sums;
+  std::vector<std::pair<float, uint32_t>> ranked;
+  RecordScratch() {
+    for (int p = 0; p < kDatagenPlayers; ++p) {
+      weights[p].resize(kNumPloHands);
+      values[p].resize(kNumPloHands);
+    }
+    bucket.resize(kNumPloHands);
+  }
+};
+
+// Strength-percentile buckets: hands avoiding the board ranked by showdown
+// value against a uniform range, split into K equal-count buckets.
+void percentile_buckets(const std::array<int, 5>& board, uint64_t bmask, int K, RecordScratch& s) {
+  std::vector<float>& uniform = s.weights[0];
+  std::fill(uniform.begin(), uniform.end(), 1.f);
+  const float* w[1] = {uniform.data()};
+  float* v[1] = {s.values[0].data()};
+  river_showdown_values(board, w, v, 1);
+  const int32_t* hands = all_hands().data();
+  s.ranked.clear();
+  for (uint32_t h = 0; h < kNumPloHands; ++h) {
+    const int32_t* c = hands + h * 4;
+    const uint64_t m = (uint64_t{1} << c[0]) | (uint64_t{1} << c[1]) | (uint64_t{1} << c[2]) | (uint64_t{1} << c[3]);
+    s.bucket[h] = kNoBucket;
+    if (!(m & bmask)) s.ranked.emplace_back(s.values[0][h], h);
+  }
+  std::sort(s.ranked.begin(), s.ranked.end());
+  const size_t n = s.ranked.size();
+  for (size_t r = 0; r < n; ++r) s.bucket[s.ranked[r].second] = static_cast<uint32_t>(r * K / n);
+}
+
+}  // namespace
+
+bool generate_record(const DatagenConfig& cfg, uint64_t index, DatagenRecord& out) {
+  const int K = cfg.K;
+  const int P = kDatagenPlayers;
+  if (K <= 0) return false;
+  thread_local RecordScratch s;
+  RecordRng rng(mix64(cfg.seed) ^ mix64(index ^ 0x5DA7A6E11ULL));
+
+  // Board: a stored board under a random suit relabeling, or 5 uniform cards.
+  std::array<int, 5> board{};
+  if (cfg.buckets) {
+    if (cfg.buckets->num_boards() == 0) return false;
+    int32_t cards[5];
+    if (cfg.buckets->board(rng.below(cfg.buckets->num_boards()), cards) != 5) return false;
+    int suits[4] = {0, 1, 2, 3};
+    for (int i = 3; i > 0; --i) std::swap(suits[i], suits[rng.below(i + 1)]);
+    for (int i = 0; i < 5; ++i) board[i] = suits[cards[i] / 13] * 13 + cards[i] % 13;
+  } else {
+    int deck[52];
+    for (int c = 0; c < 52; ++c) deck[c] = c;
+    for (int i = 0; i < 5; ++i) {
+      std::swap(deck[i], deck[i + rng.below(52 - i)]);
+      board[i] = deck[i];
+    }
+  }
+  std::sort(board.begin(), board.end());
+  uint64_t bmask = 0;
+  for (int c : board) bmask |= uint64_t{1} << c;
+
+  if (cfg.buckets) {
+    const int32_t b32[5] = {board[0], board[1], board[2], board[3], board[4]};
+    cfg.buckets->buckets_of(b32, 5, all_hands().data(), kNumPloHands, s.bucket.data());
+    for (uint32_t& b : s.bucket) {
+      if (b >= static_cast<uint32_t>(K)) b = kNoBucket;
+    }
+  } else {
+    percentile_buckets(board, bmask, K, s);
+  }
+  s.count.assign(K, 0);
+  size_t bucketed = 0;
+  for (uint32_t b : s.bucket) {
+    if (b != kNoBucket) {
+      ++s.count[b];
+      ++bucketed;
+    }
+  }
+  if (bucketed == 0) return false;
+
+  // Beliefs: log-normal masses of random spread on a random subset of the
+  // non-empty buckets, normalized.
+  s.ranges.assign(static_cast<size_t>(P) * K, 0.f);
+  for (int p = 0; p < P; ++p) {
+    float* r = s.ranges.data() + static_cast<size_t>(p) * K;
+    const double sigma = 3.0 * rng.uniform();
+    const double keep = 0.1 + 0.9 * rng.uniform();
+    double total = 0.0;
+    for (int k = 0; k < K; ++k) {
+      const double z = rng.normal();
+      const bool live = rng.uniform() < keep;
+      if (s.count[k] == 0 || !live) continue;
+      r[k] = static_cast<float>(std::exp(sigma * z));
+      total += r[k];
+    }
+    if (total == 0.0) {
+      for (int k = 0; k < K; ++k) r[k] = s.count[k] ? 1.f : 0.f;
+      total = 0.0;
+      for (int k = 0; k < K; ++k) total += r[k];
+    }
+    for (int k = 0; k < K; ++k) r[k] = static_cast<float>(r[k] / total);
+    // A bucket's mass is spread evenly over its hands.
+    for (uint32_t h = 0; h < kNumPloHands; ++h) {
+      const uint32_t b = s.bucket[h];
+      s.weights[p][h] = b == kNoBucket ? 0.f : r[b] / static_cast<float>(s.count[b]);
+    }
+  }
+  const int32_t act = static_cast<int32_t>(rng.below(P));
+  const double s2pr = cfg.max_s2pr * rng.uniform();
+
+  // Seat p's hands against seat 1 - p's belief.
+  const float* w[2] = {s.weights[1].data(), s.weights[0].data()};
+  float* v[2] = {s.values[0].data(), s.values[1].data()};
+  river_showdown_values(board, w, v, P);
+  s.sums.assign(static_cast<size_t>(P) * K, 0.0);
+  for (uint32_t h = 0; h < kNumPloHands; ++h) {
+    const uint32_t b = s.bucket[h];
+    if (b == kNoBucket) continue;
+    for (int p = 0; p < P; ++p) s.sums[static_cast<size_t>(p) * K + b] += s.values[p][h];
+  }
+  out.target.resize(static_cast<size_t>(P) * K);
+  for (int p = 0; p < P; ++p) {
+    for (int k = 0; k < K; ++k) {
+      const size_t i = static_cast<size_t>(p) * K + k;
+      out.target[i] = s.count[k] ? static_cast<float>(s.sums[i] / s.count[k]) : 0.f;
+    }
+  }
+
+  const int32_t b32[5] = {board[0], board[1], board[2], board[3], board[4]};
+  DenseQueryBatch q;
+  q.batch = 1;
+  q.players = P;
+  q.K = K;
+  q.player_act = &act;
+  q.s2pr = &s2pr;
+  q.board = b32;
+  q.ranges = s.ranges.data();
+  out.query.resize(static_cast<size_t>(P) * dense_slice_size(K));
+  pack_dense_queries(q, out.query.data());
+  return true;
+}
+
+namespace {
+
+bool fail(std::string* error, const std::string& msg) {
+  if (error) *error = msg;
+  return false;
+}
+
+std::string shard_name(size_t i) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "shard-%06zu.qshd", i);
+  return name;
+}
+
+struct ShardInfo {
+  uint64_t first_record;
+  uint32_t count;
+};
+
+struct FilePart {
+  const void* data;
+  size_t bytes;
+};
+
+// Writes the parts to path + ".tmp" and renames it over `path`.
+bool write_file(const std::string& path, std::initializer_list<FilePart> parts) {
+  const std::string tmp = path + ".tmp";
+  FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (!f) return false;
+  bool ok = true;
+  for (const FilePart& p : parts) ok = ok && (p.bytes == 0 || std::fwrite(p.data, 1, p.bytes, f) == p.bytes);
+  ok = std::fclose(f) == 0 && ok;
+  if (ok) ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+  if (!ok) std::remove(tmp.c_str());
+  return ok;
+}
+
+bool write_manifest(const std::string& dir, const ShardHeader& h, uint32_t records_per_shard,
+                    const std::vector<ShardInfo>& shards) {
+  uint64_t records = 0;
+  for (const ShardInfo& s : shards) records += s.count;
+  std::string json;
+  char line[256];
+  std::snprintf(line, sizeof(line),
+                "{\n  \"format\": %u,\n  \"players\": %u,\n  \"K\": %u,\n  \"input_size\": %u,\n"
+                "  \"bucket_version\": %u,\n  \"seed\": %llu,\n  \"records_per_shard\": %u,\n"
+                "  \"num_records\": %llu,\n  \"shards\": [",
+                h.format, h.players, h.K, h.input_size, h.bucket_version, static_cast<unsigned long long>(h.seed),
+                records_per_shard, static_cast<unsigned long long>(records));
+  json += line;
+  for (size_t i = 0; i < shards.size(); ++i) {
+    std::snprintf(line, sizeof(line), "%s\n    {\"file\": \"%s\", \"first_record\": %llu, \"count\": %u}",
+                  i ? "," : "", shard_name(i).c_str(), static_cast<unsigned long long>(shards[i].first_record),
+                  shards[i].count);
+    json += line;
+  }
+  json += "\n  ]\n}\n";
+  return write_file(dir + "/manifest.json", {{json.data(), json.size()}});
+}
+
+// Header of an existing shard. False if the file is missing or does not
+// start with the shard magic, i.e. holds nothing resume should keep; `intact`
+// says whether its columns and size match the header.
+bool read_shard_header(const std::string& path, ShardHeader& h, bool& intact) {
+  FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return false;
+  bool ok = std::fread(&h, 1, sizeof(h), f) == sizeof(h) && std::fseek(f, 0, SEEK_END) == 0;
+  const long size = ok ? std::ftell(f) : -1;
+  std::fclose(f);
+  if (!ok || std::memcmp(h.magic, kShardMagic, sizeof(h.magic)) != 0) return false;
+  intact = size >= 0 && h.query_offset == shard_query_offset() &&
+           h.target_offset == shard_target_offset(h.count, h.players, h.input_size) &&
+           static_cast<uint64_t>(size) == shard_bytes(h.count, h.players, h.input_size, h.K);
+  return true;
+}
+
+// Indices of the files in `dir` named like shards, ascending.
+std::vector<size_t> shard_files(const std::string& dir) {
+  std::vector<size_t> out;
+  DIR* d = ::opendir(dir.c_str());
+  if (!d) return out;
+  while (const dirent* e = ::readdir(d)) {
+    size_t i = 0;
+    if (std::sscanf(e->d_name, "shard-%zu.qshd", &i) == 1 && shard_name(i) == e->d_name) out.push_back(i);
+  }
+  ::closedir(d);
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+}  // namespace
+
+bool run_datagen(const DatagenConfig& cfg, const std::string& out_dir, DatagenStats* stats, std::string* error) {
+  const int P = kDatagenPlayers;
+  if (cfg.K <= 0 || cfg.records_per_shard == 0) return fail(error, "K and records_per_shard must be positive");
+  if (::mkdir(out_dir.c_str(), 0755) != 0 && errno != EEXIST) return fail(error, "cannot create " + out_dir);
+
+  ShardHeader proto;
+  std::memset(&proto, 0, sizeof(proto));
+  std::memcpy(proto.magic, kShardMagic, sizeof(proto.magic));
+  proto.format = kShardFormat;
+  proto.players = static_cast<uint16_t>(P);
+  proto.K = static_cast<uint32_t>(cfg.K);
+  proto.input_size = static_cast<uint32_t>(dense_slice_size(cfg.K));
+  proto.bucket_version = cfg.buckets ? cfg.buckets->bucket_version() : cfg.bucket_version;
+  proto.seed = cfg.seed;
+  const size_t query_floats = static_cast<size_t>(P) * proto.input_size;
+  const size_t target_floats = static_cast<size_t>(P) * cfg.K;
+  const uint64_t rps = cfg.records_per_shard;
+
+  // Every shard already in out_dir is checked before anything is written:
+  // one from another configuration, a damaged one, or one holding records
+  // past num_records is an error wherever it lies. Only files without the
+  // shard magic are written over. Generation then resumes after the leading
+  // shards that are complete for this run; a short trailing shard is rebuilt.
+  const uint64_t num_shards = (cfg.num_records + rps - 1) / rps;
+  const std::vector<size_t> on_disk = shard_files(out_dir);
+  std::map<size_t, uint32_t> counts;  // shards with the magic -> record count
+  for (size_t i : on_disk) {
+    ShardHeader h;
+    bool intact = false;
+    const std::string path = out_dir + "/" + shard_name(i);
+    if (!read_shard_header(path, h, intact)) continue;
+    if (h.format != kShardFormat) {
+      return fail(error, path + " is shard format " + std::to_string(h.format) + " but this build writes format " +
+                             std::to_string(kShardFormat) + "; generate into a new directory");
+    }
+    if (!intact) return fail(error, path + " is truncated or corrupt");
+    if (h.players != proto.players || h.K != proto.K || h.input_size != proto.input_size ||
+        h.bucket_version != proto.bucket_version || h.seed != proto.seed || h.first_record != i * rps ||
+        h.count == 0 || h.count > rps) {
+      return fail(error, path + " was generated with a different configuration");
+    }
+    if (h.first_record + h.count > cfg.num_records) {
+      return fail(error, path + " holds records past the " + std::to_string(cfg.num_records) +
+                             " requested; generate into a new directory");
+    }
+    counts[i] = h.count;
+  }
+  // A short shard can only be the last one (else records_per_shard changed).
+  for (const auto& c : counts) {
+    if (c.second < rps && c.first != counts.rbegin()->first) {
+      return fail(error, out_dir + "/" + shard_name(c.first) + " was generated with a different configuration");
+    }
+  }
+  std::vector<ShardInfo> shards;
+  while (shards.size() < num_shards) {
+    const uint64_t first = shards.size() * rps;
+    const auto it = counts.find(shards.size());
+    if (it == counts.end() || it->second != std::min<uint64_t>(rps, cfg.num_records - first)) break;
+    shards.push_back({first, it->second});
+  }
+  DatagenStats st;
+  for (const ShardInfo& sh : shards) st.resumed += sh.count;
+  const uint64_t start = st.resumed, end = cfg.num_records;
+
+  const int threads = cfg.threads > 0 ? cfg.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  const uint64_t max_pending = cfg.max_pending > 0 ? cfg.max_pending : 4 * static_cast<uint64_t>(threads);
+  struct Done {
+    bool ok;
+    DatagenRecord rec;
+  };
+  std::mutex mu;
+  std::condition_variable can_claim, can_write;
+  std::map<uint64_t, Done> ready;  // finished records waiting for their turn
+  uint64_t next_claim = start, next_write = start;
+  bool stop = false;
+
+  auto worker = [&] {
+    for (;;) {
+      uint64_t i;
+      {
+        std::unique_lock<std::mutex> lock(mu);
+        can_claim.wait(lock, [&] { return stop || next_claim >= end || next_claim < next_write + max_pending; });
+        if (stop || next_claim >= end) return;
+        i = next_claim++;
+      }
+      Done d;
+      d.ok = generate_record(cfg, i, d.rec);
+      {
+        std::lock_guard<std::mutex> lock(mu);
+        ready.emplace(i, std::move(d));
+      }
+      can_write.notify_one();
+    }
+  };
+  std::vector<std::thread> workers;
+  if (start < end) {
+    for (int t = 0; t < threads; ++t) workers.emplace_back(worker);
+  }
+
+  // Columns of the shard being filled.
+  std::vector<float> queries, targets;
+  const size_t first_shard = static_cast<size_t>(std::min<uint64_t>(rps, end - start));
+  queries.reserve(first_shard * query_floats);
+  targets.reserve(first_shard * target_floats);
+  static const char kPad[64] = {0};
+  bool ok = true;
+  for (uint64_t i = start; i < end && ok; ++i) {
+    Done d;
+    {
+      std::unique_lock<std::mutex> lock(mu);
+      can_write.wait(lock, [&] { return ready.count(i) != 0; });
+      auto it = ready.find(i);
+      d = std::move(it->second);
+      ready.erase(it);
+      ++next_write;
+    }
+    can_claim.notify_all();
+    if (d.ok) {
+      queries.insert(queries.end(), d.rec.query.begin(), d.rec.query.end());
+      targets.insert(targets.end(), d.rec.target.begin(), d.rec.target.end());
+      ++st.written;
+    } else {
+      queries.resize(queries.size() + query_floats, 0.f);
+      targets.resize(targets.size() + target_floats, 0.f);
+      ++st.skipped;
+    }
+    const uint64_t count = targets.size() / target_floats;
+    if (count == rps || i + 1 == end) {
+      ShardHeader h = proto;
+      h.first_record = shards.size() * rps;
+      h.count = static_cast<uint32_t>(count);
+      h.query_offset = shard_query_offset();
+      h.target_offset = shard_target_offset(count, P, proto.input_size);
+      const size_t query_bytes = queries.size() * sizeof(float);
+      const size_t pad = static_cast<size_t>(h.target_offset - h.query_offset) - query_bytes;
+      ok = write_file(out_dir + "/" + shard_name(shards.size()),
+                      {{&h, sizeof(h)}, {queries.data(), query_bytes}, {kPad, pad},
+                       {targets.data(), targets.size() * sizeof(float)}});
+      if (ok) {
+        shards.push_back({h.first_record, h.count});
+        ok = write_manifest(out_dir, proto, cfg.records_per_shard, shards);
+      }
+      queries.clear();
+      targets.clear();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    stop = true;
+  }
+  can_claim.notify_all();
+  for (auto& t : workers) t.join();
+  if (ok && start == end) ok = write_manifest(out_dir, proto, cfg.records_per_shard, shards);
+  st.shards = shards.size();
+  if (stats) *stats = st;
+  return ok || fail(error, "cannot write to " + out_dir);
+}
+
+}  // namespace quasar
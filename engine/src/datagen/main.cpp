@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "quasar/bucketing/bucket_store.h"
+#include "quasar/datagen/datagen.h"
+
+// Usage:
+//   quasar_datagen --out DIR --records N [--k K] [--seed S] [--shard-records N]
+//                  [--threads N] [--max-pending N] [--max-s2pr X]
+//                  [--buckets STORE] [--bucket-version V]
+// Writes heads-up river (query, target) records to DIR as fixed-size shards
+// plus manifest.json (quasar/datagen/datagen.h). Rerunning with the same
+// arguments resumes after the complete shards already in DIR; a larger
+// --records extends the dataset.
+int main(int argc, char** argv) {
+  quasar::DatagenConfig cfg;
+  std::string out_dir, store_path;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--out" && has_value) {
+      out_dir = argv[++i];
+    } else if (arg == "--records" && has_value) {
+      cfg.num_records = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--k" && has_value) {
+      cfg.K = std::atoi(argv[++i]);
+    } else if (arg == "--seed" && has_value) {
+      cfg.seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--shard-records" && has_value) {
+      cfg.records_per_shard = static_cast<uint32_t>(std::max(1L, std::atol(argv[++i])));
+    } else if (arg == "--threads" && has_value) {
+      cfg.threads = std::atoi(argv[++i]);
+    } else if (arg == "--max-pending" && has_value) {
+      cfg.max_pending = static_cast<size_t>(std::max(0L, std::atol(argv[++i])));
+    } else if (arg == "--max-s2pr" && has_value) {
+      cfg.max_s2pr = std::atof(argv[++i]);
+    } else if (arg == "--buckets" && has_value) {
+      store_path = argv[++i];
+    } else if (arg == "--bucket-version" && has_value) {
+      cfg.bucket_version = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else {
+      std::fprintf(stderr, "unknown argument: %s\n", arg.c_str());
+      return 2;
+    }
+  }
+  if (out_dir.empty() || cfg.num_records == 0 || cfg.K <= 0) {
+    std::fprintf(stderr,
+                 "usage: quasar_datagen --out DIR --records N [--k K] [--seed S] [--shard-records N] "
+                 "[--threads N] [--max-pending N] [--max-s2pr X] [--buckets STORE] [--bucket-version V]\n");
+    return 2;
+  }
+  std::unique_ptr<quasar::BucketStore> store;
+  if (!store_path.empty()) {
+    store = quasar::BucketStore::open(store_path);
+    if (!store) {
+      std::fprintf(stderr, "quasar_datagen: not a readable bucket store: %s\n", store_path.c_str());
+      return 1;
+    }
+    cfg.buckets = store.get();
+  }
+
+  quasar::DatagenStats st;
+  std::string error;
+  if (!quasar::run_datagen(cfg, out_dir, &st, &error)) {
+    std::fprintf(stderr, "quasar_datagen: %s\n", error.c_str());
+    return 1;
+  }
+  std::fprintf(stderr, "resumed=%llu written=%llu skipped=%llu shards=%zu\n",
+               static_cast<unsigned long long>(st.resumed), static_cast<unsigned long long>(st.written),
+               static_cast<unsigned long long>(st.skipped), st.shards);
+  return 0;
+}
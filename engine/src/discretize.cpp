@@ -5,51 +5,117 @@
 
 namespace quasar {
 
-static inline double clamp(double x, double lo, double hi) {
-  return std::max(lo, std::min(hi, x));
+namespace {
+
+struct PotInfo {
+  Chips pot_now = 0;
+  Chips max_bet = 0;
+  Chips to_call = 0;  // for player_to_act
+};
+
+PotInfo pot_info(const PublicState& s) {
+  PotInfo r;
+  for (double c : s.committed_total) r.pot_now += to_chips(c);
+  for (double c : s.committed_on_street) r.max_bet = std::max(r.max_bet, to_chips(c));
+  const int p = s.player_to_act;
+  const Chips me = (p >= 0 && p < static_cast<int>(s.committed_on_street.size())) ? to_chips(s.committed_on_street[p]) : 0;
+  r.to_call = std::max<Chips>(0, r.max_bet - me);
+  return r;
 }
 
-std::vector<Action> discretize_actions(const PublicState& s,
-                                       const LegalActionSummary& la,
-                                       const DiscretizationConfig& cfg) {
-  std::vector<Action> out;
-  const double pot_now = s.pot_total();
-  auto unique_push = [&](ActionType t, double amt) {
-    for (const auto& a : out) {
-      if (a.type == t && std::fabs(a.amount - amt) < 1e-9) return;
-    }
-    out.push_back({t, amt});
-  };
+PotInfo pot_info(const CompactPublicState& s) {
+  PotInfo r;
+  r.pot_now = s.pot;
+  r.max_bet = s.current_bet;
+  const int p = s.player_to_act;
+  const Chips me = (p >= 0 && p < s.num_players) ? s.committed_on_street[p] : 0;
+  r.to_call = std::max<Chips>(0, r.max_bet - me);
+  return r;
+}
 
-  if (la.bet_bounds) {
-    const double lo = la.bet_bounds->min_to;
-    const double hi = la.bet_bounds->max_to;
-    if (cfg.include_min) unique_push(ActionType::kBet, lo);
-    for (double f : cfg.pot_fracs) {
-      double to = clamp(f * pot_now, lo, hi);
-      unique_push(ActionType::kBet, to);
-    }
-    if (cfg.include_all_in && hi > lo + 1e-9) unique_push(ActionType::kAllIn, hi);
+// Emits candidates in the historical order; `push` deduplicates.
+template <typename Push>
+void discretize_core(const PotInfo& pi,
+                     const std::optional<ChipRaiseBounds>& bet,
+                     const std::optional<ChipRaiseBounds>& raise,
+                     const DiscretizationConfig& cfg,
+                     Push push) {
+  if (bet) {
+    const Chips lo = bet->min_to;
+    const Chips hi = bet->max_to;
+    if (cfg.include_min) push(ActionType::kBet, lo);
+    for (double f : cfg.pot_fracs) push(ActionType::kBet, std::clamp(chips_fraction(f, pi.pot_now), lo, hi));
+    if (cfg.include_all_in && hi > lo) push(ActionType::kAllIn, hi);
   }
-  if (la.raise_bounds) {
-    const double lo = la.raise_bounds->min_to;
-    const double hi = la.raise_bounds->max_to;
-    if (cfg.include_min) unique_push(ActionType::kRaise, lo);
-    if (cfg.include_pot_raise) {
-      // pot raise target was: current_bet + pot_after_call
-      const double max_bet = s.current_bet_to_call();
-      const double pot_raise_to = clamp(max_bet + pot_after_call(s, s.player_to_act), lo, hi);
-      unique_push(ActionType::kRaise, pot_raise_to);
-    }
+  if (raise) {
+    const Chips lo = raise->min_to;
+    const Chips hi = raise->max_to;
+    const Chips pot_after_call = pi.pot_now + pi.to_call;
+    if (cfg.include_min) push(ActionType::kRaise, lo);
+    // pot raise target: current_bet + pot_after_call
+    if (cfg.include_pot_raise) push(ActionType::kRaise, std::clamp(pi.max_bet + pot_after_call, lo, hi));
     for (double f : cfg.pot_fracs) {
-      const double max_bet = s.current_bet_to_call();
-      double to = clamp(max_bet + f * pot_after_call(s, s.player_to_act), lo, hi);
-      unique_push(ActionType::kRaise, to);
+      push(ActionType::kRaise, std::clamp(pi.max_bet + chips_fraction(f, pot_after_call), lo, hi));
     }
-    if (cfg.include_all_in && hi > lo + 1e-9) unique_push(ActionType::kAllIn, hi);
+    if (cfg.include_all_in && hi > lo) push(ActionType::kAllIn, hi);
   }
+}
+
+std::optional<ChipRaiseBounds> bounds_to_chips(const std::optional<RaiseBounds>& b) {
+  if (!b) return std::nullopt;
+  return ChipRaiseBounds{to_chips(b->min_to), to_chips(b->max_to)};
+}
+
+template <typename State>
+void discretize_chips_impl(const State& s, const ChipLegalSummary& la,
+                           const DiscretizationConfig& cfg, std::vector<ChipAction>& out) {
+  out.clear();
+  discretize_core(pot_info(s), la.bet_bounds, la.raise_bounds, cfg, [&](ActionType t, Chips amt) {
+    for (const auto& a : out) {
+      if (a.type == t && a.amount == amt) return;
+    }
+    out.push_back({t, amt});
+  });
+}
+
+}  // namespace
+
+std::vector<Action> discretize_actions(const PublicState& s,
+                                       const LegalActionSummary& la,
+                                       const DiscretizationConfig& cfg) {
+  std::vector<Action> out;
+  discretize_actions(s, la, cfg, out);
   return out;
 }
 
-}  // namespace quasar
+void discretize_actions(const PublicState& s,
+                        const LegalActionSummary& la,
+                        const DiscretizationConfig& cfg,
+                        std::vector<Action>& out) {
+  out.clear();
+  // from_chips is injective, so exact double comparison is exact chip dedup.
+  discretize_core(pot_info(s), bounds_to_chips(la.bet_bounds), bounds_to_chips(la.raise_bounds), cfg,
+                  [&](ActionType t, Chips amt) {
+                    const double v = from_chips(amt);
+                    for (const auto& a : out) {
+                      if (a.type == t && a.amount == v) return;
+                    }
+                    out.push_back({t, v});
+                  });
+}
+
+void discretize_actions_chips(const PublicState& s,
+                              const ChipLegalSummary& la,
+                              const DiscretizationConfig& cfg,
+                              std::vector<ChipAction>& out) {
+  discretize_chips_impl(s, la, cfg, out);
+}
+
+void discretize_actions_chips(const CompactPublicState& s,
+                              const ChipLegalSummary& la,
+                              const DiscretizationConfig& cfg,
+                              std::vector<ChipAction>& out) {
+  discretize_chips_impl(s, la, cfg, out);
+}
 
+}  // namespace quasar
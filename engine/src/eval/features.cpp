@@ -0,0 +1,266 @@
+#include "quasar/eval/features.h"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <vector>
+
+#include "quasar/eval/hand_index.h"
+#include "quasar/eval/river.h"
+#include "quasar/util/thread_pool.h"
+
+namespace quasar {
+
+namespace {
+
+// Opponent hands that share no card with the board or the hero: C(43, 4).
+constexpr uint32_t kOpponents = 123410;
+
+// Order-preserving 24-bit form of a river key (category and five ranks).
+inline uint32_t compress_key(uint64_t k) { return static_cast<uint32_t>(((k >> 60) << 20) | (k & 0xFFFFF)); }
+
+inline uint32_t pair_index(int a, int b) { return binom52(b, 2) + a; }  // a < b
+inline uint32_t triple_index(int a, int b, int c) { return binom52(c, 3) + binom52(b, 2) + a; }  // a < b < c
+
+// Integer sums per hand index, so results do not depend on how runouts are
+// split across workers.
+struct Accumulator {
+  std::vector<uint64_t> sum;   // sum over rivers of 2 * beaten + tied
+  std::vector<uint64_t> sum2;  // sum of its squares
+  std::vector<uint32_t> nuts;  // rivers on which no opponent hand is better
+  Accumulator() : sum(kNumPloHands, 0), sum2(kNumPloHands, 0), nuts(kNumPloHands, 0) {}
+};
+
+// Per-worker buffers reused across rivers.
+struct RiverScratch {
+  std::vector<std::array<int, 4>> hands;  // ascending cards
+  std::vector<uint32_t> index;            // plo_hand_index of each hand
+  std::vector<uint64_t> order, tmp;       // (key24 << 32) | local hand
+  std::vector<uint32_t> beaten;
+  std::vector<uint32_t> c1, c2, c3;       // counted hands containing a card, pair, triple
+  RiverScratch() : c1(52), c2(binom52(52, 2)), c3(binom52(52, 3)) {}
+};
+
+// Counted hands sharing no card with h, by inclusion-exclusion over the
+// subsets of h. `self` is 1 when h itself has been counted (its four-card
+// subset term).
+inline uint32_t disjoint_count(const std::array<int, 4>& h, uint32_t total, const RiverScratch& s, int self) {
+  int64_t v = total;
+  for (int i = 0; i < 4; ++i) v -= s.c1[h[i]];
+  for (int i = 0; i < 4; ++i) {
+    for (int j = i + 1; j < 4; ++j) v += s.c2[pair_index(h[i], h[j])];
+  }
+  v -= s.c3[triple_index(h[0], h[1], h[2])] + s.c3[triple_index(h[0], h[1], h[3])] +
+       s.c3[triple_index(h[0], h[2], h[3])] + s.c3[triple_index(h[1], h[2], h[3])];
+  return static_cast<uint32_t>(v + self);
+}
+
+inline void count_hand(const std::array<int, 4>& h, RiverScratch& s) {
+  for (int i = 0; i < 4; ++i) ++s.c1[h[i]];
+  for (int i = 0; i < 4; ++i) {
+    for (int j = i + 1; j < 4; ++j) ++s.c2[pair_index(h[i], h[j])];
+  }
+  ++s.c3[triple_index(h[0], h[1], h[2])];
+  ++s.c3[triple_index(h[0], h[1], h[3])];
+  ++s.c3[triple_index(h[0], h[2], h[3])];
+  ++s.c3[triple_index(h[1], h[2], h[3])];
+}
+
+// Scores every hand that avoids a full board against every opponent hand in
+// one pass over the hands sorted by key.
+void score_river(const std::array<int, 5>& board, RiverScratch& s, Accumulator& acc) {
+  uint64_t bmask = 0;
+  for (int c : board) bmask |= uint64_t{1} << c;
+  int deck[52];
+  int nd = 0;
+  for (int c = 0; c < 52; ++c) {
+    if (!(bmask >> c & 1)) deck[nd++] = c;
+  }
+  s.hands.clear();
+  s.index.clear();
+  for (int d = 3; d < nd; ++d) {
+    for (int c = 2; c < d; ++c) {
+      for (int b = 1; b < c; ++b) {
+        for (int a = 0; a < b; ++a) {
+          s.hands.push_back({deck[a], deck[b], deck[c], deck[d]});
+          s.index.push_back(plo_hand_index_sorted(deck[a], deck[b], deck[c], deck[d]));
+        }
+      }
+    }
+  }
+  const size_t m = s.hands.size();
+  const RiverBoardEvaluator ev(board);
+  s.order.resize(m);
+  s.tmp.resize(m);
+  for (size_t i = 0; i < m; ++i) {
+    const int32_t h[4] = {s.hands[i][0], s.hands[i][1], s.hands[i][2], s.hands[i][3]};
+    s.order[i] = static_cast<uint64_t>(compress_key(ev.key(h))) << 32 | i;
+  }
+  // LSD radix sort on the 24 key bits.
+  for (int shift = 32; shift < 56; shift += 8) {
+    size_t count[257] = {0};
+    for (uint64_t v : s.order) ++count[(v >> shift & 0xFF) + 1];
+    for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+    for (uint64_t v : s.order) s.tmp[count[v >> shift & 0xFF]++] = v;
+    s.order.swap(s.tmp);
+  }
+
+  std::fill(s.c1.begin(), s.c1.end(), 0);
+  std::fill(s.c2.begin(), s.c2.end(), 0);
+  std::fill(s.c3.begin(), s.c3.end(), 0);
+  s.beaten.resize(m);
+  uint32_t total = 0;
+  for (size_t g = 0; g < m;) {
+    size_t e = g + 1;
+    while (e < m && (s.order[e] >> 32) == (s.order[g] >> 32)) ++e;
+    for (size_t q = g; q < e; ++q) {
+      const uint32_t i = static_cast<uint32_t>(s.order[q]);
+      s.beaten[i] = disjoint_count(s.hands[i], total, s, 0);
+    }
+    for (size_t q = g; q < e; ++q) count_hand(s.hands[static_cast<uint32_t>(s.order[q])], s);
+    total += static_cast<uint32_t>(e - g);
+    for (size_t q = g; q < e; ++q) {
+      const uint32_t i = static_cast<uint32_t>(s.order[q]);
+      const uint32_t not_worse = disjoint_count(s.hands[i], total, s, 1);  // beaten + tied
+      const uint64_t num = static_cast<uint64_t>(s.beaten[i]) + not_worse;
+      const uint32_t h = s.index[i];
+      acc.sum[h] += num;
+      acc.sum2[h] += num * num;
+      acc.nuts[h] += not_worse == kOpponents ? 1 : 0;
+    }
+    g = e;
+  }
+}
+
+// True if two distinct hole ranks plus three board ranks form a straight.
+bool makes_straight(int hole_ranks, int board_ranks) {
+  for (int hi = 3; hi <= 12; ++hi) {
+    const int w = hi == 3 ? 0x100F : 0x1F << (hi - 4);
+    const int missing = w & ~board_ranks;
+    if (__builtin_popcount(missing) > 2 || (missing & ~hole_ranks)) continue;
+    if (__builtin_popcount(hole_ranks & w) >= 2) return true;
+  }
+  return false;
+}
+
+constexpr int kTriples[10][3] = {{0, 1, 2}, {0, 1, 3}, {0, 1, 4}, {0, 2, 3}, {0, 2, 4},
+                                 {0, 3, 4}, {1, 2, 3}, {1, 2, 4}, {1, 3, 4}, {2, 3, 4}};
+
+}  // namespace
+
+bool plo_hand_features(const int32_t* board, int board_len, const int32_t* hands, size_t n, float* out,
+                       ThreadPool* pool) {
+  if (board_len < 3 || board_len > 5) return false;
+  uint64_t bmask = 0;
+  for (int k = 0; k < board_len; ++k) {
+    if (board[k] < 0 || board[k] >= 52 || (bmask >> board[k] & 1)) return false;
+    bmask |= uint64_t{1} << board[k];
+  }
+  ThreadPool& tp = pool ? *pool : default_thread_pool();
+
+  // Runouts completing the board to a river.
+  std::vector<std::array<int, 5>> rivers;
+  std::array<int, 5> full{};
+  for (int k = 0; k < board_len; ++k) full[k] = board[k];
+  if (board_len == 5) {
+    rivers.push_back(full);
+  } else {
+    for (int r = 0; r < 52; ++r) {
+      if (bmask >> r & 1) continue;
+      full[board_len] = r;
+      if (board_len == 4) {
+        rivers.push_back(full);
+        continue;
+      }
+      for (int t = r + 1; t < 52; ++t) {
+        if (bmask >> t & 1) continue;
+        full[4] = t;
+        rivers.push_back(full);
+      }
+    }
+  }
+  // Every hand that avoids the board sees the same number of runouts.
+  const int unseen = 52 - board_len - 4;
+  const double per_hand = board_len == 5 ? 1.0 : board_len == 4 ? unseen : unseen * (unseen - 1) / 2.0;
+
+  const size_t slices = std::min(rivers.size(), static_cast<size_t>(tp.size()) + 1);
+  std::vector<Accumulator> acc(slices);
+  auto run_slice = [&](size_t sl) {
+    RiverScratch scratch;
+    const size_t r0 = rivers.size() * sl / slices, r1 = rivers.size() * (sl + 1) / slices;
+    for (size_t r = r0; r < r1; ++r) score_river(rivers[r], scratch, acc[sl]);
+  };
+  tp.parallel_for(slices, run_slice, 1);
+  Accumulator& total = acc[0];
+  for (size_t sl = 1; sl < slices; ++sl) {
+    for (uint32_t h = 0; h < kNumPloHands; ++h) {
+      total.sum[h] += acc[sl].sum[h];
+      total.sum2[h] += acc[sl].sum2[h];
+      total.nuts[h] += acc[sl].nuts[h];
+    }
+  }
+
+  int board_suits[4] = {0, 0, 0, 0};
+  int board_ranks = 0;
+  for (int k = 0; k < board_len; ++k) {
+    ++board_suits[card_suit(board[k])];
+    board_ranks |= 1 << card_rank(board[k]);
+  }
+  std::optional<RiverBoardEvaluator> river_ev;
+  if (board_len == 5) river_ev.emplace(rivers[0]);
+  const double scale = 2.0 * kOpponents;
+
+  auto fill_row = [&](size_t i) {
+    const int32_t* h = hands + i * 4;
+    float* row = out + i * kHandFeatureDim;
+    std::fill(row, row + kHandFeatureDim, 0.f);
+    uint64_t m = 0;
+    for (int k = 0; k < 4; ++k) {
+      if (h[k] < 0 || h[k] >= 52 || (m >> h[k] & 1)) return;
+      m |= uint64_t{1} << h[k];
+    }
+    if (m & bmask) return;
+    const uint32_t idx = plo_hand_index(h);
+    row[kFeatEhs] = static_cast<float>(total.sum[idx] / (scale * per_hand));
+    row[kFeatEhs2] = static_cast<float>(static_cast<double>(total.sum2[idx]) / (scale * scale * per_hand));
+    row[kFeatNut] = static_cast<float>(total.nuts[idx] / per_hand);
+
+    uint64_t key = 0;
+    if (river_ev) {
+      key = river_ev->key(h);
+    } else {
+      for (const auto& t : kTriples) {
+        if (t[2] >= board_len) continue;
+        for (int a = 0; a < 4; ++a) {
+          for (int b = a + 1; b < 4; ++b) {
+            key = std::max(key, eval_5card({h[a], h[b], board[t[0]], board[t[1]], board[t[2]]}));
+          }
+        }
+      }
+    }
+    row[kFeatCategory] = static_cast<float>(key >> 60) / 8.f;
+
+    if (board_len < 5) {
+      int hole_suits[4] = {0, 0, 0, 0};
+      int hole_ranks = 0;
+      for (int k = 0; k < 4; ++k) {
+        ++hole_suits[card_suit(h[k])];
+        hole_ranks |= 1 << card_rank(h[k]);
+      }
+      for (int s = 0; s < 4; ++s) {
+        if (board_suits[s] == 2 && hole_suits[s] >= 2) row[kFeatFlushDraw] = 1.f;
+      }
+      if (!makes_straight(hole_ranks, board_ranks)) {
+        int outs = 0;
+        for (int r = 0; r < 13; ++r) {
+          if (!(board_ranks >> r & 1) && makes_straight(hole_ranks, board_ranks | 1 << r)) ++outs;
+        }
+        row[kFeatStraightOuts] = outs / 13.f;
+      }
+    }
+  };
+  tp.parallel_for(n, fill_row, 1024);
+  return true;
+}
+
+}  // namespace quasar
@@ -0,0 +1,405 @@
+#include "quasar/eval/preflop_equity.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include "quasar/eval/hand_index.h"
+#include "quasar/eval/river.h"
+#include "quasar/util/hash.h"
+#include "quasar/util/thread_pool.h"
+
+namespace quasar {
+
+namespace {
+
+constexpr uint64_t kClassesOffset = sizeof(PreflopEquityHeader);
+constexpr double kEquityScale = 65534.0;
+
+inline uint64_t align64(uint64_t x) { return (x + 63) / 64 * 64; }
+inline uint64_t tri_size(uint64_t n) { return n * (n + 1) / 2; }
+
+// The 24 suit permutations.
+struct SuitPerms {
+  std::array<std::array<int, 4>, 24> p{};
+  SuitPerms() {
+    std::array<int, 4> s{0, 1, 2, 3};
+    for (auto& row : p) {
+      row = s;
+      std::next_permutation(s.begin(), s.end());
+    }
+  }
+};
+
+const SuitPerms& suit_perms() {
+  static const SuitPerms perms;
+  return perms;
+}
+
+inline void mask_cards(uint64_t mask, int32_t* cards) {
+  int n = 0;
+  for (int c = 0; c < 52; ++c) {
+    if (mask >> c & 1) cards[n++] = c;
+  }
+}
+
+// Row of `mask` in the ascending class list, or -1.
+inline int find_class(const std::vector<uint64_t>& classes, uint64_t mask) {
+  const auto it = std::lower_bound(classes.begin(), classes.end(), mask);
+  return it != classes.end() && *it == mask ? static_cast<int>(it - classes.begin()) : -1;
+}
+
+inline uint8_t encode_overlap(uint32_t disjoint, uint32_t members) {
+  if (disjoint == 0) return 0;
+  const long v = std::lround(255.0 * disjoint / members);
+  return static_cast<uint8_t>(std::max(1L, v));
+}
+
+// Members of each tabulated class, grouped in class order.
+struct ClassMembers {
+  std::vector<uint32_t> start;                // [n + 1]
+  std::vector<uint64_t> mask;                 // per member
+  std::vector<std::array<int32_t, 4>> cards;  // per member
+};
+
+ClassMembers group_members(const std::vector<uint64_t>& classes) {
+  std::vector<int32_t> row(kNumPloHands);
+  std::vector<uint32_t> count(classes.size() + 1, 0);
+  for (uint32_t h = 0; h < kNumPloHands; ++h) {
+    int32_t c[4];
+    plo_hand_from_index(h, c);
+    row[h] = find_class(classes, canonical_hand(c));
+    if (row[h] >= 0) ++count[row[h] + 1];
+  }
+  ClassMembers m;
+  m.start.assign(classes.size() + 1, 0);
+  for (size_t i = 0; i < classes.size(); ++i) m.start[i + 1] = m.start[i] + count[i + 1];
+  m.mask.resize(m.start.back());
+  m.cards.resize(m.start.back());
+  std::vector<uint32_t> next(m.start.begin(), m.start.end() - 1);
+  for (uint32_t h = 0; h < kNumPloHands; ++h) {
+    if (row[h] < 0) continue;
+    const uint32_t k = next[row[h]]++;
+    plo_hand_from_index(h, m.cards[k].data());
+    m.mask[k] = 0;
+    for (int32_t c : m.cards[k]) m.mask[k] |= uint64_t{1} << c;
+  }
+  return m;
+}
+
+// Row i of both triangles (columns j >= i).
+void build_row(const std::vector<uint64_t>& classes, const ClassMembers& m, size_t i, uint32_t boards,
+               uint64_t seed, uint16_t* equity, uint8_t* overlap) {
+  const size_t n = classes.size();
+  const uint64_t amask = classes[i];
+  int32_t a[4];
+  mask_cards(amask, a);
+  std::vector<uint64_t> points(n - i, 0), seen(n - i, 0);  // 2 * wins + ties, scored matchups
+  int deck[48];
+  int nd = 0;
+  for (int c = 0; c < 52; ++c) {
+    if (!(amask >> c & 1)) deck[nd++] = c;
+  }
+  std::mt19937_64 rng(hash_combine(mix64(seed), amask));
+  for (uint32_t b = 0; b < boards; ++b) {
+    std::array<int, 5> board{};
+    uint64_t bmask = 0;
+    for (int k = 0; k < 5; ++k) {
+      std::swap(deck[k], deck[k + rng() % (nd - k)]);
+      board[k] = deck[k];
+      bmask |= uint64_t{1} << deck[k];
+    }
+    const RiverBoardEvaluator ev(board);
+    const uint64_t ka = ev.key(a);
+    const uint64_t dead = amask | bmask;
+    for (size_t j = i + 1; j < n; ++j) {
+      uint64_t pts = 0, cnt = 0;
+      for (uint32_t k = m.start[j]; k < m.start[j + 1]; ++k) {
+        if (m.mask[k] & dead) continue;
+        const uint64_t kb = ev.key(m.cards[k].data());
+        pts += ka > kb ? 2 : ka == kb ? 1 : 0;
+        ++cnt;
+      }
+      points[j - i] += pts;
+      seen[j - i] += cnt;
+    }
+  }
+  for (size_t j = i; j < n; ++j) {
+    uint32_t disjoint = 0;
+    for (uint32_t k = m.start[j]; k < m.start[j + 1]; ++k) disjoint += (m.mask[k] & amask) == 0;
+    overlap[j - i] = encode_overlap(disjoint, m.start[j + 1] - m.start[j]);
+    // The diagonal is 1/2 by symmetry; pairs never scored keep it too.
+    const double eq = j > i && seen[j - i] > 0 ? points[j - i] / (2.0 * seen[j - i]) : 0.5;
+    equity[j - i] = disjoint ? static_cast<uint16_t>(std::lround(eq * kEquityScale)) : 0;
+  }
+}
+
+bool fail(std::string* error, const std::string& msg) {
+  if (error) *error = msg;
+  return false;
+}
+
+}  // namespace
+
+uint64_t canonical_hand(const int32_t* hand) {
+  uint64_t seen = 0;
+  for (int k = 0; k < 4; ++k) {
+    if (hand[k] < 0 || hand[k] >= 52 || (seen >> hand[k] & 1)) return 0;
+    seen |= uint64_t{1} << hand[k];
+  }
+  uint64_t best = ~uint64_t{0};
+  for (const auto& p : suit_perms().p) {
+    uint64_t m = 0;
+    for (int k = 0; k < 4; ++k) m |= uint64_t{1} << (p[hand[k] / 13] * 13 + hand[k] % 13);
+    best = std::min(best, m);
+  }
+  return best;
+}
+
+std::vector<uint64_t> preflop_classes() {
+  std::vector<uint64_t> out;
+  out.reserve(kNumPreflopClasses);
+  for (uint32_t h = 0; h < kNumPloHands; ++h) {
+    int32_t c[4];
+    plo_hand_from_index(h, c);
+    const uint64_t m = canonical_hand(c);
+    if (m == (uint64_t{1} << c[0] | uint64_t{1} << c[1] | uint64_t{1} << c[2] | uint64_t{1} << c[3])) {
+      out.push_back(m);  // each class once, at its canonical member
+    }
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+// ---- builder --------------------------------------------------------------
+
+bool build_preflop_equity(const PreflopEquityConfig& cfg, const std::string& path, std::string* error,
+                          ThreadPool* pool) {
+  std::vector<uint64_t> classes;
+  if (cfg.classes.empty()) {
+    classes = preflop_classes();
+  } else {
+    for (uint64_t mask : cfg.classes) {
+      int32_t c[4];
+      if (__builtin_popcountll(mask) != 4 || (mask >> 52) != 0) return fail(error, "class is not a 4-card hand mask");
+      mask_cards(mask, c);
+      classes.push_back(canonical_hand(c));
+    }
+    std::sort(classes.begin(), classes.end());
+    classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+  }
+  if (cfg.boards == 0) return fail(error, "boards must be positive");
+  const size_t n = classes.size();
+  const ClassMembers members = group_members(classes);
+
+  PreflopEquityHeader h{};
+  std::memcpy(h.magic, kPreflopEquityMagic, sizeof(h.magic));
+  h.format = kPreflopEquityFormat;
+  h.num_classes = static_cast<uint32_t>(n);
+  h.boards = cfg.boards;
+  h.seed = cfg.seed;
+  h.classes_offset = kClassesOffset;
+  h.equity_offset = align64(kClassesOffset + n * sizeof(uint64_t));
+  h.overlap_offset = align64(h.equity_offset + tri_size(n) * sizeof(uint16_t));
+
+  const std::string tmp = path + ".tmp";
+  FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (!f) return fail(error, "cannot write " + tmp);
+  const unsigned char zeros[64] = {0};
+  // Zero header until the end: an unfinished file fails the magic check.
+  bool ok = std::fwrite(zeros, 1, sizeof(h), f) == sizeof(h) &&
+            std::fwrite(classes.data(), sizeof(uint64_t), n, f) == n &&
+            std::fwrite(zeros, 1, h.equity_offset - kClassesOffset - n * sizeof(uint64_t), f) ==
+                h.equity_offset - kClassesOffset - n * sizeof(uint64_t);
+
+  // Equity rows are streamed in chunks; the overlap triangle (one byte per
+  // pair) is kept and written after them.
+  ThreadPool& tp = pool ? *pool : default_thread_pool();
+  std::vector<uint8_t> overlap(tri_size(n));
+  std::vector<uint16_t> equity;
+  constexpr size_t kChunkRows = 64;
+  for (size_t r0 = 0; ok && r0 < n; r0 += kChunkRows) {
+    const size_t r1 = std::min(n, r0 + kChunkRows);
+    const uint64_t first = tri_size(n) - tri_size(n - r0);  // entries before row r0
+    equity.assign(tri_size(n - r0) - tri_size(n - r1), 0);
+    tp.parallel_for(r1 - r0, [&](size_t k) {
+      const size_t i = r0 + k;
+      const uint64_t at = tri_size(n) - tri_size(n - i);
+      build_row(classes, members, i, cfg.boards, cfg.seed, equity.data() + (at - first), overlap.data() + at);
+    });
+    ok = std::fwrite(equity.data(), sizeof(uint16_t), equity.size(), f) == equity.size();
+  }
+  const uint64_t eq_end = h.equity_offset + tri_size(n) * sizeof(uint16_t);
+  ok = ok && std::fwrite(zeros, 1, h.overlap_offset - eq_end, f) == h.overlap_offset - eq_end &&
+       std::fwrite(overlap.data(), 1, overlap.size(), f) == overlap.size() && std::fseek(f, 0, SEEK_SET) == 0 &&
+       std::fwrite(&h, sizeof(h), 1, f) == 1;
+  ok = std::fclose(f) == 0 && ok;
+  if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    return fail(error, "I/O error writing " + path);
+  }
+  return true;
+}
+
+// ---- reader ---------------------------------------------------------------
+
+std::unique_ptr<PreflopEquityTable> PreflopEquityTable::open(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return nullptr;
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(PreflopEquityHeader)) {
+    ::close(fd);
+    return nullptr;
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return nullptr;
+  std::unique_ptr<PreflopEquityTable> t(new PreflopEquityTable());
+  t->base_ = static_cast<const unsigned char*>(p);
+  t->size_ = size;
+  PreflopEquityHeader& h = t->header_;
+  std::memcpy(&h, t->base_, sizeof(h));
+  const uint64_t n = h.num_classes;
+  if (std::memcmp(h.magic, kPreflopEquityMagic, sizeof(h.magic)) != 0 || h.format != kPreflopEquityFormat ||
+      n == 0 || n > kNumPreflopClasses || h.classes_offset != kClassesOffset ||
+      h.equity_offset != align64(kClassesOffset + n * sizeof(uint64_t)) ||
+      h.overlap_offset != align64(h.equity_offset + tri_size(n) * sizeof(uint16_t)) ||
+      size != h.overlap_offset + tri_size(n)) {
+    return nullptr;
+  }
+  t->classes_ = reinterpret_cast<const uint64_t*>(t->base_ + h.classes_offset);
+  t->equity_ = reinterpret_cast<const uint16_t*>(t->base_ + h.equity_offset);
+  t->overlap_ = t->base_ + h.overlap_offset;
+  for (uint64_t i = 0; i < n; ++i) {
+    int32_t c[4];
+    if (__builtin_popcountll(t->classes_[i]) != 4 || (t->classes_[i] >> 52) != 0) return nullptr;
+    mask_cards(t->classes_[i], c);
+    if (canonical_hand(c) != t->classes_[i] || (i > 0 && t->classes_[i - 1] >= t->classes_[i])) return nullptr;
+  }
+  const std::vector<uint64_t> classes(t->classes_, t->classes_ + n);
+  t->row_of_hand_.resize(kNumPloHands);
+  for (uint32_t hi = 0; hi < kNumPloHands; ++hi) {
+    int32_t c[4];
+    plo_hand_from_index(hi, c);
+    t->row_of_hand_[hi] = find_class(classes, canonical_hand(c));
+  }
+  return t;
+}
+
+PreflopEquityTable::~PreflopEquityTable() {
+  if (base_) ::munmap(const_cast<unsigned char*>(base_), size_);
+}
+
+size_t PreflopEquityTable::tri(size_t i, size_t j) const {
+  const size_t n = header_.num_classes;
+  return tri_size(n) - tri_size(n - i) + (j - i);
+}
+
+int PreflopEquityTable::class_of(const int32_t* hand) const {
+  for (int k = 0; k < 4; ++k) {
+    if (hand[k] < 0 || hand[k] >= 52) return -1;
+  }
+  if (canonical_hand(hand) == 0) return -1;
+  return row_of_hand_[plo_hand_index(hand)];
+}
+
+float PreflopEquityTable::class_equity(size_t i, size_t j) const {
+  const size_t k = i <= j ? tri(i, j) : tri(j, i);
+  if (overlap_[k] == 0) return std::numeric_limits<float>::quiet_NaN();
+  const float e = static_cast<float>(equity_[k] / kEquityScale);
+  return i <= j ? e : 1.0f - e;
+}
+
+float PreflopEquityTable::class_overlap(size_t i, size_t j) const {
+  return overlap_[i <= j ? tri(i, j) : tri(j, i)] / 255.0f;
+}
+
+float PreflopEquityTable::equity(const int32_t* hand, const int32_t* villain) const {
+  const int i = class_of(hand), j = class_of(villain);
+  uint64_t mh = 0, mv = 0;
+  for (int k = 0; k < 4; ++k) {
+    mh |= uint64_t{1} << (hand[k] & 63);
+    mv |= uint64_t{1} << (villain[k] & 63);
+  }
+  if (i < 0 || j < 0 || (mh & mv)) return std::numeric_limits<float>::quiet_NaN();
+  return class_equity(i, j);
+}
+
+void PreflopEquityTable::class_weights(const float* hand_weights, double* out) const {
+  std::fill(out, out + header_.num_classes, 0.0);
+  for (uint32_t h = 0; h < kNumPloHands; ++h) {
+    if (row_of_hand_[h] >= 0 && hand_weights[h] != 0.f) out[row_of_hand_[h]] += hand_weights[h];
+  }
+}
+
+void PreflopEquityTable::class_vs_range(const double* villain, float* out, ThreadPool* pool) const {
+  const size_t n = header_.num_classes;
+  std::vector<uint32_t> cols;
+  for (uint32_t j = 0; j < n; ++j) {
+    if (villain[j] != 0.0) cols.push_back(j);
+  }
+  ThreadPool& tp = pool ? *pool : default_thread_pool();
+  tp.parallel_for(n, [&](size_t i) {
+    double s = 0.0, w = 0.0;
+    for (uint32_t j : cols) {
+      const size_t t = i <= j ? tri(i, j) : tri(j, i);
+      if (overlap_[t] == 0) continue;
+      const double e = equity_[t] / kEquityScale;
+      const double v = villain[j] * overlap_[t];
+      s += v * (i <= j ? e : 1.0 - e);
+      w += v;
+    }
+    out[i] = w > 0.0 ? static_cast<float>(s / w) : std::numeric_limits<float>::quiet_NaN();
+  }, 16);
+}
+
+double PreflopEquityTable::range_vs_range(const float* hero, const float* villain, ThreadPool* pool) const {
+  const size_t n = header_.num_classes;
+  std::vector<double> hw(n), vw(n);
+  class_weights(hero, hw.data());
+  class_weights(villain, vw.data());
+  std::vector<uint32_t> live;  // classes in either range
+  for (size_t i = 0; i < n; ++i) {
+    if (hw[i] != 0.0 || vw[i] != 0.0) live.push_back(static_cast<uint32_t>(i));
+  }
+  // Each unordered class pair is read once from its upper-triangle row, in
+  // both directions, so every row is scanned sequentially; per-row sums are
+  // added in row order, so the result does not depend on the pool.
+  std::vector<double> num(live.size()), den(live.size());
+  ThreadPool& tp = pool ? *pool : default_thread_pool();
+  tp.parallel_for(live.size(), [&](size_t k) {
+    const uint32_t i = live[k];
+    const size_t row = tri(i, i);
+    double s = 0.0, w = 0.0;
+    for (size_t q = k; q < live.size(); ++q) {
+      const uint32_t j = live[q];
+      const size_t t = row + (j - i);
+      if (overlap_[t] == 0) continue;
+      const double e = equity_[t] / kEquityScale;
+      const double fwd = hw[i] * vw[j] * overlap_[t];
+      const double rev = j != i ? hw[j] * vw[i] * overlap_[t] : 0.0;
+      s += fwd * e + rev * (1.0 - e);
+      w += fwd + rev;
+    }
+    num[k] = s;
+    den[k] = w;
+  }, 16);
+  double s = 0.0, w = 0.0;
+  for (size_t k = 0; k < live.size(); ++k) {
+    s += num[k];
+    w += den[k];
+  }
+  return w > 0.0 ? s / w : std::numeric_limits<double>::quiet_NaN();
+}
+
+}  // namespace quasar
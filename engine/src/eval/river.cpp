@@ -3,15 +3,16 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
-#include <vector>
+
+#include "quasar/util/thread_pool.h"
 
 namespace quasar {
 
 static inline uint64_t make_key(int cat, const std::array<int, 5>& ranks_desc) {
-  // cat in [0..8], ranks 0..12 with 12=Ace high
+  // cat in [0..8], ranks 0..12 with 12=Ace high; first rank is most significant
   uint64_t key = static_cast<uint64_t>(cat & 0xF) << 60;
   for (int i = 0; i < 5; ++i) {
-    key |= static_cast<uint64_t>(ranks_desc[i] & 0xF) << (i * 12);
+    key |= static_cast<uint64_t>(ranks_desc[i] & 0xF) << ((4 - i) * 4);
   }
   return key;
 }
@@ -31,35 +32,33 @@ static inline int straight_high_from_mask(int mask) {
 uint64_t eval_5card(const std::array<int, 5>& cards) {
   int rank_counts[13] = {0};
   int suit_counts[4] = {0};
-  int ranks[5];
-  int suits[5];
   int mask = 0;
   for (int i = 0; i < 5; ++i) {
-    ranks[i] = card_rank(cards[i]);
-    suits[i] = card_suit(cards[i]);
-    ++rank_counts[ranks[i]];
-    ++suit_counts[suits[i]];
-    mask |= (1 << ranks[i]);
+    const int r = card_rank(cards[i]);
+    ++rank_counts[r];
+    ++suit_counts[card_suit(cards[i])];
+    mask |= (1 << r);
   }
   bool is_flush = false;
   for (int s = 0; s < 4; ++s) if (suit_counts[s] == 5) { is_flush = true; break; }
   int straight_hi = straight_high_from_mask(mask);
   bool is_straight = (straight_hi >= 0);
 
-  // Collect ranks sorted descending for high-card based categories
-  std::vector<int> rank_list;
-  rank_list.reserve(5);
+  // Ranks sorted descending for high-card based categories
+  int rank_list[5];
+  int nr = 0;
   for (int r = 12; r >= 0; --r) {
-    for (int c = 0; c < rank_counts[r]; ++c) rank_list.push_back(r);
+    for (int c = 0; c < rank_counts[r]; ++c) rank_list[nr++] = r;
   }
 
   // Analyze groups
   int four = -1, three = -1;
-  std::vector<int> pairs;
+  int pairs[2] = {-1, -1};
+  int num_pairs = 0;
   for (int r = 12; r >= 0; --r) {
     if (rank_counts[r] == 4) four = r;
     else if (rank_counts[r] == 3) three = r;
-    else if (rank_counts[r] == 2) pairs.push_back(r);
+    else if (rank_counts[r] == 2) pairs[num_pairs++] = r;
   }
 
   if (is_straight && is_flush) {
@@ -74,7 +73,7 @@ uint64_t eval_5card(const std::array<int, 5>& cards) {
     std::array<int,5> ranks_desc{four,four,four,four,kicker};
     return make_key(7, ranks_desc);
   }
-  if (three >= 0 && !pairs.empty()) {
+  if (three >= 0 && num_pairs > 0) {
     std::array<int,5> ranks_desc{three,three,three,pairs[0],pairs[0]};
     return make_key(6, ranks_desc);
   }
@@ -94,7 +93,7 @@ uint64_t eval_5card(const std::array<int, 5>& cards) {
     std::array<int,5> ranks_desc{three,three,three,k1,k2};
     return make_key(3, ranks_desc);
   }
-  if (pairs.size() >= 2) {
+  if (num_pairs >= 2) {
     int p1 = pairs[0];
     int p2 = pairs[1];
     int kicker=-1;
@@ -102,7 +101,7 @@ uint64_t eval_5card(const std::array<int, 5>& cards) {
     std::array<int,5> ranks_desc{p1,p1,p2,p2,kicker};
     return make_key(2, ranks_desc);
   }
-  if (pairs.size() == 1) {
+  if (num_pairs == 1) {
     int p = pairs[0];
     int k1=-1,k2=-1,k3=-1;
     for (int r : rank_list) if (r != p) {
@@ -139,5 +138,94 @@ int compare_plo_river(const std::array<int, 4>& holeA,
   return 0;
 }
 
-}  // namespace quasar
+namespace {
+
+constexpr int kBoardTriples[10][3] = {{0, 1, 2}, {0, 1, 3}, {0, 1, 4}, {0, 2, 3}, {0, 2, 4},
+                                      {0, 3, 4}, {1, 2, 3}, {1, 2, 4}, {1, 3, 4}, {2, 3, 4}};
+
+// Bitmask of a 4-card hand, or 0 if a card is out of range or repeated.
+inline uint64_t hand_mask(const int32_t* h) {
+  uint64_t m = 0;
+  for (int k = 0; k < 4; ++k) {
+    if (h[k] < 0 || h[k] >= 52) return 0;
+    const uint64_t bit = uint64_t{1} << h[k];
+    if (m & bit) return 0;
+    m |= bit;
+  }
+  return m;
+}
+
+}  // namespace
+
+RiverBoardEvaluator::RiverBoardEvaluator(const std::array<int, 5>& board) {
+  int suit_counts[4] = {0};
+  for (int c : board) {
+    board_mask_ |= uint64_t{1} << c;
+    ++suit_counts[card_suit(c)];
+  }
+  for (int s = 0; s < 4; ++s) {
+    if (suit_counts[s] >= 3) flush_suit_ = s;
+  }
+  // Hole cards of two different suits can never complete a flush, so the
+  // non-flush table depends on ranks alone.
+  for (int r1 = 0; r1 < 13; ++r1) {
+    for (int r2 = r1; r2 < 13; ++r2) {
+      uint64_t best = 0, flush = 0;
+      for (const auto& t : kBoardTriples) {
+        const int b0 = board[t[0]], b1 = board[t[1]], b2 = board[t[2]];
+        best = std::max(best, eval_5card({r1, r2 + 13, b0, b1, b2}));
+        if (r1 != r2 && card_suit(b0) == flush_suit_ && card_suit(b1) == flush_suit_ &&
+            card_suit(b2) == flush_suit_) {
+          flush = std::max(flush, eval_5card({flush_suit_ * 13 + r1, flush_suit_ * 13 + r2, b0, b1, b2}));
+        }
+      }
+      best_[r1 * 13 + r2] = best_[r2 * 13 + r1] = best;
+      flush_best_[r1 * 13 + r2] = flush_best_[r2 * 13 + r1] = flush;
+    }
+  }
+}
+
+uint64_t RiverBoardEvaluator::key(const int32_t* hole) const {
+  uint64_t best = 0;
+  for (int i = 0; i < 4; ++i) {
+    for (int j = i + 1; j < 4; ++j) {
+      const int idx = card_rank(hole[i]) * 13 + card_rank(hole[j]);
+      uint64_t k = best_[idx];
+      if (card_suit(hole[i]) == flush_suit_ && card_suit(hole[j]) == flush_suit_) {
+        k = std::max(k, flush_best_[idx]);
+      }
+      best = std::max(best, k);
+    }
+  }
+  return best;
+}
 
+void plo_river_keys(const std::array<int, 5>& board, const int32_t* hands, size_t n,
+                    uint64_t* keys, ThreadPool* pool) {
+  if (n == 0) return;
+  const RiverBoardEvaluator ev(board);
+  auto eval_hand = [&](size_t i) {
+    const int32_t* h = hands + i * 4;
+    const uint64_t m = hand_mask(h);
+    keys[i] = (m == 0 || (m & ev.board_mask())) ? 0 : ev.key(h);
+  };
+  ThreadPool& p = pool ? *pool : default_thread_pool();
+  p.parallel_for(n, eval_hand, 4096);
+}
+
+void board_collision_mask(const int32_t* board, int board_len, const int32_t* hands, size_t n,
+                          uint8_t* out, ThreadPool* pool) {
+  if (n == 0) return;
+  uint64_t bmask = 0;
+  for (int k = 0; k < board_len; ++k) {
+    if (board[k] >= 0 && board[k] < 52) bmask |= uint64_t{1} << board[k];
+  }
+  auto check_hand = [&](size_t i) {
+    const uint64_t m = hand_mask(hands + i * 4);
+    out[i] = (m == 0 || (m & bmask)) ? 1 : 0;
+  };
+  ThreadPool& p = pool ? *pool : default_thread_pool();
+  p.parallel_for(n, check_hand, 16384);
+}
+
+}  // namespace quasar
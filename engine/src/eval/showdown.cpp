@@ -0,0 +1,140 @@
+#include "quasar/eval/showdown.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "quasar/eval/hand_index.h"
+#include "quasar/eval/river.h"
+
+namespace quasar {
+
+namespace {
+
+// Order-preserving 24-bit form of a river key (category and five ranks).
+inline uint32_t compress_key(uint64_t k) { return static_cast<uint32_t>(((k >> 60) << 20) | (k & 0xFFFFF)); }
+
+inline uint32_t pair_index(int a, int b) { return binom52(b, 2) + a; }  // a < b
+inline uint32_t triple_index(int a, int b, int c) { return binom52(c, 3) + binom52(b, 2) + a; }  // a < b < c
+
+// Per-thread buffers reused across boards. Counters and per-hand sums are
+// laid out [item * ranges + r].
+struct ShowdownScratch {
+  std::vector<std::array<int, 4>> hands;  // ascending cards
+  std::vector<uint32_t> index;            // plo_hand_index of each hand
+  std::vector<uint64_t> order, tmp;       // (key24 << 32) | local hand
+  std::vector<double> c1, c2, c3;         // counted weight containing a card, pair, triple
+  std::vector<double> total;              // counted weight per range
+  std::vector<double> below, not_worse;   // per hand: weight beaten, beaten + tied
+};
+
+// Counted weight of range r sharing no card with h, by inclusion-exclusion
+// over the subsets of h. `self` is h's own weight once h has been counted.
+inline double disjoint_weight(const std::array<int, 4>& h, const ShowdownScratch& s, int R, int r, double self) {
+  double v = s.total[r] + self;
+  for (int i = 0; i < 4; ++i) v -= s.c1[h[i] * R + r];
+  for (int i = 0; i < 4; ++i) {
+    for (int j = i + 1; j < 4; ++j) v += s.c2[pair_index(h[i], h[j]) * R + r];
+  }
+  v -= s.c3[triple_index(h[0], h[1], h[2]) * R + r] + s.c3[triple_index(h[0], h[1], h[3]) * R + r] +
+       s.c3[triple_index(h[0], h[2], h[3]) * R + r] + s.c3[triple_index(h[1], h[2], h[3]) * R + r];
+  return v;
+}
+
+inline void count_hand(const std::array<int, 4>& h, double w, ShowdownScratch& s, int R, int r) {
+  for (int i = 0; i < 4; ++i) s.c1[h[i] * R + r] += w;
+  for (int i = 0; i < 4; ++i) {
+    for (int j = i + 1; j < 4; ++j) s.c2[pair_index(h[i], h[j]) * R + r] += w;
+  }
+  s.c3[triple_index(h[0], h[1], h[2]) * R + r] += w;
+  s.c3[triple_index(h[0], h[1], h[3]) * R + r] += w;
+  s.c3[triple_index(h[0], h[2], h[3]) * R + r] += w;
+  s.c3[triple_index(h[1], h[2], h[3]) * R + r] += w;
+  s.total[r] += w;
+}
+
+}  // namespace
+
+void river_showdown_values(const std::array<int, 5>& board, const float* const* weights, float* const* values,
+                           int ranges) {
+  const int R = ranges;
+  if (R <= 0) return;
+  for (int r = 0; r < R; ++r) std::fill(values[r], values[r] + kNumPloHands, 0.f);
+  uint64_t bmask = 0;
+  for (int c : board) {
+    if (c < 0 || c >= 52 || (bmask >> c & 1)) return;
+    bmask |= uint64_t{1} << c;
+  }
+  thread_local ShowdownScratch s;
+  int deck[52];
+  int nd = 0;
+  for (int c = 0; c < 52; ++c) {
+    if (!(bmask >> c & 1)) deck[nd++] = c;
+  }
+  s.hands.clear();
+  s.index.clear();
+  for (int d = 3; d < nd; ++d) {
+    for (int c = 2; c < d; ++c) {
+      for (int b = 1; b < c; ++b) {
+        for (int a = 0; a < b; ++a) {
+          s.hands.push_back({deck[a], deck[b], deck[c], deck[d]});
+          s.index.push_back(plo_hand_index_sorted(deck[a], deck[b], deck[c], deck[d]));
+        }
+      }
+    }
+  }
+  const size_t m = s.hands.size();
+  const RiverBoardEvaluator ev(board);
+  s.order.resize(m);
+  s.tmp.resize(m);
+  for (size_t i = 0; i < m; ++i) {
+    const int32_t h[4] = {s.hands[i][0], s.hands[i][1], s.hands[i][2], s.hands[i][3]};
+    s.order[i] = static_cast<uint64_t>(compress_key(ev.key(h))) << 32 | i;
+  }
+  // LSD radix sort on the 24 key bits.
+  for (int shift = 32; shift < 56; shift += 8) {
+    size_t count[257] = {0};
+    for (uint64_t v : s.order) ++count[(v >> shift & 0xFF) + 1];
+    for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+    for (uint64_t v : s.order) s.tmp[count[v >> shift & 0xFF]++] = v;
+    s.order.swap(s.tmp);
+  }
+
+  s.c1.assign(52 * static_cast<size_t>(R), 0.0);
+  s.c2.assign(binom52(52, 2) * static_cast<size_t>(R), 0.0);
+  s.c3.assign(binom52(52, 3) * static_cast<size_t>(R), 0.0);
+  s.total.assign(R, 0.0);
+  s.below.resize(m * R);
+  s.not_worse.resize(m * R);
+  for (size_t g = 0; g < m;) {
+    size_t e = g + 1;
+    while (e < m && (s.order[e] >> 32) == (s.order[g] >> 32)) ++e;
+    for (size_t q = g; q < e; ++q) {
+      const uint32_t i = static_cast<uint32_t>(s.order[q]);
+      for (int r = 0; r < R; ++r) s.below[i * R + r] = disjoint_weight(s.hands[i], s, R, r, 0.0);
+    }
+    for (size_t q = g; q < e; ++q) {
+      const uint32_t i = static_cast<uint32_t>(s.order[q]);
+      for (int r = 0; r < R; ++r) count_hand(s.hands[i], weights[r][s.index[i]], s, R, r);
+    }
+    for (size_t q = g; q < e; ++q) {
+      const uint32_t i = static_cast<uint32_t>(s.order[q]);
+      for (int r = 0; r < R; ++r) {
+        s.not_worse[i * R + r] = disjoint_weight(s.hands[i], s, R, r, weights[r][s.index[i]]);
+      }
+    }
+    g = e;
+  }
+  // With every hand counted, the disjoint weight is each hand's opponent total.
+  for (size_t i = 0; i < m; ++i) {
+    for (int r = 0; r < R; ++r) {
+      const double w = weights[r][s.index[i]];
+      const double t = disjoint_weight(s.hands[i], s, R, r, w);
+      if (!(t > 1e-12 * s.total[r])) continue;
+      const double lose = t - s.not_worse[i * R + r];
+      values[r][s.index[i]] = static_cast<float>((s.below[i * R + r] - lose) / (2.0 * t));
+    }
+  }
+}
+
+}  // namespace quasar
@@ -1,174 +1,411 @@
 #include "quasar/engine/json.h"
 
+#include <algorithm>
+#include <charconv>
 #include <cstdlib>
-#include <sstream>
+#include <cstring>
+
+#include "quasar/util/format.h"
 
 namespace quasar {
 
-static std::string get_string(const std::string& s, const std::string& key) {
-  auto pos = s.find("\"" + key + "\"");
-  if (pos == std::string::npos) return "";
-  pos = s.find(':', pos);
-  if (pos == std::string::npos) return "";
-  auto start = s.find('"', pos + 1);
-  if (start == std::string::npos) return "";
-  auto end = s.find('"', start + 1);
-  if (end == std::string::npos) return "";
-  return s.substr(start + 1, end - start - 1);
-}
-
-static double get_number(const std::string& s, const std::string& key, double def = 0.0) {
-  auto pos = s.find("\"" + key + "\"");
-  if (pos == std::string::npos) return def;
-  pos = s.find(':', pos);
-  if (pos == std::string::npos) return def;
-  char* end = nullptr;
-  const char* start = s.c_str() + pos + 1;
-  double val = std::strtod(start, &end);
-  if (start == end) return def;
-  return val;
-}
-
-static std::vector<double> get_number_array(const std::string& s, const std::string& key) {
-  std::vector<double> out;
-  auto pos = s.find("\"" + key + "\"");
-  if (pos == std::string::npos) return out;
-  pos = s.find('[', pos);
-  if (pos == std::string::npos) return out;
-  auto end = s.find(']', pos);
-  if (end == std::string::npos) return out;
-  std::string arr = s.substr(pos + 1, end - pos - 1);
-  std::stringstream ss(arr);
-  while (ss.good()) {
-    std::string tok;
-    std::getline(ss, tok, ',');
-    if (tok.empty()) continue;
-    out.push_back(std::atof(tok.c_str()));
+namespace {
+
+// Minimal JSON tokenizer over [p, end): no allocation, strings are returned
+// as views (escape sequences are skipped, not decoded; the schema has no
+// escaped keys or values).
+class Cursor {
+ public:
+  Cursor(const char* b, const char* e) : p_(b), e_(e) {}
+
+  void ws() {
+    while (p_ < e_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
   }
-  return out;
+  bool at_end() { ws(); return p_ >= e_; }
+  bool peek(char c) { ws(); return p_ < e_ && *p_ == c; }
+  bool eat(char c) {
+    if (!peek(c)) return false;
+    ++p_;
+    return true;
+  }
+
+  bool string(std::string_view& out) {
+    if (!eat('"')) return false;
+    const char* s = p_;
+    while (p_ < e_ && *p_ != '"') p_ += (*p_ == '\\') ? 2 : 1;
+    if (p_ >= e_) return false;
+    out = std::string_view(s, static_cast<size_t>(p_ - s));
+    ++p_;
+    return true;
+  }
+
+  bool number(double& v) {
+    ws();
+    const char* s = p_;
+    while (p_ < e_ && ((*p_ >= '0' && *p_ <= '9') || *p_ == '-' || *p_ == '+' || *p_ == '.' || *p_ == 'e' || *p_ == 'E')) ++p_;
+    if (p_ == s) return false;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const char* b = (*s == '+') ? s + 1 : s;
+    return std::from_chars(b, p_, v).ptr == p_;
+#else
+    char buf[64];
+    const size_t n = std::min<size_t>(static_cast<size_t>(p_ - s), sizeof(buf) - 1);
+    std::memcpy(buf, s, n);
+    buf[n] = '\0';
+    char* q = nullptr;
+    v = std::strtod(buf, &q);
+    return q == buf + n;
+#endif
+  }
+
+  template <size_t N>
+  bool literal(const char (&word)[N]) {
+    ws();
+    const size_t n = N - 1;
+    if (static_cast<size_t>(e_ - p_) < n || std::memcmp(p_, word, n) != 0) return false;
+    p_ += n;
+    return true;
+  }
+
+  bool boolean(bool& v) {
+    if (literal("true")) { v = true; return true; }
+    if (literal("false")) { v = false; return true; }
+    return false;
+  }
+
+  bool skip_value(int depth = 0) {
+    if (depth > 64) return false;
+    ws();
+    if (p_ >= e_) return false;
+    std::string_view sv;
+    double d;
+    switch (*p_) {
+      case '"': return string(sv);
+      case '{':
+        return object([&](std::string_view) { return skip_value(depth + 1); });
+      case '[':
+        return array([&]() { return skip_value(depth + 1); });
+      case 't': return literal("true");
+      case 'f': return literal("false");
+      case 'n': return literal("null");
+      default: return number(d);
+    }
+  }
+
+  // Calls on_key(key) with the cursor before each value; on_key must consume it.
+  template <typename F>
+  bool object(F on_key) {
+    if (!eat('{')) return false;
+    if (eat('}')) return true;
+    do {
+      std::string_view key;
+      if (!string(key) || !eat(':') || !on_key(key)) return false;
+    } while (eat(','));
+    return eat('}');
+  }
+
+  template <typename F>
+  bool array(F on_elem) {
+    if (!eat('[')) return false;
+    if (eat(']')) return true;
+    do {
+      if (!on_elem()) return false;
+    } while (eat(','));
+    return eat(']');
+  }
+
+  // Typed reads that fall back to skipping a value of another type, keeping
+  // the old best-effort behaviour for unexpected inputs.
+  bool read_number(double& v) {
+    ws();
+    if (p_ < e_ && ((*p_ >= '0' && *p_ <= '9') || *p_ == '-' || *p_ == '+' || *p_ == '.')) return number(v);
+    return skip_value();
+  }
+  bool read_bool(bool& v) {
+    ws();
+    if (p_ < e_ && (*p_ == 't' || *p_ == 'f')) return boolean(v);
+    return skip_value();
+  }
+  bool read_string(std::string_view& v) {
+    if (peek('"')) return string(v);
+    return skip_value();
+  }
+  template <typename T>
+  bool read_numbers(std::vector<T>& out) {
+    if (!peek('[')) return skip_value();
+    out.clear();
+    return array([&]() {
+      double d = -1.0;
+      if (literal("null")) {
+        out.push_back(static_cast<T>(-1));
+        return true;
+      }
+      if (!number(d)) return false;
+      out.push_back(static_cast<T>(d));
+      return true;
+    });
+  }
+
+ private:
+  const char* p_;
+  const char* e_;
+};
+
+struct Targets {
+  PublicState* state = nullptr;
+  BettingRules* rules = nullptr;
+  DiscretizationConfig* disc = nullptr;
+  SolveOneConfig* solver = nullptr;  // cfr_iters and eval only
+};
+
+void reset_state(PublicState& s) {
+  s.num_players = 0;
+  s.player_to_act = 0;
+  s.button = 0;
+  s.street = 0;
+  s.sb = 1.0;
+  s.bb = 2.0;
+  s.ante = 0.0;
+  s.last_raise_size = 0.0;
+  s.board.clear();
+  s.stacks.clear();
+  s.committed_total.clear();
+  s.committed_on_street.clear();
 }
 
-static std::vector<int> get_int_array(const std::string& s, const std::string& key) {
-  std::vector<int> out;
-  auto nums = get_number_array(s, key);
-  out.reserve(nums.size());
-  for (double d : nums) out.push_back(static_cast<int>(d));
-  return out;
+bool parse_discretization(Cursor& c, DiscretizationConfig* d) {
+  if (!d || !c.peek('{')) return c.skip_value();
+  return c.object([&](std::string_view k) {
+    if (k == "pot_fracs") {
+      // An empty list keeps the default fractions.
+      if (!c.peek('[')) return c.skip_value();
+      std::vector<double>& pf = d->pot_fracs;
+      const size_t keep = pf.size();
+      // Parse after the current contents so an empty array can be rolled back.
+      bool ok = c.array([&]() {
+        double v;
+        if (!c.number(v)) return false;
+        pf.push_back(v);
+        return true;
+      });
+      if (pf.size() > keep) pf.erase(pf.begin(), pf.begin() + static_cast<std::ptrdiff_t>(keep));
+      return ok;
+    }
+    if (k == "include_min") return c.read_bool(d->include_min);
+    if (k == "include_pot_raise") return c.read_bool(d->include_pot_raise);
+    if (k == "include_all_in") return c.read_bool(d->include_all_in);
+    return c.skip_value();
+  });
 }
 
-bool parse_public_state_from_json(const std::string& input, PublicState& s) {
-  const std::string street = get_string(input, "street");
-  s.street = 0;
-  if (street == "flop") s.street = 1; else if (street == "turn") s.street = 2; else if (street == "river") s.street = 3;
-  s.sb = get_number(input, "sb", 1.0);
-  s.bb = get_number(input, "bb", 2.0);
-  s.ante = get_number(input, "ante", 0.0);
-  s.player_to_act = static_cast<int>(get_number(input, "to_act", 0));
-  s.button = static_cast<int>(get_number(input, "button", 0));
-  s.last_raise_size = get_number(input, "last_raise_size", 0.0);
-  s.stacks = get_number_array(input, "stacks");
-  s.num_players = static_cast<int>(s.stacks.size());
-  s.committed_total = get_number_array(input, "committed_total");
-  s.committed_on_street = get_number_array(input, "committed_on_street");
-  s.board = get_int_array(input, "board");
-  return s.num_players >= 2 && s.stacks.size() == s.committed_total.size() && s.stacks.size() == s.committed_on_street.size();
-}
-
-bool parse_rules_from_json(const std::string& input, BettingRules& rules) {
-  // Optional: "min_bet_rule": "BigBlind" | "OneChip"
-  const std::string mbr = get_string(input, "min_bet_rule");
-  if (!mbr.empty()) {
-    if (mbr == "OneChip") rules.min_bet_rule = BettingRules::MinBetRule::OneChip;
-    else rules.min_bet_rule = BettingRules::MinBetRule::BigBlind;
+bool parse_solver(Cursor& c, SolveOneConfig* cfg) {
+  if (!cfg || !c.peek('{')) return c.skip_value();
+  return c.object([&](std::string_view k) {
+    double v = 0.0;
+    if (k == "iters") {
+      v = cfg->cfr_iters;
+      if (!c.read_number(v)) return false;
+      cfg->cfr_iters = static_cast<int>(v);
+      return true;
+    }
+    if (k == "win_prob") return c.read_number(cfg->eval.win_prob);
+    if (k == "call_k") return c.read_number(cfg->eval.call_k);
+    return c.skip_value();
+  });
+}
+
+// One pass over the document; only the requested targets are written.
+bool parse_spot(std::string_view json, const Targets& t) {
+  if (t.state) reset_state(*t.state);
+  Cursor c(json.data(), json.data() + json.size());
+  PublicState* s = t.state;
+  bool ok = c.object([&](std::string_view k) {
+    double v = 0.0;
+    if (s) {
+      if (k == "street") {
+        std::string_view st;
+        if (!c.read_string(st)) return false;
+        s->street = st == "flop" ? 1 : st == "turn" ? 2 : st == "river" ? 3 : 0;
+        return true;
+      }
+      if (k == "sb") return c.read_number(s->sb);
+      if (k == "bb") return c.read_number(s->bb);
+      if (k == "ante") return c.read_number(s->ante);
+      if (k == "last_raise_size") return c.read_number(s->last_raise_size);
+      if (k == "to_act" || k == "button") {
+        v = 0.0;
+        if (!c.read_number(v)) return false;
+        (k == "to_act" ? s->player_to_act : s->button) = static_cast<int>(v);
+        return true;
+      }
+      if (k == "stacks") return c.read_numbers(s->stacks);
+      if (k == "committed_total") return c.read_numbers(s->committed_total);
+      if (k == "committed_on_street") return c.read_numbers(s->committed_on_street);
+      if (k == "board") return c.read_numbers(s->board);
+    }
+    if (k == "min_bet_rule" && t.rules) {
+      std::string_view r;
+      if (!c.read_string(r)) return false;
+      if (!r.empty()) {
+        t.rules->min_bet_rule = (r == "OneChip") ? BettingRules::MinBetRule::OneChip : BettingRules::MinBetRule::BigBlind;
+      }
+      return true;
+    }
+    if (k == "discretization") return parse_discretization(c, t.disc);
+    if (k == "solver") return parse_solver(c, t.solver);
+    return c.skip_value();
+  });
+  ok = ok && c.at_end();
+  if (!s) return ok;
+  s->num_players = static_cast<int>(s->stacks.size());
+  return ok && s->num_players >= 2 && s->stacks.size() == s->committed_total.size() &&
+         s->stacks.size() == s->committed_on_street.size();
+}
+
+void reset_config(SolveOneConfig& cfg) {
+  static const SolveOneConfig kDefault;
+  cfg.rules = kDefault.rules;
+  cfg.discretization.pot_fracs.assign(kDefault.discretization.pot_fracs.begin(),
+                                      kDefault.discretization.pot_fracs.end());
+  cfg.discretization.include_min = kDefault.discretization.include_min;
+  cfg.discretization.include_pot_raise = kDefault.discretization.include_pot_raise;
+  cfg.discretization.include_all_in = kDefault.discretization.include_all_in;
+  cfg.cfr_iters = kDefault.cfr_iters;
+  cfg.eval = kDefault.eval;
+}
+
+}  // namespace
+
+bool parse_spot_json(std::string_view json, SpotRequest& out) {
+  reset_config(out.config);
+  Targets t;
+  t.state = &out.state;
+  t.rules = &out.config.rules;
+  t.disc = &out.config.discretization;
+  t.solver = &out.config;
+  return parse_spot(json, t);
+}
+
+size_t parse_spot_ndjson(std::string_view text, std::vector<SpotRequest>& out, std::vector<bool>* ok) {
+  size_t n = 0, good = 0;
+  if (ok) ok->clear();
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t eol = text.find('\n', pos);
+    if (eol == std::string_view::npos) eol = text.size();
+    std::string_view line = text.substr(pos, eol - pos);
+    pos = eol + 1;
+    if (line.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+    if (n == out.size()) out.emplace_back();  // reuse existing entries' capacity
+    const bool r = parse_spot_json(line, out[n++]);
+    good += r ? 1 : 0;
+    if (ok) ok->push_back(r);
   }
+  out.resize(n);
+  return good;
+}
+
+bool parse_public_state_from_json(std::string_view input, PublicState& s) {
+  Targets t;
+  t.state = &s;
+  return parse_spot(input, t);
+}
+
+bool parse_rules_from_json(std::string_view input, BettingRules& rules) {
+  // Optional: "min_bet_rule": "BigBlind" | "OneChip"
+  Targets t;
+  t.rules = &rules;
+  parse_spot(input, t);
   return true;
 }
 
-DiscretizationConfig parse_discretization_from_json(const std::string& input, const DiscretizationConfig& def) {
+DiscretizationConfig parse_discretization_from_json(std::string_view input, const DiscretizationConfig& def) {
+  // Optional: {"discretization": {"pot_fracs": [..], "include_min": bool,
+  //            "include_pot_raise": bool, "include_all_in": bool}}
   DiscretizationConfig cfg = def;
-  // Optional: {
-  //   "discretization": {
-  //      "pot_fracs": [..],
-  //      "include_min": true/false,
-  //      "include_pot_raise": true/false,
-  //      "include_all_in": true/false
-  //   }
-  // }
-  auto pos = input.find("\"discretization\"");
-  if (pos != std::string::npos) {
-    // pot_fracs
-    // Find pot_fracs array relative to discretization block
-    auto pf_pos = input.find("\"pot_fracs\"", pos);
-    if (pf_pos != std::string::npos) {
-      // temporarily slice from pf_pos to extract array
-      std::vector<double> pf = get_number_array(input.substr(pf_pos), "pot_fracs");
-      if (!pf.empty()) cfg.pot_fracs = pf;
-    }
-    // Booleans: include_min, include_pot_raise, include_all_in
-    auto get_bool = [&](const std::string& key, bool defv) {
-      auto kpos = input.find("\"" + key + "\"", pos);
-      if (kpos == std::string::npos) return defv;
-      kpos = input.find(':', kpos);
-      if (kpos == std::string::npos) return defv;
-      // look for true/false
-      auto tpos = input.find("true", kpos);
-      auto fpos = input.find("false", kpos);
-      if (tpos != std::string::npos && (fpos == std::string::npos || tpos < fpos)) return true;
-      if (fpos != std::string::npos && (tpos == std::string::npos || fpos < tpos)) return false;
-      return defv;
-    };
-    cfg.include_min = get_bool("include_min", cfg.include_min);
-    cfg.include_pot_raise = get_bool("include_pot_raise", cfg.include_pot_raise);
-    cfg.include_all_in = get_bool("include_all_in", cfg.include_all_in);
-  }
+  Targets t;
+  t.disc = &cfg;
+  parse_spot(input, t);
   return cfg;
 }
 
-std::string assemble_response_json(const LegalActionSummary& la,
-                                   const std::vector<Action>& discrete) {
+bool parse_solve_config_from_json(std::string_view input, SolveOneConfig& cfg) {
+  // Rules, discretization and {"solver": {"type":"cfr", "iters":N, "win_prob":w, "call_k":k}}
+  Targets t;
+  t.rules = &cfg.rules;
+  t.disc = &cfg.discretization;
+  t.solver = &cfg;
+  parse_spot(input, t);
+  return true;
+}
+
+namespace {
+
+void append_action(StringAppender& w, int type, double amount, double prob) {
+  w.lit("{\"type\":");
+  w.integer(type);
+  w.lit(",\"amount\":");
+  w.num(amount);
+  w.lit(",\"prob\":");
+  w.num(prob);
+  w.ch('}');
+}
+
+}  // namespace
+
+void append_response_json(std::string& out, const LegalActionSummary& la,
+                          const std::vector<Action>& discrete) {
   // Base discrete actions + check/fold/call as appropriate → uniform
-  struct UA { int type; double amount; double prob; };
-  std::vector<UA> ua;
+  const size_t n = discrete.size() + (la.can_check ? 1 : (la.can_fold ? 2 : 1));
+  const double p = 1.0 / static_cast<double>(std::max<size_t>(1, n));
+  out += "{\"legal\":";
+  append_json(out, la);
+  StringAppender w(out);
+  w.lit(",\"uniform_actions\":[");
   if (la.can_check) {
-    ua.push_back({static_cast<int>(ActionType::kCheck), 0.0, 0.0});
+    append_action(w, static_cast<int>(ActionType::kCheck), 0.0, p);
   } else {
-    if (la.can_fold) ua.push_back({static_cast<int>(ActionType::kFold), 0.0, 0.0});
-    ua.push_back({static_cast<int>(ActionType::kCall), la.call_amount, 0.0});
+    if (la.can_fold) {
+      append_action(w, static_cast<int>(ActionType::kFold), 0.0, p);
+      w.ch(',');
+    }
+    append_action(w, static_cast<int>(ActionType::kCall), la.call_amount, p);
+  }
+  for (const auto& a : discrete) {
+    w.ch(',');
+    append_action(w, static_cast<int>(a.type), a.amount, p);
   }
-  for (auto& a : discrete) ua.push_back({static_cast<int>(a.type), a.amount, 0.0});
-  const double n = static_cast<double>(std::max<size_t>(1, ua.size()));
-  for (auto& a : ua) a.prob = 1.0 / n;
+  w.lit("]}");
+}
 
-  std::ostringstream oss;
-  oss << "{";
-  oss << "\"legal\":" << to_json(la) << ",";
-  oss << "\"uniform_actions\":[";
-  for (size_t i = 0; i < ua.size(); ++i) {
-    oss << "{\"type\":" << ua[i].type << ",\"amount\":" << ua[i].amount
-        << ",\"prob\":" << ua[i].prob << "}";
-    if (i + 1 < ua.size()) oss << ",";
+void append_response_json(std::string& out, const LegalActionSummary& la,
+                          const std::vector<Action>& actions,
+                          const std::vector<double>& probs) {
+  // Emit JSON with provided probabilities
+  out += "{\"legal\":";
+  append_json(out, la);
+  StringAppender w(out);
+  w.lit(",\"uniform_actions\":[");  // keep key name for backward compat
+  for (size_t i = 0; i < actions.size(); ++i) {
+    if (i) w.ch(',');
+    append_action(w, static_cast<int>(actions[i].type), actions[i].amount, i < probs.size() ? probs[i] : 0.0);
   }
-  oss << "]}";
-  return oss.str();
+  w.lit("]}");
+}
+
+std::string assemble_response_json(const LegalActionSummary& la,
+                                   const std::vector<Action>& discrete) {
+  std::string out;
+  append_response_json(out, la, discrete);
+  return out;
 }
 
 std::string assemble_response_json(const LegalActionSummary& la,
                                    const std::vector<Action>& actions,
                                    const std::vector<double>& probs) {
-  // Emit JSON with provided probabilities
-  std::ostringstream oss;
-  oss << "{";
-  oss << "\"legal\":" << to_json(la) << ",";
-  oss << "\"uniform_actions\":[";  // keep key name for backward compat
-  for (size_t i = 0; i < actions.size(); ++i) {
-    const auto& a = actions[i];
-    const double p = (i < probs.size() ? probs[i] : 0.0);
-    oss << "{\"type\":" << static_cast<int>(a.type) << ",\"amount\":" << a.amount
-        << ",\"prob\":" << p << "}";
-    if (i + 1 < actions.size()) oss << ",";
-  }
-  oss << "]}";
-  return oss.str();
+  std::string out;
+  append_response_json(out, la, actions, probs);
+  return out;
 }
 
 }  // namespace quasar
@@ -0,0 +1,106 @@
+#include "quasar/nn/batching_value_net.h"
+
+#include <chrono>
+#include <cstring>
+#include <exception>
+
+namespace quasar {
+
+BatchingValueNet::BatchingValueNet(IValueNet* inner, const BatchingConfig& cfg)
+    : inner_(inner), cfg_(cfg) {}
+
+std::vector<float> BatchingValueNet::compute_values(const std::vector<float>& queries, int batch, int players) {
+  std::vector<float> out(static_cast<size_t>(batch) * players * output_size());
+  compute_values_into(queries.data(), batch, players, out.data());
+  return out;
+}
+
+void BatchingValueNet::compute_values_into(const float* queries, int batch, int players, float* out) {
+  if (batch <= 0) return;
+  Pending me{queries, out, batch, players, false, nullptr};
+  std::unique_lock<std::mutex> lock(mu_);
+  queue_.push_back(&me);
+  queued_items_ += batch;
+  ++stats_.calls;
+  cv_.notify_all();
+  // Wait until a leader has served us or the leader slot is free.
+  while (!me.done && leader_active_) cv_.wait(lock);
+  if (me.done) {
+    if (me.error) std::rethrow_exception(me.error);
+    return;
+  }
+
+  leader_active_ = true;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(cfg_.max_wait_us);
+  cv_.wait_until(lock, deadline, [this] { return queued_items_ >= cfg_.max_batch; });
+
+  // Take every queued call with our player count; the rest wait for the next leader.
+  taken_.clear();
+  int items = 0;
+  size_t keep = 0;
+  for (Pending* p : queue_) {
+    if (p->players == players) {
+      taken_.push_back(p);
+      items += p->batch;
+    } else {
+      queue_[keep++] = p;
+    }
+  }
+  queue_.resize(keep);
+  queued_items_ -= items;
+  lock.unlock();
+
+  // A throwing forward must still release the leader slot and every caller
+  // in the batch, or they would wait forever; each of them rethrows it.
+  std::exception_ptr error;
+  try {
+    forward(queries, batch, players, out, items);
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  lock.lock();
+  for (Pending* p : taken_) {
+    p->error = error;
+    p->done = true;
+  }
+  ++stats_.batches;
+  stats_.items += static_cast<uint64_t>(items);
+  leader_active_ = false;
+  cv_.notify_all();
+  lock.unlock();
+  if (error) std::rethrow_exception(error);
+}
+
+void BatchingValueNet::forward(const float* queries, int batch, int players, float* out, int items) {
+  if (taken_.size() == 1) {
+    inner_->compute_values_into(queries, batch, players, out);
+  } else {
+    const size_t item_in = static_cast<size_t>(players) * input_size();
+    const size_t item_out = static_cast<size_t>(players) * output_size();
+    in_.resize(static_cast<size_t>(items) * item_in);
+    out_.resize(static_cast<size_t>(items) * item_out);
+    size_t off = 0;
+    for (const Pending* p : taken_) {
+      std::memcpy(in_.data() + off * item_in, p->queries, p->batch * item_in * sizeof(float));
+      off += static_cast<size_t>(p->batch);
+    }
+    inner_->compute_values_into(in_.data(), items, players, out_.data());
+    off = 0;
+    for (Pending* p : taken_) {
+      std::memcpy(p->out, out_.data() + off * item_out, p->batch * item_out * sizeof(float));
+      off += static_cast<size_t>(p->batch);
+    }
+  }
+}
+
+bool BatchingValueNet::compute_values_sparse(const SparseQueries& q, float* out) {
+  return inner_->compute_values_sparse(q, out);
+}
+
+BatchingStats BatchingValueNet::stats() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return stats_;
+}
+
+}  // namespace quasar
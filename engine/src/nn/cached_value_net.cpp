@@ -0,0 +1,89 @@
+#include "quasar/nn/cached_value_net.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+#include "quasar/nn/query_layout.h"
+
+namespace quasar {
+
+static inline int64_t quantize(float x, float step) {
+  return static_cast<int64_t>(std::llround(static_cast<double>(x) / step));
+}
+
+CachedValueNet::CachedValueNet(IValueNet* inner, const ValueCacheConfig& cfg)
+    : inner_(inner), cfg_(cfg), cache_(cfg.capacity_bytes ? cfg.capacity_bytes : cfg.capacity, cfg.shards) {}
+
+Hash128 CachedValueNet::item_key(const float* item, int players) const {
+  const int in = inner_->input_size();
+  Hasher128 h(static_cast<uint64_t>(players));
+  // Board is shared by all players; flop order carries no information.
+  int board[kSliceBoardCards];
+  for (int i = 0; i < kSliceBoardCards; ++i) board[i] = static_cast<int>(item[kSliceBoard + i]);
+  std::sort(board, board + 3);
+  for (int c : board) h.add(static_cast<uint64_t>(c + 1));
+  for (int p = 0; p < players; ++p) {
+    const float* slice = item + static_cast<size_t>(p) * in;
+    h.add(static_cast<uint64_t>(static_cast<int64_t>(slice[kSlicePlayerAct])));
+    h.add(static_cast<uint64_t>(static_cast<int64_t>(slice[kSlicePosition])));
+    h.add(static_cast<uint64_t>(quantize(slice[kSliceS2PR], cfg_.s2pr_quantum)));
+    for (int k = kSlicePublicSize; k < in; ++k) {
+      const int64_t q = quantize(slice[k], cfg_.range_quantum);
+      // Skip empty buckets but keep their position in the hash via the index.
+      if (q != 0) h.add((static_cast<uint64_t>(k) << 40) ^ static_cast<uint64_t>(q));
+    }
+  }
+  return h.digest();
+}
+
+std::vector<float> CachedValueNet::compute_values(const std::vector<float>& queries, int batch, int players) {
+  std::vector<float> out(static_cast<size_t>(batch) * players * output_size());
+  compute_values_into(queries.data(), batch, players, out.data());
+  return out;
+}
+
+void CachedValueNet::compute_values_into(const float* queries, int batch, int players, float* out) {
+  const size_t item_in = static_cast<size_t>(players) * input_size();
+  const size_t item_out = static_cast<size_t>(players) * output_size();
+  // Call-local scratch: the wrapped net may itself run a cached net on this
+  // thread (nested caches, or a batching leader), so nothing here may be
+  // shared between calls.
+  std::vector<float> miss_in, miss_out;
+  std::vector<int> miss_items;
+  std::vector<Hash128> miss_keys;
+  std::shared_ptr<const std::vector<float>> value;
+
+  for (int b = 0; b < batch; ++b) {
+    const float* item = queries + b * item_in;
+    const Hash128 key = item_key(item, players);
+    if (cache_.get(key, value) && value->size() == item_out) {
+      std::memcpy(out + b * item_out, value->data(), item_out * sizeof(float));
+      continue;
+    }
+    miss_items.push_back(b);
+    miss_keys.push_back(key);
+    miss_in.insert(miss_in.end(), item, item + item_in);
+  }
+  if (miss_items.empty()) return;
+
+  const int n_miss = static_cast<int>(miss_items.size());
+  miss_out.resize(static_cast<size_t>(n_miss) * item_out);
+  inner_->compute_values_into(miss_in.data(), n_miss, players, miss_out.data());
+  const size_t cost = cfg_.capacity_bytes ? item_out * sizeof(float) : 1;
+  for (int i = 0; i < n_miss; ++i) {
+    const float* src = miss_out.data() + i * item_out;
+    std::memcpy(out + miss_items[i] * item_out, src, item_out * sizeof(float));
+    cache_.put(miss_keys[i], std::make_shared<const std::vector<float>>(src, src + item_out), cost);
+  }
+}
+
+bool CachedValueNet::compute_values_sparse(const SparseQueries& q, float* out) {
+  // Sparse models are served uncached; dense nets go through the cached
+  // dense path via the default scatter/gather.
+  if (inner_->is_sparse()) return inner_->compute_values_sparse(q, out);
+  return IValueNet::compute_values_sparse(q, out);
+}
+
+}  // namespace quasar
@@ -0,0 +1,400 @@
+#include "quasar/nn/native_value_net.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define QUASAR_NATIVE_AVX2 1
+#endif
+
+namespace quasar {
+
+namespace {
+
+constexpr char kMagic[4] = {'Q', 'V', 'N', 'W'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kFlagNormFirst = 1u << 0;
+constexpr uint32_t kFlagGelu = 1u << 1;
+constexpr uint32_t kMaxDim = 1u << 16;  // per-dimension cap, keeps size arithmetic in range
+
+// ---- dot-product kernels -------------------------------------------------
+
+#ifdef QUASAR_NATIVE_AVX2
+inline float hsum256(__m256 v) {
+  __m128 lo = _mm256_castps256_ps128(v);
+  __m128 hi = _mm256_extractf128_ps(v, 1);
+  lo = _mm_add_ps(lo, hi);
+  __m128 sh = _mm_movehdup_ps(lo);
+  lo = _mm_add_ps(lo, sh);
+  sh = _mm_movehl_ps(sh, lo);
+  lo = _mm_add_ss(lo, sh);
+  return _mm_cvtss_f32(lo);
+}
+#endif
+
+inline float dot_f32(const float* a, const float* b, int n) {
+  int i = 0;
+  float acc = 0.f;
+#ifdef QUASAR_NATIVE_AVX2
+  __m256 s0 = _mm256_setzero_ps();
+  __m256 s1 = _mm256_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+    s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), s1);
+  }
+  for (; i + 8 <= n; i += 8) {
+    s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+  }
+  acc = hsum256(_mm256_add_ps(s0, s1));
+#else
+  float s[4] = {0.f, 0.f, 0.f, 0.f};
+  for (; i + 4 <= n; i += 4) {
+    s[0] += a[i] * b[i];
+    s[1] += a[i + 1] * b[i + 1];
+    s[2] += a[i + 2] * b[i + 2];
+    s[3] += a[i + 3] * b[i + 3];
+  }
+  acc = (s[0] + s[1]) + (s[2] + s[3]);
+#endif
+  for (; i < n; ++i) acc += a[i] * b[i];
+  return acc;
+}
+
+inline float dot_i8(const float* a, const int8_t* b, int n) {
+  int i = 0;
+  float acc = 0.f;
+#ifdef QUASAR_NATIVE_AVX2
+  __m256 s0 = _mm256_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    __m128i q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + i));
+    __m256 w = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q));
+    s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), w, s0);
+  }
+  acc = hsum256(s0);
+#else
+  float s[4] = {0.f, 0.f, 0.f, 0.f};
+  for (; i + 4 <= n; i += 4) {
+    s[0] += a[i] * static_cast<float>(b[i]);
+    s[1] += a[i + 1] * static_cast<float>(b[i + 1]);
+    s[2] += a[i + 2] * static_cast<float>(b[i + 2]);
+    s[3] += a[i + 3] * static_cast<float>(b[i + 3]);
+  }
+  acc = (s[0] + s[1]) + (s[2] + s[3]);
+#endif
+  for (; i < n; ++i) acc += a[i] * static_cast<float>(b[i]);
+  return acc;
+}
+
+// ---- layers --------------------------------------------------------------
+
+// y = x W^T + b with W stored row-major [out, in] (PyTorch nn.Linear layout).
+struct Linear {
+  int in = 0;
+  int out = 0;
+  std::vector<float> w;
+  std::vector<int8_t> wq;      // int8 weights when quantized
+  std::vector<float> wscale;   // per output row
+  std::vector<float> b;
+
+  void quantize() {
+    wq.resize(w.size());
+    wscale.resize(out);
+    for (int o = 0; o < out; ++o) {
+      const float* row = w.data() + static_cast<size_t>(o) * in;
+      float amax = 0.f;
+      for (int i = 0; i < in; ++i) amax = std::max(amax, std::fabs(row[i]));
+      const float scale = amax > 0.f ? amax / 127.f : 1.f;
+      wscale[o] = scale;
+      for (int i = 0; i < in; ++i) {
+        const float q = std::round(row[i] / scale);
+        wq[static_cast<size_t>(o) * in + i] = static_cast<int8_t>(std::max(-127.f, std::min(127.f, q)));
+      }
+    }
+    w.clear();
+    w.shrink_to_fit();
+  }
+
+  // x: [rows, in] -> y: [rows, out]. Rows are blocked so one weight row is
+  // reused against several activations while it is hot in L1.
+  void forward(const float* x, int rows, float* y) const {
+    constexpr int kRowBlock = 4;
+    const bool q = !wq.empty();
+    for (int r0 = 0; r0 < rows; r0 += kRowBlock) {
+      const int r1 = std::min(rows, r0 + kRowBlock);
+      for (int o = 0; o < out; ++o) {
+        const size_t off = static_cast<size_t>(o) * in;
+        for (int r = r0; r < r1; ++r) {
+          const float* xr = x + static_cast<size_t>(r) * in;
+          const float d = q ? dot_i8(xr, wq.data() + off, in) * wscale[o] : dot_f32(xr, w.data() + off, in);
+          y[static_cast<size_t>(r) * out + o] = d + b[o];
+        }
+      }
+    }
+  }
+};
+
+struct LayerNorm {
+  std::vector<float> g;
+  std::vector<float> b;
+  float eps = 1e-5f;
+
+  void apply(float* x, int rows, int d) const {
+    for (int r = 0; r < rows; ++r) {
+      float* xr = x + static_cast<size_t>(r) * d;
+      float mean = 0.f;
+      for (int i = 0; i < d; ++i) mean += xr[i];
+      mean /= static_cast<float>(d);
+      float var = 0.f;
+      for (int i = 0; i < d; ++i) {
+        const float c = xr[i] - mean;
+        var += c * c;
+      }
+      var /= static_cast<float>(d);
+      const float inv = 1.f / std::sqrt(var + eps);
+      for (int i = 0; i < d; ++i) xr[i] = (xr[i] - mean) * inv * g[i] + b[i];
+    }
+  }
+};
+
+struct EncoderLayer {
+  Linear in_proj;   // [3d, d]
+  Linear out_proj;  // [d, d]
+  Linear ff1;       // [ff, d]
+  Linear ff2;       // [d, ff]
+  LayerNorm norm1;
+  LayerNorm norm2;
+};
+
+// ---- loading -------------------------------------------------------------
+
+class Reader {
+ public:
+  explicit Reader(std::ifstream& in) : in_(in) {}
+  bool u32(uint32_t& v) { return raw(&v, sizeof(v)); }
+  bool f32(float& v) { return raw(&v, sizeof(v)); }
+  bool floats(std::vector<float>& v, size_t n) {
+    v.resize(n);
+    return raw(v.data(), n * sizeof(float));
+  }
+  bool linear(Linear& l, int out, int in) {
+    l.out = out;
+    l.in = in;
+    return floats(l.w, static_cast<size_t>(out) * in) && floats(l.b, out);
+  }
+  bool norm(LayerNorm& n, int d, float eps) {
+    n.eps = eps;
+    return floats(n.g, d) && floats(n.b, d);
+  }
+
+ private:
+  bool raw(void* dst, size_t bytes) {
+    in_.read(static_cast<char*>(dst), static_cast<std::streamsize>(bytes));
+    return static_cast<size_t>(in_.gcount()) == bytes;
+  }
+  std::ifstream& in_;
+};
+
+class NativeValueNet final : public IValueNet {
+ public:
+  bool load(const std::string& path, const NativeValueNetOptions& opts) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good()) return false;
+    char magic[4];
+    in.read(magic, 4);
+    if (in.gcount() != 4 || std::memcmp(magic, kMagic, 4) != 0) return false;
+    Reader r(in);
+    uint32_t version = 0, input = 0, output = 0, d = 0, heads = 0, layers = 0, ff = 0, flags = 0;
+    float eps = 0.f;
+    if (!r.u32(version) || version != kVersion) return false;
+    if (!r.u32(input) || !r.u32(output) || !r.u32(d) || !r.u32(heads) || !r.u32(layers) || !r.u32(ff) ||
+        !r.u32(flags) || !r.f32(eps)) {
+      return false;
+    }
+    if (input == 0 || output == 0 || d == 0 || heads == 0 || d % heads != 0 || ff == 0) return false;
+    // Every size is checked against the bytes left in the file before anything
+    // is allocated, so a corrupt header fails the load instead of throwing.
+    if (input > kMaxDim || output > kMaxDim || d > kMaxDim || ff > kMaxDim) return false;
+    const std::streamoff pos = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff end = in.tellg();
+    in.seekg(pos);
+    if (pos < 0 || end < pos) return false;
+    const uint64_t left = static_cast<uint64_t>(end - pos) / sizeof(float);
+    const uint64_t per_layer = 4ull * d * d + 2ull * d * ff + ff + 9ull * d;
+    const uint64_t fixed = uint64_t{d} * input + d + uint64_t{output} * d + output;
+    if (fixed > left || layers > (left - fixed) / per_layer || fixed + layers * per_layer != left) return false;
+    input_ = static_cast<int>(input);
+    output_ = static_cast<int>(output);
+    d_ = static_cast<int>(d);
+    heads_ = static_cast<int>(heads);
+    ff_ = static_cast<int>(ff);
+    norm_first_ = (flags & kFlagNormFirst) != 0;
+    gelu_ = (flags & kFlagGelu) != 0;
+
+    if (!r.linear(proj_in_, d_, input_)) return false;
+    layers_.resize(layers);
+    for (auto& L : layers_) {
+      if (!r.linear(L.in_proj, 3 * d_, d_) || !r.linear(L.out_proj, d_, d_) || !r.linear(L.ff1, ff_, d_) ||
+          !r.linear(L.ff2, d_, ff_) || !r.norm(L.norm1, d_, eps) || !r.norm(L.norm2, d_, eps)) {
+        return false;
+      }
+    }
+    if (!r.linear(head_, output_, d_)) return false;
+
+    if (opts.int8_weights) {
+      proj_in_.quantize();
+      for (auto& L : layers_) {
+        L.in_proj.quantize();
+        L.out_proj.quantize();
+        L.ff1.quantize();
+        L.ff2.quantize();
+      }
+      head_.quantize();
+    }
+    return true;
+  }
+
+  int input_size() const override { return input_; }
+  int output_size() const override { return output_; }
+  bool is_sparse() const override { return false; }
+
+  // Sized from the head the forward pass writes through; short inputs give
+  // an empty result rather than a read past the end.
+  std::vector<float> compute_values(const std::vector<float>& queries, int batch, int players) override {
+    const size_t rows = static_cast<size_t>(batch) * players;
+    if (batch <= 0 || players <= 0 || queries.size() < rows * proj_in_.in) return {};
+    std::vector<float> result(rows * head_.out);
+    compute_values_into(queries.data(), batch, players, result.data());
+    return result;
+  }
+
+  void compute_values_into(const float* queries, int batch, int players, float* out) override {
+    const int rows = batch * players;
+    reserve(rows, players);
+    float* h = h_.data();
+    proj_in_.forward(queries, rows, h);
+    for (const auto& L : layers_) {
+      // Self-attention block
+      const float* src = h;
+      if (norm_first_) {
+        std::copy(h, h + static_cast<size_t>(rows) * d_, tmp_.data());
+        L.norm1.apply(tmp_.data(), rows, d_);
+        src = tmp_.data();
+      }
+      L.in_proj.forward(src, rows, qkv_.data());
+      attention(batch, players);
+      L.out_proj.forward(attn_.data(), rows, tmp_.data());
+      add_inplace(h, tmp_.data(), static_cast<size_t>(rows) * d_);
+      if (!norm_first_) L.norm1.apply(h, rows, d_);
+
+      // Feed-forward block
+      src = h;
+      if (norm_first_) {
+        std::copy(h, h + static_cast<size_t>(rows) * d_, tmp_.data());
+        L.norm2.apply(tmp_.data(), rows, d_);
+        src = tmp_.data();
+      }
+      L.ff1.forward(src, rows, ff_buf_.data());
+      activate(ff_buf_.data(), static_cast<size_t>(rows) * ff_);
+      L.ff2.forward(ff_buf_.data(), rows, tmp_.data());
+      add_inplace(h, tmp_.data(), static_cast<size_t>(rows) * d_);
+      if (!norm_first_) L.norm2.apply(h, rows, d_);
+    }
+    head_.forward(h, rows, out);
+  }
+
+ private:
+  void reserve(int rows, int players) {
+    const size_t r = static_cast<size_t>(rows);
+    if (h_.size() < r * d_) {
+      h_.resize(r * d_);
+      tmp_.resize(r * d_);
+      attn_.resize(r * d_);
+      qkv_.resize(r * 3 * d_);
+      ff_buf_.resize(r * ff_);
+    }
+    if (scores_.size() < static_cast<size_t>(players)) scores_.resize(players);
+  }
+
+  // Multi-head attention across the players of each batch item. All tokens
+  // are attended to; padded seats only affect their own (unused) outputs.
+  void attention(int batch, int players) {
+    const int hd = d_ / heads_;
+    const float scale = 1.f / std::sqrt(static_cast<float>(hd));
+    const size_t stride = static_cast<size_t>(3) * d_;
+    for (int bi = 0; bi < batch; ++bi) {
+      const float* base = qkv_.data() + static_cast<size_t>(bi) * players * stride;
+      float* obase = attn_.data() + static_cast<size_t>(bi) * players * d_;
+      for (int hh = 0; hh < heads_; ++hh) {
+        const int qo = hh * hd;
+        const int ko = d_ + hh * hd;
+        const int vo = 2 * d_ + hh * hd;
+        for (int i = 0; i < players; ++i) {
+          const float* q = base + i * stride + qo;
+          float mx = -std::numeric_limits<float>::infinity();
+          for (int j = 0; j < players; ++j) {
+            scores_[j] = dot_f32(q, base + j * stride + ko, hd) * scale;
+            mx = std::max(mx, scores_[j]);
+          }
+          float sum = 0.f;
+          for (int j = 0; j < players; ++j) {
+            scores_[j] = std::exp(scores_[j] - mx);
+            sum += scores_[j];
+          }
+          float* o = obase + static_cast<size_t>(i) * d_ + hh * hd;
+          std::fill(o, o + hd, 0.f);
+          for (int j = 0; j < players; ++j) {
+            const float p = scores_[j] / sum;
+            const float* v = base + j * stride + vo;
+            for (int k = 0; k < hd; ++k) o[k] += p * v[k];
+          }
+        }
+      }
+    }
+  }
+
+  void activate(float* x, size_t n) const {
+    if (gelu_) {
+      for (size_t i = 0; i < n; ++i) x[i] = 0.5f * x[i] * (1.f + std::erf(x[i] * 0.70710678118654752f));
+    } else {
+      for (size_t i = 0; i < n; ++i) x[i] = std::max(0.f, x[i]);
+    }
+  }
+
+  static void add_inplace(float* dst, const float* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] += src[i];
+  }
+
+  int input_ = 0;
+  int output_ = 0;
+  int d_ = 0;
+  int heads_ = 0;
+  int ff_ = 0;
+  bool norm_first_ = false;
+  bool gelu_ = false;
+  Linear proj_in_;
+  std::vector<EncoderLayer> layers_;
+  Linear head_;
+
+  // Scratch, grown on demand and reused across calls
+  std::vector<float> h_, tmp_, attn_, qkv_, ff_buf_, scores_;
+};
+
+}  // namespace
+
+IValueNet* load_native_value_net(const std::string& path, const NativeValueNetOptions& opts) {
+  auto* net = new NativeValueNet();
+  if (!net->load(path, opts)) {
+    delete net;
+    return nullptr;
+  }
+  return net;
+}
+
+}  // namespace quasar
@@ -0,0 +1,64 @@
+#include "quasar/nn/query_pack.h"
+
+#include <cstring>
+
+#include "quasar/util/thread_pool.h"
+
+namespace quasar {
+
+void hand_card_masks(const int32_t* hands, size_t n, uint64_t* out) {
+  for (size_t i = 0; i < n; ++i) {
+    const int32_t* h = hands + i * 4;
+    uint64_t m = 0;
+    for (int k = 0; k < 4; ++k) {
+      const uint64_t bit = (h[k] >= 0 && h[k] < 52) ? uint64_t{1} << h[k] : 0;
+      if (bit == 0 || (m & bit)) {
+        m = kImpossibleBucket;
+        break;
+      }
+      m |= bit;
+    }
+    out[i] = m;
+  }
+}
+
+void pack_dense_queries(const DenseQueryBatch& q, float* out, ThreadPool* pool) {
+  if (q.batch <= 0 || q.players <= 0) return;
+  const size_t K = static_cast<size_t>(q.K > 0 ? q.K : 0);
+  const size_t slice = kSlicePublicSize + K;
+  const size_t P = static_cast<size_t>(q.players);
+  auto pack_state = [&](size_t b) {
+    float prefix[kSlicePublicSize];
+    prefix[kSliceS2PR] = scale_s2pr(q.s2pr ? q.s2pr[b] : 0.0);
+    uint64_t bmask = kImpossibleBucket;
+    for (int k = 0; k < kSliceBoardCards; ++k) {
+      const int32_t c = q.board ? q.board[b * kSliceBoardCards + k] : -1;
+      prefix[kSliceBoard + k] = static_cast<float>(c);
+      if (c >= 0 && c < 52) bmask |= uint64_t{1} << c;
+    }
+    const int32_t act = q.player_act ? q.player_act[b] : -1;
+    for (size_t p = 0; p < P; ++p) {
+      float* dst = out + (b * P + p) * slice;
+      prefix[kSlicePlayerAct] = static_cast<int32_t>(p) == act ? 1.f : 0.f;
+      prefix[kSlicePosition] = static_cast<float>(q.positions ? q.positions[b * P + p] : static_cast<int32_t>(p));
+      std::memcpy(dst, prefix, sizeof(prefix));
+      float* range = dst + kSlicePublicSize;
+      if (!q.ranges) {
+        std::memset(range, 0, K * sizeof(float));
+        continue;
+      }
+      const float* src = q.ranges + (b * P + p) * K;
+      if (!q.bucket_masks) {
+        std::memcpy(range, src, K * sizeof(float));
+        continue;
+      }
+      // Branch-free select so the loop vectorizes.
+      const uint64_t* masks = q.bucket_masks + (q.masks_per_player ? p * K : 0);
+      for (size_t k = 0; k < K; ++k) range[k] = (masks[k] & bmask) ? 0.f : src[k];
+    }
+  };
+  ThreadPool& p = pool ? *pool : default_thread_pool();
+  p.parallel_for(static_cast<size_t>(q.batch), pack_state, 64);
+}
+
+}  // namespace quasar
@@ -1,46 +1,104 @@
 #include "quasar/nn/value_net.h"
+#include "quasar/nn/query_layout.h"
 
 #ifdef QUASAR_USE_TORCH
 #include <torch/script.h>
 #endif
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <stdexcept>
+#include <string>
 
 namespace quasar {
 
 #ifdef QUASAR_USE_TORCH
 class TorchscriptValueNet final : public IValueNet {
  public:
-  explicit TorchscriptValueNet(const std::string& path) {
+  TorchscriptValueNet(const std::string& path, int max_batch) {
     module_ = torch::jit::load(path);
+    module_.eval();
     // Read attributes if present
     input_size_ = get_attr<int64_t>("input_size", 0);
     output_size_ = get_attr<int64_t>("output_size", 0);
     is_sparse_ = get_attr<bool>("is_sparse", false);
+    // Heads-up is the common case; reserve_mask grows on demand for more seats.
+    reserve_mask(static_cast<int64_t>(max_batch) * 2);
+    inputs_.reserve(4);
   }
 
   int input_size() const override { return static_cast<int>(input_size_); }
   int output_size() const override { return static_cast<int>(output_size_); }
   bool is_sparse() const override { return is_sparse_; }
 
+  // Sized from the tensor the forward pass produced; a model without an
+  // output_size attribute takes it from its first output.
   std::vector<float> compute_values(const std::vector<float>& queries, int batch, int players) override {
-    const int in_size = input_size();
-    const int out_size = output_size();
-    std::vector<int64_t> shape = {batch, players, in_size};
-    auto options = torch::TensorOptions().dtype(torch::kFloat32);
-    torch::Tensor x = torch::from_blob(const_cast<float*>(queries.data()), shape, options).clone();
-    torch::Tensor mask = torch::ones({batch, players}, options);
-    std::vector<torch::jit::IValue> inputs;
-    inputs.push_back(x);
-    inputs.push_back(mask);
-    auto out = module_.forward(inputs).toTensor();
-    auto out_contig = out.contiguous();
-    std::vector<float> result(out_contig.numel());
-    std::memcpy(result.data(), out_contig.data_ptr<float>(), result.size() * sizeof(float));
-    return result;
+    c10::InferenceMode guard;
+    torch::Tensor y = forward_dense(queries.data(), batch, players);
+    if (output_size_ == 0 && y.dim() > 0) output_size_ = y.size(-1);
+    return std::vector<float>(y.data_ptr<float>(), y.data_ptr<float>() + y.numel());
+  }
+
+  void compute_values_into(const float* queries, int batch, int players, float* out) override {
+    c10::InferenceMode guard;
+    torch::Tensor y = forward_dense(queries, batch, players);
+    const int64_t rows = static_cast<int64_t>(batch) * players;
+    if (y.numel() != rows * output_size_) {
+      throw std::runtime_error("TorchScript value net produced " + std::to_string(y.numel()) +
+                               " outputs, expected batch * players * output_size = " +
+                               std::to_string(rows * output_size_));
+    }
+    std::memcpy(out, y.data_ptr<float>(), static_cast<size_t>(y.numel()) * sizeof(float));
+  }
+
+  // Sparse models are traced as forward(pub, indices, values, mask) with
+  // indices as int64; the int32 ids are widened into a persistent buffer.
+  bool compute_values_sparse(const SparseQueries& q, float* out) override {
+    if (!is_sparse_) return IValueNet::compute_values_sparse(q, out);
+    c10::InferenceMode guard;
+    const int64_t n = static_cast<int64_t>(q.batch) * q.players * q.m_max;
+    if (!idx_.defined() || idx_.size(0) < n) {
+      const int64_t cap = std::max<int64_t>(n, idx_.defined() ? 2 * idx_.size(0) : 0);
+      idx_ = torch::empty({cap}, torch::TensorOptions().dtype(torch::kInt64));
+    }
+    int64_t* idx = idx_.data_ptr<int64_t>();
+    for (int64_t i = 0; i < n; ++i) idx[i] = q.indices[i];
+    const std::vector<int64_t> shape = {q.batch, q.players, q.m_max};
+    inputs_.clear();
+    inputs_.emplace_back(torch::from_blob(const_cast<float*>(q.pub), {q.batch, q.players, kSlicePublicSize}, options_));
+    inputs_.emplace_back(idx_.narrow(0, 0, n).view(shape));
+    inputs_.emplace_back(torch::from_blob(const_cast<float*>(q.values), shape, options_));
+    inputs_.emplace_back(torch::from_blob(const_cast<float*>(q.mask), shape, options_));
+    torch::Tensor y = module_.forward(inputs_).toTensor();
+    inputs_.clear();
+    if (!y.is_contiguous() || y.scalar_type() != torch::kFloat32) y = y.to(torch::kFloat32).contiguous();
+    if (y.numel() != n) {
+      throw std::runtime_error("TorchScript value net produced " + std::to_string(y.numel()) +
+                               " outputs, expected batch * players * m_max = " + std::to_string(n));
+    }
+    std::memcpy(out, y.data_ptr<float>(), static_cast<size_t>(n) * sizeof(float));
+    return true;
   }
 
  private:
+  // Runs the dense forward; returns a contiguous float32 tensor.
+  torch::Tensor forward_dense(const float* queries, int batch, int players) {
+    const int64_t rows = static_cast<int64_t>(batch) * players;
+    reserve_mask(rows);
+    // Zero-copy view over the caller's queries; the module never writes its input.
+    torch::Tensor x = torch::from_blob(const_cast<float*>(queries), {batch, players, input_size_}, options_);
+    torch::Tensor mask = mask_.narrow(0, 0, rows).view({batch, players});
+    inputs_.clear();
+    inputs_.emplace_back(std::move(x));
+    inputs_.emplace_back(std::move(mask));
+    torch::Tensor y = module_.forward(inputs_).toTensor();
+    inputs_.clear();
+    if (!y.is_contiguous() || y.scalar_type() != torch::kFloat32) y = y.to(torch::kFloat32).contiguous();
+    return y;
+  }
+
   template <typename T>
   T get_attr(const char* name, T def) {
     if (module_.has_attribute(name)) {
@@ -49,25 +107,38 @@ class TorchscriptValueNet final : public IValueNet {
     return def;
   }
 
+  // Persistent all-ones mask sized to the largest batch*players seen so far.
+  void reserve_mask(int64_t rows) {
+    if (mask_.defined() && mask_.size(0) >= rows) return;
+    c10::InferenceMode guard;
+    int64_t cap = mask_.defined() ? mask_.size(0) : 0;
+    cap = std::max<int64_t>({rows, 2 * cap, 2});
+    mask_ = torch::ones({cap}, options_);
+  }
+
   torch::jit::script::Module module_;
   int64_t input_size_ = 0;
   int64_t output_size_ = 0;
   bool is_sparse_ = false;
+  torch::TensorOptions options_ = torch::TensorOptions().dtype(torch::kFloat32);
+  torch::Tensor mask_;
+  torch::Tensor idx_;
+  std::vector<torch::jit::IValue> inputs_;
 };
 #endif
 
-IValueNet* load_torchscript_value_net(const std::string& path) {
+IValueNet* load_torchscript_value_net(const std::string& path, int max_batch) {
 #ifdef QUASAR_USE_TORCH
   try {
-    return new TorchscriptValueNet(path);
+    return new TorchscriptValueNet(path, max_batch);
   } catch (...) {
     return nullptr;
   }
 #else
   (void)path;
+  (void)max_batch;
   return nullptr;
 #endif
 }
 
 }  // namespace quasar
-
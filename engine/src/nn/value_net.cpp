@@ -0,0 +1,46 @@
+#include "quasar/nn/value_net.h"
+
+#include <algorithm>
+
+#include "quasar/nn/query_layout.h"
+
+namespace quasar {
+
+void IValueNet::compute_values_into(const float* queries, int batch, int players, float* out) {
+  const size_t n_in = static_cast<size_t>(batch) * players * input_size();
+  std::vector<float> q(queries, queries + n_in);
+  auto res = compute_values(q, batch, players);
+  std::copy(res.begin(), res.end(), out);
+}
+
+bool IValueNet::compute_values_sparse(const SparseQueries& q, float* out) {
+  const int K = output_size();
+  if (is_sparse() || K <= 0 || input_size() != dense_slice_size(K)) return false;
+  const int rows = q.batch * q.players;
+  const int in = input_size();
+  std::vector<float> dense(static_cast<size_t>(rows) * in, 0.f);
+  std::vector<float> values(static_cast<size_t>(rows) * K);
+  for (int r = 0; r < rows; ++r) {
+    float* slice = dense.data() + static_cast<size_t>(r) * in;
+    std::copy(q.pub + static_cast<size_t>(r) * kSlicePublicSize,
+              q.pub + static_cast<size_t>(r + 1) * kSlicePublicSize, slice);
+    for (int m = 0; m < q.m_max; ++m) {
+      const size_t e = static_cast<size_t>(r) * q.m_max + m;
+      const int32_t idx = q.indices[e];
+      if (q.mask[e] < 0.5f || idx < 0 || idx >= K) continue;
+      slice[kSlicePublicSize + idx] = q.values[e];
+    }
+  }
+  compute_values_into(dense.data(), q.batch, q.players, values.data());
+  for (int r = 0; r < rows; ++r) {
+    for (int m = 0; m < q.m_max; ++m) {
+      const size_t e = static_cast<size_t>(r) * q.m_max + m;
+      const int32_t idx = q.indices[e];
+      const bool live = q.mask[e] >= 0.5f && idx >= 0 && idx < K;
+      out[e] = live ? values[static_cast<size_t>(r) * K + idx] : 0.f;
+    }
+  }
+  return true;
+}
+
+}  // namespace quasar
@@ -2,13 +2,10 @@
 
 #include <algorithm>
 #include <cmath>
-#include <sstream>
 
-namespace quasar {
+#include "quasar/util/format.h"
 
-static inline double clamp(double x, double lo, double hi) {
-  return std::max(lo, std::min(hi, x));
-}
+namespace quasar {
 
 double pot_after_call(const PublicState& s, int player) {
   const double atc = s.amount_to_call(player);
@@ -22,66 +19,140 @@ double min_raise_size(const PublicState& s) {
   return s.bb;
 }
 
-LegalActionSummary compute_legal_actions(const PublicState& s, const BettingRules& rules) {
-  LegalActionSummary out;
-  const int p = s.player_to_act;
-  const double atc = s.amount_to_call(p);
-  const double max_bet = s.current_bet_to_call();
-  const double me_on_street = s.contributed_this_street(p);
-  const double my_stack = (p < static_cast<int>(s.stacks.size())) ? s.stacks[p] : 0.0;
-  const double pot_now = s.pot_total();
-
-  const bool facing_bet = atc > 0.0 && (max_bet > me_on_street + 1e-12);
+namespace {
+
+// Chip-valued accessors over the two state layouts so both share one core.
+struct PublicStateChips {
+  const PublicState& s;
+  int n() const { return static_cast<int>(s.committed_on_street.size()); }
+  Chips on_street(int i) const { return to_chips(s.committed_on_street[i]); }
+  Chips max_bet() const {
+    Chips m = 0;
+    for (double c : s.committed_on_street) m = std::max(m, to_chips(c));
+    return m;
+  }
+  Chips pot() const {
+    Chips t = 0;
+    for (double c : s.committed_total) t += to_chips(c);
+    return t;
+  }
+  Chips stack(int p) const { return (p >= 0 && p < static_cast<int>(s.stacks.size())) ? to_chips(s.stacks[p]) : 0; }
+  Chips bb() const { return to_chips(s.bb); }
+  Chips last_raise() const { return to_chips(s.last_raise_size); }
+};
+
+struct CompactStateChips {
+  const CompactPublicState& s;
+  int n() const { return s.num_players; }
+  Chips on_street(int i) const { return s.committed_on_street[i]; }
+  Chips max_bet() const { return s.current_bet; }
+  Chips pot() const { return s.pot; }
+  Chips stack(int p) const { return (p >= 0 && p < s.num_players) ? s.stacks[p] : 0; }
+  Chips bb() const { return s.bb; }
+  Chips last_raise() const { return s.last_raise_size; }
+};
+
+template <typename S>
+ChipLegalSummary legal_core(const S& st, int p, const BettingRules& rules) {
+  ChipLegalSummary out;
+  const Chips max_bet = st.max_bet();
+  const Chips pot_now = st.pot();
+  const Chips me_on_street = (p >= 0 && p < st.n()) ? st.on_street(p) : 0;
+  const Chips atc = std::max<Chips>(0, max_bet - me_on_street);
+  const Chips my_stack = st.stack(p);
+
+  const bool facing_bet = atc > 0;
   out.can_check = !facing_bet;
-  out.can_fold = facing_bet && my_stack > 0.0;
+  out.can_fold = facing_bet && my_stack > 0;
   out.call_amount = std::min(atc, my_stack);
 
   if (!facing_bet) {
     // Bet case
-    const double base_min = (rules.min_bet_rule == BettingRules::MinBetRule::BigBlind) ? s.bb : 1.0;
-    const double min_to = std::min(std::max(base_min, 0.0), my_stack);
-    const double max_to = std::min(pot_now, my_stack);
-    if (max_to >= min_to + 1e-9) {
-      out.bet_bounds = RaiseBounds{min_to, max_to};
-    }
+    const Chips base_min = (rules.min_bet_rule == BettingRules::MinBetRule::BigBlind) ? st.bb() : kChipsPerUnit;
+    const Chips min_to = std::min(std::max<Chips>(base_min, 0), my_stack);
+    const Chips max_to = std::min(pot_now, my_stack);
+    if (max_to > min_to) out.bet_bounds = ChipRaiseBounds{min_to, max_to};
   } else {
-    // Raise case
-    const double min_r = min_raise_size(s);
-    const double min_to = std::max(max_bet + min_r, max_bet);  // ensure strictly above
+    // Raise case: min raise is the last raise size on this street, else bb
+    const Chips min_r = st.last_raise() > 0 ? st.last_raise() : st.bb();
+    const Chips min_to = std::max(max_bet + min_r, max_bet);
     // Max raise-over-call is pot after call, capped by remaining stack
-    const double over_call_cap = std::min(pot_after_call(s, p), std::max(0.0, my_stack - atc));
-    const double max_to = max_bet + over_call_cap;
-    if (max_to >= min_to + 1e-9) {
-      out.raise_bounds = RaiseBounds{min_to, max_to};
-    }
+    const Chips over_call_cap = std::min(pot_now + atc, std::max<Chips>(0, my_stack - atc));
+    const Chips max_to = max_bet + over_call_cap;
+    if (max_to > min_to) out.raise_bounds = ChipRaiseBounds{min_to, max_to};
   }
+  return out;
+}
+
+}  // namespace
 
+ChipLegalSummary compute_legal_actions_chips(const PublicState& s, const BettingRules& rules) {
+  return legal_core(PublicStateChips{s}, s.player_to_act, rules);
+}
+
+ChipLegalSummary compute_legal_actions_chips(const CompactPublicState& s, const BettingRules& rules) {
+  if (s.terminal) return ChipLegalSummary{};
+  return legal_core(CompactStateChips{s}, s.player_to_act, rules);
+}
+
+static LegalActionSummary from_chip_summary(const ChipLegalSummary& c) {
+  LegalActionSummary out;
+  out.can_check = c.can_check;
+  out.can_fold = c.can_fold;
+  out.call_amount = from_chips(c.call_amount);
+  if (c.bet_bounds) out.bet_bounds = RaiseBounds{from_chips(c.bet_bounds->min_to), from_chips(c.bet_bounds->max_to)};
+  if (c.raise_bounds) out.raise_bounds = RaiseBounds{from_chips(c.raise_bounds->min_to), from_chips(c.raise_bounds->max_to)};
   return out;
 }
 
-std::string to_json(const LegalActionSummary& la) {
-  std::ostringstream oss;
-  oss << "{";
-  oss << "\"can_check\":" << (la.can_check ? "true" : "false") << ",";
-  oss << "\"can_fold\":" << (la.can_fold ? "true" : "false") << ",";
-  oss << "\"call_amount\":" << la.call_amount << ",";
+LegalActionSummary compute_legal_actions(const PublicState& s, const BettingRules& rules) {
+  return from_chip_summary(compute_legal_actions_chips(s, rules));
+}
+
+LegalActionSummary compute_legal_actions(const CompactPublicState& s, const BettingRules& rules) {
+  return from_chip_summary(compute_legal_actions_chips(s, rules));
+}
+
+void append_json(std::string& out, const LegalActionSummary& la) {
+  StringAppender w(out);
+  w.lit("{\"can_check\":");
+  w.str(la.can_check ? "true" : "false");
+  w.lit(",\"can_fold\":");
+  w.str(la.can_fold ? "true" : "false");
+  w.lit(",\"call_amount\":");
+  w.num(la.call_amount);
+  w.ch(',');
   if (la.bet_bounds) {
-    oss << "\"bet\":{\"min_to\":" << la.bet_bounds->min_to
-        << ",\"max_to\":" << la.bet_bounds->max_to << "},";
+    w.lit("\"bet\":{\"min_to\":");
+    w.num(la.bet_bounds->min_to);
+    w.lit(",\"max_to\":");
+    w.num(la.bet_bounds->max_to);
+    w.lit("},");
   }
   if (la.raise_bounds) {
-    oss << "\"raise\":{\"min_to\":" << la.raise_bounds->min_to
-        << ",\"max_to\":" << la.raise_bounds->max_to << "},";
+    w.lit("\"raise\":{\"min_to\":");
+    w.num(la.raise_bounds->min_to);
+    w.lit(",\"max_to\":");
+    w.num(la.raise_bounds->max_to);
+    w.lit("},");
   }
-  oss << "\"suggestions\":[";
+  w.lit("\"suggestions\":[");
   for (size_t i = 0; i < la.suggestions.size(); ++i) {
     const auto& a = la.suggestions[i];
-    oss << "{\"type\":" << static_cast<int>(a.type)
-        << ",\"amount\":" << a.amount << "}";
-    if (i + 1 < la.suggestions.size()) oss << ",";
+    w.lit("{\"type\":");
+    w.integer(static_cast<int>(a.type));
+    w.lit(",\"amount\":");
+    w.num(a.amount);
+    w.ch('}');
+    if (i + 1 < la.suggestions.size()) w.ch(',');
   }
-  oss << "]}";
-  return oss.str();
+  w.lit("]}");
+}
+
+std::string to_json(const LegalActionSummary& la) {
+  std::string out;
+  append_json(out, la);
+  return out;
 }
 
 }  // namespace quasar
@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "quasar/eval/preflop_equity.h"
+#include "quasar/util/thread_pool.h"
+
+// Usage:
+//   quasar_preflop_equity --out PATH [--boards N] [--seed S] [--threads N] [--classes N]
+// Builds the preflop class-vs-class equity table (quasar/eval/preflop_equity.h).
+// --classes N tabulates only the first N classes (in canonical-mask order),
+// which holds the same entries as the full table for a quick check.
+int main(int argc, char** argv) {
+  quasar::PreflopEquityConfig cfg;
+  std::string out;
+  int threads = 0;
+  size_t limit = 0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--out" && has_value) {
+      out = argv[++i];
+    } else if (arg == "--boards" && has_value) {
+      cfg.boards = static_cast<uint32_t>(std::max(0L, std::atol(argv[++i])));
+    } else if (arg == "--seed" && has_value) {
+      cfg.seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--threads" && has_value) {
+      threads = std::atoi(argv[++i]);
+    } else if (arg == "--classes" && has_value) {
+      limit = static_cast<size_t>(std::max(0L, std::atol(argv[++i])));
+    } else {
+      std::fprintf(stderr, "unknown argument: %s\n", arg.c_str());
+      return 2;
+    }
+  }
+  if (out.empty() || cfg.boards == 0) {
+    std::fprintf(stderr, "usage: quasar_preflop_equity --out PATH [--boards N] [--seed S] [--threads N] [--classes N]\n");
+    return 2;
+  }
+  if (limit > 0) {
+    cfg.classes = quasar::preflop_classes();
+    cfg.classes.resize(std::min(limit, cfg.classes.size()));
+  }
+  std::unique_ptr<quasar::ThreadPool> pool;
+  if (threads > 0) pool = std::make_unique<quasar::ThreadPool>(threads);
+  std::string error;
+  if (!quasar::build_preflop_equity(cfg, out, &error, pool.get())) {
+    std::fprintf(stderr, "quasar_preflop_equity: %s\n", error.c_str());
+    return 1;
+  }
+  return 0;
+}
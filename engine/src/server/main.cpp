@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <pthread.h>
+#include <string>
+
+#include "quasar/server/solve_server.h"
+
+// Usage:
+//   quasar_server --unix PATH | --port N  [--workers N] [--max-queue N] [--cache N]
+// Serves the framed protocol in quasar/server/solve_server.h until SIGINT or
+// SIGTERM. --port 0 picks a free localhost port; the bound endpoint is printed
+// on stdout once the server is listening.
+int main(int argc, char** argv) {
+  quasar::SolveServerConfig cfg;
+  bool have_endpoint = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--unix" && has_value) {
+      cfg.unix_path = argv[++i];
+      have_endpoint = true;
+    } else if (arg == "--port" && has_value) {
+      cfg.tcp_port = std::atoi(argv[++i]);
+      have_endpoint = true;
+    } else if (arg == "--workers" && has_value) {
+      cfg.workers = std::atoi(argv[++i]);
+    } else if (arg == "--max-queue" && has_value) {
+      cfg.max_in_flight = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+    } else if (arg == "--cache" && has_value) {
+      cfg.cache_capacity = static_cast<size_t>(std::max(0L, std::atol(argv[++i])));
+    } else {
+      std::fprintf(stderr, "unknown argument: %s\n", arg.c_str());
+      return 2;
+    }
+  }
+  if (!have_endpoint) {
+    std::fprintf(stderr, "usage: quasar_server --unix PATH | --port N [--workers N] [--max-queue N] [--cache N]\n");
+    return 2;
+  }
+
+  // Block the stop signals before any thread starts so only sigwait sees them.
+  sigset_t stop_signals;
+  sigemptyset(&stop_signals);
+  sigaddset(&stop_signals, SIGINT);
+  sigaddset(&stop_signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
+  quasar::SolveServer server(cfg);
+  if (!server.start()) {
+    std::perror("quasar_server: cannot listen");
+    return 1;
+  }
+  if (cfg.unix_path.empty()) {
+    std::printf("listening on 127.0.0.1:%d\n", server.port());
+  } else {
+    std::printf("listening on %s\n", cfg.unix_path.c_str());
+  }
+  std::fflush(stdout);
+
+  int sig = 0;
+  sigwait(&stop_signals, &sig);
+  server.stop();
+  const auto st = server.stats();
+  std::fprintf(stderr, "connections=%llu requests=%llu solved=%llu invalid=%llu overloaded=%llu expired=%llu\n",
+               static_cast<unsigned long long>(st.connections), static_cast<unsigned long long>(st.requests),
+               static_cast<unsigned long long>(st.solved), static_cast<unsigned long long>(st.invalid),
+               static_cast<unsigned long long>(st.overloaded), static_cast<unsigned long long>(st.expired));
+  return 0;
+}
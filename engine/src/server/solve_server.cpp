@@ -0,0 +1,375 @@
+#include "quasar/server/solve_server.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "quasar/engine/json.h"
+#include "quasar/engine/solve_one.h"
+#include "quasar/engine/wire.h"
+#include "quasar/util/thread_pool.h"
+
+namespace quasar {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+inline void put_u32(unsigned char* p, uint32_t v) {
+  p[0] = static_cast<unsigned char>(v);
+  p[1] = static_cast<unsigned char>(v >> 8);
+  p[2] = static_cast<unsigned char>(v >> 16);
+  p[3] = static_cast<unsigned char>(v >> 24);
+}
+
+inline uint32_t get_u32(const unsigned char* p) {
+  return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+bool read_full(int fd, void* buf, size_t n) {
+  char* p = static_cast<char*>(buf);
+  while (n > 0) {
+    const ssize_t r = ::recv(fd, p, n, 0);
+    if (r > 0) {
+      p += r;
+      n -= static_cast<size_t>(r);
+    } else if (r < 0 && errno == EINTR) {
+      continue;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool write_full(int fd, const char* p, size_t n) {
+  while (n > 0) {
+    const ssize_t r = ::send(fd, p, n, kSendFlags);
+    if (r > 0) {
+      p += r;
+      n -= static_cast<size_t>(r);
+    } else if (r < 0 && errno == EINTR) {
+      continue;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Header and payload go out in one write so small frames are one segment.
+bool write_frame(int fd, uint32_t w1, uint32_t w2, std::string_view payload, std::string& buf) {
+  buf.resize(kFrameHeaderBytes + payload.size());
+  auto* h = reinterpret_cast<unsigned char*>(&buf[0]);
+  put_u32(h, static_cast<uint32_t>(payload.size()));
+  put_u32(h + 4, w1);
+  put_u32(h + 8, w2);
+  if (!payload.empty()) std::memcpy(&buf[kFrameHeaderBytes], payload.data(), payload.size());
+  return write_full(fd, buf.data(), buf.size());
+}
+
+void set_nodelay(int fd) {
+  int one = 1;
+  ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+}  // namespace
+
+struct SolveServer::Connection {
+  int fd;
+  std::mutex write_mu;
+  explicit Connection(int f) : fd(f) {}
+  ~Connection() { ::close(fd); }
+
+  void reply(uint32_t id, ServerStatus status, std::string_view body) {
+    thread_local std::string buf;
+    std::lock_guard<std::mutex> lock(write_mu);
+    write_frame(fd, id, static_cast<uint32_t>(status), body, buf);
+  }
+};
+
+struct SolveServer::Session {
+  std::shared_ptr<Connection> conn;
+  std::thread thread;
+  std::atomic<bool> done{false};
+};
+
+SolveServer::SolveServer(const SolveServerConfig& cfg) : cfg_(cfg) {}
+
+SolveServer::~SolveServer() { stop(); }
+
+bool SolveServer::start() {
+  if (listen_fd_ >= 0) return true;
+  const bool unix_socket = !cfg_.unix_path.empty();
+  int fd = -1;
+  if (unix_socket) {
+    sockaddr_un addr{};
+    if (cfg_.unix_path.size() >= sizeof(addr.sun_path)) return false;
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, cfg_.unix_path.c_str(), cfg_.unix_path.size() + 1);
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    ::unlink(cfg_.unix_path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+      ::close(fd);
+      return false;
+    }
+  } else {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(cfg_.tcp_port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    socklen_t len = sizeof(addr);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+      ::close(fd);
+      return false;
+    }
+    port_ = ntohs(addr.sin_port);
+  }
+  if (::listen(fd, 128) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  if (cfg_.cache_capacity > 0) {
+    SolveCacheConfig cc;
+    cc.capacity = cfg_.cache_capacity;
+    cache_ = std::make_unique<SolveCache>(cc);
+  }
+  pool_ = std::make_unique<ThreadPool>(cfg_.workers);
+  listen_fd_ = fd;
+  stopping_ = false;
+  acceptor_ = std::thread([this] { accept_loop(); });
+  return true;
+}
+
+void SolveServer::stop() {
+  if (listen_fd_ < 0) return;
+  stopping_ = true;
+  acceptor_.join();
+  ::close(listen_fd_);
+  listen_fd_ = -1;
+  if (!cfg_.unix_path.empty()) ::unlink(cfg_.unix_path.c_str());
+
+  std::list<std::unique_ptr<Session>> sessions;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mu_);
+    sessions.swap(sessions_);
+  }
+  // Wake blocked readers; pending replies fail quietly on the shut-down socket.
+  for (auto& s : sessions) ::shutdown(s->conn->fd, SHUT_RDWR);
+  for (auto& s : sessions) s->thread.join();
+  pool_.reset();  // drains queued tasks
+  cache_.reset();
+}
+
+void SolveServer::accept_loop() {
+  const bool tcp = cfg_.unix_path.empty();
+  while (!stopping_) {
+    pollfd p{listen_fd_, POLLIN, 0};
+    const int r = ::poll(&p, 1, 100);
+    {
+      // Reap sessions whose client disconnected.
+      std::lock_guard<std::mutex> lock(sessions_mu_);
+      for (auto it = sessions_.begin(); it != sessions_.end();) {
+        if ((*it)->done) {
+          (*it)->thread.join();
+          it = sessions_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    if (r <= 0 || !(p.revents & POLLIN)) continue;
+    const int fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) continue;
+    if (tcp) set_nodelay(fd);
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    ++connections_;
+    auto session = std::make_unique<Session>();
+    session->conn = std::make_shared<Connection>(fd);
+    Session* s = session.get();
+    std::lock_guard<std::mutex> lock(sessions_mu_);
+    sessions_.push_back(std::move(session));
+    s->thread = std::thread([this, s] {
+      read_loop(s->conn);
+      s->done = true;
+    });
+  }
+}
+
+void SolveServer::read_loop(const std::shared_ptr<Connection>& conn) {
+  unsigned char header[kFrameHeaderBytes];
+  std::string payload;
+  while (!stopping_ && read_full(conn->fd, header, sizeof(header))) {
+    const uint32_t length = get_u32(header);
+    const uint32_t id = get_u32(header + 4);
+    const uint32_t deadline_ms = get_u32(header + 8);
+    const auto received = std::chrono::steady_clock::now();
+    if (length > cfg_.max_frame_bytes) {
+      conn->reply(id, ServerStatus::kFrameTooLarge, {});
+      return;
+    }
+    payload.resize(length);
+    if (length > 0 && !read_full(conn->fd, &payload[0], length)) return;
+    ++requests_;
+
+    // Admission control: reject up front rather than queue without bound. A
+    // spot batch weighs one per record, since its records run across the pool.
+    size_t weight = 1;
+    if (is_wire_buffer(payload) && payload.size() >= sizeof(WireHeader)) {
+      WireHeader h;
+      std::memcpy(&h, payload.data(), sizeof(h));
+      weight = std::max<size_t>(1, h.count);
+    }
+    if (in_flight_.fetch_add(weight) + weight > cfg_.max_in_flight) {
+      in_flight_.fetch_sub(weight);
+      ++overloaded_;
+      conn->reply(id, ServerStatus::kOverloaded, {});
+      continue;
+    }
+    const auto deadline = received + std::chrono::milliseconds(deadline_ms);
+    pool_->submit([this, conn, id, deadline, deadline_ms, weight, body = std::move(payload)] {
+      handle(conn, id, deadline, deadline_ms != 0, body);
+      in_flight_.fetch_sub(weight);
+    });
+  }
+}
+
+void SolveServer::handle(const std::shared_ptr<Connection>& conn, uint32_t id,
+                         std::chrono::steady_clock::time_point deadline, bool has_deadline,
+                         const std::string& payload) {
+  if (has_deadline && std::chrono::steady_clock::now() > deadline) {
+    ++expired_;
+    conn->reply(id, ServerStatus::kDeadlineExceeded, {});
+    return;
+  }
+  // Per-worker scratch, reused across requests.
+  thread_local SpotRequest req;
+  thread_local SolveWorkspace ws;
+  thread_local std::string out;
+  if (is_wire_buffer(payload)) {
+    // Binary spot batch: solved across the pool, answered with one result
+    // batch. The deadline is checked per record, not just at the start.
+    bool late = false;
+    if (!solve_wire_batch(payload, out, pool_.get(), has_deadline ? &deadline : nullptr, &late)) {
+      ++invalid_;
+      conn->reply(id, ServerStatus::kInvalidRequest, {});
+      return;
+    }
+    if (late) {
+      ++expired_;
+      conn->reply(id, ServerStatus::kDeadlineExceeded, {});
+      return;
+    }
+    ++solved_;
+    conn->reply(id, ServerStatus::kOk, out);
+    return;
+  }
+  if (!parse_spot_json(payload, req)) {
+    ++invalid_;
+    conn->reply(id, ServerStatus::kInvalidRequest, {});
+    return;
+  }
+  out.clear();
+  if (cache_) {
+    const auto res = cache_->solve(req.state, req.config);
+    append_response_json(out, res->legal, res->actions, res->probabilities);
+  } else {
+    solve_one(req.state, req.config, ws);
+    append_response_json(out, ws.legal, ws.actions, ws.probabilities);
+  }
+  ++solved_;
+  conn->reply(id, ServerStatus::kOk, out);
+}
+
+ServerStats SolveServer::stats() const {
+  ServerStats s;
+  s.connections = connections_;
+  s.requests = requests_;
+  s.solved = solved_;
+  s.invalid = invalid_;
+  s.overloaded = overloaded_;
+  s.expired = expired_;
+  return s;
+}
+
+bool SolveClient::connect_unix(const std::string& path) {
+  close();
+  sockaddr_un addr{};
+  if (path.size() >= sizeof(addr.sun_path)) return false;
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    return false;
+  }
+  fd_ = fd;
+  return true;
+}
+
+bool SolveClient::connect_tcp(int port) {
+  close();
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    return false;
+  }
+  set_nodelay(fd);
+  fd_ = fd;
+  return true;
+}
+
+void SolveClient::close() {
+  if (fd_ >= 0) ::close(fd_);
+  fd_ = -1;
+}
+
+bool SolveClient::send(uint32_t id, std::string_view payload, uint32_t deadline_ms) {
+  thread_local std::string buf;
+  return fd_ >= 0 && write_frame(fd_, id, deadline_ms, payload, buf);
+}
+
+bool SolveClient::recv(ServerResponse& out) {
+  unsigned char header[kFrameHeaderBytes];
+  if (fd_ < 0 || !read_full(fd_, header, sizeof(header))) return false;
+  const uint32_t length = get_u32(header);
+  out.id = get_u32(header + 4);
+  out.status = static_cast<ServerStatus>(get_u32(header + 8));
+  out.body.resize(length);
+  return length == 0 || read_full(fd_, &out.body[0], length);
+}
+
+bool SolveClient::call(std::string_view payload, ServerResponse& out, uint32_t deadline_ms) {
+  const uint32_t id = next_id_++;
+  return send(id, payload, deadline_ms) && recv(out) && out.id == id;
+}
+
+}  // namespace quasar
@@ -0,0 +1,101 @@
+#include "quasar/engine/solve_batch.h"
+
+#include <cmath>
+#include <limits>
+
+#include "quasar/engine/compact_state.h"
+#include "quasar/util/thread_pool.h"
+
+namespace quasar {
+
+namespace {
+
+int street_from_board(const int32_t* board) {
+  int cards = 0;
+  for (int i = 0; i < 5; ++i) cards += board[i] >= 0 ? 1 : 0;
+  return cards >= 5 ? 3 : cards == 4 ? 2 : cards >= 3 ? 1 : 0;
+}
+
+// Fills `s` from row i; false if the row's seat count or to_act is invalid.
+bool load_row(const SpotBatchView& v, size_t i, PublicState& s) {
+  const int P = v.players;
+  const int n = v.num_players ? v.num_players[i] : P;
+  if (n < 2 || n > P) return false;
+  const size_t row = i * static_cast<size_t>(P);
+  s.num_players = n;
+  s.player_to_act = v.to_act[i];
+  if (s.player_to_act < 0 || s.player_to_act >= n) return false;
+  s.button = v.button ? v.button[i] : 0;
+  s.sb = v.sb;
+  s.bb = v.bb;
+  s.ante = v.ante;
+  s.last_raise_size = v.last_raise_size ? v.last_raise_size[i] : 0.0;
+  s.stacks.assign(v.stacks + row, v.stacks + row + n);
+  s.committed_total.assign(v.committed_total + row, v.committed_total + row + n);
+  s.committed_on_street.assign(v.committed_on_street + row, v.committed_on_street + row + n);
+  s.board.clear();
+  if (v.board) {
+    const int32_t* b = v.board + i * 5;
+    for (int k = 0; k < 5; ++k) {
+      if (b[k] >= 0) s.board.push_back(b[k]);
+    }
+    s.street = v.street ? v.street[i] : street_from_board(b);
+  } else {
+    s.street = v.street ? v.street[i] : 0;
+  }
+  return true;
+}
+
+}  // namespace
+
+int max_solve_actions(const SolveOneConfig& cfg) {
+  // fold + call (or check), then min, every fraction, pot raise and all-in.
+  return 2 + static_cast<int>(cfg.discretization.pot_fracs.size()) + 3;
+}
+
+void solve_batch(const SpotBatchView& spots, const SolveOneConfig& cfg,
+                 const ActionBatchOut& out, ThreadPool* pool) {
+  if (spots.n == 0) return;
+  const size_t A = static_cast<size_t>(out.max_actions > 0 ? out.max_actions : 0);
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const bool players_ok = spots.players >= 2 && spots.players <= kMaxPlayers;
+  auto solve_row = [&](size_t i) {
+    thread_local PublicState s;
+    thread_local SolveWorkspace ws;
+    int32_t* types = out.types + i * A;
+    double* amounts = out.amounts + i * A;
+    double* probs = out.probabilities + i * A;
+    for (size_t k = 0; k < A; ++k) {
+      types[k] = -1;
+      amounts[k] = 0.0;
+      probs[k] = 0.0;
+    }
+    out.num_actions[i] = 0;
+    if (out.call_amount) out.call_amount[i] = 0.0;
+    if (out.can_check) out.can_check[i] = 0;
+    if (out.can_fold) out.can_fold[i] = 0;
+    if (out.min_to) out.min_to[i] = nan;
+    if (out.max_to) out.max_to[i] = nan;
+    if (!players_ok || !load_row(spots, i, s)) return;
+
+    solve_one(s, cfg, ws);
+    const LegalActionSummary& la = ws.legal;
+    if (out.call_amount) out.call_amount[i] = la.call_amount;
+    if (out.can_check) out.can_check[i] = la.can_check ? 1 : 0;
+    if (out.can_fold) out.can_fold[i] = la.can_fold ? 1 : 0;
+    const RaiseBounds* rb = la.raise_bounds ? &*la.raise_bounds : la.bet_bounds ? &*la.bet_bounds : nullptr;
+    if (rb && out.min_to) out.min_to[i] = rb->min_to;
+    if (rb && out.max_to) out.max_to[i] = rb->max_to;
+    if (ws.actions.size() > A) return;
+    for (size_t k = 0; k < ws.actions.size(); ++k) {
+      types[k] = static_cast<int32_t>(ws.actions[k].type);
+      amounts[k] = ws.actions[k].amount;
+      probs[k] = ws.probabilities[k];
+    }
+    out.num_actions[i] = static_cast<int32_t>(ws.actions.size());
+  };
+  ThreadPool& p = pool ? *pool : default_thread_pool();
+  p.parallel_for(spots.n, solve_row, 64);
+}
+
+}  // namespace quasar
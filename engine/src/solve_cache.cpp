@@ -0,0 +1,37 @@
+#include "quasar/engine/solve_cache.h"
+
+namespace quasar {
+
+Hash128 solve_cache_key(const PublicState& s, const SolveOneConfig& cfg) {
+  return combine_hashes(hash_public_state(s), hash_solve_config(cfg));
+}
+
+Hash128 solve_cache_key(const CompactPublicState& s, const SolveOneConfig& cfg) {
+  return combine_hashes(s.hash, hash_solve_config(cfg));
+}
+
+SolveCache::SolveCache(const SolveCacheConfig& cfg) : cache_(cfg.capacity, cfg.shards) {}
+
+std::shared_ptr<const SolveOneResult> SolveCache::solve(const PublicState& s, const SolveOneConfig& cfg) {
+  return solve(solve_cache_key(s, cfg), s, cfg);
+}
+
+std::shared_ptr<const SolveOneResult> SolveCache::solve(const CompactPublicState& s, const SolveOneConfig& cfg) {
+  const Hash128 key = solve_cache_key(s, cfg);
+  std::shared_ptr<const SolveOneResult> res;
+  if (cache_.get(key, res)) return res;
+  res = std::make_shared<const SolveOneResult>(solve_one(s.to_public_state(), cfg));
+  cache_.put(key, res);
+  return res;
+}
+
+std::shared_ptr<const SolveOneResult> SolveCache::solve(const Hash128& key, const PublicState& s,
+                                                        const SolveOneConfig& cfg) {
+  std::shared_ptr<const SolveOneResult> res;
+  if (cache_.get(key, res)) return res;
+  res = std::make_shared<const SolveOneResult>(solve_one(s, cfg));
+  cache_.put(key, res);
+  return res;
+}
+
+}  // namespace quasar
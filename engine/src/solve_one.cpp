@@ -1,14 +1,17 @@
 #include "quasar/engine/solve_one.h"
 
 #include <algorithm>
+#include <stdexcept>
+#include <string>
 
 #include "quasar/solver/cfr.h"
 #include "quasar/solver/eval.h"
+#include "quasar/util/thread_pool.h"
 
 namespace quasar {
 
-static std::vector<Action> build_action_list(const PublicState& s, const LegalActionSummary& la, const std::vector<Action>& discrete) {
-  std::vector<Action> out;
+static void build_action_list(const LegalActionSummary& la, const std::vector<Action>& discrete, std::vector<Action>& out) {
+  out.clear();
   if (la.can_check) {
     out.push_back({ActionType::kCheck, 0.0});
   } else {
@@ -16,12 +19,11 @@ static std::vector<Action> build_action_list(const PublicState& s, const LegalAc
     out.push_back({ActionType::kCall, la.call_amount});
   }
   out.insert(out.end(), discrete.begin(), discrete.end());
-  return out;
 }
 
-static std::vector<double> immediate_utilities(const PublicState& s, const LegalActionSummary& la, const std::vector<Action>& actions) {
-  std::vector<double> utils;
-  utils.reserve(actions.size());
+static void immediate_utilities(const PublicState& s, const LegalActionSummary& la, const std::vector<Action>& actions,
+                                std::vector<double>& utils) {
+  utils.clear();
   const int p = s.player_to_act;
   const double me_on_street = s.contributed_this_street(p);
   for (const auto& a : actions) {
@@ -41,36 +43,79 @@ static std::vector<double> immediate_utilities(const PublicState& s, const Legal
     }
     utils.push_back(u);
   }
-  return utils;
 }
 
-SolveOneResult solve_one(const PublicState& s, const SolveOneConfig& cfg) {
-  auto la = compute_legal_actions(s, cfg.rules);
-  auto disc = discretize_actions(s, la, cfg.discretization);
-  auto actions = build_action_list(s, la, disc);
+void solve_one(const PublicState& s, const SolveOneConfig& cfg, SolveWorkspace& ws) {
+  ws.legal = compute_legal_actions(s, cfg.rules);
+  discretize_actions(s, ws.legal, cfg.discretization, ws.discrete);
+  build_action_list(ws.legal, ws.discrete, ws.actions);
 
-  std::vector<double> probs(actions.size(), 0.0);
-  if (actions.empty()) {
-    return SolveOneResult{la, actions, probs};
+  const size_t n = ws.actions.size();
+  if (n == 0) {
+    ws.probabilities.clear();
+    return;
   }
 
   if (cfg.cfr_iters > 0) {
-    std::vector<double> utils;
     if (s.street == 3) {
-      utils = evaluate_simple_river(s, la, actions, cfg.eval);
+      evaluate_simple_river(s, ws.legal, ws.actions, cfg.eval, ws.utils);
     } else {
-      utils = immediate_utilities(s, la, actions);
+      immediate_utilities(s, ws.legal, ws.actions, ws.utils);
     }
     CFRConfig c;
     c.iters = cfg.cfr_iters;
-    auto res = cfr_onestep(utils, c);
-    probs = std::move(res.strategy);
+    cfr_onestep(ws.utils, c, ws.cfr);
+    ws.probabilities.assign(ws.cfr.strategy_sum.begin(), ws.cfr.strategy_sum.end());
   } else {
-    const double u = 1.0 / static_cast<double>(actions.size());
-    std::fill(probs.begin(), probs.end(), u);
+    ws.probabilities.assign(n, 1.0 / static_cast<double>(n));
   }
+}
+
+SolveOneResult solve_one(const PublicState& s, const SolveOneConfig& cfg) {
+  SolveWorkspace ws;
+  solve_one(s, cfg, ws);
+  return SolveOneResult{std::move(ws.legal), std::move(ws.actions), std::move(ws.probabilities)};
+}
+
+// Spots are cheap (microseconds), so hand them out in small chunks to keep
+// scheduling overhead below the work itself.
+static constexpr size_t kSolveGrain = 16;
+
+// Batch workers solve into a per-thread workspace and copy out only the
+// result vectors.
+static SolveOneResult solve_with_thread_workspace(const PublicState& s, const SolveOneConfig& cfg) {
+  thread_local SolveWorkspace ws;
+  solve_one(s, cfg, ws);
+  return SolveOneResult{ws.legal, ws.actions, ws.probabilities};
+}
+
+std::vector<SolveOneResult> solve_many(const PublicState* states, size_t n,
+                                       const SolveOneConfig& cfg,
+                                       ThreadPool* pool) {
+  std::vector<SolveOneResult> out(n);
+  ThreadPool& tp = pool ? *pool : default_thread_pool();
+  tp.parallel_for(n, [&](size_t i) { out[i] = solve_with_thread_workspace(states[i], cfg); }, kSolveGrain);
+  return out;
+}
 
-  return SolveOneResult{la, actions, probs};
+std::vector<SolveOneResult> solve_many(const std::vector<PublicState>& states,
+                                       const SolveOneConfig& cfg,
+                                       ThreadPool* pool) {
+  return solve_many(states.data(), states.size(), cfg, pool);
+}
+
+std::vector<SolveOneResult> solve_many(const std::vector<PublicState>& states,
+                                       const std::vector<SolveOneConfig>& cfgs,
+                                       ThreadPool* pool) {
+  if (states.size() != cfgs.size()) {
+    throw std::invalid_argument("solve_many: " + std::to_string(states.size()) + " states but " +
+                                std::to_string(cfgs.size()) + " configs");
+  }
+  const size_t n = states.size();
+  std::vector<SolveOneResult> out(n);
+  ThreadPool& tp = pool ? *pool : default_thread_pool();
+  tp.parallel_for(n, [&](size_t i) { out[i] = solve_with_thread_workspace(states[i], cfgs[i]); }, kSolveGrain);
+  return out;
 }
 
 }  // namespace quasar
@@ -15,14 +15,16 @@ static inline void normalize(std::vector<double>& v) {
   }
 }
 
-CFRResult cfr_onestep(const std::vector<double>& action_utils, const CFRConfig& cfg) {
+void cfr_onestep(const std::vector<double>& action_utils, const CFRConfig& cfg, CFRWorkspace& ws) {
   const int A = static_cast<int>(action_utils.size());
-  std::vector<double> regrets(A, 0.0);
-  std::vector<double> strategy(A, 0.0);
-  std::vector<double> strategy_sum(A, 0.0);
+  auto& regrets = ws.regrets;
+  auto& strategy = ws.strategy;
+  auto& strategy_sum = ws.strategy_sum;
+  regrets.assign(A, 0.0);
+  strategy_sum.assign(A, 0.0);
 
   // Start with uniform strategy
-  std::fill(strategy.begin(), strategy.end(), A > 0 ? 1.0 / A : 0.0);
+  strategy.assign(A, A > 0 ? 1.0 / A : 0.0);
 
   for (int it = 0; it < cfg.iters; ++it) {
     // Expected utility under current strategy
@@ -46,7 +48,12 @@ CFRResult cfr_onestep(const std::vector<double>& action_utils, const CFRConfig&
 
   // Average strategy
   normalize(strategy_sum);
-  return CFRResult{strategy_sum, regrets};
+}
+
+CFRResult cfr_onestep(const std::vector<double>& action_utils, const CFRConfig& cfg) {
+  CFRWorkspace ws;
+  cfr_onestep(action_utils, cfg, ws);
+  return CFRResult{std::move(ws.strategy_sum), std::move(ws.regrets)};
 }
 
 }  // namespace quasar
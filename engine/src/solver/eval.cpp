@@ -12,14 +12,23 @@ std::vector<double> evaluate_simple_river(const PublicState& s,
                                           const std::vector<Action>& actions,
                                           const SolveOneConfig::SimpleEvalConfig& cfg) {
   std::vector<double> utils;
-  utils.reserve(actions.size());
+  evaluate_simple_river(s, la, actions, cfg, utils);
+  return utils;
+}
+
+void evaluate_simple_river(const PublicState& s,
+                           const LegalActionSummary& la,
+                           const std::vector<Action>& actions,
+                           const SolveOneConfig::SimpleEvalConfig& cfg,
+                           std::vector<double>& utils) {
+  utils.clear();
   const int p = s.player_to_act;
   const int q = 1 - p;  // assume heads-up
   const double pot_now = s.pot_total();
   const double me_on = s.contributed_this_street(p);
   const double opp_on = s.contributed_this_street(q);
-  const double max_bet = s.current_bet_to_call();
-  const bool facing_bet = la.call_amount > 0.0 && (max_bet > me_on + 1e-12);
+  // call_amount is exact (chip legality), so > 0 implies a live bet.
+  const bool facing_bet = la.call_amount > 0.0;
 
   auto call_prob_from_size = [&](double to_amount) {
     // Size as fraction of pot; higher leads to lower call prob.
@@ -75,7 +84,6 @@ std::vector<double> evaluate_simple_river(const PublicState& s,
     }
     utils.push_back(u);
   }
-  return utils;
 }
 
 }  // namespace quasar
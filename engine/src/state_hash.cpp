@@ -0,0 +1,91 @@
+#include "quasar/engine/state_hash.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace quasar {
+
+Hash128 hash_public_state(const PublicStateView& v) {
+  Hasher128 h(1);
+  h.add(static_cast<uint64_t>(v.num_players));
+  h.add(static_cast<uint64_t>(v.player_to_act));
+  h.add(static_cast<uint64_t>(v.button));
+  h.add(static_cast<uint64_t>(v.street));
+  int board[5];
+  int n = 0;
+  for (int i = 0; i < v.board_len; ++i) {
+    if (v.board[i] >= 0 && n < 5) board[n++] = v.board[i];
+  }
+  std::sort(board, board + std::min(n, 3));
+  h.add(static_cast<uint64_t>(n));
+  for (int i = 0; i < n; ++i) h.add(static_cast<uint64_t>(board[i]));
+  h.add(static_cast<uint64_t>(v.sb));
+  h.add(static_cast<uint64_t>(v.bb));
+  h.add(static_cast<uint64_t>(v.ante));
+  const Chips* arrs[3] = {v.stacks, v.committed_total, v.committed_on_street};
+  const int lens[3] = {v.stacks_len, v.committed_total_len, v.committed_on_street_len};
+  for (int a = 0; a < 3; ++a) {
+    h.add(static_cast<uint64_t>(lens[a]));
+    for (int i = 0; i < lens[a]; ++i) h.add(static_cast<uint64_t>(arrs[a][i]));
+  }
+  h.add(static_cast<uint64_t>(v.last_raise_size));
+  if (v.folded_mask | v.acted_mask | static_cast<uint32_t>(v.num_raises) | (v.terminal ? 1u : 0u)) {
+    h.add((static_cast<uint64_t>(v.folded_mask) << 32) | v.acted_mask);
+    h.add((static_cast<uint64_t>(v.num_raises) << 1) | (v.terminal ? 1u : 0u));
+  }
+  return h.digest();
+}
+
+Hash128 hash_public_state(const PublicState& s) {
+  // Convert into stack buffers for the common seat counts.
+  constexpr size_t kInline = 16;
+  Chips inline_buf[3][kInline];
+  std::vector<Chips> heap_buf[3];
+  const std::vector<double>* src[3] = {&s.stacks, &s.committed_total, &s.committed_on_street};
+  const Chips* conv[3];
+  for (int a = 0; a < 3; ++a) {
+    const std::vector<double>& x = *src[a];
+    Chips* dst = inline_buf[a];
+    if (x.size() > kInline) {
+      heap_buf[a].resize(x.size());
+      dst = heap_buf[a].data();
+    }
+    for (size_t i = 0; i < x.size(); ++i) dst[i] = to_chips(x[i]);
+    conv[a] = dst;
+  }
+  PublicStateView v;
+  v.num_players = s.num_players;
+  v.player_to_act = s.player_to_act;
+  v.button = s.button;
+  v.street = s.street;
+  v.board = s.board.data();
+  v.board_len = static_cast<int>(s.board.size());
+  v.sb = to_chips(s.sb);
+  v.bb = to_chips(s.bb);
+  v.ante = to_chips(s.ante);
+  v.stacks = conv[0];
+  v.stacks_len = static_cast<int>(s.stacks.size());
+  v.committed_total = conv[1];
+  v.committed_total_len = static_cast<int>(s.committed_total.size());
+  v.committed_on_street = conv[2];
+  v.committed_on_street_len = static_cast<int>(s.committed_on_street.size());
+  v.last_raise_size = to_chips(s.last_raise_size);
+  return hash_public_state(v);
+}
+
+Hash128 hash_solve_config(const SolveOneConfig& cfg) {
+  Hasher128 h(2);
+  h.add(static_cast<uint64_t>(cfg.rules.min_bet_rule));
+  const auto& d = cfg.discretization;
+  h.add(d.pot_fracs.size());
+  for (double f : d.pot_fracs) h.add_double(f);
+  h.add((d.include_min ? 1u : 0u) | (d.include_pot_raise ? 2u : 0u) | (d.include_all_in ? 4u : 0u));
+  h.add(static_cast<uint64_t>(std::max(0, cfg.cfr_iters)));
+  if (cfg.cfr_iters > 0) {
+    h.add_double(cfg.eval.win_prob);
+    h.add_double(cfg.eval.call_k);
+  }
+  return h.digest();
+}
+
+}  // namespace quasar
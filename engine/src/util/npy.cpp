@@ -0,0 +1,52 @@
+#include "quasar/util/npy.h"
+
+#include <cstdio>
+
+namespace quasar {
+
+namespace {
+
+bool write_array(const std::string& path, const char* descr, const void* data, size_t elem_bytes,
+                 const std::vector<size_t>& shape) {
+  std::string dict = std::string("{'descr': '") + descr + "', 'fortran_order': False, 'shape': (";
+  size_t count = 1;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    dict += std::to_string(shape[i]);
+    if (shape.size() == 1 || i + 1 < shape.size()) dict += ",";
+    if (i + 1 < shape.size()) dict += " ";
+    count *= shape[i];
+  }
+  dict += "), }";
+  // Magic (6) + version (2) + header length (2) + dict, padded with spaces
+  // and a newline so the data starts on a 64-byte boundary.
+  const size_t unpadded = 10 + dict.size() + 1;
+  dict.append((64 - unpadded % 64) % 64, ' ');
+  dict += '\n';
+
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return false;
+  const unsigned char preamble[10] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+                                      static_cast<unsigned char>(dict.size() & 0xFF),
+                                      static_cast<unsigned char>(dict.size() >> 8)};
+  bool ok = std::fwrite(preamble, 1, sizeof(preamble), f) == sizeof(preamble) &&
+            std::fwrite(dict.data(), 1, dict.size(), f) == dict.size() &&
+            (count == 0 || std::fwrite(data, elem_bytes, count, f) == count);
+  ok = std::fclose(f) == 0 && ok;
+  return ok;
+}
+
+}  // namespace
+
+bool write_npy(const std::string& path, const float* data, const std::vector<size_t>& shape) {
+  return write_array(path, "<f4", data, sizeof(float), shape);
+}
+
+bool write_npy(const std::string& path, const int32_t* data, const std::vector<size_t>& shape) {
+  return write_array(path, "<i4", data, sizeof(int32_t), shape);
+}
+
+bool write_npy(const std::string& path, const uint64_t* data, const std::vector<size_t>& shape) {
+  return write_array(path, "<u8", data, sizeof(uint64_t), shape);
+}
+
+}  // namespace quasar
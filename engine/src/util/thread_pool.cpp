@@ -0,0 +1,91 @@
+#include "quasar/util/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace quasar {
+
+ThreadPool::ThreadPool(int num_threads) {
+  if (num_threads <= 0) num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) workers_.emplace_back([this] { worker_loop(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : workers_) t.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void ThreadPool::worker_loop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) return;  // stop_ set and queue drained
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void ThreadPool::parallel_for(size_t n, const std::function<void(size_t)>& fn, size_t grain) {
+  if (n == 0) return;
+  grain = std::max<size_t>(1, grain);
+  struct Job {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::mutex mu;
+    std::condition_variable cv;
+    std::exception_ptr error;
+  };
+  auto job = std::make_shared<Job>();
+  const std::function<void(size_t)>* f = &fn;
+  // Helpers that start after the range is exhausted never touch `fn`.
+  auto run = [job, f, n, grain] {
+    for (;;) {
+      const size_t begin = job->next.fetch_add(grain);
+      if (begin >= n) return;
+      const size_t end = std::min(n, begin + grain);
+      try {
+        for (size_t i = begin; i < end; ++i) (*f)(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(job->mu);
+        if (!job->error) job->error = std::current_exception();
+      }
+      if (job->done.fetch_add(end - begin) + (end - begin) == n) {
+        std::lock_guard<std::mutex> lock(job->mu);
+        job->cv.notify_all();
+      }
+    }
+  };
+  const size_t chunks = (n + grain - 1) / grain;
+  const size_t helpers = std::min(chunks - 1, workers_.size());
+  for (size_t i = 0; i < helpers; ++i) submit(run);
+  run();
+  std::unique_lock<std::mutex> lock(job->mu);
+  job->cv.wait(lock, [&] { return job->done.load() == n; });
+  if (job->error) std::rethrow_exception(job->error);
+}
+
+ThreadPool& default_thread_pool() {
+  static ThreadPool pool;
+  return pool;
+}
+
+}  // namespace quasar
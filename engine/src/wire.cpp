@@ -0,0 +1,249 @@
+#include "quasar/engine/wire.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include "quasar/util/thread_pool.h"
+
+namespace quasar {
+
+namespace {
+
+void write_header(uint16_t kind, size_t n, size_t record_bytes, std::string& out) {
+  WireHeader h;
+  std::memcpy(h.magic, kWireMagic, sizeof(h.magic));
+  h.version = kWireVersion;
+  h.kind = kind;
+  h.count = static_cast<uint32_t>(n);
+  h.record_bytes = static_cast<uint32_t>(record_bytes);
+  out.assign(sizeof(WireHeader) + n * record_bytes, '\0');
+  std::memcpy(&out[0], &h, sizeof(h));
+}
+
+// Validates the header and total size; returns the record count or -1.
+long check_header(std::string_view buf, uint16_t kind, size_t record_bytes) {
+  if (buf.size() < sizeof(WireHeader)) return -1;
+  WireHeader h;
+  std::memcpy(&h, buf.data(), sizeof(h));
+  if (std::memcmp(h.magic, kWireMagic, sizeof(h.magic)) != 0 || h.version != kWireVersion ||
+      h.kind != kind || h.record_bytes != record_bytes ||
+      buf.size() != sizeof(WireHeader) + static_cast<size_t>(h.count) * record_bytes) {
+    return -1;
+  }
+  return static_cast<long>(h.count);
+}
+
+inline const char* record(std::string_view buf, size_t i, size_t record_bytes) {
+  return buf.data() + sizeof(WireHeader) + i * record_bytes;
+}
+
+}  // namespace
+
+bool encode_spot(const PublicState& s, const SolveOneConfig& cfg, WireSpot& out) {
+  const size_t n = s.stacks.size();
+  const auto& fracs = cfg.discretization.pot_fracs;
+  if (n < 2 || n > static_cast<size_t>(kMaxPlayers) || s.committed_total.size() != n ||
+      s.committed_on_street.size() != n || s.board.size() > 5 ||
+      fracs.size() > static_cast<size_t>(kWireMaxFracs)) {
+    return false;
+  }
+  std::memset(&out, 0, sizeof(out));
+  out.sb = s.sb;
+  out.bb = s.bb;
+  out.ante = s.ante;
+  out.last_raise_size = s.last_raise_size;
+  for (size_t i = 0; i < n; ++i) {
+    out.stacks[i] = s.stacks[i];
+    out.committed_total[i] = s.committed_total[i];
+    out.committed_on_street[i] = s.committed_on_street[i];
+  }
+  for (size_t i = 0; i < fracs.size(); ++i) out.pot_fracs[i] = fracs[i];
+  out.win_prob = cfg.eval.win_prob;
+  out.call_k = cfg.eval.call_k;
+  out.cfr_iters = cfg.cfr_iters;
+  out.num_players = static_cast<int8_t>(n);
+  out.player_to_act = static_cast<int8_t>(s.player_to_act);
+  out.button = static_cast<int8_t>(s.button);
+  out.street = static_cast<int8_t>(s.street);
+  for (int i = 0; i < 5; ++i) out.board[i] = i < static_cast<int>(s.board.size()) ? static_cast<int8_t>(s.board[i]) : -1;
+  out.num_fracs = static_cast<uint8_t>(fracs.size());
+  const auto& d = cfg.discretization;
+  out.flags = (d.include_min ? kWireIncludeMin : 0) | (d.include_pot_raise ? kWireIncludePotRaise : 0) |
+              (d.include_all_in ? kWireIncludeAllIn : 0) |
+              (cfg.rules.min_bet_rule == BettingRules::MinBetRule::OneChip ? kWireMinBetOneChip : 0);
+  return true;
+}
+
+bool decode_spot(const WireSpot& w, SpotRequest& out) {
+  if (w.num_players < 2 || w.num_players > kMaxPlayers || w.num_fracs > kWireMaxFracs ||
+      w.player_to_act < 0 || w.player_to_act >= w.num_players) {
+    return false;
+  }
+  const size_t n = static_cast<size_t>(w.num_players);
+  PublicState& s = out.state;
+  s.num_players = w.num_players;
+  s.player_to_act = w.player_to_act;
+  s.button = w.button;
+  s.street = w.street;
+  s.board.clear();
+  for (int8_t c : w.board) {
+    if (c >= 0) s.board.push_back(c);
+  }
+  s.sb = w.sb;
+  s.bb = w.bb;
+  s.ante = w.ante;
+  s.last_raise_size = w.last_raise_size;
+  s.stacks.assign(w.stacks, w.stacks + n);
+  s.committed_total.assign(w.committed_total, w.committed_total + n);
+  s.committed_on_street.assign(w.committed_on_street, w.committed_on_street + n);
+
+  SolveOneConfig& cfg = out.config;
+  cfg.rules.min_bet_rule = (w.flags & kWireMinBetOneChip) ? BettingRules::MinBetRule::OneChip
+                                                           : BettingRules::MinBetRule::BigBlind;
+  cfg.discretization.pot_fracs.assign(w.pot_fracs, w.pot_fracs + w.num_fracs);
+  cfg.discretization.include_min = (w.flags & kWireIncludeMin) != 0;
+  cfg.discretization.include_pot_raise = (w.flags & kWireIncludePotRaise) != 0;
+  cfg.discretization.include_all_in = (w.flags & kWireIncludeAllIn) != 0;
+  cfg.cfr_iters = w.cfr_iters;
+  cfg.eval.win_prob = w.win_prob;
+  cfg.eval.call_k = w.call_k;
+  return true;
+}
+
+bool encode_result(const LegalActionSummary& la, const std::vector<Action>& actions,
+                   const std::vector<double>& probs, WireResult& out) {
+  std::memset(&out, 0, sizeof(out));
+  if (actions.size() > static_cast<size_t>(kWireMaxActions) || probs.size() != actions.size()) return false;
+  out.call_amount = la.call_amount;
+  uint8_t flags = kWireOk | (la.can_check ? kWireCanCheck : 0) | (la.can_fold ? kWireCanFold : 0);
+  if (la.bet_bounds) {
+    flags |= kWireHasBet;
+    out.bet_min_to = la.bet_bounds->min_to;
+    out.bet_max_to = la.bet_bounds->max_to;
+  }
+  if (la.raise_bounds) {
+    flags |= kWireHasRaise;
+    out.raise_min_to = la.raise_bounds->min_to;
+    out.raise_max_to = la.raise_bounds->max_to;
+  }
+  for (size_t i = 0; i < actions.size(); ++i) {
+    out.types[i] = static_cast<int8_t>(actions[i].type);
+    out.amounts[i] = actions[i].amount;
+    out.probabilities[i] = probs[i];
+  }
+  out.num_actions = static_cast<uint8_t>(actions.size());
+  out.flags = flags;
+  return true;
+}
+
+void decode_result(const WireResult& w, SolveOneResult& out) {
+  LegalActionSummary& la = out.legal;
+  la.can_check = (w.flags & kWireCanCheck) != 0;
+  la.can_fold = (w.flags & kWireCanFold) != 0;
+  la.call_amount = w.call_amount;
+  la.bet_bounds.reset();
+  la.raise_bounds.reset();
+  if (w.flags & kWireHasBet) la.bet_bounds = RaiseBounds{w.bet_min_to, w.bet_max_to};
+  if (w.flags & kWireHasRaise) la.raise_bounds = RaiseBounds{w.raise_min_to, w.raise_max_to};
+  la.suggestions.clear();
+  const size_t n = w.num_actions <= kWireMaxActions ? w.num_actions : kWireMaxActions;
+  out.actions.resize(n);
+  out.probabilities.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    out.actions[i].type = static_cast<ActionType>(w.types[i]);
+    out.actions[i].amount = w.amounts[i];
+    out.probabilities[i] = w.probabilities[i];
+  }
+}
+
+void write_spot_batch(const SpotRequest* reqs, size_t n, std::string& out, const std::vector<bool>* ok) {
+  write_header(kWireSpots, n, sizeof(WireSpot), out);
+  WireSpot w;
+  for (size_t i = 0; i < n; ++i) {
+    if ((!ok || (*ok)[i]) && encode_spot(reqs[i].state, reqs[i].config, w)) {
+      std::memcpy(&out[sizeof(WireHeader) + i * sizeof(WireSpot)], &w, sizeof(w));
+    }
+  }
+}
+
+bool read_spot_batch(std::string_view buf, std::vector<SpotRequest>& out, std::vector<bool>* ok) {
+  const long n = check_header(buf, kWireSpots, sizeof(WireSpot));
+  if (n < 0) return false;
+  out.resize(static_cast<size_t>(n));
+  if (ok) ok->assign(static_cast<size_t>(n), false);
+  WireSpot w;
+  for (size_t i = 0; i < out.size(); ++i) {
+    std::memcpy(&w, record(buf, i, sizeof(WireSpot)), sizeof(w));
+    const bool good = decode_spot(w, out[i]);
+    if (ok) (*ok)[i] = good;
+  }
+  return true;
+}
+
+void write_result_batch(const SolveOneResult* results, size_t n, std::string& out) {
+  write_header(kWireResults, n, sizeof(WireResult), out);
+  WireResult w;
+  for (size_t i = 0; i < n; ++i) {
+    if (encode_result(results[i].legal, results[i].actions, results[i].probabilities, w)) {
+      std::memcpy(&out[sizeof(WireHeader) + i * sizeof(WireResult)], &w, sizeof(w));
+    }
+  }
+}
+
+bool read_result_batch(std::string_view buf, std::vector<SolveOneResult>& out, std::vector<bool>* ok) {
+  const long n = check_header(buf, kWireResults, sizeof(WireResult));
+  if (n < 0) return false;
+  out.resize(static_cast<size_t>(n));
+  if (ok) ok->assign(static_cast<size_t>(n), false);
+  WireResult w;
+  for (size_t i = 0; i < out.size(); ++i) {
+    std::memcpy(&w, record(buf, i, sizeof(WireResult)), sizeof(w));
+    decode_result(w, out[i]);
+    if (ok) (*ok)[i] = (w.flags & kWireOk) != 0;
+  }
+  return true;
+}
+
+bool is_wire_buffer(std::string_view buf) {
+  return buf.size() >= sizeof(kWireMagic) && std::memcmp(buf.data(), kWireMagic, sizeof(kWireMagic)) == 0;
+}
+
+bool solve_wire_batch(std::string_view spots, std::string& results, ThreadPool* pool,
+                      const std::chrono::steady_clock::time_point* deadline, bool* expired) {
+  const long count = check_header(spots, kWireSpots, sizeof(WireSpot));
+  if (count < 0) return false;
+  if (expired) *expired = false;
+  const size_t n = static_cast<size_t>(count);
+  write_header(kWireResults, n, sizeof(WireResult), results);
+  if (n == 0) return true;
+  char* dst = &results[sizeof(WireHeader)];
+  // Records are decoded, solved and encoded in place per worker; invalid
+  // spots, and records skipped after the deadline, leave their zeroed record.
+  std::atomic<bool> late{false};
+  auto solve_record = [&](size_t i) {
+    if (deadline) {
+      if (late.load(std::memory_order_relaxed)) return;
+      if (std::chrono::steady_clock::now() > *deadline) {
+        late.store(true, std::memory_order_relaxed);
+        return;
+      }
+    }
+    thread_local SpotRequest req;
+    thread_local SolveWorkspace ws;
+    WireSpot w;
+    std::memcpy(&w, record(spots, i, sizeof(WireSpot)), sizeof(w));
+    if (!decode_spot(w, req)) return;
+    solve_one(req.state, req.config, ws);
+    WireResult r;
+    if (encode_result(ws.legal, ws.actions, ws.probabilities, r)) {
+      std::memcpy(dst + i * sizeof(WireResult), &r, sizeof(r));
+    }
+  };
+  ThreadPool& p = pool ? *pool : default_thread_pool();
+  p.parallel_for(n, solve_record, 16);
+  if (expired) *expired = late.load();
+  return true;
+}
+
+}  // namespace quasar
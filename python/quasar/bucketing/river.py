@@ -1,9 +1,11 @@
 from __future__ import annotations
 
+import itertools
 import math
+import os
 import random
 from dataclasses import dataclass
-from typing import Iterable, List, Sequence, Tuple
+from typing import Iterable, List, Optional, Sequence, Tuple
 
 import numpy as np
 
@@ -47,7 +49,305 @@ def simple_features(board: Sequence[int], hand: Tuple[int, int, int, int]) -> np
     return feats
 
 
-def kmeans(x: np.ndarray, K: int, iters: int = 50, seed: int = 42) -> Tuple[np.ndarray, np.ndarray]:
+def _as_hands(hands) -> np.ndarray:
+    return np.ascontiguousarray(np.asarray(hands, dtype=np.int32).reshape(-1, 4))
+
+
+def hand_features(board: Sequence[int], hands) -> np.ndarray:
+    """`simple_features` for every row of an [N, 4] hand array, vectorized."""
+    h = _as_hands(hands)
+    suits = h // 13
+    suit_counts = (suits[:, :, None] == np.arange(4)[None, None, :]).sum(axis=1)
+    top2 = -np.sort(-(h % 13), axis=1)[:, :2]
+    b_suit_mult, b_rank_mult = board_summary(board)
+    board_cols = np.broadcast_to(np.array([b_suit_mult, b_rank_mult]), (len(h), 2))
+    return np.concatenate([suit_counts, top2, board_cols], axis=1).astype(np.float32)
+
+
+def board_collision_mask(board: Sequence[int], hands, threads: int = 0) -> np.ndarray:
+    """[N] bool: hand shares a card with the board (-1 entries are padding) or
+    holds an out-of-range or repeated card.
+
+    Uses the native `quasar_engine_py.board_collision_mask` (multithreaded,
+    GIL released) when available, else NumPy bitmasks.
+    """
+    h = _as_hands(hands)
+    b = np.ascontiguousarray(np.asarray(list(board), dtype=np.int32).reshape(-1))
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        return qepy.board_collision_mask(b, h, threads)
+    except ImportError:
+        pass
+    valid = ((h >= 0) & (h < 52)).all(axis=1)
+    bits = np.left_shift(np.uint64(1), np.where(valid[:, None], h, 0).astype(np.uint64))
+    hand_bits = np.bitwise_or.reduce(bits, axis=1)
+    distinct = np.sort(h, axis=1)
+    valid &= (distinct[:, 1:] != distinct[:, :-1]).all(axis=1)
+    board_bits = np.uint64(0)
+    for c in b:
+        if 0 <= c < 52:
+            board_bits |= np.uint64(1) << np.uint64(c)
+    return ~valid | ((hand_bits & board_bits) != 0)
+
+
+def _make_key(cat: int, ranks: Sequence[int]) -> int:
+    key = cat << 60
+    for i, r in enumerate(ranks):
+        key |= r << ((4 - i) * 4)
+    return key
+
+
+def eval_5card(cards: Sequence[int]) -> int:
+    """Python mirror of quasar::eval_5card (same key layout)."""
+    ranks = [card_rank(c) for c in cards]
+    counts = [ranks.count(r) for r in range(13)]
+    is_flush = len({card_suit(c) for c in cards}) == 1
+    mask = sum(1 << r for r in set(ranks))
+    hi = -1
+    if mask & 0x100F == 0x100F:
+        hi = 3
+    for top in range(12, 3, -1):
+        need = 0x1F << (top - 4)
+        if mask & need == need:
+            hi = top
+            break
+    desc = sorted(ranks, reverse=True)
+    straight = [3, 2, 1, 0, 12] if hi == 3 else [hi - k for k in range(5)]
+    groups = sorted(((counts[r], r) for r in range(13) if counts[r] >= 2), reverse=True)
+    if hi >= 0 and is_flush:
+        return _make_key(8, straight)
+    if groups and groups[0][0] == 4:
+        q = groups[0][1]
+        return _make_key(7, [q] * 4 + [r for r in desc if r != q][:1])
+    if len(groups) >= 2 and groups[0][0] == 3:
+        return _make_key(6, [groups[0][1]] * 3 + [groups[1][1]] * 2)
+    if is_flush:
+        return _make_key(5, desc)
+    if hi >= 0:
+        return _make_key(4, straight)
+    if groups and groups[0][0] == 3:
+        t = groups[0][1]
+        return _make_key(3, [t] * 3 + [r for r in desc if r != t][:2])
+    if len(groups) >= 2:
+        p1, p2 = groups[0][1], groups[1][1]
+        return _make_key(2, [p1, p1, p2, p2] + [r for r in desc if r not in (p1, p2)][:1])
+    if groups:
+        p = groups[0][1]
+        return _make_key(1, [p, p] + [r for r in desc if r != p][:3])
+    return _make_key(0, desc)
+
+
+_HOLE_PAIRS = [(i, j) for i in range(4) for j in range(i + 1, 4)]
+
+
+def _table_keys(board: List[int], h: np.ndarray) -> np.ndarray:
+    # Best 2-hole + 3-board key for each row of h, from per-board tables (as
+    # in quasar::RiverBoardEvaluator): the best key per hole-rank pair over
+    # the board triples, plus the best flush key when a suit has three board
+    # cards. Works for 3-, 4- and 5-card boards; ignores collisions.
+    triples = list(itertools.combinations(board, 3))
+    suit_hist = [sum(card_suit(c) == s for c in board) for s in range(4)]
+    flush_suit = next((s for s in range(4) if suit_hist[s] >= 3), -1)
+    best = np.zeros((13, 13), dtype=np.uint64)
+    flush_best = np.zeros((13, 13), dtype=np.uint64)
+    for r1 in range(13):
+        for r2 in range(r1, 13):
+            k = f = 0
+            for tri in triples:
+                k = max(k, eval_5card([r1, r2 + 13, *tri]))
+                if r1 != r2 and all(card_suit(c) == flush_suit for c in tri):
+                    f = max(f, eval_5card([flush_suit * 13 + r1, flush_suit * 13 + r2, *tri]))
+            best[r1, r2] = best[r2, r1] = k
+            flush_best[r1, r2] = flush_best[r2, r1] = f
+    ranks, suits = h % 13, h // 13
+    keys = np.zeros(len(h), dtype=np.uint64)
+    for i, j in _HOLE_PAIRS:
+        k = best[ranks[:, i], ranks[:, j]]
+        suited = (suits[:, i] == flush_suit) & (suits[:, j] == flush_suit)
+        k = np.where(suited, np.maximum(k, flush_best[ranks[:, i], ranks[:, j]]), k)
+        keys = np.maximum(keys, k)
+    return keys
+
+
+def river_keys(board: Sequence[int], hands, threads: int = 0) -> np.ndarray:
+    """[N] uint64 best PLO river key per hand (2 hole + 3 board); higher is
+    stronger, 0 where the hand collides with the board or is invalid.
+
+    Uses the native `quasar_engine_py.river_keys` (multithreaded, GIL
+    released) when available. The NumPy fallback uses the same per-board
+    tables as quasar::RiverBoardEvaluator: best key per hole-rank pair, plus
+    the best flush key when the board has a three-card suit.
+    """
+    h = _as_hands(hands)
+    b = [int(c) for c in board]
+    if len(b) != 5 or any(not 0 <= c < 52 for c in b):
+        raise ValueError("river_keys needs a full 5-card board")
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        return qepy.river_keys(np.asarray(b, dtype=np.int32), h, threads)
+    except ImportError:
+        pass
+    keys = _table_keys(b, h)
+    keys[board_collision_mask(b, h)] = 0
+    return keys
+
+
+NUM_PLO_HANDS = 270725  # C(52, 4)
+FEATURE_NAMES = ("ehs", "ehs2", "category", "nut", "flush_draw", "straight_outs")
+_OPPONENTS = 123410  # C(43, 4): opponent hands avoiding the board and the hero
+
+
+def hand_index(hands) -> np.ndarray:
+    """Colexicographic index in [0, NUM_PLO_HANDS) (quasar/eval/hand_index.h)."""
+    s = np.sort(_as_hands(hands), axis=1).astype(np.int64)
+    a, b, c, d = s[:, 0], s[:, 1], s[:, 2], s[:, 3]
+    return a + b * (b - 1) // 2 + c * (c - 1) * (c - 2) // 6 + d * (d - 1) * (d - 2) * (d - 3) // 24
+
+
+def _subset_ids(h: np.ndarray, size: int) -> np.ndarray:
+    # [M, C(4, size)] colex ids of the card subsets of each (ascending) hand.
+    cols = []
+    for pos in itertools.combinations(range(4), size):
+        idx = np.zeros(len(h), dtype=np.int64)
+        for k, p in enumerate(pos, start=1):
+            c = h[:, p].astype(np.int64)
+            idx += np.prod([c - t for t in range(k)], axis=0) // math.factorial(k)
+        cols.append(idx)
+    return np.stack(cols, axis=1)
+
+
+def _score_river(board: List[int], sums: np.ndarray, sums2: np.ndarray, nuts: np.ndarray) -> None:
+    # NumPy version of the native river pass: opponents beaten / tied by each
+    # hand, excluding those sharing a card with it, by inclusion-exclusion
+    # over sorted (subset id, key) lists.
+    deck = [c for c in range(52) if c not in board]
+    h = np.array(list(itertools.combinations(deck, 4)), dtype=np.int32)
+    k = _table_keys(board, h)
+    key = ((k >> np.uint64(60)) << np.uint64(20) | (k & np.uint64(0xFFFFF))).astype(np.int64)
+    sorted_keys = np.sort(key)
+    below = np.searchsorted(sorted_keys, key, "left")
+    not_worse = np.searchsorted(sorted_keys, key, "right")
+    for size, sign in ((1, -1), (2, 1), (3, -1)):
+        ids = _subset_ids(h, size)
+        combined = np.sort((ids << 24 | key[:, None]).ravel())
+        for col in range(ids.shape[1]):
+            q = ids[:, col] << 24
+            below += sign * (np.searchsorted(combined, q | key, "left") - np.searchsorted(combined, q, "left"))
+            not_worse += sign * (np.searchsorted(combined, q | key, "right") - np.searchsorted(combined, q, "left"))
+    not_worse += 1  # the hand itself (its four-card subset term)
+    num = (below + not_worse).astype(np.uint64)
+    idx = hand_index(h)
+    sums[idx] += num
+    sums2[idx] += num * num
+    nuts[idx] += not_worse == _OPPONENTS
+
+
+def _straight(hole_ranks: int, board_ranks: int) -> bool:
+    for hi in range(3, 13):
+        w = 0x100F if hi == 3 else 0x1F << (hi - 4)
+        missing = w & ~board_ranks
+        if bin(missing).count("1") <= 2 and not missing & ~hole_ranks and bin(hole_ranks & w).count("1") >= 2:
+            return True
+    return False
+
+
+def hand_strength_features(board: Sequence[int], hands, threads: int = 0) -> np.ndarray:
+    """[N, 6] float32 bucketing features for hands on a 3-, 4- or 5-card board
+    (columns in FEATURE_NAMES; see quasar/eval/features.h):
+    equity vs a uniform random hand over all runouts, E[HS^2], made-hand
+    category / 8, share of runouts holding the nuts, flush draw and straight
+    outs / 13. Rows of hands colliding with the board (or invalid) are zero.
+
+    Uses the native `quasar_engine_py.hand_features` (runouts in parallel,
+    GIL released) when available. The NumPy fallback computes the same values
+    but scores each river in about a second, so turn and especially flop
+    boards are slow without the extension.
+    """
+    h = _as_hands(hands)
+    b = [int(c) for c in board]
+    if not 3 <= len(b) <= 5 or len(set(b)) != len(b) or any(not 0 <= c < 52 for c in b):
+        raise ValueError("board must be 3..5 distinct cards in 0..51")
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        return qepy.hand_features(np.asarray(b, dtype=np.int32), h, threads)
+    except ImportError:
+        pass
+    sums = np.zeros(NUM_PLO_HANDS, dtype=np.uint64)
+    sums2 = np.zeros(NUM_PLO_HANDS, dtype=np.uint64)
+    nuts = np.zeros(NUM_PLO_HANDS, dtype=np.uint64)
+    rest = [c for c in range(52) if c not in b]
+    for runout in itertools.combinations(rest, 5 - len(b)):
+        _score_river(b + list(runout), sums, sums2, nuts)
+    unseen = 52 - len(b) - 4
+    per_hand = math.comb(unseen, 5 - len(b))
+    out = np.zeros((len(h), len(FEATURE_NAMES)), dtype=np.float32)
+    ok = ~board_collision_mask(b, h)
+    idx = hand_index(np.where(ok[:, None], h, np.arange(4)))
+    scale = 2.0 * _OPPONENTS
+    out[:, 0] = sums[idx] / (scale * per_hand)
+    out[:, 1] = sums2[idx] / (scale * scale * per_hand)
+    out[:, 3] = nuts[idx] / per_hand
+    out[:, 2] = (_table_keys(b, np.where(ok[:, None], h, 0)) >> np.uint64(60)).astype(np.float32) / 8.0
+    if len(b) < 5:
+        board_suits = np.bincount(np.asarray(b) // 13, minlength=4)
+        hole_suits = (h[:, :, None] // 13 == np.arange(4)).sum(axis=1)
+        out[:, 4] = ((board_suits == 2)[None, :] & (hole_suits >= 2)).any(axis=1)
+        board_ranks = sum(1 << r for r in {c % 13 for c in b})
+        for i, row in enumerate(h.tolist()):
+            if not ok[i]:
+                continue
+            hole_ranks = sum(1 << r for r in {c % 13 for c in row})
+            if not _straight(hole_ranks, board_ranks):
+                outs = sum(
+                    1 for r in range(13) if not board_ranks >> r & 1 and _straight(hole_ranks, board_ranks | 1 << r)
+                )
+                out[i, 5] = outs / 13.0
+    out[~ok] = 0.0
+    return out
+
+
+def _nearest(x: np.ndarray, centers: np.ndarray, block: int = 4096) -> np.ndarray:
+    # ||x - c||^2 = ||x||^2 - 2 x.c + ||c||^2, in row blocks: memory is
+    # O(block * K) instead of the O(N * K * D) broadcast difference.
+    c_norm = (centers * centers).sum(axis=1)
+    labels = np.empty(len(x), dtype=np.int32)
+    for i in range(0, len(x), block):
+        xb = x[i : i + block]
+        labels[i : i + block] = np.argmin(c_norm[None, :] - 2.0 * (xb @ centers.T), axis=1)
+    return labels
+
+
+def kmeans(
+    x: np.ndarray,
+    K: int,
+    iters: int = 50,
+    seed: int = 42,
+    *,
+    batch_size: int = 0,
+    threads: int = 0,
+    out_dir: Optional[str] = None,
+) -> Tuple[np.ndarray, np.ndarray]:
+    """Cluster [N, D] features into K buckets; returns (labels, centers).
+
+    Uses the native `quasar_engine_py.kmeans` (k-means++ seeding, blocked
+    multithreaded assignment, mini-batch updates when batch_size > 0,
+    deterministic for a given seed) when available. The NumPy fallback runs
+    Lloyd iterations from a random init. With `out_dir`, labels.npy and
+    centers.npy are written there.
+    """
+    x = np.ascontiguousarray(x, dtype=np.float32)
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        labels, centers, _ = qepy.kmeans(
+            x, int(K), iters=iters, seed=seed, batch_size=batch_size, threads=threads, out_dir=out_dir or ""
+        )
+        return labels, centers
+    except ImportError:
+        pass
     rng = np.random.default_rng(seed)
     N, D = x.shape
     if K >= N:
@@ -57,16 +357,19 @@ def kmeans(x: np.ndarray, K: int, iters: int = 50, seed: int = 42) -> Tuple[np.n
     centers = x[idx].copy()
     labels = np.zeros(N, dtype=np.int32)
     for _ in range(iters):
-        # Assign
-        dists = np.linalg.norm(x[:, None, :] - centers[None, :, :], axis=2)
-        labels = np.argmin(dists, axis=1).astype(np.int32)
-        # Update
-        for k in range(K):
-            mask = labels == k
-            if np.any(mask):
-                centers[k] = x[mask].mean(axis=0)
-            else:
-                centers[k] = x[rng.integers(0, N)]
+        labels = _nearest(x, centers)
+        sums = np.zeros((K, D), dtype=np.float64)
+        np.add.at(sums, labels, x)
+        counts = np.bincount(labels, minlength=K)
+        filled = counts > 0
+        centers[filled] = (sums[filled] / counts[filled, None]).astype(np.float32)
+        empty = np.flatnonzero(~filled)
+        if len(empty):
+            centers[empty] = x[rng.integers(0, N, size=len(empty))]
+    if out_dir:
+        os.makedirs(out_dir, exist_ok=True)
+        np.save(os.path.join(out_dir, "labels.npy"), labels)
+        np.save(os.path.join(out_dir, "centers.npy"), centers)
     return labels, centers
 
 
@@ -75,9 +378,13 @@ def bucket_hands_on_river(
     hands: Sequence[Tuple[int, int, int, int]],
     K: int = 50,
     seed: int = 42,
+    out_dir: Optional[str] = None,
 ) -> BucketResult:
-    feats = np.stack([simple_features(board, h) for h in hands], axis=0)
-    labels, centers = kmeans(feats, K, seed=seed)
+    """Cluster river hands; with `out_dir`, writes labels.npy, centers.npy and features.npy."""
+    feats = hand_features(board, hands)
+    labels, centers = kmeans(feats, K, seed=seed, out_dir=out_dir)
+    if out_dir:
+        np.save(os.path.join(out_dir, "features.npy"), feats)
     return BucketResult(labels=labels, centers=centers, K=int(centers.shape[0]), features=feats)
 
 
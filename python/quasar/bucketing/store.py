@@ -0,0 +1,182 @@
+"""Memory-mapped hand -> bucket store (engine/include/quasar/bucketing/bucket_store.h).
+
+One file holds per-board bucket maps: a 32-byte header (padded to 64) with
+`bucket_version`, one block of uint16/uint32 ids per suit-canonical board
+indexed by colex hand index, and a directory of (canonical board mask,
+offset) sorted by mask. Readers map the file instead of unpickling lists, so
+opening is O(1) and a lookup is a directory search plus one array read.
+"""
+from __future__ import annotations
+
+import itertools
+import os
+from typing import Any, Dict, Optional, Sequence, Tuple
+
+import numpy as np
+
+from quasar.bucketing.river import NUM_PLO_HANDS, hand_index
+
+MAGIC = b"QBKT"
+FORMAT = 1
+NO_BUCKET = 0xFFFFFFFF
+DATA_START = 64
+
+HEADER_DTYPE = np.dtype(
+    [
+        ("magic", "S4"),
+        ("format", "<u2"),
+        ("id_bytes", "<u2"),
+        ("bucket_version", "<u4"),
+        ("num_boards", "<u4"),
+        ("dir_offset", "<u8"),
+        ("hands_per_board", "<u4"),
+        ("reserved", "<u4"),
+    ]
+)
+ENTRY_DTYPE = np.dtype([("board_key", "<u8"), ("offset", "<u8")])
+assert HEADER_DTYPE.itemsize == 32 and ENTRY_DTYPE.itemsize == 16
+
+# Lexicographic order, matching the C++ tie-break between equal masks.
+_PERMS = list(itertools.permutations(range(4)))
+_ALL_HANDS: Optional[np.ndarray] = None
+
+
+def _all_hands() -> np.ndarray:
+    # [NUM_PLO_HANDS, 4] ascending hands, row i = colex index i.
+    global _ALL_HANDS
+    if _ALL_HANDS is None:
+        combos = np.array(list(itertools.combinations(range(52), 4)), dtype=np.int32)
+        out = np.empty_like(combos)
+        out[hand_index(combos)] = combos
+        _ALL_HANDS = out
+    return _ALL_HANDS
+
+
+def canonical_board(board: Sequence[int]) -> Tuple[int, Tuple[int, ...]]:
+    """(card mask, suit_map) of the suit relabeling with the smallest mask."""
+    cards = [int(c) for c in board]
+    if not 3 <= len(cards) <= 5 or len(set(cards)) != len(cards) or any(not 0 <= c < 52 for c in cards):
+        raise ValueError("board must be 3..5 distinct cards in 0..51")
+    best = None
+    for p in _PERMS:
+        mask = sum(1 << (p[c // 13] * 13 + c % 13) for c in cards)
+        if best is None or mask < best[0]:
+            best = (mask, p)
+    assert best is not None
+    return best
+
+
+def _relabel(cards: np.ndarray, suit_map: Sequence[int]) -> np.ndarray:
+    return np.asarray(suit_map, dtype=np.int32)[cards // 13] * 13 + cards % 13
+
+
+def dense_labels(hands, labels) -> np.ndarray:
+    """[NUM_PLO_HANDS] uint32 labels indexed by colex hand index (NO_BUCKET
+    elsewhere), e.g. from `bucket_hands_on_river(board, hands).labels`."""
+    out = np.full(NUM_PLO_HANDS, NO_BUCKET, dtype=np.uint32)
+    out[hand_index(hands)] = np.asarray(labels, dtype=np.uint32)
+    return out
+
+
+def write_bucket_store(
+    path: str, bucket_version: int, boards: Sequence[Sequence[int]], labels: Sequence[np.ndarray], id_bytes: int = 2
+) -> None:
+    """Write per-board dense labels ([NUM_PLO_HANDS] each, see `dense_labels`).
+
+    Uses the native writer when available. Boards must be distinct up to suit
+    isomorphism; with id_bytes=2, ids must be below 0xFFFF.
+    """
+    if id_bytes not in (2, 4):
+        raise ValueError("id_bytes must be 2 or 4")
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        qepy.write_bucket_store(
+            path, bucket_version, [list(map(int, b)) for b in boards], np.stack(labels).astype(np.uint32), id_bytes
+        )
+        return
+    except ImportError:
+        pass
+    id_dtype = np.dtype("<u2" if id_bytes == 2 else "<u4")
+    block_bytes = (NUM_PLO_HANDS * id_bytes + 63) // 64 * 64
+    hands = _all_hands()
+    entries = []
+    with open(path, "wb") as f:
+        f.write(b"\0" * DATA_START)
+        offset = DATA_START
+        for board, lab in zip(boards, labels):
+            key, suit_map = canonical_board(board)
+            if any(e[0] == key for e in entries):
+                raise ValueError(f"board {list(board)} duplicates a stored board up to suit isomorphism")
+            lab = np.asarray(lab, dtype=np.uint64)
+            keep = (lab != NO_BUCKET) & ~np.isin(hands, list(board)).any(axis=1)
+            if id_bytes == 2 and (lab[keep] >= 0xFFFF).any():
+                raise ValueError("bucket id does not fit in uint16")
+            block = np.full(block_bytes // id_bytes, np.iinfo(id_dtype).max, dtype=id_dtype)
+            block[hand_index(_relabel(hands[keep], suit_map))] = lab[keep]
+            f.write(block.tobytes())
+            entries.append((key, offset))
+            offset += block_bytes
+        entries.sort()
+        f.write(np.array(entries, dtype=ENTRY_DTYPE).tobytes())
+        header = np.zeros(1, dtype=HEADER_DTYPE)
+        header[0] = (MAGIC, FORMAT, id_bytes, bucket_version, len(entries), offset, NUM_PLO_HANDS, 0)
+        f.seek(0)
+        f.write(header.tobytes())
+
+
+class BucketStore:
+    """NumPy memmap reader with the same API as `quasar_engine_py.BucketStore`."""
+
+    def __init__(self, path: str):
+        self._mm = np.memmap(path, dtype=np.uint8, mode="r")
+        if len(self._mm) < DATA_START:
+            raise ValueError(f"not a readable bucket store: {path}")
+        h = np.frombuffer(self._mm[: HEADER_DTYPE.itemsize].tobytes(), dtype=HEADER_DTYPE)[0]
+        if h["magic"] != MAGIC or h["format"] != FORMAT or h["id_bytes"] not in (2, 4) or h["hands_per_board"] != NUM_PLO_HANDS:
+            raise ValueError(f"not a readable bucket store: {path}")
+        self.bucket_version = int(h["bucket_version"])
+        self.id_bytes = int(h["id_bytes"])
+        self.num_boards = int(h["num_boards"])
+        start = int(h["dir_offset"])
+        if start + self.num_boards * ENTRY_DTYPE.itemsize > len(self._mm):
+            raise ValueError(f"truncated bucket store: {path}")
+        self._dir = self._mm[start : start + self.num_boards * ENTRY_DTYPE.itemsize].view(ENTRY_DTYPE)
+        self._dtype = np.dtype("<u2" if self.id_bytes == 2 else "<u4")
+
+    def _block(self, board: Sequence[int]) -> Tuple[Optional[np.ndarray], Tuple[int, ...]]:
+        key, suit_map = canonical_board(board)
+        keys = self._dir["board_key"]
+        i = int(np.searchsorted(keys, np.uint64(key)))
+        if i == len(keys) or int(keys[i]) != key:
+            return None, suit_map
+        off = int(self._dir["offset"][i])
+        return self._mm[off : off + NUM_PLO_HANDS * self.id_bytes].view(self._dtype), suit_map
+
+    def buckets_of(self, board: Sequence[int], hands) -> np.ndarray:
+        h = np.asarray(hands, dtype=np.int32).reshape(-1, 4)
+        out = np.full(len(h), NO_BUCKET, dtype=np.uint32)
+        block, suit_map = self._block(board)
+        if block is None:
+            return out
+        from quasar.bucketing.river import board_collision_mask
+
+        ok = ~board_collision_mask(board, h)
+        ids = block[hand_index(_relabel(h[ok], suit_map))].astype(np.uint32)
+        if self.id_bytes == 2:
+            ids[ids == 0xFFFF] = NO_BUCKET
+        out[ok] = ids
+        return out
+
+    def bucket_of(self, board: Sequence[int], hand: Sequence[int]) -> int:
+        return int(self.buckets_of(board, [hand])[0])
+
+
+def open_bucket_store(path: str) -> Any:
+    """Native mmap reader when the extension is built, else the NumPy one."""
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        return qepy.BucketStore(path)
+    except ImportError:
+        return BucketStore(path)
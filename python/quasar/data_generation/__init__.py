@@ -1,2 +1 @@
-# Placeholder for self-play, solver orchestration, replay interfaces
-
+# Self-play data: training shard format and streaming loader (shards.py)
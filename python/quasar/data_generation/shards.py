@@ -0,0 +1,229 @@
+"""Training shards written by `quasar_datagen` (engine/include/quasar/datagen/datagen.h).
+
+A shard is a 64-byte header followed by two 64-byte-aligned float32 columns:
+queries `[count, players, input_size]` and targets `[count, players, K]`.
+Both columns are memory-mapped, so records are read straight from the page
+cache, and shuffling permutes record indices instead of moving data.
+"""
+from __future__ import annotations
+
+import json
+import os
+from dataclasses import dataclass
+from typing import Iterator, List, Optional, Sequence, Tuple, Union
+
+import numpy as np
+
+MAGIC = b"QSHD"
+FORMAT = 2
+
+HEADER_DTYPE = np.dtype(
+    [
+        ("magic", "S4"),
+        ("format", "<u2"),
+        ("players", "<u2"),
+        ("K", "<u4"),
+        ("input_size", "<u4"),
+        ("count", "<u4"),
+        ("bucket_version", "<u4"),
+        ("first_record", "<u8"),
+        ("seed", "<u8"),
+        ("query_offset", "<u8"),
+        ("target_offset", "<u8"),
+        ("reserved", "u1", (8,)),
+    ]
+)
+assert HEADER_DTYPE.itemsize == 64
+
+
+def _target_offset(count: int, players: int, input_size: int) -> int:
+    return (HEADER_DTYPE.itemsize + count * players * input_size * 4 + 63) // 64 * 64
+
+
+@dataclass
+class Shard:
+    path: str
+    K: int
+    players: int
+    input_size: int
+    bucket_version: int
+    first_record: int
+    seed: int
+    queries: np.ndarray  # [count, players, input_size] float32 memmap
+    targets: np.ndarray  # [count, players, K] float32 memmap
+
+    def __len__(self) -> int:
+        return len(self.queries)
+
+
+def open_shard(path: str) -> Shard:
+    """Maps a shard's columns copy-on-write: nothing is read until used, and
+    the arrays are writable (as torch.from_numpy requires) without touching
+    the file."""
+    mm = np.memmap(path, dtype=np.uint8, mode="c")
+    if len(mm) < HEADER_DTYPE.itemsize:
+        raise ValueError(f"not a training shard: {path}")
+    h = mm[: HEADER_DTYPE.itemsize].view(HEADER_DTYPE)[0]
+    if h["magic"] != MAGIC:
+        raise ValueError(f"not a training shard: {path}")
+    if h["format"] != FORMAT:
+        raise ValueError(f"{path}: shard format {int(h['format'])}, expected {FORMAT}")
+    count, players, width, K = int(h["count"]), int(h["players"]), int(h["input_size"]), int(h["K"])
+    q0, t0 = int(h["query_offset"]), int(h["target_offset"])
+    if q0 != HEADER_DTYPE.itemsize or t0 != _target_offset(count, players, width) or len(mm) != t0 + count * players * K * 4:
+        raise ValueError(f"{path}: truncated or inconsistent shard")
+    queries = mm[q0 : q0 + count * players * width * 4].view(np.float32).reshape(count, players, width)
+    targets = mm[t0:].view(np.float32).reshape(count, players, K)
+    return Shard(path, K, players, width, int(h["bucket_version"]), int(h["first_record"]), int(h["seed"]), queries, targets)
+
+
+def write_shard(
+    path: str, queries: np.ndarray, targets: np.ndarray, *, bucket_version: int = 0, first_record: int = 0, seed: int = 0
+) -> None:
+    """Writes one shard from [count, players, 8 + K] queries and [count, players, K] targets."""
+    q = np.ascontiguousarray(queries, dtype="<f4")
+    t = np.ascontiguousarray(targets, dtype="<f4")
+    count, players, width = q.shape
+    K = t.shape[2]
+    if t.shape[:2] != (count, players) or width != 8 + K:
+        raise ValueError("queries must be [N, P, 8 + K] and targets [N, P, K]")
+    h = np.zeros(1, dtype=HEADER_DTYPE)
+    t0 = _target_offset(count, players, width)
+    h[0] = (MAGIC, FORMAT, players, K, width, count, bucket_version, first_record, seed, HEADER_DTYPE.itemsize, t0, 0)
+    tmp = path + ".tmp"
+    with open(tmp, "wb") as f:
+        f.write(h.tobytes())
+        f.write(q.tobytes())
+        f.write(b"\0" * (t0 - HEADER_DTYPE.itemsize - q.nbytes))
+        f.write(t.tobytes())
+    os.replace(tmp, path)
+
+
+def read_manifest(directory: str) -> dict:
+    with open(os.path.join(directory, "manifest.json")) as f:
+        return json.load(f)
+
+
+def shard_paths(directory: str) -> List[str]:
+    """Shard files listed in a datagen output directory's manifest, in order."""
+    return [os.path.join(directory, s["file"]) for s in read_manifest(directory)["shards"]]
+
+
+try:
+    from torch.utils.data import IterableDataset as _DatasetBase  # type: ignore
+except ImportError:  # NumPy-only installs still get the iterator
+    _DatasetBase = object  # type: ignore
+
+
+class ShardDataset(_DatasetBase):  # type: ignore[misc]
+    """Streams (queries, targets) batches from memory-mapped shards.
+
+    source: a datagen output directory (read through its manifest) or a list
+    of shard paths. shuffle:
+      - "records": one permutation of all records per epoch; each batch is
+        gathered from the maps (one copy per batch).
+      - "blocks": shard order and each shard's batch order are permuted;
+        batches are zero-copy views of contiguous records.
+      - "none": file order, zero-copy views.
+    Call `set_epoch(e)` for a new order each epoch; the order depends only on
+    (seed, epoch). Under a torch DataLoader, workers take every
+    num_workers-th batch of the same plan. Batches are NumPy arrays, or
+    torch tensors sharing their memory with `as_torch=True`.
+    """
+
+    def __init__(
+        self,
+        source: Union[str, Sequence[str]],
+        batch_size: int = 1024,
+        shuffle: str = "records",
+        seed: int = 0,
+        drop_last: bool = False,
+        as_torch: bool = False,
+        bucket_version: Optional[int] = None,
+    ):
+        if shuffle not in ("records", "blocks", "none"):
+            raise ValueError("shuffle must be 'records', 'blocks' or 'none'")
+        paths = shard_paths(source) if isinstance(source, str) else list(source)
+        self.shards = [open_shard(p) for p in paths]
+        if not self.shards:
+            raise ValueError("no shards")
+        s0 = self.shards[0]
+        for s in self.shards:
+            if (s.K, s.players, s.input_size, s.bucket_version) != (s0.K, s0.players, s0.input_size, s0.bucket_version):
+                raise ValueError(f"{s.path}: K/players/input_size/bucket_version differ from {s0.path}")
+        if bucket_version is not None and s0.bucket_version != bucket_version:
+            raise ValueError(f"shards use bucket_version {s0.bucket_version}, expected {bucket_version}")
+        self.K, self.players, self.input_size, self.bucket_version = s0.K, s0.players, s0.input_size, s0.bucket_version
+        self.batch_size = int(batch_size)
+        self.shuffle = shuffle
+        self.seed = seed
+        self.drop_last = drop_last
+        self.as_torch = as_torch
+        self.epoch = 0
+        self._starts = np.cumsum([0] + [len(s) for s in self.shards])
+
+    @property
+    def num_records(self) -> int:
+        return int(self._starts[-1])
+
+    def set_epoch(self, epoch: int) -> None:
+        self.epoch = int(epoch)
+
+    def _plan(self) -> list:
+        # Batches as (shard, start, stop) views or index arrays.
+        rng = np.random.default_rng([self.seed, self.epoch])
+        bs = self.batch_size
+        if self.shuffle == "records":
+            perm = rng.permutation(self.num_records)
+            stop = len(perm) - len(perm) % bs if self.drop_last else len(perm)
+            return [perm[i : min(i + bs, stop)] for i in range(0, stop, bs)]
+        order = rng.permutation(len(self.shards)) if self.shuffle == "blocks" else range(len(self.shards))
+        plan = []
+        for si in order:
+            n = len(self.shards[si])
+            blocks = [(int(si), i, min(i + bs, n)) for i in range(0, n, bs) if not (self.drop_last and i + bs > n)]
+            if self.shuffle == "blocks":
+                blocks = [blocks[j] for j in rng.permutation(len(blocks))]
+            plan.extend(blocks)
+        return plan
+
+    def __len__(self) -> int:
+        return len(self._plan())
+
+    def _gather(self, ids: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        which = np.searchsorted(self._starts, ids, side="right") - 1
+        q = np.empty((len(ids), self.players, self.input_size), dtype=np.float32)
+        t = np.empty((len(ids), self.players, self.K), dtype=np.float32)
+        for si in np.unique(which):
+            sel = which == si
+            # Sorted local indices read each shard's pages in file order.
+            local = ids[sel] - self._starts[si]
+            order = np.argsort(local, kind="stable")
+            dst = np.flatnonzero(sel)[order]
+            q[dst] = self.shards[si].queries[local[order]]
+            t[dst] = self.shards[si].targets[local[order]]
+        return q, t
+
+    def __iter__(self) -> Iterator[Tuple[np.ndarray, np.ndarray]]:
+        plan = self._plan()
+        worker, workers = 0, 1
+        try:
+            from torch.utils.data import get_worker_info  # type: ignore
+
+            info = get_worker_info()
+            if info is not None:
+                worker, workers = info.id, info.num_workers
+        except ImportError:
+            pass
+        for b in plan[worker::workers]:
+            if isinstance(b, tuple):
+                s = self.shards[b[0]]
+                q, t = s.queries[b[1] : b[2]], s.targets[b[1] : b[2]]
+            else:
+                q, t = self._gather(b)
+            if self.as_torch:
+                import torch  # type: ignore
+
+                yield torch.from_numpy(np.asarray(q)), torch.from_numpy(np.asarray(t))
+            else:
+                yield q, t
@@ -1,10 +1,12 @@
 from __future__ import annotations
 
+import atexit
 import json
 import os
 import shutil
 import subprocess
-from typing import Any, Dict, Optional, Union
+import threading
+from typing import Any, Dict, List, Optional, Sequence, Union
 
 
 def _to_json_str(data: Union[str, Dict[str, Any]]) -> str:
@@ -16,10 +18,13 @@ def _to_json_str(data: Union[str, Dict[str, Any]]) -> str:
 def solve_one_move(spot: Union[str, Dict[str, Any]], *, cli_path: Optional[str] = None) -> Dict[str, Any]:
     """Solve one move by calling pybind if available, else falling back to CLI.
 
+    The CLI fallback reuses one `quasar_cli --stream` process per binary
+    (see StreamingEngine), so only the first call pays process startup.
+
     Args:
         spot: dict or JSON string matching docs/SPOT_JSON.md schema
-        cli_path: optional path to compiled quasar_cli binary; if None, tries to
-                  discover in common build locations.
+        cli_path: optional path to compiled quasar_cli binary; if None, uses
+                  $QUASAR_CLI or tries to discover in common build locations.
     Returns:
         Parsed JSON dict with keys: legal, uniform_actions
     """
@@ -33,22 +38,214 @@ def solve_one_move(spot: Union[str, Dict[str, Any]], *, cli_path: Optional[str]
     except Exception:
         pass
 
-    # Fallback to CLI
-    if cli_path is None:
-        # try standard build path
-        candidates = [
-            os.path.join(os.path.dirname(os.path.dirname(__file__)), "..", "build", "engine", "quasar_cli"),
-            os.path.join(os.getcwd(), "build", "engine", "quasar_cli"),
-        ]
-        for c in candidates:
-            if os.path.exists(c) and os.access(c, os.X_OK):
-                cli_path = c
-                break
-    if cli_path is None:
-        raise RuntimeError("CLI not found; set cli_path to quasar_cli")
-
-    proc = subprocess.run([cli_path], input=payload.encode("utf-8"), stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    # Fallback to a persistent `quasar_cli --stream` process
+    return _stream_engine(cli_path).solve(payload)
+
+
+def _find_cli(cli_path: Optional[str]) -> str:
+    if cli_path is not None:
+        return cli_path
+    env = os.environ.get("QUASAR_CLI")
+    if env:
+        return env
+    # try standard build path
+    candidates = [
+        os.path.join(os.path.dirname(os.path.dirname(__file__)), "..", "build", "engine", "quasar_cli"),
+        os.path.join(os.getcwd(), "build", "engine", "quasar_cli"),
+    ]
+    for c in candidates:
+        if os.path.exists(c) and os.access(c, os.X_OK):
+            return c
+    raise RuntimeError("CLI not found; set cli_path to quasar_cli")
+
+
+class StreamingEngine:
+    """A long-lived `quasar_cli --stream` process answering one spot per line.
+
+    Avoids process startup per request and keeps the CLI's result cache warm.
+    Thread-safe (requests are serialized); restarts the process if it exits.
+    Usable as a context manager.
+    """
+
+    def __init__(self, cli_path: Optional[str] = None, *, cache: Optional[int] = None):
+        self.cli_path = _find_cli(cli_path)
+        self.cache = cache
+        self._proc: Optional[subprocess.Popen] = None
+        self._lock = threading.Lock()
+
+    def _start(self) -> subprocess.Popen:
+        args = [self.cli_path, "--stream"]
+        if self.cache is not None:
+            args += ["--cache", str(int(self.cache))]
+        return subprocess.Popen(
+            args,
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.DEVNULL,
+            text=True,
+            encoding="utf-8",
+            bufsize=1,
+        )
+
+    def solve(self, spot: Union[str, Dict[str, Any]]) -> Dict[str, Any]:
+        # One request per line: JSON strings cannot contain raw newlines, so
+        # folding them to spaces keeps any valid document intact.
+        line = _to_json_str(spot).replace("\r", " ").replace("\n", " ")
+        with self._lock:
+            if self._proc is None or self._proc.poll() is not None:
+                self._proc = self._start()
+            assert self._proc.stdin is not None and self._proc.stdout is not None
+            self._proc.stdin.write(line + "\n")
+            self._proc.stdin.flush()
+            out = self._proc.stdout.readline()
+        if not out:
+            raise RuntimeError("quasar_cli --stream exited unexpectedly")
+        res = json.loads(out)
+        if "error" in res:
+            raise ValueError(f"quasar_cli rejected spot: {res['error']}")
+        return res
+
+    def close(self) -> None:
+        with self._lock:
+            if self._proc is not None:
+                if self._proc.stdin:
+                    self._proc.stdin.close()
+                self._proc.wait(timeout=5)
+                if self._proc.stdout:
+                    self._proc.stdout.close()
+                self._proc = None
+
+    def __enter__(self) -> "StreamingEngine":
+        return self
+
+    def __exit__(self, *exc: Any) -> None:
+        self.close()
+
+
+_STREAMS: Dict[str, StreamingEngine] = {}
+_STREAMS_LOCK = threading.Lock()
+
+
+def _stream_engine(cli_path: Optional[str]) -> StreamingEngine:
+    path = _find_cli(cli_path)
+    with _STREAMS_LOCK:
+        eng = _STREAMS.get(path)
+        if eng is None:
+            eng = StreamingEngine(path)
+            _STREAMS[path] = eng
+            atexit.register(eng.close)
+        return eng
+
+
+
+def solve_many_moves(spots: Sequence[Union[str, Dict[str, Any]]], *, threads: int = 0, cli_path: Optional[str] = None) -> List[Dict[str, Any]]:
+    """Solve a batch of spots; results are returned in input order.
+
+    Uses the pybind `solve_many_json` (parallel, GIL released) when available,
+    otherwise falls back to the persistent CLI stream.
+    """
+    payloads = [_to_json_str(s) for s in spots]
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        return [json.loads(o) for o in qepy.solve_many_json(payloads, threads)]
+    except ImportError:
+        pass
+    return [solve_one_move(p, cli_path=cli_path) for p in payloads]
+
+
+def solve_wire_batch(spots: bytes, *, threads: int = 0, cli_path: Optional[str] = None) -> bytes:
+    """Solve a binary spot batch (quasar.wire) and return the binary result batch.
+
+    Uses the pybind `solve_wire_batch` (GIL released) when available,
+    otherwise pipes the batch through `quasar_cli --binary`.
+    """
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        return qepy.solve_wire_batch(spots, threads)
+    except ImportError:
+        pass
+    args = [_find_cli(cli_path), "--binary"]
+    if threads > 0:
+        args += ["--threads", str(int(threads))]
+    proc = subprocess.run(args, input=spots, stdout=subprocess.PIPE, stderr=subprocess.PIPE, check=False)
     if proc.returncode != 0:
-        raise RuntimeError(f"quasar_cli failed: {proc.stderr.decode('utf-8', 'ignore')}")
-    return json.loads(proc.stdout.decode("utf-8"))
+        raise ValueError(proc.stderr.decode("utf-8", "replace").strip() or "quasar_cli --binary failed")
+    return proc.stdout
 
+
+def solve_batch(
+    stacks: "np.ndarray",
+    committed_total: "np.ndarray",
+    committed_on_street: "np.ndarray",
+    to_act: "np.ndarray",
+    *,
+    board: Optional["np.ndarray"] = None,
+    button: Optional["np.ndarray"] = None,
+    street: Optional["np.ndarray"] = None,
+    num_players: Optional["np.ndarray"] = None,
+    last_raise_size: Optional["np.ndarray"] = None,
+    sb: float = 1.0,
+    bb: float = 2.0,
+    ante: float = 0.0,
+    config: Optional[Dict[str, Any]] = None,
+    threads: int = 0,
+    cli_path: Optional[str] = None,
+) -> Dict[str, "np.ndarray"]:
+    """Solve N spots given as NumPy arrays; returns padded NumPy outputs.
+
+    Inputs: stacks/committed_total/committed_on_street [N, P], to_act [N],
+    optional board [N, 5] (-1 padded), button/street/num_players [N] int32
+    and last_raise_size [N]. `config` holds the spot JSON config blocks.
+    Outputs: types/amounts/probs [N, A] (type -1 pads unused slots),
+    num_actions, call_amount, can_check, can_fold, min_to, max_to [N].
+
+    Uses the pybind `solve_batch` (GIL released, no per-spot Python objects)
+    when available, else the binary wire format through `quasar_cli --binary`.
+    """
+    import numpy as np
+
+    from quasar import wire
+
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        def opt(a: Any, dtype: Any) -> Any:
+            return None if a is None else np.ascontiguousarray(a, dtype=dtype)
+
+        return qepy.solve_batch(
+            np.ascontiguousarray(stacks, dtype=np.float64),
+            np.ascontiguousarray(committed_total, dtype=np.float64),
+            np.ascontiguousarray(committed_on_street, dtype=np.float64),
+            np.ascontiguousarray(to_act, dtype=np.int32),
+            board=opt(board, np.int32),
+            button=opt(button, np.int32),
+            street=opt(street, np.int32),
+            num_players=opt(num_players, np.int32),
+            last_raise_size=opt(last_raise_size, np.float64),
+            sb=sb,
+            bb=bb,
+            ante=ante,
+            config_json=json.dumps(config) if config else "",
+            threads=threads,
+        )
+    except ImportError:
+        pass
+    buf = wire.spot_batch_from_arrays(
+        stacks,
+        committed_total,
+        committed_on_street,
+        to_act,
+        board=board,
+        button=button,
+        street=street,
+        num_players=num_players,
+        last_raise_size=last_raise_size,
+        sb=sb,
+        bb=bb,
+        ante=ante,
+        config=config,
+    )
+    out = solve_wire_batch(buf, threads=threads, cli_path=cli_path)
+    return wire.result_arrays(out, wire.max_solve_actions(config))
@@ -1,5 +1,6 @@
 from __future__ import annotations
 
+import struct
 from dataclasses import dataclass
 from typing import Optional
 
@@ -39,3 +40,62 @@ def export_to_torchscript(model: DenseTransformerNet, path: str, batch: int = 2,
     scripted.save(path)
     return path
 
+
+
+NATIVE_MAGIC = b"QVNW"
+NATIVE_VERSION = 1
+
+
+def export_native_weights(model: DenseTransformerNet, path: str) -> str:
+    """Write fp32 weights in the engine's native binary format (load_native_value_net).
+
+    Layout (little-endian): magic "QVNW", u32 version, u32 input_size, output_size,
+    d_model, nhead, num_layers, dim_feedforward, flags (bit0 norm_first, bit1 gelu),
+    f32 layer_norm eps; then raw f32 tensors: proj_in W,b; per layer in_proj W,b,
+    out_proj W,b, linear1 W,b, linear2 W,b, norm1 g,b, norm2 g,b; head W,b.
+    """
+    layers = list(model.encoder.layers)
+    first = layers[0]
+    flags = 0
+    if getattr(first, "norm_first", False):
+        flags |= 1
+    if getattr(first, "activation_relu_or_gelu", 1) == 2:
+        flags |= 2
+
+    def raw(t: torch.Tensor) -> bytes:
+        return t.detach().to(torch.float32).contiguous().cpu().numpy().astype("<f4").tobytes()
+
+    with open(path, "wb") as f:
+        f.write(NATIVE_MAGIC)
+        f.write(
+            struct.pack(
+                "<8If",
+                NATIVE_VERSION,
+                model.input_size,
+                model.output_size,
+                model.proj_in.out_features,
+                first.self_attn.num_heads,
+                len(layers),
+                first.linear1.out_features,
+                flags,
+                float(first.norm1.eps),
+            )
+        )
+        f.write(raw(model.proj_in.weight))
+        f.write(raw(model.proj_in.bias))
+        for layer in layers:
+            f.write(raw(layer.self_attn.in_proj_weight))
+            f.write(raw(layer.self_attn.in_proj_bias))
+            f.write(raw(layer.self_attn.out_proj.weight))
+            f.write(raw(layer.self_attn.out_proj.bias))
+            f.write(raw(layer.linear1.weight))
+            f.write(raw(layer.linear1.bias))
+            f.write(raw(layer.linear2.weight))
+            f.write(raw(layer.linear2.bias))
+            f.write(raw(layer.norm1.weight))
+            f.write(raw(layer.norm1.bias))
+            f.write(raw(layer.norm2.weight))
+            f.write(raw(layer.norm2.bias))
+        f.write(raw(model.head.weight))
+        f.write(raw(model.head.bias))
+    return path
@@ -0,0 +1,49 @@
+from __future__ import annotations
+
+import torch
+import torch.nn as nn
+
+
+class SparseTransformerNet(nn.Module):
+    """Sparse-bucket value net: only populated buckets are read or written.
+
+    forward(pub, indices, values, mask):
+      pub:     [batch, players, 8] public slice prefix
+      indices: [batch, players, M] int64 bucket ids
+      values:  [batch, players, M] range mass
+      mask:    [batch, players, M] 1 for populated entries
+    returns [batch, players, M] CFVs aligned with indices (0 on padding).
+    """
+
+    def __init__(self, num_buckets: int, d_model: int = 64, nhead: int = 4, num_layers: int = 2):
+        super().__init__()
+        self.input_size = int(num_buckets)
+        self.output_size = int(num_buckets)
+        self.is_sparse = True
+
+        self.pub_proj = nn.Linear(8, d_model)
+        self.in_emb = nn.Embedding(num_buckets, d_model)
+        encoder_layer = nn.TransformerEncoderLayer(d_model=d_model, nhead=nhead, dim_feedforward=4 * d_model, batch_first=True)
+        self.encoder = nn.TransformerEncoder(encoder_layer, num_layers=num_layers)
+        self.out_emb = nn.Embedding(num_buckets, d_model)
+        self.out_bias = nn.Embedding(num_buckets, 1)
+
+    def forward(self, pub: torch.Tensor, indices: torch.Tensor, values: torch.Tensor, mask: torch.Tensor) -> torch.Tensor:
+        w = values * mask
+        # Range embedding: mass-weighted sum of the populated bucket embeddings
+        h = self.pub_proj(pub) + (self.in_emb(indices) * w.unsqueeze(-1)).sum(dim=2)
+        h = self.encoder(h)
+        # Head: per-bucket output embeddings fetched only for the populated ids
+        out = (self.out_emb(indices) * h.unsqueeze(2)).sum(dim=-1) + self.out_bias(indices).squeeze(-1)
+        return out * mask
+
+
+def export_sparse_to_torchscript(model: SparseTransformerNet, path: str, batch: int = 2, players: int = 2, m_max: int = 8) -> str:
+    model.eval()
+    pub = torch.zeros((batch, players, 8), dtype=torch.float32)
+    indices = torch.zeros((batch, players, m_max), dtype=torch.int64)
+    values = torch.zeros((batch, players, m_max), dtype=torch.float32)
+    mask = torch.ones((batch, players, m_max), dtype=torch.float32)
+    scripted = torch.jit.trace(model, (pub, indices, values, mask))
+    scripted.save(path)
+    return path
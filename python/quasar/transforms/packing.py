@@ -29,7 +29,7 @@ def pad_board(board: Sequence[int]) -> List[int]:
 
 
 def zero_impossible(range_vec: np.ndarray, range_indices: Optional[Sequence[Tuple[int, int, int, int]]], board: Sequence[int]) -> np.ndarray:
-    """Zero range entries that contain any board card.
+    """Zero range entries that contain any board card (or an invalid/repeated card).
 
     Args:
         range_vec: shape [K]
@@ -37,12 +37,84 @@ def zero_impossible(range_vec: np.ndarray, range_indices: Optional[Sequence[Tupl
         board: list of ints (0..51 or -1)
     """
     out = range_vec.copy()
-    if range_indices is None:
+    if range_indices is None or len(range_indices) == 0:
         return out
-    bset = set([c for c in board if c >= 0])
-    for i, hand in enumerate(range_indices):
-        if any(c in bset for c in hand):
-            out[i] = 0.0
+    from quasar.bucketing.river import board_collision_mask
+
+    hit = board_collision_mask(board, range_indices)
+    out[: len(hit)][hit] = 0.0
+    return out
+
+
+PUBLIC_SIZE = 1 + 1 + 1 + 5  # [PLAYER_ACT, POSITION, S2PR, BOARD[5]]
+IMPOSSIBLE_BUCKET = np.uint64(1 << 63)  # mask bit: bucket is impossible on any board
+
+
+def hand_card_masks(hands) -> np.ndarray:
+    """[N] uint64 card masks of [N, 4] hands (one bucket per hand), with
+    IMPOSSIBLE_BUCKET for a hand holding an out-of-range or repeated card."""
+    h = np.asarray(hands, dtype=np.int32).reshape(-1, 4)
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        return qepy.hand_card_masks(np.ascontiguousarray(h))
+    except ImportError:
+        pass
+    valid = ((h >= 0) & (h < 52)).all(axis=1)
+    bits = np.left_shift(np.uint64(1), np.where(valid[:, None], h, 0).astype(np.uint64))
+    srt = np.sort(h, axis=1)
+    valid &= (srt[:, 1:] != srt[:, :-1]).all(axis=1)
+    return np.where(valid, np.bitwise_or.reduce(bits, axis=1), IMPOSSIBLE_BUCKET)
+
+
+def pack_dense_batch(
+    player_act,
+    positions,
+    s2pr,
+    board,
+    ranges,
+    bucket_masks: Optional[np.ndarray] = None,
+    out: Optional[np.ndarray] = None,
+    threads: int = 0,
+) -> np.ndarray:
+    """Packs B states at once into [B, P, 8 + K] float32 dense slices.
+
+    player_act: [B]; positions: [B, P] (None: seat index); s2pr: [B] unscaled;
+    board: [B, 5] padded with -1 (None: no board); ranges: [B, P, K].
+    bucket_masks: uint64 card mask per bucket ([K] shared, or [P, K] per
+    seat; see `hand_card_masks`); buckets meeting the board are zeroed.
+    Writes into `out` when given. Uses the native packer (GIL released) when
+    available, else vectorized NumPy.
+    """
+    ranges = np.ascontiguousarray(ranges, dtype=np.float32)
+    B, P, K = ranges.shape
+    act = np.ascontiguousarray(np.asarray(player_act, dtype=np.int32).reshape(B))
+    s2 = np.ascontiguousarray(np.asarray(s2pr, dtype=np.float64).reshape(B))
+    pos = None if positions is None else np.ascontiguousarray(np.asarray(positions, dtype=np.int32).reshape(B, P))
+    brd = None if board is None else np.ascontiguousarray(np.asarray(board, dtype=np.int32).reshape(B, 5))
+    masks = None if bucket_masks is None else np.ascontiguousarray(bucket_masks, dtype=np.uint64)
+    if out is None:
+        out = np.empty((B, P, PUBLIC_SIZE + K), dtype=np.float32)
+    try:
+        import quasar_engine_py as qepy  # type: ignore
+
+        return qepy.pack_dense(act, pos, s2, brd, ranges, masks, out, threads)
+    except ImportError:
+        pass
+    out[..., 0] = np.arange(P)[None, :] == act[:, None]
+    out[..., 1] = np.arange(P)[None, :] if pos is None else pos
+    out[..., 2] = (np.minimum(np.maximum(s2, -0.5), s2 + 0.5) * 100.0).astype(np.float32)[:, None]
+    out[..., 3:PUBLIC_SIZE] = -1.0 if brd is None else brd[:, None, :]
+    if masks is None:
+        out[..., PUBLIC_SIZE:] = ranges
+        return out
+    bmask = np.full(B, IMPOSSIBLE_BUCKET, dtype=np.uint64)
+    if brd is not None:
+        valid = (brd >= 0) & (brd < 52)
+        bits = np.left_shift(np.uint64(1), np.where(valid, brd, 0).astype(np.uint64))
+        bmask |= np.bitwise_or.reduce(np.where(valid, bits, np.uint64(0)), axis=1)
+    dead = (masks.reshape(1, -1, K) & bmask[:, None, None]) != 0
+    np.copyto(out[..., PUBLIC_SIZE:], np.where(dead, np.float32(0), ranges))
     return out
 
 
@@ -68,36 +140,84 @@ def pack_per_player_slice(
     P = len(positions)
     assert len(ranges) == P
 
-    padded_board = pad_board(board)
-    s2pr_scaled = clamp_s2pr(s2pr)
-
-    # Determine range length K
+    # Determine range length K; shorter ranges are zero-padded
     K = int(max(len(r) for r in ranges)) if ranges else 0
-    features_per_player = 1 + 1 + 1 + 5 + K
-
-    x = np.zeros((1, P, features_per_player), dtype=np.float32)
+    r = np.zeros((1, P, K), dtype=np.float32)
+    for p in range(P):
+        r[0, p, : len(ranges[p])] = ranges[p]
+
+    masks = None
+    if range_indices is not None:
+        # Buckets without a hand tuple are never zeroed (mask 0).
+        masks = np.zeros((P, K), dtype=np.uint64)
+        for p in range(P):
+            if len(range_indices[p]):
+                m = hand_card_masks(range_indices[p])[:K]
+                masks[p, : len(m)] = m
+
+    x = pack_dense_batch([player_act], [positions], [s2pr], [pad_board(board)], r, masks)
     mask = np.ones((1, P), dtype=np.float32)
+    return PackedBatch(x=x, mask=mask)
 
-    for p in range(P):
-        offset = 0
-        x[0, p, offset] = 1.0 if (p == player_act) else 0.0
-        offset += 1
-        x[0, p, offset] = float(positions[p])
-        offset += 1
-        x[0, p, offset] = s2pr_scaled
-        offset += 1
-        for b in padded_board:
-            x[0, p, offset] = float(b)
-            offset += 1
-
-        r = np.asarray(ranges[p], dtype=np.float32)
-        if range_indices is not None:
-            r = zero_impossible(r, range_indices[p], padded_board)
-
-        # Pad range to K
-        if len(r) < K:
-            r = np.pad(r, (0, K - len(r)))
-        x[0, p, offset : offset + K] = r
 
-    return PackedBatch(x=x, mask=mask)
+@dataclass
+class SparsePackedBatch:
+    # Public prefix per player: [batch, players, 8]
+    pub: np.ndarray
+    # Populated bucket ids: [batch, players, M_max] (int64, padding 0)
+    indices: np.ndarray
+    # Range mass at those buckets: [batch, players, M_max]
+    values: np.ndarray
+    # 1 for populated entries, 0 for padding: [batch, players, M_max]
+    mask: np.ndarray
+
+
+def pack_per_player_sparse(
+    player_act: int,
+    positions: Sequence[int],
+    s2pr: float,
+    board: Sequence[int],
+    range_indices: Sequence[Sequence[int]],
+    range_values: Sequence[Sequence[float]],
+    m_max: int,
+    range_hands: Optional[Sequence[Sequence[Tuple[int, int, int, int]]]] = None,
+) -> SparsePackedBatch:
+    """Packs per-player sparse slices without materializing RANGE[K].
+
+    Each player's range is given as populated bucket ids and their mass. Entries
+    with zero mass are dropped; when `range_hands` is given (one 4-card tuple per
+    entry), entries colliding with the board are dropped as impossible.
+
+    Returns: SparsePackedBatch with batch dimension 1 and M_max padding.
+    """
+    P = len(positions)
+    assert len(range_indices) == P and len(range_values) == P
+
+    padded_board = pad_board(board)
+    bset = set(c for c in padded_board if c >= 0)
 
+    pub = np.zeros((1, P, PUBLIC_SIZE), dtype=np.float32)
+    indices = np.zeros((1, P, m_max), dtype=np.int64)
+    values = np.zeros((1, P, m_max), dtype=np.float32)
+    mask = np.zeros((1, P, m_max), dtype=np.float32)
+
+    pub[0, :, 0] = [1.0 if p == player_act else 0.0 for p in range(P)]
+    pub[0, :, 1] = np.asarray(positions, dtype=np.float32)
+    pub[0, :, 2] = clamp_s2pr(s2pr)
+    pub[0, :, 3:8] = np.asarray(padded_board, dtype=np.float32)
+
+    for p in range(P):
+        idx = np.asarray(range_indices[p], dtype=np.int64)
+        val = np.asarray(range_values[p], dtype=np.float32)
+        keep = val != 0.0
+        if range_hands is not None:
+            keep &= np.array([not any(c in bset for c in h) for h in range_hands[p]], dtype=bool)
+        idx, val = idx[keep], val[keep]
+        if len(idx) > m_max:
+            raise ValueError(f"player {p}: {len(idx)} populated buckets exceed M_max={m_max}")
+        n = len(idx)
+        indices[0, p, :n] = idx
+        values[0, p, :n] = val
+        mask[0, p, :n] = 1.0
+
+    return SparsePackedBatch(pub=pub, indices=indices, values=values, mask=mask)
@@ -0,0 +1,262 @@
+"""Binary wire format for spot and result batches (engine/include/quasar/engine/wire.h).
+
+A batch is one buffer: a 16-byte header followed by fixed-size little-endian
+records, so whole batches map onto NumPy structured arrays without per-spot
+text conversion. The dtypes below mirror the C++ structs field for field.
+"""
+from __future__ import annotations
+
+from typing import Any, Dict, Iterable, Mapping
+
+import numpy as np
+
+MAGIC = b"QWIR"
+VERSION = 1
+KIND_SPOTS = 1
+KIND_RESULTS = 2
+MAX_PLAYERS = 9
+MAX_FRACS = 8
+MAX_ACTIONS = 16
+
+# WireSpot.flags
+INCLUDE_MIN = 1 << 0
+INCLUDE_POT_RAISE = 1 << 1
+INCLUDE_ALL_IN = 1 << 2
+MIN_BET_ONE_CHIP = 1 << 3
+
+# WireResult.flags
+OK = 1 << 0
+CAN_CHECK = 1 << 1
+CAN_FOLD = 1 << 2
+HAS_BET = 1 << 3
+HAS_RAISE = 1 << 4
+
+HEADER_DTYPE = np.dtype(
+    [("magic", "S4"), ("version", "<u2"), ("kind", "<u2"), ("count", "<u4"), ("record_bytes", "<u4")]
+)
+
+SPOT_DTYPE = np.dtype(
+    [
+        ("sb", "<f8"),
+        ("bb", "<f8"),
+        ("ante", "<f8"),
+        ("last_raise_size", "<f8"),
+        ("stacks", "<f8", (MAX_PLAYERS,)),
+        ("committed_total", "<f8", (MAX_PLAYERS,)),
+        ("committed_on_street", "<f8", (MAX_PLAYERS,)),
+        ("pot_fracs", "<f8", (MAX_FRACS,)),
+        ("win_prob", "<f8"),
+        ("call_k", "<f8"),
+        ("cfr_iters", "<i4"),
+        ("num_players", "i1"),
+        ("player_to_act", "i1"),
+        ("button", "i1"),
+        ("street", "i1"),
+        ("board", "i1", (5,)),
+        ("num_fracs", "u1"),
+        ("flags", "u1"),
+        ("reserved", "u1"),
+    ]
+)
+
+RESULT_DTYPE = np.dtype(
+    [
+        ("call_amount", "<f8"),
+        ("bet_min_to", "<f8"),
+        ("bet_max_to", "<f8"),
+        ("raise_min_to", "<f8"),
+        ("raise_max_to", "<f8"),
+        ("amounts", "<f8", (MAX_ACTIONS,)),
+        ("probabilities", "<f8", (MAX_ACTIONS,)),
+        ("types", "i1", (MAX_ACTIONS,)),
+        ("num_actions", "u1"),
+        ("flags", "u1"),
+        ("reserved", "u1", (6,)),
+    ]
+)
+
+assert HEADER_DTYPE.itemsize == 16 and SPOT_DTYPE.itemsize == 344 and RESULT_DTYPE.itemsize == 320
+
+_STREETS = {"preflop": 0, "flop": 1, "turn": 2, "river": 3}
+_DEFAULT_FRACS = (0.33, 0.5, 0.75, 1.0)
+
+
+def _header(kind: int, count: int, record_bytes: int) -> bytes:
+    h = np.zeros(1, dtype=HEADER_DTYPE)
+    h[0] = (MAGIC, VERSION, kind, count, record_bytes)
+    return h.tobytes()
+
+
+def _records(buf: bytes, kind: int, dtype: np.dtype) -> np.ndarray:
+    if len(buf) < HEADER_DTYPE.itemsize:
+        raise ValueError("buffer shorter than a wire header")
+    h = np.frombuffer(buf, dtype=HEADER_DTYPE, count=1)[0]
+    if h["magic"] != MAGIC or h["version"] != VERSION or h["kind"] != kind or h["record_bytes"] != dtype.itemsize:
+        raise ValueError("unexpected wire header")
+    count = int(h["count"])
+    if len(buf) != HEADER_DTYPE.itemsize + count * dtype.itemsize:
+        raise ValueError("wire buffer size does not match its header")
+    return np.frombuffer(buf, dtype=dtype, count=count, offset=HEADER_DTYPE.itemsize)
+
+
+def spot_record(spot: Mapping[str, Any]) -> np.ndarray:
+    """One spot dict (docs/SPOT_JSON.md schema) as a SPOT_DTYPE scalar record."""
+    r = np.zeros((), dtype=SPOT_DTYPE)
+    stacks = list(spot["stacks"])
+    n = len(stacks)
+    if not 2 <= n <= MAX_PLAYERS:
+        raise ValueError(f"wire format supports 2..{MAX_PLAYERS} players, got {n}")
+    disc = spot.get("discretization", {})
+    fracs = list(disc.get("pot_fracs", _DEFAULT_FRACS))
+    if len(fracs) > MAX_FRACS:
+        raise ValueError(f"wire format supports at most {MAX_FRACS} pot_fracs")
+    solver = spot.get("solver", {})
+    board = list(spot.get("board", []))[:5]
+    r["sb"] = spot.get("sb", 1.0)
+    r["bb"] = spot.get("bb", 2.0)
+    r["ante"] = spot.get("ante", 0.0)
+    r["last_raise_size"] = spot.get("last_raise_size", 0.0)
+    r["stacks"][:n] = stacks
+    r["committed_total"][:n] = spot["committed_total"]
+    r["committed_on_street"][:n] = spot["committed_on_street"]
+    r["pot_fracs"][: len(fracs)] = fracs
+    r["win_prob"] = solver.get("win_prob", 0.5)
+    r["call_k"] = solver.get("call_k", 0.5)
+    r["cfr_iters"] = solver.get("iters", 0)
+    r["num_players"] = n
+    r["player_to_act"] = spot.get("to_act", 0)
+    r["button"] = spot.get("button", 0)
+    r["street"] = _STREETS.get(spot.get("street", "preflop"), 0)
+    r["board"] = board + [-1] * (5 - len(board))
+    r["num_fracs"] = len(fracs)
+    r["flags"] = (
+        (INCLUDE_MIN if disc.get("include_min", True) else 0)
+        | (INCLUDE_POT_RAISE if disc.get("include_pot_raise", True) else 0)
+        | (INCLUDE_ALL_IN if disc.get("include_all_in", True) else 0)
+        | (MIN_BET_ONE_CHIP if spot.get("min_bet_rule") == "OneChip" else 0)
+    )
+    return r
+
+
+def encode_spots(spots: Iterable[Mapping[str, Any]]) -> bytes:
+    """Encode spot dicts into one binary spot batch."""
+    records = np.array([spot_record(s) for s in spots], dtype=SPOT_DTYPE)
+    return _header(KIND_SPOTS, len(records), SPOT_DTYPE.itemsize) + records.tobytes()
+
+
+def spot_records(buf: bytes) -> np.ndarray:
+    """Zero-copy SPOT_DTYPE view of a spot batch."""
+    return _records(buf, KIND_SPOTS, SPOT_DTYPE)
+
+
+def result_records(buf: bytes) -> np.ndarray:
+    """Zero-copy RESULT_DTYPE view of a result batch (check `flags & OK`)."""
+    return _records(buf, KIND_RESULTS, RESULT_DTYPE)
+
+
+def result_dict(r: np.ndarray) -> Dict[str, Any]:
+    """One result record in the JSON response shape (docs/SPOT_JSON.md)."""
+    flags = int(r["flags"])
+    if not flags & OK:
+        return {"error": "invalid spot"}
+    legal: Dict[str, Any] = {
+        "can_check": bool(flags & CAN_CHECK),
+        "can_fold": bool(flags & CAN_FOLD),
+        "call_amount": float(r["call_amount"]),
+    }
+    if flags & HAS_BET:
+        legal["bet"] = {"min_to": float(r["bet_min_to"]), "max_to": float(r["bet_max_to"])}
+    if flags & HAS_RAISE:
+        legal["raise"] = {"min_to": float(r["raise_min_to"]), "max_to": float(r["raise_max_to"])}
+    legal["suggestions"] = []
+    n = int(r["num_actions"])
+    actions = [
+        {"type": int(t), "amount": float(a), "prob": float(p)}
+        for t, a, p in zip(r["types"][:n], r["amounts"][:n], r["probabilities"][:n])
+    ]
+    return {"legal": legal, "uniform_actions": actions}
+
+
+def spot_batch_from_arrays(
+    stacks: np.ndarray,
+    committed_total: np.ndarray,
+    committed_on_street: np.ndarray,
+    to_act: np.ndarray,
+    *,
+    board: np.ndarray | None = None,
+    button: np.ndarray | None = None,
+    street: np.ndarray | None = None,
+    num_players: np.ndarray | None = None,
+    last_raise_size: np.ndarray | None = None,
+    sb: float = 1.0,
+    bb: float = 2.0,
+    ante: float = 0.0,
+    config: Mapping[str, Any] | None = None,
+) -> bytes:
+    """Spot batch from the array form used by `quasar_engine_py.solve_batch`.
+
+    stacks/committed_*: [N, P] with P <= MAX_PLAYERS; board: [N, 5] padded
+    with -1; the other per-spot arrays are [N]. `config` takes the spot JSON
+    config blocks (discretization, solver, min_bet_rule). Vectorized: no
+    per-spot Python work.
+    """
+    stacks = np.asarray(stacks, dtype=np.float64)
+    n, p = stacks.shape
+    if p > MAX_PLAYERS:
+        raise ValueError(f"wire format supports at most {MAX_PLAYERS} players")
+    base = spot_record({"stacks": [0.0, 0.0], "committed_total": [0, 0], "committed_on_street": [0, 0], **(config or {})})
+    r = np.repeat(base[None], n)
+    r["sb"], r["bb"], r["ante"] = sb, bb, ante
+    r["stacks"][:, :p] = stacks
+    r["committed_total"][:, :p] = committed_total
+    r["committed_on_street"][:, :p] = committed_on_street
+    r["player_to_act"] = to_act
+    r["num_players"] = p if num_players is None else num_players
+    if button is not None:
+        r["button"] = button
+    if last_raise_size is not None:
+        r["last_raise_size"] = last_raise_size
+    if board is not None:
+        board = np.asarray(board)
+        r["board"] = board
+        cards = (board >= 0).sum(axis=1)
+        derived = np.select([cards >= 5, cards == 4, cards >= 3], [3, 2, 1], 0)
+        r["street"] = derived if street is None else street
+    elif street is not None:
+        r["street"] = street
+    return _header(KIND_SPOTS, n, SPOT_DTYPE.itemsize) + r.tobytes()
+
+
+def result_arrays(buf: bytes, max_actions: int) -> Dict[str, np.ndarray]:
+    """Result batch as the padded array dict returned by `solve_batch`."""
+    recs = result_records(buf)
+    flags = recs["flags"].astype(np.int64)
+    ok = (flags & OK) != 0
+    num = np.where(ok & (recs["num_actions"] <= max_actions), recs["num_actions"], 0).astype(np.int32)
+    used = np.arange(max_actions)[None, :] < num[:, None]
+    has_raise = (flags & HAS_RAISE) != 0
+    has_any = has_raise | ((flags & HAS_BET) != 0)
+    width = min(max_actions, MAX_ACTIONS)
+    types = np.full((len(recs), max_actions), -1, dtype=np.int32)
+    amounts = np.zeros((len(recs), max_actions))
+    probs = np.zeros((len(recs), max_actions))
+    types[:, :width] = recs["types"][:, :width]
+    amounts[:, :width] = recs["amounts"][:, :width]
+    probs[:, :width] = recs["probabilities"][:, :width]
+    return {
+        "types": np.where(used, types, -1).astype(np.int32),
+        "amounts": np.where(used, amounts, 0.0),
+        "probs": np.where(used, probs, 0.0),
+        "num_actions": num,
+        "call_amount": recs["call_amount"].copy(),
+        "can_check": (flags & CAN_CHECK) != 0,
+        "can_fold": (flags & CAN_FOLD) != 0,
+        "min_to": np.where(has_raise, recs["raise_min_to"], np.where(has_any, recs["bet_min_to"], np.nan)),
+        "max_to": np.where(has_raise, recs["raise_max_to"], np.where(has_any, recs["bet_max_to"], np.nan)),
+    }
+
+
+def max_solve_actions(config: Mapping[str, Any] | None = None) -> int:
+    """Row width of `solve_batch` outputs (mirrors quasar::max_solve_actions)."""
+    fracs = (config or {}).get("discretization", {}).get("pot_fracs", _DEFAULT_FRACS)
+    return 2 + len(fracs) + 3
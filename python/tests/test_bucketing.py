@@ -18,3 +18,102 @@ def test_bucket_shapes():
     assert res.centers.shape[0] == K or res.centers.shape[0] == len(hands)
     assert res.features.shape[0] == len(hands)
 
+
+
+def _brute_river_key(board, hand):
+    from itertools import combinations
+
+    from quasar.bucketing.river import eval_5card
+
+    return max(eval_5card(list(h) + list(t)) for h in combinations(hand, 2) for t in combinations(board, 3))
+
+
+def test_river_keys_and_collisions():
+    from quasar.bucketing.river import board_collision_mask, hand_features, river_keys, simple_features
+
+    rng = np.random.default_rng(5)
+    board = [0, 4, 8, 13, 26]  # three clubs: flushes possible
+    deck = np.setdiff1d(np.arange(52), board)
+    hands = np.stack([rng.choice(deck, 4, replace=False) for _ in range(300)]).astype(np.int32)
+    hands[0, 1] = 8  # board card
+    hands[1, 2] = hands[1, 3]  # repeated card
+    keys = river_keys(board, hands)
+    assert keys.dtype == np.uint64 and keys.shape == (300,)
+    assert keys[0] == 0 and keys[1] == 0
+    for i in range(2, 300):
+        assert int(keys[i]) == _brute_river_key(board, hands[i].tolist())
+
+    hit = board_collision_mask([0, 4, 8, -1, -1], hands)
+    expected = [bool(set(h) & {0, 4, 8}) or len(set(h)) < 4 for h in hands.tolist()]
+    assert hit.tolist() == expected
+
+    feats = hand_features(board, hands[:20])
+    assert np.array_equal(feats, np.stack([simple_features(board, tuple(h)) for h in hands[:20].tolist()]))
+
+
+def test_eval_kicker_order():
+    from quasar.bucketing.river import eval_5card
+
+    assert eval_5card([12, 24, 5, 29, 1]) > eval_5card([12, 23, 5, 29, 1])  # A-K-x beats A-Q-x
+    assert eval_5card([7, 20, 0, 27, 2]) > eval_5card([6, 19, 12, 37, 10])  # 9s beat 8s
+
+
+def test_kmeans_blobs_and_artifacts(tmp_path):
+    from quasar.bucketing.river import kmeans
+
+    rng = np.random.default_rng(0)
+    truth = np.repeat(np.arange(4), 50)
+    x = (10.0 * np.eye(4)[truth] + rng.normal(0, 0.1, (200, 4))).astype(np.float32)
+    labels, centers = kmeans(x, 4, seed=1, out_dir=str(tmp_path))
+    assert centers.shape == (4, 4) and labels.shape == (200,)
+    # Each blob maps to one cluster (random init may merge blobs; allow that but never split one).
+    for b in range(4):
+        assert len(set(labels[truth == b].tolist())) == 1
+    assert np.array_equal(np.load(tmp_path / "labels.npy"), labels)
+    assert np.array_equal(np.load(tmp_path / "centers.npy"), centers)
+
+
+def test_hand_strength_features_river():
+    from itertools import combinations
+
+    from quasar.bucketing.river import hand_index, hand_strength_features, river_keys
+
+    board = [0, 4, 8, 13, 26]
+    heroes = np.array([[11, 12, 14, 27], [17, 30, 40, 41], [19, 20, 33, 47], [0, 1, 2, 3]], dtype=np.int32)
+    f = hand_strength_features(board, heroes)
+    assert f.shape == (4, 6) and f.dtype == np.float32
+    assert not f[3].any()  # board collision
+    for i in range(3):
+        hero = heroes[i].tolist()
+        deck = [c for c in range(52) if c not in board and c not in hero]
+        opps = np.array(list(combinations(deck, 4)), dtype=np.int32)
+        hk = river_keys(board, heroes[i : i + 1])[0]
+        ok = river_keys(board, opps)
+        ehs = ((ok < hk).sum() + 0.5 * (ok == hk).sum()) / len(opps)
+        assert abs(f[i, 0] - ehs) < 1e-6 and abs(f[i, 1] - ehs * ehs) < 1e-6
+        assert f[i, 3] == float((ok <= hk).all())
+        assert f[i, 2] == float(int(hk) >> 60) / 8.0
+    assert hand_index([[51, 50, 49, 48]])[0] == 270724
+
+
+def test_bucket_store_roundtrip(tmp_path):
+    from quasar.bucketing.river import bucket_hands_on_river
+    from quasar.bucketing.store import NO_BUCKET, dense_labels, open_bucket_store, write_bucket_store
+
+    board = [0, 1, 2, 14, 28]  # no suit symmetry, so isomorphic hands map 1:1
+    rng = np.random.default_rng(2)
+    deck = np.setdiff1d(np.arange(52), board)
+    hands = np.unique(np.sort(np.stack([rng.choice(deck, 4, replace=False) for _ in range(200)]), axis=1), axis=0)
+    res = bucket_hands_on_river(board, hands, K=8, seed=3)
+    path = str(tmp_path / "river.qbkt")
+    write_bucket_store(path, 5, [board], [dense_labels(hands, res.labels)])
+    store = open_bucket_store(path)
+    assert store.bucket_version == 5 and store.num_boards == 1
+    assert np.array_equal(store.buckets_of(board, hands), res.labels.astype(np.uint32))
+    assert store.bucket_of(board, [0, 1, 2, 3]) == NO_BUCKET  # collides with the board
+    assert store.bucket_of([1, 2, 3], [4, 5, 6, 7]) == NO_BUCKET  # board not stored
+    # Swapping suits on board and hands lands on the same canonical block.
+    swap = np.array([2, 3, 0, 1])
+    iso_board = [int(swap[c // 13] * 13 + c % 13) for c in board]
+    iso_hands = swap[hands // 13] * 13 + hands % 13
+    assert np.array_equal(store.buckets_of(iso_board, iso_hands), res.labels.astype(np.uint32))
@@ -4,7 +4,21 @@ import shutil
 
 import pytest
 
-from quasar.engine_api import solve_one_move
+from quasar.engine_api import StreamingEngine, solve_one_move
+
+
+def _find_cli():
+    env = os.environ.get("QUASAR_CLI")
+    if env and os.access(env, os.X_OK):
+        return env
+    candidates = [
+        os.path.join(os.path.dirname(os.path.dirname(__file__)), "..", "build", "engine", "quasar_cli"),
+        os.path.join(os.getcwd(), "build", "engine", "quasar_cli"),
+    ]
+    for c in candidates:
+        if os.path.exists(c) and os.access(c, os.X_OK):
+            return c
+    return None
 
 
 def test_engine_api_cli_fallback():
@@ -22,15 +36,7 @@ def test_engine_api_cli_fallback():
         "board": [],
     }
     # Try to locate CLI binary if built
-    candidates = [
-        os.path.join(os.path.dirname(os.path.dirname(__file__)), "..", "build", "engine", "quasar_cli"),
-        os.path.join(os.getcwd(), "build", "engine", "quasar_cli"),
-    ]
-    cli = None
-    for c in candidates:
-        if os.path.exists(c) and os.access(c, os.X_OK):
-            cli = c
-            break
+    cli = _find_cli()
     if cli is None:
         pytest.skip("quasar_cli not built; skipping CLI fallback test")
 
@@ -40,3 +46,99 @@ def test_engine_api_cli_fallback():
     # Expect facing 1 chip to call SB vs BB
     assert out["legal"]["call_amount"] == 1
 
+
+
+def test_streaming_engine_reuses_process():
+    cli = _find_cli()
+    if cli is None:
+        pytest.skip("quasar_cli not built; skipping streaming test")
+    spot = {
+        "street": "flop",
+        "sb": 1.0,
+        "bb": 2.0,
+        "to_act": 0,
+        "button": 1,
+        "stacks": [100.0, 100.0],
+        "committed_total": [5.0, 5.0],
+        "committed_on_street": [0.0, 0.0],
+        "board": [0, 12, 25],
+    }
+    with StreamingEngine(cli) as eng:
+        first = eng.solve(spot)
+        pid = eng._proc.pid
+        # Multi-line JSON strings are folded onto one line
+        second = eng.solve(json.dumps(spot, indent=2))
+        assert eng._proc.pid == pid
+        assert first == second
+        assert first["legal"]["bet"] == {"min_to": 2, "max_to": 10}
+        with pytest.raises(ValueError):
+            eng.solve("{not json")
+        # The process survives a rejected request
+        assert eng.solve(spot) == first
+
+
+def test_wire_batch_matches_json():
+    from quasar import wire
+    from quasar.engine_api import solve_wire_batch
+
+    cli = _find_cli()
+    if cli is None:
+        pytest.skip("quasar_cli not built; skipping wire batch test")
+
+    root = os.path.join(os.path.dirname(__file__), "..", "..", "scripts")
+    spots = [json.load(open(os.path.join(root, f))) for f in ("example_spot.json", "example_flop.json")]
+    buf = wire.encode_spots(spots * 3)
+    assert wire.spot_records(buf)["num_players"].tolist() == [2] * 6
+
+    out = solve_wire_batch(buf, cli_path=cli)
+    recs = wire.result_records(out)
+    assert len(recs) == 6 and all(recs["flags"] & wire.OK)
+    with StreamingEngine(cli) as eng:
+        want = [eng.solve(s) for s in spots]
+    for i, r in enumerate(recs):
+        assert wire.result_dict(r) == want[i % 2]
+
+    with pytest.raises(ValueError):
+        solve_wire_batch(b"{}", cli_path=cli)
+
+
+def test_solve_batch_arrays():
+    import numpy as np
+
+    from quasar.engine_api import solve_batch
+
+    cli = _find_cli()
+    if cli is None:
+        pytest.skip("quasar_cli not built; skipping array batch test")
+
+    stacks = np.array([[98, 100, 0], [90, 80, 70], [50, 50, 0]], dtype=np.float64)
+    total = np.array([[1, 2, 0], [10, 10, 10], [5, 5, 0]], dtype=np.float64)
+    street = np.array([[1, 2, 0], [0, 4, 0], [0, 0, 0]], dtype=np.float64)
+    to_act = np.array([0, 0, 7], dtype=np.int32)  # last row is invalid
+    board = np.full((3, 5), -1, dtype=np.int32)
+    board[1, :3] = [0, 13, 26]
+    seats = np.array([2, 3, 2], dtype=np.int32)
+    config = {"discretization": {"pot_fracs": [0.5, 1.0]}}
+    out = solve_batch(stacks, total, street, to_act, board=board, num_players=seats, config=config, cli_path=cli)
+
+    assert out["types"].shape == (3, 2 + 2 + 3) and out["types"].dtype == np.int32
+    assert out["num_actions"][2] == 0 and (out["types"][2] == -1).all() and np.isnan(out["min_to"][2])
+    with StreamingEngine(cli) as eng:
+        for i, cards in enumerate([[], [0, 13, 26]]):
+            n = int(seats[i])
+            spot = {
+                "street": "preflop" if not cards else "flop",
+                "sb": 1.0, "bb": 2.0, "ante": 0.0, "to_act": 0, "button": 0,
+                "stacks": stacks[i, :n].tolist(),
+                "committed_total": total[i, :n].tolist(),
+                "committed_on_street": street[i, :n].tolist(),
+                "board": cards,
+                **config,
+            }
+            want = eng.solve(spot)["uniform_actions"]
+            k = int(out["num_actions"][i])
+            assert k == len(want)
+            assert out["types"][i, :k].tolist() == [a["type"] for a in want]
+            assert out["amounts"][i, :k].tolist() == [a["amount"] for a in want]
+            assert out["probs"][i, :k].tolist() == [a["prob"] for a in want]
+            assert (out["types"][i, k:] == -1).all()
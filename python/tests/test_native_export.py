@@ -0,0 +1,65 @@
+import os
+import struct
+import tempfile
+
+import torch
+
+from quasar.models.dense_transformer import DenseTransformerNet, export_native_weights
+
+
+def test_native_export_header_and_size():
+    model = DenseTransformerNet(input_size=16, output_size=8, d_model=32, nhead=4, num_layers=2)
+    with tempfile.TemporaryDirectory() as td:
+        path = os.path.join(td, "model.qvn")
+        export_native_weights(model, path)
+        with open(path, "rb") as f:
+            blob = f.read()
+    assert blob[:4] == b"QVNW"
+    version, inp, out, d, heads, layers, ff, flags, eps = struct.unpack("<8If", blob[4:40])
+    assert (version, inp, out, d, heads, layers, ff) == (1, 16, 8, 32, 4, 2, 128)
+    assert flags == 0 and abs(eps - 1e-5) < 1e-9
+    per_layer = 3 * d * d + 3 * d + d * d + d + ff * d + ff + d * ff + d + 4 * d
+    n_floats = d * inp + d + layers * per_layer + out * d + out
+    assert len(blob) == 40 + 4 * n_floats
+
+
+# Outputs of a fixed-weight model on a fixed input, from an independent float64
+# reference; tests/test_native_value_net.cpp checks the native forward against
+# the same numbers.
+KNOWN_OUTPUT = [-0.462458, 1.212810, -0.450761, 1.204306, -0.463889, 1.213833, -0.460091, 1.210777]
+
+
+def _export_order(model):
+    tensors = [model.proj_in.weight, model.proj_in.bias]
+    for layer in model.encoder.layers:
+        tensors += [
+            layer.self_attn.in_proj_weight, layer.self_attn.in_proj_bias,
+            layer.self_attn.out_proj.weight, layer.self_attn.out_proj.bias,
+            layer.linear1.weight, layer.linear1.bias, layer.linear2.weight, layer.linear2.bias,
+            layer.norm1.weight, layer.norm1.bias, layer.norm2.weight, layer.norm2.bias,
+        ]
+    return tensors + [model.head.weight, model.head.bias]
+
+
+def test_native_export_forward_matches_known_values():
+    model = DenseTransformerNet(input_size=3, output_size=2, d_model=4, nhead=2, num_layers=2).eval()
+    tensors = _export_order(model)
+    n = sum(t.numel() for t in tensors)
+    flat = (0.5 * torch.sin(0.7 * torch.arange(n, dtype=torch.float64) + 0.3)).float()
+    offset = 0
+    with torch.no_grad():
+        for t in tensors:
+            t.copy_(flat[offset:offset + t.numel()].view_as(t))
+            offset += t.numel()
+        x = (2.0 * torch.cos(1.3 * torch.arange(12, dtype=torch.float64))).float().view(2, 2, 3)
+        y = model(x)
+    assert torch.allclose(y.flatten(), torch.tensor(KNOWN_OUTPUT), atol=1e-5)
+
+    with tempfile.TemporaryDirectory() as td:
+        path = os.path.join(td, "model.qvn")
+        export_native_weights(model, path)
+        with open(path, "rb") as f:
+            blob = f.read()
+    # The exported payload is the formula's floats in file order, which is
+    # what the C++ test writes before checking the native forward.
+    assert blob[40:] == flat.numpy().astype("<f4").tobytes()
@@ -49,3 +49,51 @@ def test_pack_shape_and_zeroing():
     # Second player's hand 1 overlaps board (card 1) -> zeroed
     assert batch.x[0, 1, 8 + 1] == 0.0
 
+
+
+def test_pack_sparse_drops_impossible_and_pads():
+    from quasar.transforms.packing import pack_per_player_sparse
+
+    board = [0, 1, 2, 3, 4]
+    batch = pack_per_player_sparse(
+        player_act=0,
+        positions=[0, 1],
+        s2pr=2.0,
+        board=board,
+        range_indices=[[10, 20, 30], [7, 9]],
+        range_values=[[0.5, 0.0, 0.5], [0.25, 0.75]],
+        m_max=4,
+        range_hands=[[(5, 6, 7, 8), (9, 10, 11, 12), (13, 14, 15, 16)], [(1, 20, 21, 22), (23, 24, 25, 26)]],
+    )
+    assert batch.pub.shape == (1, 2, 8) and batch.indices.shape == (1, 2, 4)
+    assert batch.pub[0, 0, 0] == 1.0 and batch.pub[0, 1, 2] == 200.0
+    # Zero-mass entry (20) dropped
+    assert list(batch.indices[0, 0, :2]) == [10, 30] and list(batch.mask[0, 0]) == [1, 1, 0, 0]
+    # Board-colliding hand (bucket 7 holds card 1) dropped
+    assert batch.indices[0, 1, 0] == 9 and batch.values[0, 1, 0] == 0.75 and batch.mask[0, 1].sum() == 1
+
+
+def test_pack_dense_batch_matches_per_state_packing():
+    from quasar.transforms.packing import hand_card_masks, pack_dense_batch
+
+    rng = np.random.default_rng(0)
+    B, P, K = 6, 3, 12
+    hands = rng.integers(0, 52, size=(K, 4))
+    hands[2] = [7, 7, 8, 9]  # repeated card: always impossible
+    masks = hand_card_masks(hands)
+    assert masks[2] == np.uint64(1 << 63)
+    ranges = rng.random((B, P, K)).astype(np.float32)
+    boards = np.full((B, 5), -1)
+    boards[1:, :3] = rng.choice(52, size=(B - 1, 3))
+    s2pr = np.linspace(-2.0, 4.0, B)
+    out = np.full((B, P, 8 + K), np.nan, dtype=np.float32)
+    x = pack_dense_batch(np.arange(B) % P, None, s2pr, boards, ranges, masks, out=out)
+    assert x is out or np.array_equal(x, out)
+    for b in range(B):
+        for p in range(P):
+            pub = [float(p == b % P), float(p), clamp_s2pr(float(s2pr[b]))] + [float(c) for c in boards[b]]
+            rng_ref = zero_impossible(ranges[b, p], [tuple(h) for h in hands], list(boards[b]))
+            assert np.array_equal(x[b, p], np.concatenate([np.float32(pub), rng_ref]))
+    # The single-state packer is the B=1 case.
+    one = pack_per_player_slice(1, [0, 1, 2], float(s2pr[3]), boards[3, :3], list(ranges[3]), [hands] * P)
+    assert np.array_equal(one.x[0, :, 8:], x[3, :, 8:]) and one.x[0, 1, 0] == 1.0
@@ -17,3 +17,21 @@ def test_export_import_roundtrip():
         y = m(x, mask)
         assert y.shape == (2, 3, 8)
 
+
+
+def test_sparse_export_roundtrip():
+    from quasar.models.sparse_transformer import SparseTransformerNet, export_sparse_to_torchscript
+
+    model = SparseTransformerNet(num_buckets=100, d_model=16, nhead=2, num_layers=1)
+    with tempfile.TemporaryDirectory() as td:
+        path = os.path.join(td, "sparse.pt")
+        export_sparse_to_torchscript(model, path, batch=2, players=2, m_max=6)
+        m = torch.jit.load(path)
+        pub = torch.randn(2, 2, 8)
+        idx = torch.randint(0, 100, (2, 2, 6))
+        val = torch.rand(2, 2, 6)
+        mask = torch.ones(2, 2, 6)
+        mask[:, :, 4:] = 0
+        y = m(pub, idx, val, mask)
+        assert y.shape == (2, 2, 6)
+        assert torch.all(y[:, :, 4:] == 0)
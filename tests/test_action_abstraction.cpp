@@ -0,0 +1,107 @@
+#include "quasar/engine/action_abstraction.h"
+#include "quasar/engine/apply_action.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+
+using namespace quasar;
+
+static bool same_set(std::vector<ChipAction> a, std::vector<ChipAction> b) {
+  auto key = [](const ChipAction& x, const ChipAction& y) {
+    return x.type != y.type ? x.type < y.type : x.amount < y.amount;
+  };
+  std::sort(a.begin(), a.end(), key);
+  std::sort(b.begin(), b.end(), key);
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i)
+    if (a[i].type != b[i].type || a[i].amount != b[i].amount) return false;
+  return true;
+}
+
+int main() {
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<int> chips(0, 40000);
+  std::uniform_int_distribution<int> coin(0, 1);
+
+  const std::vector<std::vector<double>> frac_sets = {
+      {0.33, 0.5, 0.75, 1.0}, {0.5, 1.0, 2.0}, {1.0, 0.25, 1.0, 3.0}, {}};
+  for (const auto& fracs : frac_sets) {
+    DiscretizationConfig d;
+    d.pot_fracs = fracs;
+    d.include_min = coin(rng);
+    d.include_pot_raise = coin(rng);
+    d.include_all_in = coin(rng);
+    ActionAbstraction table(ActionAbstractionConfig::from_discretization(d));
+
+    std::vector<ChipAction> ref, got;
+    for (int it = 0; it < 20000; ++it) {
+      CompactPublicState s;
+      s.num_players = 2;
+      s.street = static_cast<int8_t>(it % 4);
+      s.player_to_act = 0;
+      s.bb = 100;
+      s.stacks[0] = chips(rng) / (1 + it % 7);
+      s.stacks[1] = chips(rng);
+      s.committed_total[0] = 1 + chips(rng) / 10;
+      s.committed_total[1] = s.committed_total[0];
+      if (coin(rng)) {  // facing a bet
+        const Chips bet = 1 + chips(rng) / (1 + it % 13);
+        s.committed_on_street[1] = bet;
+        s.committed_total[1] += bet;
+        s.last_raise_size = coin(rng) ? bet : 0;
+      }
+      s.rehash();
+      ChipLegalSummary la = compute_legal_actions_chips(s);
+      discretize_actions_chips(s, la, d, ref);
+      table.actions(s, la, got);
+      assert(same_set(ref, got));
+      // Ascending, no duplicates per type
+      for (size_t i = 1; i < got.size(); ++i)
+        if (got[i].type == got[i - 1].type) assert(got[i].amount > got[i - 1].amount);
+    }
+  }
+
+  // PLO defaults: flop {50,100,200%} + all-in, raise cap 4 per street.
+  {
+    ActionAbstraction table(ActionAbstractionConfig::plo_default());
+    PublicState p;
+    p.num_players = 2; p.street = 1; p.button = 0; p.player_to_act = 1;
+    p.sb = 0.5; p.bb = 1.0;
+    p.board = {0, 1, 2};
+    p.stacks = {1000, 1000};
+    p.committed_total = {10, 10};
+    p.committed_on_street = {0, 0};
+    CompactPublicState s;
+    CompactPublicState::from_public_state(p, s);
+    std::vector<ChipAction> acts;
+    table.actions(s, compute_legal_actions_chips(s), acts);
+    // 50% and 100%; 200% clamps to the pot (same as 100%), plus all-in at pot.
+    assert(acts.size() == 3);
+    assert(acts[0].type == ActionType::kBet && acts[0].amount == 1000);
+    assert(acts[1].type == ActionType::kBet && acts[1].amount == 2000);
+    assert(acts[2].type == ActionType::kAllIn && acts[2].amount == 2000);
+
+    // Bet, raise, raise, raise reaches the cap: only fold/call remain.
+    ActionUndo u;
+    for (int k = 0; k < 4; ++k) {
+      table.actions(s, compute_legal_actions_chips(s), acts);
+      assert(!acts.empty());
+      apply_action(s, acts.back(), u, false);
+    }
+    assert(s.num_raises == 4 && !s.terminal);
+    table.actions(s, compute_legal_actions_chips(s), acts);
+    assert(acts.empty());
+  }
+
+  // Quantization
+  {
+    ActionAbstraction table(ActionAbstractionConfig{});
+    assert(table.spr_bucket(100, 400) == 1);
+    assert(table.spr_bucket(1000000, 100) == table.spr_bucket(5000, 100));
+    assert(table.facing_bucket(0, 100) == 0 && table.facing_bucket(100, 100) == ActionAbstraction::kFacingSteps);
+  }
+
+  std::cout << "Action abstraction tests passed" << std::endl;
+  return 0;
+}
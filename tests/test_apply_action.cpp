@@ -0,0 +1,156 @@
+#include "quasar/engine/apply_action.h"
+#include "quasar/engine/discretize.h"
+#include "quasar/engine/state_hash.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+using namespace quasar;
+
+static const Chips U = kChipsPerUnit;
+
+static CompactPublicState hu_preflop(double stack) {
+  PublicState s;
+  s.num_players = 2; s.street = 0; s.button = 0; s.player_to_act = 0;  // BTN = SB acts first
+  s.sb = 0.5; s.bb = 1.0;
+  s.stacks = {stack - 0.5, stack - 1.0};
+  s.committed_total = {0.5, 1.0};
+  s.committed_on_street = {0.5, 1.0};
+  CompactPublicState c;
+  bool ok = CompactPublicState::from_public_state(s, c);
+  assert(ok);
+  return c;
+}
+
+static bool same(const CompactPublicState& a, const CompactPublicState& b) {
+  return a.num_players == b.num_players && a.player_to_act == b.player_to_act && a.street == b.street &&
+         a.stacks == b.stacks && a.committed_total == b.committed_total &&
+         a.committed_on_street == b.committed_on_street && a.last_raise_size == b.last_raise_size &&
+         a.pot == b.pot && a.current_bet == b.current_bet && a.folded_mask == b.folded_mask &&
+         a.acted_mask == b.acted_mask && a.num_raises == b.num_raises && a.terminal == b.terminal &&
+         a.hash == b.hash;
+}
+
+static void children(const CompactPublicState& s, std::vector<ChipAction>& out, std::vector<ChipAction>& tmp) {
+  out.clear();
+  ChipLegalSummary la = compute_legal_actions_chips(s);
+  if (la.can_fold) out.push_back({ActionType::kFold, 0});
+  if (la.can_check) out.push_back({ActionType::kCheck, 0});
+  if (la.call_amount > 0) out.push_back({ActionType::kCall, la.call_amount});
+  DiscretizationConfig cfg;
+  cfg.pot_fracs = {0.5, 1.0};
+  discretize_actions_chips(s, la, cfg, tmp);
+  out.insert(out.end(), tmp.begin(), tmp.end());
+}
+
+static long dfs(CompactPublicState& s, int depth) {
+  if (s.terminal || depth == 0) return 1;
+  std::vector<ChipAction> acts, tmp;
+  children(s, acts, tmp);
+  long leaves = 0;
+  for (const auto& a : acts) {
+    const CompactPublicState before = s;
+    ActionUndo u;
+    bool ok = apply_action(s, a, u);
+    assert(ok);
+    // Cached fields and hash match a from-scratch recompute.
+    CompactPublicState check = s;
+    check.rehash();
+    assert(same(check, s));
+    leaves += dfs(s, depth - 1);
+    undo_action(s, u);
+    assert(same(before, s));
+  }
+  return leaves;
+}
+
+int main() {
+  // Limp / check moves to the flop; BB acts first postflop.
+  {
+    CompactPublicState s = hu_preflop(100);
+    ActionUndo u1, u2;
+    apply_action(s, ChipAction{ActionType::kCall, 0}, u1);
+    assert(s.street == 0 && s.player_to_act == 1 && s.pot == 2 * U);
+    apply_action(s, ChipAction{ActionType::kCheck, 0}, u2);
+    assert(s.street == 1 && s.player_to_act == 1 && !s.terminal);
+    assert(s.current_bet == 0 && s.committed_on_street[0] == 0 && s.committed_on_street[1] == 0);
+    assert(s.pot == 2 * U && s.acted_mask == 0 && s.num_raises == 0);
+    PublicState back = s.to_public_state();
+    LegalActionSummary la = compute_legal_actions(s);
+    LegalActionSummary lb = compute_legal_actions(back);
+    assert(la.bet_bounds && lb.bet_bounds && la.bet_bounds->max_to == lb.bet_bounds->max_to);
+
+    // Bet pot, raise, fold ends the hand.
+    ActionUndo u3, u4, u5;
+    apply_action(s, Action{ActionType::kBet, 2.0}, u3);
+    assert(s.current_bet == 2 * U && s.last_raise_size == 2 * U && s.player_to_act == 0);
+    apply_action(s, Action{ActionType::kRaise, 6.0}, u4);
+    assert(s.current_bet == 6 * U && s.last_raise_size == 4 * U && s.num_raises == 2 && s.player_to_act == 1);
+    apply_action(s, ChipAction{ActionType::kFold, 0}, u5);
+    assert(s.terminal && s.folded_mask == 2);
+    assert(compute_legal_actions(s).bet_bounds == std::nullopt && !compute_legal_actions(s).can_check);
+    ActionUndo dummy;
+    assert(!apply_action(s, ChipAction{ActionType::kCheck, 0}, dummy));
+    undo_action(s, u5); undo_action(s, u4); undo_action(s, u3); undo_action(s, u2); undo_action(s, u1);
+    assert(same(s, hu_preflop(100)));
+  }
+
+  // All-in and call is terminal (no more betting), short all-in does not reopen.
+  {
+    CompactPublicState s = hu_preflop(3);
+    ActionUndo u1, u2;
+    apply_action(s, ChipAction{ActionType::kRaise, 100 * U}, u1);  // clamped to the stack
+    assert(s.stacks[0] == 0 && s.current_bet == 3 * U && s.player_to_act == 1);
+    apply_action(s, ChipAction{ActionType::kCall, 0}, u2);
+    assert(s.terminal && s.pot == 6 * U);
+  }
+
+  // Pot-limit all-in: discretization emits kAllIn at the pot-limit maximum,
+  // which deep stacks must not exceed.
+  {
+    CompactPublicState s = hu_preflop(100);
+    std::vector<ChipAction> acts, tmp;
+    children(s, acts, tmp);
+    const ChipLegalSummary la = compute_legal_actions_chips(s);
+    assert(acts.back().type == ActionType::kAllIn && la.raise_bounds);
+    assert(acts.back().amount == la.raise_bounds->max_to && acts.back().amount == 3 * U);
+    ActionUndo u;
+    apply_action(s, acts.back(), u);
+    assert(s.current_bet == 3 * U && s.committed_on_street[0] == 3 * U && s.stacks[0] == 97 * U);
+    // A target below the current bet is a call.
+    ActionUndo u2;
+    apply_action(s, ChipAction{ActionType::kAllIn, 0}, u2);
+    assert(s.committed_total[1] == 3 * U && s.pot == 6 * U && s.street == 1);
+  }
+
+  // Three-handed: a fold keeps the remaining two in the round.
+  {
+    PublicState p;
+    p.num_players = 3; p.button = 0; p.player_to_act = 0; p.street = 0;
+    p.sb = 0.5; p.bb = 1.0;
+    p.stacks = {100, 99.5, 99};
+    p.committed_total = {0, 0.5, 1};
+    p.committed_on_street = {0, 0.5, 1};
+    CompactPublicState s;
+    CompactPublicState::from_public_state(p, s);
+    ActionUndo u1, u2, u3;
+    apply_action(s, ChipAction{ActionType::kFold, 0}, u1);
+    assert(!s.terminal && s.player_to_act == 1);
+    apply_action(s, ChipAction{ActionType::kCall, 0}, u2);
+    assert(s.player_to_act == 2);
+    apply_action(s, ChipAction{ActionType::kCheck, 0}, u3);
+    assert(s.street == 1 && s.player_to_act == 1);  // first live seat after the button
+  }
+
+  // Depth-first traversal restores every node exactly.
+  {
+    CompactPublicState s = hu_preflop(20);
+    const CompactPublicState root = s;
+    long leaves = dfs(s, 6);
+    assert(leaves > 100);
+    assert(same(root, s));
+  }
+
+  std::cout << "Apply/undo action tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,96 @@
+#include "quasar/nn/batching_value_net.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// out[r, k] = in[r, k] * 2 + players; counts forward passes.
+class DoublingNet : public quasar::IValueNet {
+ public:
+  int input_size() const override { return 4; }
+  int output_size() const override { return 4; }
+  bool is_sparse() const override { return false; }
+  std::vector<float> compute_values(const std::vector<float>& q, int batch, int players) override {
+    ++calls;
+    std::vector<float> out(q.size());
+    for (size_t i = 0; i < q.size(); ++i) out[i] = q[i] * 2.f + static_cast<float>(players);
+    (void)batch;
+    return out;
+  }
+  std::atomic<int> calls{0};
+};
+
+// Throws from every forward pass while `fail` is set.
+class FailingNet : public DoublingNet {
+ public:
+  std::vector<float> compute_values(const std::vector<float>& q, int batch, int players) override {
+    if (fail) throw std::runtime_error("forward failed");
+    return DoublingNet::compute_values(q, batch, players);
+  }
+  std::atomic<bool> fail{true};
+};
+
+int main() {
+  DoublingNet inner;
+  quasar::BatchingConfig cfg;
+  cfg.max_batch = 64;
+  cfg.max_wait_us = 20000;
+  quasar::BatchingValueNet net(&inner, cfg);
+  assert(net.input_size() == 4 && net.output_size() == 4 && !net.is_sparse());
+
+  // Single caller: same values as the wrapped net.
+  std::vector<float> q = {1, 2, 3, 4, 5, 6, 7, 8};
+  auto y = net.compute_values(q, 1, 2);
+  for (size_t i = 0; i < q.size(); ++i) assert(y[i] == q[i] * 2.f + 2.f);
+
+  // Concurrent callers (two player counts) are coalesced and each gets its own rows.
+  const int T = 16, P2 = 2, P3 = 3;
+  std::vector<std::thread> threads;
+  std::atomic<int> bad{0};
+  for (int t = 0; t < T; ++t) {
+    threads.emplace_back([&, t] {
+      const int players = t % 2 ? P3 : P2;
+      const int batch = 1 + t % 3;
+      std::vector<float> in(static_cast<size_t>(batch) * players * 4), out(in.size(), -1.f);
+      for (size_t i = 0; i < in.size(); ++i) in[i] = static_cast<float>(t * 1000 + i);
+      net.compute_values_into(in.data(), batch, players, out.data());
+      for (size_t i = 0; i < in.size(); ++i)
+        if (out[i] != in[i] * 2.f + static_cast<float>(players)) ++bad;
+    });
+  }
+  for (auto& t : threads) t.join();
+  assert(bad == 0);
+
+  auto st = net.stats();
+  assert(st.calls == 1 + T);
+  assert(st.batches == static_cast<uint64_t>(inner.calls.load()));
+  assert(st.batches < st.calls);  // at least one forward pass served several callers
+  assert(st.items == 1 + 31);  // the single call plus sum over t of 1 + t % 3
+
+  // A throwing forward reaches every caller in the batch and frees the
+  // leader slot, so later calls still go through.
+  FailingNet failing;
+  quasar::BatchingValueNet fnet(&failing, cfg);
+  std::atomic<int> threw{0};
+  threads.clear();
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&] {
+      std::vector<float> in(8, 1.f), out(8);
+      try {
+        fnet.compute_values_into(in.data(), 1, 2, out.data());
+      } catch (const std::runtime_error&) {
+        ++threw;
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  assert(threw == 8);
+  failing.fail = false;
+  y = fnet.compute_values(q, 1, 2);
+  for (size_t i = 0; i < q.size(); ++i) assert(y[i] == q[i] * 2.f + 2.f);
+
+  std::cout << "Batching value net tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include "quasar/bucketing/bucket_store.h"
+#include "quasar/eval/hand_index.h"
+#include "quasar/eval/river.h"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+// Swaps clubs and hearts, and diamonds and spades.
+static int32_t swap_suits(int32_t c) {
+  static const int kMap[4] = {2, 3, 0, 1};
+  return kMap[c / 13] * 13 + c % 13;
+}
+
+int main() {
+  const int32_t flop[3] = {0, 17, 30};     // 2c 6d 6h
+  const int32_t river[5] = {0, 4, 8, 13, 26};
+  int32_t iso[5];
+  for (int k = 0; k < 5; ++k) iso[k] = swap_suits(river[k]);
+  int map_a[4], map_b[4];
+  assert(quasar::canonical_board(river, 5, map_a) == quasar::canonical_board(iso, 5, map_b));
+  assert(quasar::canonical_board(river, 5, map_a) != quasar::canonical_board(flop, 3, map_b));
+  const int32_t dup[3] = {0, 0, 4};
+  assert(quasar::canonical_board(dup, 3, map_a) == 0);
+
+  // uint16 store: arbitrary labels read back on the same board.
+  std::vector<uint32_t> labels(quasar::kNumPloHands);
+  for (uint32_t i = 0; i < quasar::kNumPloHands; ++i) labels[i] = i % 50000;
+  labels[7] = quasar::kNoBucket;
+  {
+    quasar::BucketStoreWriter w;
+    bool ok = w.open("bucket_store_u16.qbkt", 7, 2) && w.add_board(flop, 3, labels.data());
+    assert(ok);
+    std::vector<uint32_t> too_big(quasar::kNumPloHands, 70000);
+    ok = !w.add_board(river, 5, too_big.data()) && w.finish();
+    assert(ok);
+    (void)ok;
+  }
+  auto store = quasar::BucketStore::open("bucket_store_u16.qbkt");
+  assert(store && store->bucket_version() == 7 && store->id_bytes() == 2 && store->num_boards() == 1);
+  {
+    // Stored boards come back as their canonical cards.
+    int32_t cards[5];
+    int map[4];
+    const int n = store->board(0, cards);
+    assert(n == 3 && store->board(1, cards) == 0);
+    store->board(0, cards);
+    uint64_t mask = 0;
+    for (int i = 0; i < n; ++i) mask |= uint64_t{1} << cards[i];
+    assert(mask == quasar::canonical_board(flop, 3, map));
+    (void)n;
+    (void)mask;
+  }
+  for (uint32_t i = 0; i < quasar::kNumPloHands; i += 101) {
+    int32_t h[4];
+    quasar::plo_hand_from_index(i, h);
+    const bool collides = (h[0] == 0 || h[1] == 0 || h[2] == 0 || h[3] == 0 || h[0] == 17 || h[1] == 17 ||
+                           h[2] == 17 || h[3] == 17 || h[0] == 30 || h[1] == 30 || h[2] == 30 || h[3] == 30);
+    assert(store->bucket_of(flop, 3, h) == (collides ? quasar::kNoBucket : labels[i]));
+  }
+  int32_t h7[4];
+  quasar::plo_hand_from_index(7, h7);
+  assert(store->bucket_of(flop, 3, h7) == quasar::kNoBucket);
+  const int32_t other_flop[3] = {1, 2, 3};
+  const int32_t hand[4] = {40, 41, 42, 43};
+  assert(store->bucket_of(other_flop, 3, hand) == quasar::kNoBucket);
+
+  // uint32 store with suit-invariant labels (river key category and ranks):
+  // a suit-isomorphic board and hand find the same bucket.
+  const quasar::RiverBoardEvaluator ev({0, 4, 8, 13, 26});
+  std::vector<uint32_t> keys(quasar::kNumPloHands, quasar::kNoBucket);
+  for (uint32_t i = 0; i < quasar::kNumPloHands; ++i) {
+    int32_t h[4];
+    quasar::plo_hand_from_index(i, h);
+    const uint64_t k = ev.key(h);
+    keys[i] = static_cast<uint32_t>((k >> 60) << 20 | (k & 0xFFFFF));
+  }
+  {
+    quasar::BucketStoreWriter w;
+    bool ok = w.open("bucket_store_u32.qbkt", 3, 4) && w.add_board(river, 5, keys.data()) &&
+              !w.add_board(iso, 5, keys.data()) && w.add_board(flop, 3, labels.data()) && w.finish();
+    assert(ok);
+    (void)ok;
+  }
+  store = quasar::BucketStore::open("bucket_store_u32.qbkt");
+  assert(store && store->num_boards() == 2 && store->id_bytes() == 4);
+  std::vector<int32_t> hands, iso_hands;
+  for (uint32_t i = 0; i < quasar::kNumPloHands; i += 37) {
+    int32_t h[4];
+    quasar::plo_hand_from_index(i, h);
+    for (int k = 0; k < 4; ++k) {
+      hands.push_back(h[k]);
+      iso_hands.push_back(swap_suits(h[k]));
+    }
+  }
+  const size_t n = hands.size() / 4;
+  std::vector<uint32_t> a(n), b(n);
+  store->buckets_of(river, 5, hands.data(), n, a.data());
+  store->buckets_of(iso, 5, iso_hands.data(), n, b.data());
+  assert(a == b);
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t idx = quasar::plo_hand_index(&hands[i * 4]);
+    bool collides = false;
+    for (int k = 0; k < 4; ++k) {
+      for (int32_t c : river) collides |= hands[i * 4 + k] == c;
+    }
+    assert(a[i] == (collides ? quasar::kNoBucket : keys[idx]));
+  }
+
+  // Truncated or foreign files are rejected.
+  std::FILE* f = std::fopen("bucket_store_bad.qbkt", "wb");
+  std::fputs("QBKT", f);
+  std::fclose(f);
+  assert(!quasar::BucketStore::open("bucket_store_bad.qbkt"));
+  assert(!quasar::BucketStore::open("missing.qbkt"));
+
+  std::cout << "Bucket store tests passed" << std::endl;
+  return 0;
+}
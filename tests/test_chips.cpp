@@ -0,0 +1,88 @@
+#include "quasar/engine/chips.h"
+#include "quasar/engine/compact_state.h"
+#include "quasar/engine/discretize.h"
+#include "quasar/engine/plo_legal.h"
+#include "quasar/engine/state_hash.h"
+#include <cassert>
+#include <iostream>
+
+static quasar::PublicState flop_spot(double stack_each, double pot_each) {
+  quasar::PublicState s;
+  s.num_players = 2; s.street = 1; s.player_to_act = 0; s.button = 1;
+  s.board = {0, 13, 26, -1, -1};
+  s.sb = 0.5; s.bb = 1.0;
+  s.stacks = {stack_each, stack_each};
+  s.committed_total = {pot_each, pot_each};
+  s.committed_on_street = {0, 0};
+  return s;
+}
+
+int main() {
+  using namespace quasar;
+  assert(to_chips(1.0) == kChipsPerUnit);
+  assert(to_chips(0.1 + 0.2) == to_chips(0.3));
+  assert(from_chips(to_chips(2.5)) == 2.5);
+
+  // Rounding noise in committed amounts does not create a phantom bet.
+  {
+    PublicState s = flop_spot(50, 3);
+    s.committed_on_street = {0.1 + 0.2, 0.3};
+    auto la = compute_legal_actions(s);
+    assert(la.can_check && !la.can_fold && la.call_amount == 0.0);
+  }
+
+  // ...nor does it change the state hash.
+  {
+    PublicState a = flop_spot(50, 3), b = flop_spot(50, 3);
+    a.committed_total = {0.1 + 0.2, 0.3};
+    b.committed_total = {0.3, 0.3};
+    assert(hash_public_state(a) == hash_public_state(b));
+  }
+
+  // Exact dedup: 0.5 and 0.505 of a 2-chip pot both land on 1.01 → 101 chips.
+  {
+    PublicState s = flop_spot(100, 1);
+    s.committed_total = {1.01, 1.01};
+    auto la = compute_legal_actions(s);
+    assert(la.bet_bounds);
+    DiscretizationConfig cfg;
+    cfg.include_min = false;
+    cfg.include_all_in = false;
+    cfg.pot_fracs = {0.5, 0.5, 1.0};
+    auto acts = discretize_actions(s, la, cfg);
+    assert(acts.size() == 2 && acts[0].amount == 1.01 && acts[1].amount == 2.02);
+  }
+
+  // Compact and vector states agree on chip legality and discretization.
+  {
+    PublicState s = flop_spot(40, 5);
+    s.committed_on_street = {0, 3.5};
+    s.committed_total = {5, 8.5};
+    s.stacks = {40, 36.5};
+    s.last_raise_size = 3.5;
+    CompactPublicState c;
+    bool ok = CompactPublicState::from_public_state(s, c);
+    assert(ok);
+    auto a = compute_legal_actions_chips(s);
+    auto b = compute_legal_actions_chips(c);
+    assert(a.call_amount == 350 && b.call_amount == 350);
+    assert(a.raise_bounds && b.raise_bounds);
+    assert(a.raise_bounds->min_to == 700 && b.raise_bounds->min_to == 700);
+    // pot raise: 3.5 + (13.5 + 3.5) = 20.5
+    assert(a.raise_bounds->max_to == 2050 && b.raise_bounds->max_to == 2050);
+
+    DiscretizationConfig cfg;
+    std::vector<ChipAction> ca, cb;
+    discretize_actions_chips(s, a, cfg, ca);
+    discretize_actions_chips(c, b, cfg, cb);
+    auto dd = discretize_actions(s, compute_legal_actions(s), cfg);
+    assert(ca.size() == cb.size() && ca.size() == dd.size());
+    for (size_t i = 0; i < ca.size(); ++i) {
+      assert(ca[i].type == cb[i].type && ca[i].amount == cb[i].amount);
+      assert(dd[i].type == ca[i].type && to_chips(dd[i].amount) == ca[i].amount);
+    }
+  }
+
+  std::cout << "Chip accounting tests passed" << std::endl;
+  return 0;
+}
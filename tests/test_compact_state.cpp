@@ -0,0 +1,61 @@
+#include "quasar/engine/compact_state.h"
+#include "quasar/engine/solve_cache.h"
+#include "quasar/engine/state_hash.h"
+#include <cassert>
+#include <iostream>
+#include <type_traits>
+
+int main() {
+  static_assert(std::is_trivially_copyable<quasar::CompactPublicState>::value, "compact state must be flat");
+
+  quasar::PublicState s;
+  s.num_players = 3; s.street = 2; s.player_to_act = 1; s.button = 2;
+  s.board = {51, 0, 13, 26, -1};
+  s.sb = 0.5; s.bb = 1.0; s.ante = 0.25;
+  s.stacks = {90, 80.5, 100};
+  s.committed_total = {10, 19.5, 10};
+  s.committed_on_street = {0, 9.5, 0};
+  s.last_raise_size = 9.5;
+
+  quasar::CompactPublicState c;
+  bool ok = quasar::CompactPublicState::from_public_state(s, c);
+  assert(ok);
+  assert(c.board_card(0) == 51 && c.board_card(3) == 26 && c.board_card(4) == -1);
+  assert(c.hash == quasar::hash_public_state(s));
+
+  // Round trip preserves every field
+  quasar::PublicState r = c.to_public_state();
+  assert(r.num_players == 3 && r.board == s.board && r.stacks == s.stacks);
+  assert(r.committed_total == s.committed_total && r.committed_on_street == s.committed_on_street);
+  assert(r.sb == s.sb && r.ante == s.ante && r.last_raise_size == s.last_raise_size);
+
+  // Mutation + rehash tracks the PublicState hash
+  quasar::CompactPublicState child = c;
+  const quasar::Chips ten = 10 * quasar::kChipsPerUnit;
+  child.stacks[1] -= ten; child.committed_total[1] += ten; child.committed_on_street[1] += ten;
+  child.rehash();
+  quasar::PublicState rs = s;
+  rs.stacks[1] -= 10; rs.committed_total[1] += 10; rs.committed_on_street[1] += 10;
+  assert(child.hash == quasar::hash_public_state(rs) && child.hash != c.hash);
+
+  // Too many seats is rejected
+  quasar::PublicState big = s;
+  big.num_players = quasar::kMaxPlayers + 1;
+  big.stacks.assign(big.num_players, 100);
+  big.committed_total.assign(big.num_players, 0);
+  big.committed_on_street.assign(big.num_players, 0);
+  assert(!quasar::CompactPublicState::from_public_state(big, c));
+
+  // Compact and vector states share solve-cache entries
+  quasar::SolveOneConfig cfg;
+  quasar::SolveCache cache;
+  quasar::CompactPublicState cs;
+  quasar::CompactPublicState::from_public_state(s, cs);
+  assert(quasar::solve_cache_key(cs, cfg) == quasar::solve_cache_key(s, cfg));
+  auto a = cache.solve(s, cfg);
+  auto b = cache.solve(cs, cfg);
+  assert(a == b && cache.stats().hits == 1);
+
+  std::cout << "Compact state tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,225 @@
+#include "quasar/datagen/datagen.h"
+#include "quasar/bucketing/bucket_store.h"
+#include "quasar/eval/hand_index.h"
+#include "quasar/eval/river.h"
+#include "quasar/eval/showdown.h"
+#include "quasar/nn/query_layout.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::string slurp(const std::string& path) {
+  std::ifstream f(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+int main() {
+  using namespace quasar;
+
+  // Showdown values match a direct sum over opponent hands.
+  const std::array<int, 5> board = {3, 17, 30, 44, 50};
+  uint64_t bmask = 0;
+  for (int c : board) bmask |= uint64_t{1} << c;
+  std::vector<float> weights(kNumPloHands), values(kNumPloHands);
+  std::vector<uint64_t> keys(kNumPloHands), masks(kNumPloHands);
+  std::mt19937 rng(5);
+  const RiverBoardEvaluator ev(board);
+  for (uint32_t h = 0; h < kNumPloHands; ++h) {
+    int32_t c[4];
+    plo_hand_from_index(h, c);
+    masks[h] = (uint64_t{1} << c[0]) | (uint64_t{1} << c[1]) | (uint64_t{1} << c[2]) | (uint64_t{1} << c[3]);
+    keys[h] = ev.key(c);
+    weights[h] = (rng() % 4 == 0) ? static_cast<float>(rng() % 1000) / 1000.f : 0.f;
+  }
+  const float* w[1] = {weights.data()};
+  float* v[1] = {values.data()};
+  river_showdown_values(board, w, v, 1);
+  for (int t = 0; t < 8; ++t) {
+    uint32_t hero = rng() % kNumPloHands;
+    while (masks[hero] & bmask) hero = rng() % kNumPloHands;
+    double win = 0, lose = 0, total = 0;
+    for (uint32_t o = 0; o < kNumPloHands; ++o) {
+      if ((masks[o] & (bmask | masks[hero])) || weights[o] == 0.f) continue;
+      total += weights[o];
+      win += keys[hero] > keys[o] ? weights[o] : 0.0;
+      lose += keys[hero] < keys[o] ? weights[o] : 0.0;
+    }
+    assert(std::fabs(values[hero] - (win - lose) / (2.0 * total)) < 1e-5);
+  }
+  const int32_t collide[4] = {board[0], board[1], 5, 6};
+  const uint32_t on_board = plo_hand_index(collide);
+  assert(values[on_board] == 0.f);
+
+  // Records: deterministic in (seed, index), beliefs normalized, targets in
+  // pot units.
+  DatagenConfig cfg;
+  cfg.K = 8;
+  cfg.seed = 11;
+  DatagenRecord a, b;
+  bool ok = generate_record(cfg, 3, a) && generate_record(cfg, 3, b);
+  assert(ok && a.query == b.query && a.target == b.target);
+  const int S = dense_slice_size(cfg.K);
+  assert(a.query.size() == static_cast<size_t>(2 * S) && a.target.size() == 16u);
+  assert(a.query[kSlicePlayerAct] + a.query[S + kSlicePlayerAct] == 1.f);
+  for (int p = 0; p < 2; ++p) {
+    double mass = 0;
+    for (int k = 0; k < cfg.K; ++k) mass += a.query[p * S + kSlicePublicSize + k];
+    assert(std::fabs(mass - 1.0) < 1e-5);
+    for (int k = 0; k < cfg.K; ++k) assert(std::fabs(a.target[p * cfg.K + k]) <= 0.5f);
+  }
+  // Percentile buckets: the top bucket beats the bottom one.
+  assert(a.target[cfg.K - 1] > a.target[0]);
+  ok = generate_record(cfg, 4, b);
+  assert(ok && b.query != a.query);
+
+  // Shards: 5 records in shards of 2, then resume and extend. Records come
+  // from a one-board bucket store, which skips the percentile ranking and
+  // keeps these runs short.
+  char tmpl[] = "/tmp/quasar_datagen_XXXXXX";
+  const std::string dir = mkdtemp(tmpl);
+  const std::string store_path = dir + "/buckets.qbkt";
+  {
+    std::vector<uint32_t> labels(kNumPloHands);
+    for (uint32_t i = 0; i < kNumPloHands; ++i) labels[i] = i % static_cast<uint32_t>(cfg.K);
+    const int32_t b5[5] = {board[0], board[1], board[2], board[3], board[4]};
+    BucketStoreWriter w;
+    ok = w.open(store_path, 7) && w.add_board(b5, 5, labels.data()) && w.finish();
+    assert(ok);
+  }
+  const std::unique_ptr<BucketStore> store = BucketStore::open(store_path);
+  assert(store && store->bucket_version() == 7u);
+  cfg.buckets = store.get();
+  cfg.num_records = 5;
+  cfg.records_per_shard = 2;
+  cfg.threads = 3;
+  cfg.max_pending = 2;
+  DatagenStats st;
+  std::string error;
+  ok = run_datagen(cfg, dir, &st, &error);
+  assert(ok && st.resumed == 0 && st.written == 5 && st.skipped == 0 && st.shards == 3);
+  const size_t qbytes = 2 * S * sizeof(float), tbytes = 2 * cfg.K * sizeof(float);  // per record
+  const std::string s1 = slurp(dir + "/shard-000001.qshd");
+  const std::string s2 = slurp(dir + "/shard-000002.qshd");
+  assert(s1.size() == shard_bytes(2, 2, S, cfg.K) && s2.size() == shard_bytes(1, 2, S, cfg.K));
+  ShardHeader h;
+  std::memcpy(&h, s1.data(), sizeof(h));
+  assert(std::memcmp(h.magic, kShardMagic, 4) == 0 && h.format == kShardFormat && h.players == 2);
+  assert(h.K == 8u && h.input_size == static_cast<uint32_t>(S) && h.count == 2u && h.first_record == 2u);
+  assert(h.bucket_version == 7u && h.seed == 11u);
+  assert(h.query_offset == sizeof(ShardHeader) && h.target_offset % 64 == 0);
+  assert(h.target_offset >= h.query_offset + 2 * qbytes);
+  // Record 3 is row 1 of both columns of shard 1.
+  ok = generate_record(cfg, 3, a);
+  assert(ok);
+  assert(std::memcmp(s1.data() + h.query_offset + qbytes, a.query.data(), qbytes) == 0);
+  assert(std::memcmp(s1.data() + h.target_offset + tbytes, a.target.data(), tbytes) == 0);
+  const std::string manifest = slurp(dir + "/manifest.json");
+  assert(manifest.find("\"num_records\": 5") != std::string::npos);
+  assert(manifest.find("shard-000002.qshd") != std::string::npos);
+
+  // Resume after shard 0 reproduces the same bytes with one thread.
+  std::remove((dir + "/shard-000001.qshd").c_str());
+  std::remove((dir + "/shard-000002.qshd").c_str());
+  cfg.threads = 1;
+  ok = run_datagen(cfg, dir, &st, &error);
+  assert(ok && st.resumed == 2 && st.written == 3 && st.shards == 3);
+  assert(slurp(dir + "/shard-000001.qshd") == s1 && slurp(dir + "/shard-000002.qshd") == s2);
+
+  // Extending rebuilds the short trailing shard.
+  cfg.num_records = 6;
+  ok = run_datagen(cfg, dir, &st, &error);
+  assert(ok && st.resumed == 4 && st.written == 2 && st.shards == 3);
+  const std::string s2x = slurp(dir + "/shard-000002.qshd");
+  ShardHeader h2, h2x;
+  std::memcpy(&h2, s2.data(), sizeof(h2));
+  std::memcpy(&h2x, s2x.data(), sizeof(h2x));
+  assert(h2x.count == 2u && s2x.size() == shard_bytes(2, 2, S, cfg.K));
+  assert(s2x.compare(h2x.query_offset, qbytes, s2, h2.query_offset, qbytes) == 0);
+  assert(s2x.compare(h2x.target_offset, tbytes, s2, h2.target_offset, tbytes) == 0);
+
+  // A different seed does not silently mix into existing shards.
+  cfg.seed = 12;
+  ok = run_datagen(cfg, dir, &st, &error);
+  assert(!ok && error.find("different configuration") != std::string::npos);
+  cfg.seed = 11;
+
+  // Neither does another shard size, larger or smaller, and the shards on
+  // disk are left as they were.
+  const std::string s0 = slurp(dir + "/shard-000000.qshd");
+  for (uint32_t rps : {1u, 3u}) {
+    cfg.records_per_shard = rps;
+    error.clear();
+    ok = run_datagen(cfg, dir, &st, &error);
+    assert(!ok && error.find("different configuration") != std::string::npos);
+    assert(slurp(dir + "/shard-000000.qshd") == s0);
+  }
+  cfg.records_per_shard = 2;
+
+  // A damaged shard is reported; a file that is not a shard is written over.
+  {
+    std::ofstream f(dir + "/shard-000001.qshd", std::ios::binary | std::ios::trunc);
+    f.write(s1.data(), static_cast<std::streamsize>(s1.size() / 2));
+  }
+  ok = run_datagen(cfg, dir, &st, &error);
+  assert(!ok && error.find("truncated or corrupt") != std::string::npos);
+  {
+    std::ofstream f(dir + "/shard-000001.qshd", std::ios::binary | std::ios::trunc);
+    f << "not a shard";
+  }
+  ok = run_datagen(cfg, dir, &st, &error);
+  assert(ok && st.resumed == 2 && st.written == 4);
+  assert(slurp(dir + "/shard-000001.qshd") == s1);
+
+  // A shard in the old record-interleaved format 1 (same header, records
+  // back to back) is reported by format rather than rebuilt or misread.
+  {
+    ShardHeader old_h = h;
+    old_h.format = 1;
+    old_h.query_offset = old_h.target_offset = 0;
+    std::string v1(reinterpret_cast<const char*>(&old_h), sizeof(old_h));
+    v1.resize(sizeof(old_h) + 2 * (qbytes + tbytes), '\0');
+    std::ofstream(dir + "/shard-000001.qshd", std::ios::binary | std::ios::trunc).write(v1.data(), v1.size());
+  }
+  ok = run_datagen(cfg, dir, &st, &error);
+  assert(!ok && error.find("shard format 1") != std::string::npos);
+  assert(slurp(dir + "/shard-000001.qshd").size() == sizeof(ShardHeader) + 2 * (qbytes + tbytes));
+
+  std::ofstream(dir + "/shard-000001.qshd", std::ios::binary | std::ios::trunc).write(s1.data(), s1.size());
+
+  // Shards at or past the end of a shorter run are checked too: another
+  // config is refused even where this run would write, and a run that would
+  // leave complete shards past its manifest is refused.
+  const std::string before = slurp(dir + "/manifest.json");
+  DatagenConfig other = cfg;
+  other.num_records = 1;
+  other.K = 16;
+  other.seed = 12;
+  ok = run_datagen(other, dir, &st, &error);
+  assert(!ok && error.find("different configuration") != std::string::npos);
+  cfg.num_records = 4;
+  ok = run_datagen(cfg, dir, &st, &error);
+  assert(!ok && error.find("past the 4 requested") != std::string::npos);
+  assert(slurp(dir + "/shard-000000.qshd") == s0 && slurp(dir + "/manifest.json") == before);
+
+  for (int i = 0; i < 3; ++i) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s/shard-%06d.qshd", dir.c_str(), i);
+    std::remove(name);
+  }
+  std::remove((dir + "/manifest.json").c_str());
+  std::remove(store_path.c_str());
+  std::remove(dir.c_str());
+  (void)ok;
+
+  std::cout << "Datagen tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,29 @@
+#include "quasar/eval/river.h"
+#include <array>
+#include <cassert>
+#include <iostream>
+
+// Rank r (0 = deuce .. 12 = ace) of suit s is card s * 13 + r.
+int main() {
+  // Tie-break ranks compare from the most significant down.
+  std::array<int, 5> aak{12, 25, 37, 44, 0};  // A A K 7 2
+  std::array<int, 5> aaq{38, 51, 10, 22, 27};  // A A Q J 3
+  assert(quasar::eval_5card(aak) > quasar::eval_5card(aaq));
+  std::array<int, 5> ak_high{12, 24, 31, 40, 0};  // A K 7 3 2
+  std::array<int, 5> aq_high{25, 10, 48, 20, 6};  // A Q J 9 8
+  assert(quasar::eval_5card(ak_high) > quasar::eval_5card(aq_high));
+  std::array<int, 5> kk99{11, 24, 7, 20, 0};  // K K 9 9 2
+  std::array<int, 5> kk88{37, 50, 6, 19, 12};  // K K 8 8 A
+  assert(quasar::eval_5card(kk99) > quasar::eval_5card(kk88));
+
+  // Through the PLO river comparison: on Ac Ad 2c 5s 9h, A-A-K-T-9 (Kh Tc)
+  // beats A-A-Q-J-9 (Qh Jc).
+  std::array<int, 5> board{12, 25, 0, 42, 33};
+  std::array<int, 4> hand_kt{37, 8, 40, 18};
+  std::array<int, 4> hand_qj{36, 9, 15, 17};
+  assert(quasar::compare_plo_river(hand_kt, hand_qj, board) == 1);
+  assert(quasar::compare_plo_river(hand_qj, hand_kt, board) == -1);
+
+  std::cout << "5-card evaluator tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,133 @@
+#include "quasar/eval/features.h"
+#include "quasar/eval/hand_index.h"
+#include "quasar/eval/river.h"
+#include "quasar/util/thread_pool.h"
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static std::vector<float> features(const std::vector<int32_t>& board, const std::vector<int32_t>& hands,
+                                   quasar::ThreadPool* pool) {
+  std::vector<float> out(hands.size() / 4 * quasar::kHandFeatureDim, -1.f);
+  bool ok = quasar::plo_hand_features(board.data(), static_cast<int>(board.size()), hands.data(),
+                                      hands.size() / 4, out.data(), pool);
+  assert(ok);
+  (void)ok;
+  return out;
+}
+
+// The default run cross-checks the river features of one hand against brute
+// force and computes the turn features once. `--exhaustive` (ctest target
+// test_hand_features_exhaustive, built with QUASAR_SLOW_TESTS) also brute
+// forces the other hands, compares thread counts on the turn and checks the
+// turn features against the mean over every runout.
+int main(int argc, char** argv) {
+  const bool exhaustive = argc > 1 && std::string(argv[1]) == "--exhaustive";
+
+  // Colex index is a bijection onto [0, kNumPloHands).
+  std::vector<bool> seen(quasar::kNumPloHands, false);
+  for (uint32_t i = 0; i < quasar::kNumPloHands; ++i) {
+    int32_t h[4];
+    quasar::plo_hand_from_index(i, h);
+    assert(h[0] < h[1] && h[1] < h[2] && h[2] < h[3] && h[3] < 52);
+    const int32_t shuffled[4] = {h[2], h[0], h[3], h[1]};
+    assert(quasar::plo_hand_index(shuffled) == i);
+    seen[i] = true;
+  }
+  assert(quasar::plo_hand_index_sorted(48, 49, 50, 51) == quasar::kNumPloHands - 1);
+
+  quasar::ThreadPool one(1), three(3);
+  const std::vector<int32_t> river = {0, 4, 8, 13, 26};  // three clubs
+  // Three scored hands, a board collision and a repeated card.
+  std::vector<int32_t> hands = {11, 12, 14, 27, 17, 30, 40, 41, 19, 20, 33, 47, 0, 1, 2, 3, 5, 5, 6, 7};
+  std::vector<float> f = features(river, hands, &three);
+
+  // River equity and nut flag match brute force over every opponent hand.
+  const std::array<int, 5> rb{0, 4, 8, 13, 26};
+  for (int i = 0; i < 3; ++i) {
+    const std::array<int, 4> hero{hands[i * 4], hands[i * 4 + 1], hands[i * 4 + 2], hands[i * 4 + 3]};
+    const uint64_t hk = quasar::best_plo_river_key(hero, rb);
+    const float* row = &f[i * quasar::kHandFeatureDim];
+    assert(row[quasar::kFeatCategory] == static_cast<float>(hk >> 60) / 8.f);
+    assert(row[quasar::kFeatFlushDraw] == 0.f && row[quasar::kFeatStraightOuts] == 0.f);
+    if (i > 0 && !exhaustive) continue;
+    double wins = 0, count = 0;
+    bool nut = true;
+    for (uint32_t o = 0; o < quasar::kNumPloHands; ++o) {
+      int32_t opp[4];
+      quasar::plo_hand_from_index(o, opp);
+      bool clash = false;
+      for (int c : opp) {
+        for (int b : rb) clash |= c == b;
+        for (int x : hero) clash |= c == x;
+      }
+      if (clash) continue;
+      const uint64_t ok = quasar::best_plo_river_key({opp[0], opp[1], opp[2], opp[3]}, rb);
+      wins += hk > ok ? 1.0 : hk == ok ? 0.5 : 0.0;
+      nut &= ok <= hk;
+      count += 1;
+    }
+    assert(count == 123410);
+    assert(std::fabs(row[quasar::kFeatEhs] - wins / count) < 1e-6);
+    assert(std::fabs(row[quasar::kFeatEhs2] - (wins / count) * (wins / count)) < 1e-6);
+    assert(row[quasar::kFeatNut] == (nut ? 1.f : 0.f));
+  }
+  // 3d3h with the board's 2-2-2 is a full house, beaten by bigger boats.
+  assert(f[quasar::kFeatCategory] == 6.f / 8.f && f[quasar::kFeatNut] == 0.f);
+  for (int i = 3; i < 5; ++i) {
+    for (int k = 0; k < quasar::kHandFeatureDim; ++k) assert(f[i * quasar::kHandFeatureDim + k] == 0.f);
+  }
+
+  // Turn: EHS / E[HS^2] / nut are means over the river features of each runout,
+  // and do not depend on the thread count.
+  const std::vector<int32_t> turn = {0, 4, 21, 13};  // 2c 6c 10d 2d
+  std::vector<int32_t> heroes = {2, 3, 30, 44, 1, 29, 31, 50};  // 4c5c6h7s; 3c5h7h Ks
+  std::vector<float> t1 = features(turn, heroes, &three);
+  for (int i = 0; i < 2; ++i) {
+    const float* row = &t1[i * quasar::kHandFeatureDim];
+    assert(row[quasar::kFeatEhs] > 0.f && row[quasar::kFeatEhs] < 1.f);
+    assert(row[quasar::kFeatEhs2] <= row[quasar::kFeatEhs] && row[quasar::kFeatEhs2] >= 0.f);
+  }
+  if (exhaustive) assert(features(turn, heroes, &one) == t1);
+  double ehs[2] = {0, 0}, ehs2[2] = {0, 0}, nut[2] = {0, 0}, runouts[2] = {0, 0};
+  for (int r = 0; r < 52 && exhaustive; ++r) {
+    std::vector<int32_t> rv = turn;
+    rv.push_back(r);
+    bool on_board = false;
+    for (int b : turn) on_board |= b == r;
+    if (on_board) continue;
+    std::vector<float> fr = features(rv, heroes, &three);
+    for (int i = 0; i < 2; ++i) {
+      bool hit = false;
+      for (int k = 0; k < 4; ++k) hit |= heroes[i * 4 + k] == r;
+      if (hit) continue;
+      ehs[i] += fr[i * quasar::kHandFeatureDim + quasar::kFeatEhs];
+      ehs2[i] += fr[i * quasar::kHandFeatureDim + quasar::kFeatEhs2];
+      nut[i] += fr[i * quasar::kHandFeatureDim + quasar::kFeatNut];
+      runouts[i] += 1;
+    }
+  }
+  for (int i = 0; i < 2 && exhaustive; ++i) {
+    const float* row = &t1[i * quasar::kHandFeatureDim];
+    assert(runouts[i] == 44);
+    assert(std::fabs(row[quasar::kFeatEhs] - ehs[i] / 44) < 1e-5);
+    assert(std::fabs(row[quasar::kFeatEhs2] - ehs2[i] / 44) < 1e-5);
+    assert(std::fabs(row[quasar::kFeatNut] - nut[i] / 44) < 1e-5);
+  }
+  // Draws: hero 0 has 4c5c with 2c6c on board (flush draw) and straight
+  // outs; hero 1 has no two cards of a two-card board suit.
+  assert(t1[quasar::kFeatFlushDraw] == 1.f && t1[quasar::kFeatStraightOuts] > 0.f);
+  assert(t1[quasar::kHandFeatureDim + quasar::kFeatFlushDraw] == 0.f);
+
+  const std::vector<int32_t> bad_board = {0, 0, 4};
+  std::vector<float> none(quasar::kHandFeatureDim);
+  bool ok = quasar::plo_hand_features(bad_board.data(), 3, heroes.data(), 1, none.data(), &one);
+  assert(!ok);
+  (void)ok;
+
+  std::cout << "Hand feature tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "quasar/bucketing/kmeans.h"
+#include "quasar/util/thread_pool.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+int main() {
+  // Five well-separated blobs in 6 dimensions.
+  const int d = 6, blobs = 5;
+  const size_t per = 400, n = per * blobs;
+  std::mt19937 rng(3);
+  std::normal_distribution<float> noise(0.f, 0.1f);
+  std::vector<float> x(n * d);
+  std::vector<int> truth(n);
+  for (size_t i = 0; i < n; ++i) {
+    truth[i] = static_cast<int>(i % blobs);
+    for (int j = 0; j < d; ++j) x[i * d + j] = 10.f * ((truth[i] + j) % blobs) + noise(rng);
+  }
+
+  quasar::KMeansConfig cfg;
+  cfg.k = blobs;
+  cfg.iters = 30;
+  quasar::ThreadPool one(1), three(3);
+  quasar::KMeansResult a, b;
+  bool ok = quasar::kmeans_fit(x.data(), n, d, cfg, a, &one) && quasar::kmeans_fit(x.data(), n, d, cfg, b, &three);
+  assert(ok);
+  // Deterministic across thread counts.
+  assert(a.labels == b.labels && a.centers == b.centers && a.inertia == b.inertia);
+  // k-means++ finds every blob: one label per blob.
+  for (size_t i = 0; i < n; ++i) assert(a.labels[i] == a.labels[truth[i]]);
+  assert(a.inertia < 0.02 * n * d);
+
+  // Labels are the nearest centers.
+  std::vector<int32_t> labels(n);
+  std::vector<float> dist2(n);
+  quasar::kmeans_assign(x.data(), n, d, a.centers.data(), a.k, labels.data(), dist2.data(), &three);
+  assert(labels == a.labels);
+  for (size_t i = 0; i < n; i += 97) {
+    float best = 1e30f;
+    for (int c = 0; c < a.k; ++c) {
+      float s = 0.f;
+      for (int j = 0; j < d; ++j) s += (x[i * d + j] - a.centers[c * d + j]) * (x[i * d + j] - a.centers[c * d + j]);
+      best = std::min(best, s);
+    }
+    assert(std::fabs(dist2[i] - best) < 1e-2f);
+  }
+
+  // Mini-batch with random seeding still separates the blobs and is reproducible.
+  cfg.batch_size = 256;
+  cfg.iters = 100;
+  cfg.plus_plus = false;
+  cfg.k = 40;  // more centers than blobs: every cluster stays inside one blob
+  ok = quasar::kmeans_fit(x.data(), n, d, cfg, a, &one) && quasar::kmeans_fit(x.data(), n, d, cfg, b, &three);
+  assert(ok);
+  assert(a.labels == b.labels && a.centers == b.centers);
+  std::vector<int> blob_of(cfg.k, -1);
+  for (size_t i = 0; i < n; ++i) {
+    int& owner = blob_of[a.labels[i]];
+    assert(owner < 0 || owner == truth[i]);
+    owner = truth[i];
+  }
+
+  // k larger than n is clamped; artifacts are plain .npy files.
+  cfg = quasar::KMeansConfig();
+  cfg.k = 10;
+  ok = quasar::kmeans_fit(x.data(), 4, d, cfg, a, &one);
+  assert(ok && a.k == 4 && a.inertia == 0.0);
+  const std::string dir = "kmeans_test_out";
+  ok = quasar::save_kmeans(a, dir);
+  assert(ok);
+  FILE* f = std::fopen((dir + "/centers.npy").c_str(), "rb");
+  assert(f);
+  char head[128] = {0};
+  size_t got = std::fread(head, 1, sizeof(head) - 1, f);
+  std::fclose(f);
+  assert(got == 128 - 1 && std::string(head + 1, 5) == "NUMPY");
+  assert(std::string(head + 10).find("'shape': (4, 6)") != std::string::npos);
+  assert(!quasar::kmeans_fit(x.data(), 0, d, cfg, a));
+  (void)ok;
+  (void)got;
+
+  std::cout << "KMeans tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,187 @@
+#include "quasar/nn/native_value_net.h"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Tiny DenseTransformerNet written in the native format, checked against a
+// straightforward reference forward (post-norm, ReLU, as nn.TransformerEncoderLayer).
+
+struct Lin { int out, in; std::vector<float> w, b; };
+struct Layer { Lin inp, outp, ff1, ff2; std::vector<float> g1, b1, g2, b2; };
+
+static std::mt19937 rng(7);
+static std::vector<float> rnd(size_t n, float s) {
+  std::uniform_real_distribution<float> u(-s, s);
+  std::vector<float> v(n);
+  for (auto& x : v) x = u(rng);
+  return v;
+}
+static Lin make_lin(int out, int in) { return Lin{out, in, rnd(size_t(out) * in, 0.4f), rnd(out, 0.1f)}; }
+
+static void lin_fwd(const Lin& l, const std::vector<float>& x, int rows, std::vector<float>& y) {
+  y.assign(size_t(rows) * l.out, 0.f);
+  for (int r = 0; r < rows; ++r)
+    for (int o = 0; o < l.out; ++o) {
+      double acc = l.b[o];
+      for (int i = 0; i < l.in; ++i) acc += double(x[size_t(r) * l.in + i]) * l.w[size_t(o) * l.in + i];
+      y[size_t(r) * l.out + o] = float(acc);
+    }
+}
+
+static void ln(std::vector<float>& x, int rows, int d, const std::vector<float>& g, const std::vector<float>& b) {
+  for (int r = 0; r < rows; ++r) {
+    double m = 0, v = 0;
+    for (int i = 0; i < d; ++i) m += x[size_t(r) * d + i];
+    m /= d;
+    for (int i = 0; i < d; ++i) { double c = x[size_t(r) * d + i] - m; v += c * c; }
+    v /= d;
+    for (int i = 0; i < d; ++i) {
+      float& e = x[size_t(r) * d + i];
+      e = float((e - m) / std::sqrt(v + 1e-5) * g[i] + b[i]);
+    }
+  }
+}
+
+// Header plus either `w` or `pad` zero bytes of payload.
+static void write_header(const char* path, std::initializer_list<uint32_t> fields, size_t pad,
+                         const std::vector<float>* w = nullptr) {
+  std::ofstream f(path, std::ios::binary | std::ios::trunc);
+  f.write("QVNW", 4);
+  for (uint32_t v : fields) f.write(reinterpret_cast<const char*>(&v), 4);
+  const float eps = 1e-5f;
+  f.write(reinterpret_cast<const char*>(&eps), 4);
+  if (w) f.write(reinterpret_cast<const char*>(w->data()), w->size() * 4);
+  const std::vector<char> zeros(pad);
+  f.write(zeros.data(), zeros.size());
+}
+
+int main() {
+  const int IN = 12, OUT = 5, D = 16, H = 4, FF = 32, NL = 2, B = 3, P = 2;
+  Lin proj = make_lin(D, IN), head = make_lin(OUT, D);
+  std::vector<Layer> layers;
+  for (int l = 0; l < NL; ++l) {
+    layers.push_back(Layer{make_lin(3 * D, D), make_lin(D, D), make_lin(FF, D), make_lin(D, FF),
+                           rnd(D, 0.2f), rnd(D, 0.1f), rnd(D, 0.2f), rnd(D, 0.1f)});
+    for (auto* g : {&layers.back().g1, &layers.back().g2}) for (auto& x : *g) x += 1.f;
+  }
+
+  const char* path = "native_value_net_test.bin";
+  {
+    std::ofstream f(path, std::ios::binary);
+    auto u32 = [&](uint32_t v) { f.write(reinterpret_cast<const char*>(&v), 4); };
+    auto fl = [&](const std::vector<float>& v) { f.write(reinterpret_cast<const char*>(v.data()), v.size() * 4); };
+    f.write("QVNW", 4);
+    for (uint32_t v : {1u, uint32_t(IN), uint32_t(OUT), uint32_t(D), uint32_t(H), uint32_t(NL), uint32_t(FF), 0u}) u32(v);
+    float eps = 1e-5f;
+    f.write(reinterpret_cast<const char*>(&eps), 4);
+    fl(proj.w); fl(proj.b);
+    for (auto& L : layers) {
+      fl(L.inp.w); fl(L.inp.b); fl(L.outp.w); fl(L.outp.b); fl(L.ff1.w); fl(L.ff1.b); fl(L.ff2.w); fl(L.ff2.b);
+      fl(L.g1); fl(L.b1); fl(L.g2); fl(L.b2);
+    }
+    fl(head.w); fl(head.b);
+  }
+
+  // Reference forward
+  std::vector<float> x = rnd(size_t(B) * P * IN, 1.f);
+  const int R = B * P, hd = D / H;
+  std::vector<float> h, qkv, att(size_t(R) * D), t, f1, ref;
+  lin_fwd(proj, x, R, h);
+  for (auto& L : layers) {
+    lin_fwd(L.inp, h, R, qkv);
+    for (int b = 0; b < B; ++b)
+      for (int hh = 0; hh < H; ++hh)
+        for (int i = 0; i < P; ++i) {
+          std::vector<double> s(P);
+          double mx = -1e30, sum = 0;
+          for (int j = 0; j < P; ++j) {
+            double acc = 0;
+            for (int k = 0; k < hd; ++k)
+              acc += qkv[size_t(b * P + i) * 3 * D + hh * hd + k] * qkv[size_t(b * P + j) * 3 * D + D + hh * hd + k];
+            s[j] = acc / std::sqrt(double(hd));
+            mx = std::max(mx, s[j]);
+          }
+          for (auto& e : s) { e = std::exp(e - mx); sum += e; }
+          for (int k = 0; k < hd; ++k) {
+            double acc = 0;
+            for (int j = 0; j < P; ++j) acc += s[j] / sum * qkv[size_t(b * P + j) * 3 * D + 2 * D + hh * hd + k];
+            att[size_t(b * P + i) * D + hh * hd + k] = float(acc);
+          }
+        }
+    lin_fwd(L.outp, att, R, t);
+    for (size_t i = 0; i < h.size(); ++i) h[i] += t[i];
+    ln(h, R, D, L.g1, L.b1);
+    lin_fwd(L.ff1, h, R, f1);
+    for (auto& e : f1) e = std::max(0.f, e);
+    lin_fwd(L.ff2, f1, R, t);
+    for (size_t i = 0; i < h.size(); ++i) h[i] += t[i];
+    ln(h, R, D, L.g2, L.b2);
+  }
+  lin_fwd(head, h, R, ref);
+
+  quasar::IValueNet* net = quasar::load_native_value_net(path);
+  assert(net);
+  assert(net->input_size() == IN && net->output_size() == OUT && !net->is_sparse());
+  auto y = net->compute_values(x, B, P);
+  assert(y.size() == ref.size());
+  for (size_t i = 0; i < y.size(); ++i) assert(std::fabs(y[i] - ref[i]) < 1e-4f);
+  // Fewer queries than batch * players rows: no read past the input.
+  std::vector<float> short_x(x.begin(), x.end() - 1);
+  assert(net->compute_values(short_x, B, P).empty());
+  delete net;
+
+  quasar::NativeValueNetOptions q8;
+  q8.int8_weights = true;
+  net = quasar::load_native_value_net(path, q8);
+  assert(net);
+  std::vector<float> yq(ref.size());
+  net->compute_values_into(x.data(), B, P, yq.data());
+  for (size_t i = 0; i < yq.size(); ++i) assert(std::fabs(yq[i] - ref[i]) < 0.1f);
+  delete net;
+
+  // Truncated file is rejected
+  {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write("QVNW", 4);
+  }
+  assert(quasar::load_native_value_net(path) == nullptr);
+  // So are headers whose sizes the file cannot hold: a huge layer count, a
+  // huge width, and one layer too many for the weights that follow.
+  for (uint32_t bad_layers : {0xFFFFFFFFu, 1u << 20, uint32_t(NL + 1)}) {
+    for (uint32_t bad_d : {uint32_t(D), 0x40000000u}) {
+      write_header(path, {1u, uint32_t(IN), uint32_t(OUT), bad_d, uint32_t(H), bad_layers, uint32_t(FF), 0u},
+                   size_t(4) << 10);
+      assert(quasar::load_native_value_net(path) == nullptr);
+    }
+  }
+
+  // Known values: weights and inputs from a fixed formula, outputs from an
+  // independent float64 reference. python/tests/test_native_export.py checks
+  // nn.TransformerEncoder against the same numbers.
+  {
+    const int gi = 3, go = 2, gd = 4, gh = 2, gl = 2, gf = 4 * gd, gb = 2, gp = 2;
+    const size_t n = size_t(gd) * gi + gd + size_t(gl) * (4 * gd * gd + 2 * gd * gf + gf + 9 * gd) + size_t(go) * gd + go;
+    std::vector<float> w(n), gx(size_t(gb) * gp * gi);
+    for (size_t i = 0; i < n; ++i) w[i] = float(0.5 * std::sin(0.7 * double(i) + 0.3));
+    for (size_t i = 0; i < gx.size(); ++i) gx[i] = float(2.0 * std::cos(1.3 * double(i)));
+    write_header(path, {1u, uint32_t(gi), uint32_t(go), uint32_t(gd), uint32_t(gh), uint32_t(gl), uint32_t(gf), 0u}, 0,
+                 &w);
+    const float known[] = {-0.462458f, 1.212810f, -0.450761f, 1.204306f, -0.463889f, 1.213833f, -0.460091f, 1.210777f};
+    net = quasar::load_native_value_net(path);
+    assert(net);
+    auto gy = net->compute_values(gx, gb, gp);
+    assert(gy.size() == sizeof(known) / sizeof(known[0]));
+    for (size_t i = 0; i < gy.size(); ++i) assert(std::fabs(gy[i] - known[i]) < 1e-5f);
+    delete net;
+  }
+  std::remove(path);
+
+  std::cout << "Native value net tests passed" << std::endl;
+  return 0;
+}
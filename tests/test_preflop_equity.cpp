@@ -0,0 +1,187 @@
+#include "quasar/eval/preflop_equity.h"
+#include "quasar/eval/hand_index.h"
+#include "quasar/eval/river.h"
+#include "quasar/util/thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+static int card(int rank, int suit) { return suit * 13 + rank; }  // rank 0 = deuce .. 12 = ace
+
+static uint64_t mask_of(const int32_t* h) {
+  uint64_t m = 0;
+  for (int k = 0; k < 4; ++k) m |= uint64_t{1} << h[k];
+  return m;
+}
+
+static std::string slurp(const std::string& path) {
+  std::ifstream f(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+// Direct Monte Carlo: a fixed hero against random members of the villain's
+// class that miss it, on random boards.
+static double brute_equity(const int32_t* hero, const int32_t* villain, int trials) {
+  std::mt19937_64 rng(99);
+  const uint64_t vclass = quasar::canonical_hand(villain);
+  std::vector<std::array<int, 4>> members;
+  for (uint32_t i = 0; i < quasar::kNumPloHands; ++i) {
+    int32_t h[4];
+    quasar::plo_hand_from_index(i, h);
+    if (quasar::canonical_hand(h) == vclass && !(mask_of(h) & mask_of(hero))) members.push_back({h[0], h[1], h[2], h[3]});
+  }
+  const std::array<int, 4> a{hero[0], hero[1], hero[2], hero[3]};
+  double points = 0;
+  for (int t = 0; t < trials; ++t) {
+    const auto& b = members[rng() % members.size()];
+    const uint64_t dead = mask_of(hero) | (uint64_t{1} << b[0] | uint64_t{1} << b[1] | uint64_t{1} << b[2] |
+                                           uint64_t{1} << b[3]);
+    std::array<int, 5> board{};
+    uint64_t used = dead;
+    for (int k = 0; k < 5; ++k) {
+      int c;
+      do c = static_cast<int>(rng() % 52);
+      while (used >> c & 1);
+      used |= uint64_t{1} << c;
+      board[k] = c;
+    }
+    points += 0.5 * (quasar::compare_plo_river(a, b, board) + 1);
+  }
+  return points / trials;
+}
+
+int main() {
+  const std::vector<uint64_t> all = quasar::preflop_classes();
+  assert(all.size() == quasar::kNumPreflopClasses);
+  assert(std::is_sorted(all.begin(), all.end()));
+
+  const int32_t aakk[4] = {card(12, 0), card(12, 1), card(11, 0), card(11, 1)};  // AcAdKcKd
+  const int32_t aakk_iso[4] = {card(12, 3), card(12, 2), card(11, 3), card(11, 2)};
+  const int32_t low[4] = {card(0, 0), card(1, 1), card(5, 2), card(7, 3)};      // 2c3d7h9s
+  const int32_t quads[4] = {card(12, 0), card(12, 1), card(12, 2), card(12, 3)};
+  const int32_t conn[4] = {card(3, 2), card(4, 2), card(5, 3), card(6, 3)};     // 5h6h7s8s
+  const int32_t bad[4] = {0, 0, 1, 2};
+  assert(quasar::canonical_hand(aakk) == quasar::canonical_hand(aakk_iso));
+  assert(quasar::canonical_hand(aakk) != quasar::canonical_hand(low));
+  assert(quasar::canonical_hand(bad) == 0);
+
+  char tmpl[] = "/tmp/quasar_preflop_XXXXXX";
+  const std::string dir = mkdtemp(tmpl);
+  const std::string path_a = dir + "/a.qpeq", path_b = dir + "/b.qpeq", path_c = dir + "/c.qpeq",
+                    path_trunc = dir + "/trunc.qpeq", path_bad = dir + "/bad.qpeq";
+
+  const int boards = 3000;
+  quasar::PreflopEquityConfig cfg;
+  cfg.boards = boards;
+  cfg.seed = 5;
+  cfg.classes = {mask_of(aakk), mask_of(low), mask_of(quads), mask_of(conn)};
+  quasar::ThreadPool one(1), three(3);
+  std::string error;
+  bool ok = quasar::build_preflop_equity(cfg, path_a, &error, &one) &&
+            quasar::build_preflop_equity(cfg, path_b, &error, &three);
+  assert(ok);
+  // Same bytes for any pool size.
+  assert(slurp(path_a) == slurp(path_b));
+
+  auto t = quasar::PreflopEquityTable::open(path_a);
+  assert(t && t->num_classes() == 4 && t->boards() == static_cast<uint32_t>(boards) && t->seed() == 5);
+  const int ia = t->class_of(aakk), il = t->class_of(low), iq = t->class_of(quads), ic = t->class_of(conn);
+  assert(ia >= 0 && il >= 0 && iq >= 0 && ic >= 0);
+  assert(t->class_of(aakk_iso) == ia && t->class_of(bad) == -1);
+  const int32_t untabulated[4] = {card(9, 0), card(9, 1), card(2, 2), card(2, 3)};
+  assert(t->class_of(untabulated) == -1);
+
+  for (size_t i = 0; i < 4; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      assert(t->class_overlap(i, j) == t->class_overlap(j, i));
+      const float e = t->class_equity(i, j);
+      if (std::isnan(e)) continue;
+      assert(std::fabs(e + t->class_equity(j, i) - 1.0f) < 1e-4f);
+      if (i == j) assert(e == 0.5f);
+    }
+  }
+  // Quad aces meet AAKK nowhere; they always meet themselves.
+  assert(t->class_overlap(ia, iq) == 0.f && std::isnan(t->class_equity(ia, iq)));
+  assert(std::isnan(t->class_equity(iq, iq)));
+  // No AAKK hand shares a rank with 2379, so every pair of members is disjoint.
+  assert(t->class_overlap(ia, il) == 1.f);
+  // Sharing a card makes a specific matchup undefined.
+  const int32_t low_ace[4] = {card(0, 0), card(1, 1), card(5, 2), card(12, 0)};
+  assert(std::isnan(t->equity(aakk, low_ace)));
+
+  // Against direct simulation (standard error ~0.01 each).
+  const double e_al = t->equity(aakk, low), e_ac = t->equity(aakk, conn);
+  const double b_al = brute_equity(aakk, low, 4000), b_ac = brute_equity(aakk, conn, 4000);
+  assert(e_al > 0.6 && std::fabs(e_al - b_al) < 0.04);
+  assert(std::fabs(e_ac - b_ac) < 0.04);
+
+  // A subset table holds the same entries for the same seed.
+  cfg.classes = {mask_of(aakk), mask_of(conn)};
+  ok = quasar::build_preflop_equity(cfg, path_c, &error, &one);
+  assert(ok);
+  auto sub = quasar::PreflopEquityTable::open(path_c);
+  assert(sub && sub->num_classes() == 2);
+  assert(sub->equity(aakk, conn) == t->equity(aakk, conn));
+
+  // Range lookups weight each class pair by villain weight times overlap.
+  std::vector<float> hero(quasar::kNumPloHands, 0.f), villain(quasar::kNumPloHands, 0.f);
+  for (uint32_t i = 0; i < quasar::kNumPloHands; ++i) {
+    int32_t h[4];
+    quasar::plo_hand_from_index(i, h);
+    const int c = t->class_of(h);
+    if (c == ia) hero[i] = 1.f;
+    if (c == il) villain[i] = 1.f;
+    if (c == ic) villain[i] = 0.5f;
+  }
+  std::vector<double> vw(t->num_classes());
+  t->class_weights(villain.data(), vw.data());
+  std::vector<float> per_class(t->num_classes());
+  t->class_vs_range(vw.data(), per_class.data(), &three);
+  const double w_low = vw[il] * t->class_overlap(ia, il), w_conn = vw[ic] * t->class_overlap(ia, ic);
+  const double expect = (w_low * t->class_equity(ia, il) + w_conn * t->class_equity(ia, ic)) / (w_low + w_conn);
+  assert(std::fabs(per_class[ia] - expect) < 1e-5);
+  assert(std::fabs(t->range_vs_range(hero.data(), villain.data(), &three) - expect) < 1e-6);
+  // Quads only ever face AAKK here: no weight can meet.
+  std::vector<float> q(quasar::kNumPloHands, 0.f), a(quasar::kNumPloHands, 0.f);
+  q[quasar::plo_hand_index(quads)] = 1.f;
+  a[quasar::plo_hand_index(aakk)] = 1.f;
+  assert(std::isnan(t->range_vs_range(q.data(), a.data())));
+  const double rev = t->range_vs_range(villain.data(), hero.data(), &one);
+  assert(std::fabs(rev + expect - 1.0) < 1e-4);
+
+  // Truncated and foreign files are rejected.
+  {
+    const std::string bytes = slurp(path_a);
+    std::ofstream(path_trunc, std::ios::binary).write(bytes.data(), bytes.size() - 1);
+  }
+  assert(!quasar::PreflopEquityTable::open(path_trunc));
+  assert(!quasar::PreflopEquityTable::open(dir + "/missing.qpeq"));
+  cfg.classes = {uint64_t{7}};  // three cards
+  ok = quasar::build_preflop_equity(cfg, path_bad, &error, &one);
+  assert(!ok && !error.empty());
+
+  for (const std::string& p : {path_a, path_b, path_c, path_trunc, path_bad}) std::remove(p.c_str());
+  std::remove(dir.c_str());
+  (void)ok;
+  (void)ia;
+  (void)il;
+  (void)iq;
+  (void)ic;
+  (void)expect;
+  (void)rev;
+  (void)e_al;
+  (void)e_ac;
+  (void)b_al;
+  (void)b_ac;
+  std::cout << "preflop equity tests passed\n";
+  return 0;
+}
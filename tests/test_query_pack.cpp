@@ -0,0 +1,95 @@
+#include "quasar/nn/query_pack.h"
+#include "quasar/util/thread_pool.h"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main() {
+  using namespace quasar;
+  const int B = 37, P = 3, K = 40;
+  std::mt19937 rng(7);
+
+  // One bucket per hand; hand 5 repeats a card and hand 6 has card 52.
+  std::vector<int32_t> hands(K * 4);
+  for (int k = 0; k < K; ++k) {
+    for (int c = 0; c < 4; ++c) hands[k * 4 + c] = (k + 13 * c) % 52;
+  }
+  hands[5 * 4 + 1] = hands[5 * 4];
+  hands[6 * 4 + 3] = 52;
+  std::vector<uint64_t> masks(K);
+  hand_card_masks(hands.data(), K, masks.data());
+  assert(masks[0] == ((uint64_t{1} << 0) | (uint64_t{1} << 13) | (uint64_t{1} << 26) | (uint64_t{1} << 39)));
+  assert(masks[5] == kImpossibleBucket && masks[6] == kImpossibleBucket);
+
+  std::vector<int32_t> act(B), positions(B * P), board(B * 5, -1);
+  std::vector<double> s2pr(B);
+  std::vector<float> ranges(static_cast<size_t>(B) * P * K);
+  for (int b = 0; b < B; ++b) {
+    act[b] = b % P;
+    s2pr[b] = (b % 7) * 0.75 - 1.0;
+    for (int p = 0; p < P; ++p) positions[b * P + p] = (p + b) % P;
+    const int cards = b % 3 == 0 ? 0 : b % 3 == 1 ? 3 : 5;
+    for (int i = 0; i < cards; ++i) board[b * 5 + i] = static_cast<int32_t>((b + 11 * i) % 52);
+  }
+  std::uniform_real_distribution<float> u(0.f, 1.f);
+  for (float& r : ranges) r = u(rng);
+
+  DenseQueryBatch q;
+  q.batch = B;
+  q.players = P;
+  q.K = K;
+  q.player_act = act.data();
+  q.positions = positions.data();
+  q.s2pr = s2pr.data();
+  q.board = board.data();
+  q.ranges = ranges.data();
+  q.bucket_masks = masks.data();
+
+  const size_t S = dense_slice_size(K);
+  std::vector<float> out(B * P * S, -7.f);
+  ThreadPool pool(3);
+  pack_dense_queries(q, out.data(), &pool);
+
+  for (int b = 0; b < B; ++b) {
+    for (int p = 0; p < P; ++p) {
+      const float* s = out.data() + (b * P + p) * S;
+      assert(s[kSlicePlayerAct] == (p == act[b] ? 1.f : 0.f));
+      assert(s[kSlicePosition] == static_cast<float>(positions[b * P + p]));
+      assert(s[kSliceS2PR] == scale_s2pr(s2pr[b]));
+      uint64_t bmask = 0;
+      for (int i = 0; i < 5; ++i) {
+        const int32_t c = board[b * 5 + i];
+        assert(s[kSliceBoard + i] == static_cast<float>(c));
+        if (c >= 0) bmask |= uint64_t{1} << c;
+      }
+      for (int k = 0; k < K; ++k) {
+        const bool dead = masks[k] == kImpossibleBucket || (masks[k] & bmask);
+        assert(s[kSlicePublicSize + k] == (dead ? 0.f : ranges[(b * P + p) * K + k]));
+      }
+    }
+  }
+  assert(scale_s2pr(-0.75) == -50.f && scale_s2pr(-1.0) == -50.f && scale_s2pr(-2.0) == -150.f);
+  assert(scale_s2pr(2.5) == 250.f);
+
+  // Per-seat masks, no ranges, default positions and no board.
+  std::vector<uint64_t> seat_masks(P * K, 0);
+  seat_masks[1 * K + 2] = kImpossibleBucket;
+  q.bucket_masks = seat_masks.data();
+  q.masks_per_player = true;
+  q.positions = nullptr;
+  q.board = nullptr;
+  pack_dense_queries(q, out.data());
+  for (int p = 0; p < P; ++p) {
+    const float* s = out.data() + p * S;
+    assert(s[kSlicePosition] == static_cast<float>(p) && s[kSliceBoard] == -1.f && s[kSliceBoard + 4] == -1.f);
+    assert(s[kSlicePublicSize + 2] == (p == 1 ? 0.f : ranges[p * K + 2]));
+  }
+  q.ranges = nullptr;
+  pack_dense_queries(q, out.data());
+  for (size_t k = kSlicePublicSize; k < S; ++k) assert(out[k] == 0.f);
+
+  std::cout << "Query pack tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include "quasar/engine/json.h"
+#include "quasar/util/format.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace quasar;
+
+static double reparse(const std::string& s) { return std::strtod(s.c_str(), nullptr); }
+
+int main() {
+  // Shortest round-trip formatting; short values print as iostream would.
+  const double vals[] = {0.0, -0.0, 1.0, 0.25, 7.5, 0.1, 1.0 / 3.0, 1234567.25, 1e-7, 2.5e21, -3.75};
+  for (double v : vals) {
+    std::string s;
+    append_double(s, v);
+    assert(reparse(s) == v);
+  }
+  std::string s;
+  append_double(s, 0.25); s += ' ';
+  append_double(s, 7.5); s += ' ';
+  append_double(s, -0.0); s += ' ';
+  append_double(s, 10.0); s += ' ';
+  append_int(s, -42);
+  assert(s == "0.25 7.5 0 10 -42");
+
+  // Golden-shaped response, appended into a reused buffer.
+  LegalActionSummary la;
+  la.can_check = false;
+  la.can_fold = true;
+  la.call_amount = 1.0;
+  la.raise_bounds = RaiseBounds{4.0, 6.0};
+  std::vector<Action> acts = {{ActionType::kFold, 0.0}, {ActionType::kCall, 1.0},
+                              {ActionType::kRaise, 4.0}, {ActionType::kRaise, 6.0}};
+  std::vector<double> probs(4, 0.25);
+  const std::string golden =
+      "{\"legal\":{\"can_check\":false,\"can_fold\":true,\"call_amount\":1,\"raise\":{\"min_to\":4,\"max_to\":6},"
+      "\"suggestions\":[]},\"uniform_actions\":[{\"type\":0,\"amount\":0,\"prob\":0.25},{\"type\":2,\"amount\":1,"
+      "\"prob\":0.25},{\"type\":4,\"amount\":4,\"prob\":0.25},{\"type\":4,\"amount\":6,\"prob\":0.25}]}";
+  assert(assemble_response_json(la, acts, probs) == golden);
+  // Uniform variant adds fold/call itself.
+  std::vector<Action> discrete = {{ActionType::kRaise, 4.0}, {ActionType::kRaise, 6.0}};
+  assert(assemble_response_json(la, discrete) == golden);
+
+  std::string buf;
+  append_response_json(buf, la, acts, probs);
+  const char* data = buf.data();
+  for (int i = 0; i < 100; ++i) {
+    buf.clear();
+    append_response_json(buf, la, acts, probs);
+  }
+  assert(buf == golden && buf.data() == data);  // capacity reused, no reallocation
+
+  std::cout << "Response JSON tests passed" << std::endl;
+  return 0;
+}
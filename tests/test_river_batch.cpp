@@ -0,0 +1,61 @@
+#include "quasar/eval/river.h"
+#include "quasar/util/thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main() {
+  // Kickers compare most significant first: A-K-x-x-x beats A-Q-x-x-x, and a
+  // higher pair beats a lower pair with better kickers.
+  assert(quasar::eval_5card({12, 11 + 13, 5, 3 + 26, 1}) > quasar::eval_5card({12, 10 + 13, 5, 3 + 26, 1}));
+  assert(quasar::eval_5card({7, 7 + 13, 0, 1 + 26, 2}) > quasar::eval_5card({6, 6 + 13, 12, 11 + 26, 10}));
+  assert(quasar::eval_5card({12, 12 + 13, 4, 4 + 26, 1}) > quasar::eval_5card({12, 12 + 13, 3, 3 + 26, 11}));
+
+  // Batch keys match brute-force enumeration on flush, paired and plain boards.
+  std::mt19937 rng(7);
+  const std::array<std::array<int, 5>, 3> boards = {{{0, 4, 8, 13, 26}, {3, 16, 29, 7, 51}, {1, 15, 30, 44, 10}}};
+  quasar::ThreadPool pool(3);
+  for (const auto& board : boards) {
+    const size_t n = 5000;
+    std::vector<int32_t> hands(n * 4);
+    for (size_t i = 0; i < n; ++i) {
+      std::vector<int> deck;
+      for (int c = 0; c < 52; ++c) {
+        bool on_board = false;
+        for (int b : board) on_board |= (b == c);
+        if (!on_board) deck.push_back(c);
+      }
+      std::shuffle(deck.begin(), deck.end(), rng);
+      for (int k = 0; k < 4; ++k) hands[i * 4 + k] = deck[k];
+    }
+    hands[0] = board[2];  // board collision
+    hands[5] = hands[4];  // repeated card
+    hands[8] = 52;        // out of range
+    std::vector<uint64_t> keys(n);
+    quasar::plo_river_keys(board, hands.data(), n, keys.data(), &pool);
+    assert(keys[0] == 0 && keys[1] == 0 && keys[2] == 0);
+    for (size_t i = 3; i < n; ++i) {
+      const std::array<int, 4> h{hands[i * 4], hands[i * 4 + 1], hands[i * 4 + 2], hands[i * 4 + 3]};
+      assert(keys[i] == quasar::best_plo_river_key(h, board));
+    }
+
+    std::vector<uint8_t> collides(n);
+    const std::array<int32_t, 5> padded{board[0], board[1], board[2], -1, -1};
+    quasar::board_collision_mask(padded.data(), 5, hands.data(), n, collides.data(), &pool);
+    assert(collides[0] == 1 && collides[1] == 1 && collides[2] == 1);
+    for (size_t i = 3; i < n; ++i) {
+      bool hit = false;
+      for (int k = 0; k < 4; ++k) {
+        for (int b = 0; b < 3; ++b) hit |= hands[i * 4 + k] == board[b];
+      }
+      assert(collides[i] == (hit ? 1 : 0));
+    }
+  }
+
+  std::cout << "River batch evaluator tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include "quasar/engine/solve_batch.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+int main() {
+  // Three spots padded to P = 3 seats: preflop heads-up, a 3-way flop and a
+  // row with an out-of-range to_act.
+  const int P = 3;
+  const size_t N = 3;
+  std::vector<double> stacks = {98, 100, 0, 90, 80, 70, 50, 50, 0};
+  std::vector<double> total = {1, 2, 0, 10, 10, 10, 5, 5, 0};
+  std::vector<double> street = {1, 2, 0, 0, 4, 0, 0, 0, 0};
+  std::vector<int32_t> to_act = {0, 0, 5};
+  std::vector<int32_t> seats = {2, 3, 2};
+  std::vector<int32_t> board = {-1, -1, -1, -1, -1, 0, 13, 26, -1, -1, -1, -1, -1, -1, -1};
+  quasar::SpotBatchView v;
+  v.n = N;
+  v.players = P;
+  v.stacks = stacks.data();
+  v.committed_total = total.data();
+  v.committed_on_street = street.data();
+  v.to_act = to_act.data();
+  v.board = board.data();
+  v.num_players = seats.data();
+  v.sb = 1.0;
+  v.bb = 2.0;
+
+  quasar::SolveOneConfig cfg;
+  const int A = quasar::max_solve_actions(cfg);
+  std::vector<int32_t> types(N * A), nact(N);
+  std::vector<double> amounts(N * A), probs(N * A), call(N), lo(N), hi(N);
+  std::vector<uint8_t> can_check(N), can_fold(N);
+  quasar::ActionBatchOut out;
+  out.max_actions = A;
+  out.types = types.data();
+  out.amounts = amounts.data();
+  out.probabilities = probs.data();
+  out.num_actions = nact.data();
+  out.call_amount = call.data();
+  out.can_check = can_check.data();
+  out.can_fold = can_fold.data();
+  out.min_to = lo.data();
+  out.max_to = hi.data();
+  quasar::solve_batch(v, cfg, out);
+
+  // Rows match solve_one on the equivalent PublicState.
+  for (size_t i = 0; i < 2; ++i) {
+    quasar::PublicState s;
+    s.num_players = seats[i];
+    s.player_to_act = to_act[i];
+    s.street = i == 0 ? 0 : 1;
+    if (i == 1) s.board = {0, 13, 26};
+    for (int p = 0; p < seats[i]; ++p) {
+      s.stacks.push_back(stacks[i * P + p]);
+      s.committed_total.push_back(total[i * P + p]);
+      s.committed_on_street.push_back(street[i * P + p]);
+    }
+    const auto ref = quasar::solve_one(s, cfg);
+    assert(nact[i] == static_cast<int32_t>(ref.actions.size()) && nact[i] > 0);
+    for (int k = 0; k < A; ++k) {
+      if (k < nact[i]) {
+        assert(types[i * A + k] == static_cast<int32_t>(ref.actions[k].type));
+        assert(amounts[i * A + k] == ref.actions[k].amount && probs[i * A + k] == ref.probabilities[k]);
+      } else {
+        assert(types[i * A + k] == -1 && probs[i * A + k] == 0.0);
+      }
+    }
+    assert(call[i] == ref.legal.call_amount && (can_fold[i] != 0) == ref.legal.can_fold);
+    const auto& rb = ref.legal.raise_bounds ? ref.legal.raise_bounds : ref.legal.bet_bounds;
+    assert(rb && lo[i] == rb->min_to && hi[i] == rb->max_to);
+  }
+  assert(nact[2] == 0 && types[2 * A] == -1 && std::isnan(lo[2]));
+
+  // Rows whose actions do not fit are reported empty, legal summary intact.
+  out.max_actions = 2;
+  quasar::solve_batch(v, cfg, out);
+  assert(nact[0] == 0 && nact[1] == 0 && call[0] == 1.0);
+
+  std::cout << "Solve batch tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include "quasar/engine/solve_cache.h"
+#include <cassert>
+#include <iostream>
+
+int main() {
+  quasar::PublicState s;
+  s.street = 1; s.player_to_act = 0; s.button = 1;
+  s.board = {25, 0, 12, -1, -1};
+  s.stacks = {100, 100};
+  s.committed_total = {5, 5};
+  s.committed_on_street = {0, 0};
+  quasar::SolveOneConfig cfg;
+
+  // Canonical hashing: padding and flop order do not matter, stacks do.
+  quasar::PublicState t = s;
+  t.board = {0, 12, 25};
+  assert(quasar::hash_public_state(s) == quasar::hash_public_state(t));
+  t.stacks[1] = 99;
+  assert(quasar::hash_public_state(s) != quasar::hash_public_state(t));
+
+  // Eval params only matter when CFR is enabled.
+  quasar::SolveOneConfig c2 = cfg;
+  c2.eval.win_prob = 0.9;
+  assert(quasar::hash_solve_config(cfg) == quasar::hash_solve_config(c2));
+  c2.cfr_iters = 10;
+  cfg.cfr_iters = 10;
+  assert(quasar::hash_solve_config(cfg) != quasar::hash_solve_config(c2));
+  cfg.cfr_iters = 0;
+
+  quasar::SolveCacheConfig cc;
+  cc.capacity = 2;
+  cc.shards = 1;
+  quasar::SolveCache cache(cc);
+  auto r1 = cache.solve(s, cfg);
+  auto r2 = cache.solve(s, cfg);
+  assert(r1 == r2);  // same shared result
+  auto direct = quasar::solve_one(s, cfg);
+  assert(r1->actions.size() == direct.actions.size() && r1->probabilities == direct.probabilities);
+
+  quasar::SolveOneConfig c3 = cfg;
+  c3.discretization.pot_fracs = {1.0};
+  auto r3 = cache.solve(s, c3);
+  assert(r3 != r1 && r3->actions.size() != r1->actions.size());
+
+  auto st = cache.stats();
+  assert(st.hits == 1 && st.misses == 2 && st.size == 2);
+
+  std::cout << "Solve cache tests passed" << std::endl;
+  return 0;
+}
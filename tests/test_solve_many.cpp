@@ -0,0 +1,66 @@
+#include "quasar/engine/solve_one.h"
+#include "quasar/util/thread_pool.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+static bool same(const quasar::SolveOneResult& a, const quasar::SolveOneResult& b) {
+  if (a.actions.size() != b.actions.size() || a.probabilities != b.probabilities) return false;
+  for (size_t i = 0; i < a.actions.size(); ++i) {
+    if (a.actions[i].type != b.actions[i].type || a.actions[i].amount != b.actions[i].amount) return false;
+  }
+  return a.legal.call_amount == b.legal.call_amount && a.legal.can_check == b.legal.can_check;
+}
+
+int main() {
+  // Spots differ by facing-bet size so each result is distinguishable.
+  std::vector<quasar::PublicState> states;
+  for (int i = 0; i < 200; ++i) {
+    quasar::PublicState s;
+    s.street = 3; s.player_to_act = 0; s.button = 1;
+    s.stacks = {100, 100 - static_cast<double>(i % 50)};
+    s.committed_total = {5.0, 5.0 + (i % 50)};
+    s.committed_on_street = {0.0, static_cast<double>(i % 50)};
+    s.last_raise_size = static_cast<double>(i % 50);
+    states.push_back(s);
+  }
+  quasar::SolveOneConfig cfg;
+  cfg.cfr_iters = 50;
+
+  quasar::ThreadPool pool(4);
+  auto res = quasar::solve_many(states, cfg, &pool);
+  assert(res.size() == states.size());
+  for (size_t i = 0; i < states.size(); ++i) assert(same(res[i], quasar::solve_one(states[i], cfg)));
+
+  // Per-spot configs, default pool
+  std::vector<quasar::SolveOneConfig> cfgs(states.size(), cfg);
+  for (size_t i = 0; i < cfgs.size(); i += 2) cfgs[i].cfr_iters = 0;
+  auto res2 = quasar::solve_many(states, cfgs);
+  for (size_t i = 0; i < states.size(); ++i) assert(same(res2[i], quasar::solve_one(states[i], cfgs[i])));
+  // Mismatched sizes are rejected rather than truncated
+  cfgs.pop_back();
+  bool rejected = false;
+  try {
+    (void)quasar::solve_many(states, cfgs, &pool);
+  } catch (const std::invalid_argument&) {
+    rejected = true;
+  }
+  assert(rejected);
+
+  // parallel_for covers every index once and propagates exceptions
+  std::vector<std::atomic<int>> hits(1000);
+  pool.parallel_for(hits.size(), [&](size_t i) { hits[i]++; }, 7);
+  for (auto& h : hits) assert(h.load() == 1);
+  bool threw = false;
+  try {
+    pool.parallel_for(10, [](size_t i) { if (i == 3) throw std::runtime_error("x"); });
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  assert(threw);
+
+  std::cout << "solve_many tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,188 @@
+#include "quasar/server/solve_server.h"
+#include "quasar/engine/json.h"
+#include "quasar/engine/wire.h"
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static const char* kSpot =
+    "{\"street\":\"preflop\",\"sb\":1,\"bb\":2,\"to_act\":0,\"button\":1,"
+    "\"stacks\":[98,100],\"committed_total\":[1,2],\"committed_on_street\":[1,2],"
+    "\"discretization\":{\"pot_fracs\":[1.0],\"include_min\":true}}";
+
+static std::string expected(const std::string& spot) {
+  quasar::SpotRequest req;
+  bool ok = quasar::parse_spot_json(spot, req);
+  assert(ok);
+  (void)ok;
+  auto res = quasar::solve_one(req.state, req.config);
+  return quasar::assemble_response_json(res.legal, res.actions, res.probabilities);
+}
+
+int main() {
+  const std::string path = "/tmp/quasar_server_test_" + std::to_string(::getpid()) + ".sock";
+  const std::string want = expected(kSpot);
+  {
+    quasar::SolveServerConfig cfg;
+    cfg.unix_path = path;
+    cfg.workers = 2;
+    quasar::SolveServer server(cfg);
+    bool ok = server.start();
+    assert(ok);
+
+    quasar::SolveClient c;
+    ok = c.connect_unix(path);
+    assert(ok);
+    quasar::ServerResponse r;
+    ok = c.call(kSpot, r);
+    assert(ok && r.status == quasar::ServerStatus::kOk && r.body == want);
+    ok = c.call("{not json", r);
+    assert(ok && r.status == quasar::ServerStatus::kInvalidRequest && r.body.empty());
+
+    // A binary spot batch is answered with the matching result batch.
+    std::vector<quasar::SpotRequest> reqs(3);
+    for (auto& q : reqs) quasar::parse_spot_json(kSpot, q);
+    std::string batch, results;
+    quasar::write_spot_batch(reqs.data(), reqs.size(), batch);
+    ok = c.call(batch, r) && quasar::solve_wire_batch(batch, results);
+    assert(ok && r.status == quasar::ServerStatus::kOk && r.body == results);
+
+    // Pipelined requests from several clients; every id comes back exactly once.
+    std::vector<std::thread> clients;
+    for (int t = 0; t < 4; ++t) {
+      clients.emplace_back([&] {
+        quasar::SolveClient cc;
+        bool ok = cc.connect_unix(path);
+        assert(ok);
+        const int n = 50;
+        for (int i = 0; i < n; ++i) ok = ok && cc.send(static_cast<uint32_t>(i), kSpot);
+        std::vector<int> seen(n, 0);
+        quasar::ServerResponse rr;
+        for (int i = 0; i < n; ++i) {
+          ok = ok && cc.recv(rr);
+          assert(ok && rr.status == quasar::ServerStatus::kOk && rr.body == want);
+          ++seen[rr.id];
+        }
+        for (int s : seen) assert(s == 1);
+        (void)ok;
+      });
+    }
+    for (auto& t : clients) t.join();
+    (void)ok;
+
+    auto st = server.stats();
+    assert(st.connections == 5 && st.requests == 203 && st.solved == 202 && st.invalid == 1);
+    server.stop();
+    assert(::access(path.c_str(), F_OK) != 0);  // socket file removed
+  }
+
+  // Admission control: with no capacity every request is rejected immediately.
+  {
+    quasar::SolveServerConfig cfg;
+    cfg.workers = 1;
+    cfg.max_in_flight = 0;
+    quasar::SolveServer server(cfg);
+    bool ok = server.start();
+    assert(ok && server.port() > 0);
+    quasar::SolveClient c;
+    ok = c.connect_tcp(server.port());
+    quasar::ServerResponse r;
+    ok = ok && c.call(kSpot, r);
+    assert(ok && r.status == quasar::ServerStatus::kOverloaded);
+    assert(server.stats().overloaded == 1);
+    (void)ok;
+  }
+
+  // A spot batch counts its records toward max_in_flight: a batch that does
+  // not fit is rejected, one that does is solved.
+  {
+    quasar::SolveServerConfig cfg;
+    cfg.workers = 2;
+    cfg.max_in_flight = 4;
+    quasar::SolveServer server(cfg);
+    bool ok = server.start();
+    assert(ok);
+    quasar::SolveClient c;
+    ok = c.connect_tcp(server.port());
+    std::vector<quasar::SpotRequest> reqs(5);
+    for (auto& q : reqs) quasar::parse_spot_json(kSpot, q);
+    std::string batch, results;
+    quasar::write_spot_batch(reqs.data(), reqs.size(), batch);
+    quasar::ServerResponse r;
+    ok = ok && c.call(batch, r);
+    assert(ok && r.status == quasar::ServerStatus::kOverloaded && server.stats().overloaded == 1);
+    quasar::write_spot_batch(reqs.data(), 4, batch);
+    ok = ok && c.call(batch, r) && quasar::solve_wire_batch(batch, results);
+    assert(ok && r.status == quasar::ServerStatus::kOk && r.body == results);
+    (void)ok;
+  }
+
+  // A batch's deadline is checked per record: slow records behind a 1 ms
+  // budget are skipped and the batch expires instead of holding the pool.
+  {
+    quasar::SolveServerConfig cfg;
+    cfg.workers = 1;
+    cfg.cache_capacity = 0;
+    quasar::SolveServer server(cfg);
+    bool ok = server.start();
+    assert(ok);
+    std::string slow = kSpot;
+    slow.insert(slow.size() - 1, ",\"solver\":{\"iters\":200000}");
+    std::vector<quasar::SpotRequest> reqs(64);
+    for (auto& q : reqs) quasar::parse_spot_json(slow, q);
+    std::string batch;
+    quasar::write_spot_batch(reqs.data(), reqs.size(), batch);
+    quasar::SolveClient c;
+    ok = c.connect_tcp(server.port());
+    quasar::ServerResponse r;
+    const auto t0 = std::chrono::steady_clock::now();
+    ok = ok && c.call(batch, r, 1);
+    const auto took = std::chrono::steady_clock::now() - t0;
+    assert(ok && r.status == quasar::ServerStatus::kDeadlineExceeded && server.stats().expired == 1);
+    // Far less than solving all 64 records would take.
+    std::string one;
+    quasar::write_spot_batch(reqs.data(), 1, one);
+    const auto s0 = std::chrono::steady_clock::now();
+    std::string unused;
+    quasar::solve_wire_batch(one, unused);
+    assert(took < 16 * (std::chrono::steady_clock::now() - s0) + std::chrono::milliseconds(50));
+    (void)ok;
+  }
+
+  // Deadlines: one worker, slow CFR solves, 1 ms budget. The queue backs up
+  // behind the first solve, so later requests expire instead of being solved.
+  {
+    quasar::SolveServerConfig cfg;
+    cfg.unix_path = path;
+    cfg.workers = 1;
+    cfg.cache_capacity = 0;
+    quasar::SolveServer server(cfg);
+    bool ok = server.start();
+    assert(ok);
+    std::string slow = kSpot;
+    slow.insert(slow.size() - 1, ",\"solver\":{\"iters\":200000}");
+    quasar::SolveClient c;
+    ok = c.connect_unix(path);
+    const int n = 20;
+    for (int i = 0; i < n; ++i) ok = ok && c.send(static_cast<uint32_t>(i), slow, 1);
+    assert(ok);
+    int expired = 0;
+    quasar::ServerResponse r;
+    for (int i = 0; i < n; ++i) {
+      ok = c.recv(r);
+      assert(ok);
+      if (r.status == quasar::ServerStatus::kDeadlineExceeded) ++expired;
+      else assert(r.status == quasar::ServerStatus::kOk);
+    }
+    assert(expired > 0 && server.stats().expired == static_cast<uint64_t>(expired));
+    (void)ok;
+  }
+
+  std::cout << "Solve server tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include "quasar/engine/solve_one.h"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Count global allocations to check the workspace path stays off the heap.
+static std::atomic<long> g_allocs{0};
+
+void* operator new(std::size_t n) {
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main() {
+  quasar::PublicState river;
+  river.street = 3; river.player_to_act = 0; river.button = 1;
+  river.stacks = {100, 100};
+  river.committed_total = {5.0, 9.0};
+  river.committed_on_street = {0.0, 4.0};
+  river.last_raise_size = 4.0;
+  quasar::PublicState flop = river;
+  flop.street = 1;
+  flop.committed_total = {5.0, 5.0};
+  flop.committed_on_street = {0.0, 0.0};
+  flop.last_raise_size = 0.0;
+
+  quasar::SolveOneConfig cfg;
+  cfg.cfr_iters = 100;
+  quasar::SolveWorkspace ws;
+  // Warm up to steady-state capacity
+  for (int i = 0; i < 3; ++i) {
+    quasar::solve_one(river, cfg, ws);
+    quasar::solve_one(flop, cfg, ws);
+  }
+
+  const long before = g_allocs.load();
+  for (int i = 0; i < 1000; ++i) {
+    quasar::solve_one(i % 2 ? river : flop, cfg, ws);
+  }
+  assert(g_allocs.load() == before);
+
+  // Same answer as the allocating API
+  quasar::solve_one(river, cfg, ws);
+  auto ref = quasar::solve_one(river, cfg);
+  assert(ws.actions.size() == ref.actions.size());
+  assert(ws.probabilities == ref.probabilities);
+  assert(ws.legal.call_amount == ref.legal.call_amount);
+
+  std::cout << "solve_one workspace tests passed" << std::endl;
+  return 0;
+}
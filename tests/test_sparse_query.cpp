@@ -0,0 +1,45 @@
+#include "quasar/nn/query_layout.h"
+#include "quasar/nn/value_net.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+// Dense fake net: value[k] = 2 * range[k] + S2PR, so the scatter/gather
+// fallback can be checked exactly.
+class FakeDenseNet : public quasar::IValueNet {
+ public:
+  explicit FakeDenseNet(int K) : K_(K) {}
+  int input_size() const override { return quasar::dense_slice_size(K_); }
+  int output_size() const override { return K_; }
+  bool is_sparse() const override { return false; }
+  std::vector<float> compute_values(const std::vector<float>& q, int batch, int players) override {
+    std::vector<float> out(static_cast<size_t>(batch) * players * K_);
+    for (int r = 0; r < batch * players; ++r) {
+      const float* slice = q.data() + static_cast<size_t>(r) * input_size();
+      for (int k = 0; k < K_; ++k) out[r * K_ + k] = 2.f * slice[quasar::kSlicePublicSize + k] + slice[quasar::kSliceS2PR];
+    }
+    return out;
+  }
+
+ private:
+  int K_;
+};
+
+int main() {
+  const int K = 50, B = 1, P = 2, M = 3;
+  FakeDenseNet net(K);
+  std::vector<float> pub(B * P * quasar::kSlicePublicSize, 0.f);
+  pub[quasar::kSliceS2PR] = 1.f;
+  pub[quasar::kSlicePublicSize + quasar::kSliceS2PR] = 3.f;
+  std::vector<int32_t> idx = {4, 17, 0, 49, 2, 0};
+  std::vector<float> val = {0.25f, 0.75f, 0.f, 0.5f, 0.5f, 0.f};
+  std::vector<float> mask = {1, 1, 0, 1, 1, 0};
+  quasar::SparseQueries q{pub.data(), idx.data(), val.data(), mask.data(), B, P, M};
+  std::vector<float> out(B * P * M, -1.f);
+  bool ok = net.compute_values_sparse(q, out.data());
+  assert(ok);
+  assert(out[0] == 1.5f && out[1] == 2.5f && out[2] == 0.f);
+  assert(out[3] == 4.f && out[4] == 4.f && out[5] == 0.f);
+  std::cout << "Sparse query tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include "quasar/engine/json.h"
+#include <cassert>
+#include <iostream>
+
+using namespace quasar;
+
+int main() {
+  // Nested keys with the same names as top-level ones must not shadow them.
+  const std::string spot = R"({
+    "meta": {"street": "river", "stacks": [1, 2, 3], "note": "a \"quoted\" }{ value"},
+    "street": "turn", "sb": 0.5, "bb": 1, "ante": 0, "to_act": 1, "button": 0,
+    "stacks": [99.5, 99], "committed_total": [0.5, 1], "committed_on_street": [0.5, 1e0],
+    "board": [0, 13, 26, 39, null],
+    "discretization": {"pot_fracs": [0.5, 1.0], "include_min": false, "include_all_in": true},
+    "solver": {"type": "cfr", "iters": 10, "win_prob": 0.7, "nested": {"call_k": 9}, "call_k": 0.25},
+    "min_bet_rule": "OneChip",
+    "last_raise_size": 0.5
+  })";
+  SpotRequest req;
+  bool ok = parse_spot_json(spot, req);
+  assert(ok);
+  const PublicState& s = req.state;
+  assert(s.street == 2 && s.num_players == 2 && s.player_to_act == 1 && s.button == 0);
+  assert(s.sb == 0.5 && s.bb == 1.0 && s.last_raise_size == 0.5);
+  assert(s.stacks.size() == 2 && s.stacks[0] == 99.5 && s.committed_on_street[1] == 1.0);
+  assert(s.board.size() == 5 && s.board[3] == 39 && s.board[4] == -1);
+  const SolveOneConfig& c = req.config;
+  assert(c.rules.min_bet_rule == BettingRules::MinBetRule::OneChip);
+  assert(c.discretization.pot_fracs.size() == 2 && c.discretization.pot_fracs[1] == 1.0);
+  assert(!c.discretization.include_min && c.discretization.include_pot_raise && c.discretization.include_all_in);
+  assert(c.cfr_iters == 10 && c.eval.win_prob == 0.7 && c.eval.call_k == 0.25);
+
+  // Legacy entry points agree with the single-pass parser.
+  PublicState s2;
+  assert(parse_public_state_from_json(spot, s2));
+  assert(s2.stacks == s.stacks && s2.board == s.board && s2.street == s.street);
+  SolveOneConfig c2;
+  parse_solve_config_from_json(spot, c2);
+  assert(c2.discretization.pot_fracs == c.discretization.pot_fracs && c2.cfr_iters == 10);
+
+  // Reusing a request resets fields the new document does not set.
+  ok = parse_spot_json(R"({"stacks":[10,10,10],"committed_total":[0,0,0],"committed_on_street":[0,0,0],
+                          "discretization":{"pot_fracs":[]}})", req);
+  assert(ok);
+  assert(req.state.street == 0 && req.state.num_players == 3 && req.state.board.empty() && req.state.sb == 1.0);
+  assert(req.config.cfr_iters == 0 && req.config.rules.min_bet_rule == BettingRules::MinBetRule::BigBlind);
+  assert(req.config.discretization.pot_fracs == DiscretizationConfig{}.pot_fracs);  // empty list keeps defaults
+
+  // Malformed or incomplete input
+  assert(!parse_spot_json(R"({"stacks":[1,2],"committed_total":[0,0],"committed_on_street":[0,0])", req));
+  assert(!parse_spot_json(R"({"stacks":[1,2],"committed_total":[0,0]})", req));
+  assert(!parse_spot_json(R"({"stacks":[1,2],"committed_total":[0,0],"committed_on_street":[0,0]} x)", req));
+
+  // NDJSON: blank lines skipped, bad lines reported in order.
+  const std::string nd =
+      "{\"street\":\"flop\",\"stacks\":[1,2],\"committed_total\":[0,0],\"committed_on_street\":[0,0]}\n"
+      "\n"
+      "{\"stacks\":[1,2]\n"
+      "{\"street\":\"river\",\"stacks\":[3,4],\"committed_total\":[1,1],\"committed_on_street\":[0,0]}\r\n";
+  std::vector<SpotRequest> batch;
+  std::vector<bool> line_ok;
+  size_t good = parse_spot_ndjson(nd, batch, &line_ok);
+  assert(good == 2 && batch.size() == 3 && line_ok.size() == 3);
+  assert(line_ok[0] && !line_ok[1] && line_ok[2]);
+  assert(batch[0].state.street == 1 && batch[2].state.street == 3 && batch[2].state.stacks[1] == 4.0);
+
+  std::cout << "Spot JSON tests passed" << std::endl;
+  return 0;
+}
@@ -1,5 +1,6 @@
 #include "quasar/nn/value_net.h"
 #include <cassert>
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <vector>
@@ -22,6 +23,14 @@ int main() {
   std::vector<float> x(B * P * in, 0.f);
   auto y = net->compute_values(x, B, P);
   assert((int)y.size() == B * P * out);
+  // Caller-owned output path must agree with the vector overload.
+  std::vector<float> y2(B * P * out, -1.f);
+  net->compute_values_into(x.data(), B, P, y2.data());
+  for (size_t i = 0; i < y.size(); ++i) assert(std::fabs(y[i] - y2[i]) < 1e-5f);
+  // Grow past the preallocated batch to exercise buffer resizing.
+  const int B2 = 300;
+  std::vector<float> xb(B2 * P * in, 0.f), yb(B2 * P * out);
+  net->compute_values_into(xb.data(), B2, P, yb.data());
   delete net;
   std::cout << "TorchScript wrapper test passed" << std::endl;
   return 0;
@@ -0,0 +1,126 @@
+#include "quasar/nn/cached_value_net.h"
+#include "quasar/nn/query_layout.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+// Counts forwarded rows; value[k] = range[k] + S2PR.
+class CountingNet : public quasar::IValueNet {
+ public:
+  explicit CountingNet(int K) : K_(K) {}
+  int input_size() const override { return quasar::dense_slice_size(K_); }
+  int output_size() const override { return K_; }
+  bool is_sparse() const override { return false; }
+  std::vector<float> compute_values(const std::vector<float>& q, int batch, int players) override {
+    items += batch;
+    std::vector<float> out(static_cast<size_t>(batch) * players * K_);
+    for (int r = 0; r < batch * players; ++r) {
+      const float* s = q.data() + static_cast<size_t>(r) * input_size();
+      for (int k = 0; k < K_; ++k) out[r * K_ + k] = s[quasar::kSlicePublicSize + k] + s[quasar::kSliceS2PR];
+    }
+    return out;
+  }
+  int items = 0;
+
+ private:
+  int K_;
+};
+
+static std::vector<float> make_item(int K, int P, const int board[5], float mass) {
+  std::vector<float> q(static_cast<size_t>(P) * quasar::dense_slice_size(K), 0.f);
+  for (int p = 0; p < P; ++p) {
+    float* s = q.data() + p * quasar::dense_slice_size(K);
+    s[quasar::kSlicePlayerAct] = p == 0 ? 1.f : 0.f;
+    s[quasar::kSlicePosition] = static_cast<float>(p);
+    s[quasar::kSliceS2PR] = 250.f;
+    for (int i = 0; i < 5; ++i) s[quasar::kSliceBoard + i] = static_cast<float>(board[i]);
+    s[quasar::kSlicePublicSize + p] = mass;
+  }
+  return q;
+}
+
+int main() {
+  const int K = 8, P = 2;
+  CountingNet inner(K);
+  quasar::ValueCacheConfig cfg;
+  cfg.capacity = 4;
+  cfg.shards = 1;
+  quasar::CachedValueNet net(&inner, cfg);
+
+  const int b1[5] = {0, 12, 25, -1, -1};
+  const int b1_perm[5] = {25, 0, 12, -1, -1};
+  auto a = make_item(K, P, b1, 0.5f);
+  auto y1 = net.compute_values(a, 1, P);
+  assert(inner.items == 1);
+  assert(y1[0] == 250.5f);
+
+  // Same spot with permuted flop and sub-quantum range noise: cache hit
+  auto a2 = make_item(K, P, b1_perm, 0.5f + 1e-6f);
+  auto y2 = net.compute_values(a2, 1, P);
+  assert(inner.items == 1);
+  assert(y2 == y1);
+
+  // Batch of [hit, miss]: only the miss is forwarded
+  auto b = make_item(K, P, b1, 0.25f);
+  std::vector<float> batch(a);
+  batch.insert(batch.end(), b.begin(), b.end());
+  auto y3 = net.compute_values(batch, 2, P);
+  assert(inner.items == 2);
+  assert(y3[0] == 250.5f && y3[P * K] == 250.25f);
+
+  auto st = net.stats();
+  assert(st.hits == 2 && st.misses == 2 && st.size == 2);
+
+  // Capacity bound evicts least recently used
+  for (int i = 0; i < 6; ++i) {
+    auto c = make_item(K, P, b1, 0.01f * (i + 1));
+    net.compute_values(c, 1, P);
+  }
+  st = net.stats();
+  assert(st.size == 4 && st.evictions >= 2);
+
+  // A byte budget holds as many items as fit: 3 items of P * K floats.
+  cfg.capacity_bytes = 3 * P * K * sizeof(float);
+  quasar::CachedValueNet sized(&inner, cfg);
+  for (int i = 0; i < 5; ++i) {
+    auto c = make_item(K, P, b1, 0.01f * (i + 1));
+    sized.compute_values(c, 1, P);
+  }
+  st = sized.stats();
+  assert(st.size == 3 && st.evictions == 2);
+  // The most recent items are the ones kept.
+  const int before = inner.items;
+  auto last = make_item(K, P, b1, 0.05f);
+  auto y4 = sized.compute_values(last, 1, P);
+  assert(inner.items == before && y4[0] == 250.05f);
+
+  // A cache wrapping a cache: the inner call runs on the same thread in the
+  // middle of the outer one and must not disturb its misses.
+  {
+    CountingNet base(K);
+    quasar::ValueCacheConfig small;
+    small.shards = 1;
+    quasar::CachedValueNet inner_cache(&base, small);
+    quasar::CachedValueNet outer(&inner_cache, small);
+    std::vector<float> items, want;
+    for (int i = 0; i < 5; ++i) {
+      auto c = make_item(K, P, b1, 0.1f * (i + 1));
+      items.insert(items.end(), c.begin(), c.end());
+      want.push_back(250.f + 0.1f * (i + 1));
+    }
+    // Items 1 and 3 hit in the inner cache only.
+    std::vector<float> seed(items.begin() + P * quasar::dense_slice_size(K),
+                            items.begin() + 2 * P * quasar::dense_slice_size(K));
+    inner_cache.compute_values(seed, 1, P);
+    seed.assign(items.begin() + 3 * P * quasar::dense_slice_size(K), items.begin() + 4 * P * quasar::dense_slice_size(K));
+    inner_cache.compute_values(seed, 1, P);
+    auto y5 = outer.compute_values(items, 5, P);
+    for (int i = 0; i < 5; ++i) assert(y5[static_cast<size_t>(i) * P * K] == want[i]);
+    assert(base.items == 5);
+    auto again = outer.compute_values(items, 5, P);
+    assert(again == y5 && base.items == 5);
+  }
+
+  std::cout << "Value cache tests passed" << std::endl;
+  return 0;
+}
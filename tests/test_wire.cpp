@@ -0,0 +1,98 @@
+#include "quasar/engine/wire.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static std::string response(const quasar::SolveOneResult& r) {
+  return quasar::assemble_response_json(r.legal, r.actions, r.probabilities);
+}
+
+int main() {
+  const char* spots[] = {
+      "{\"street\":\"preflop\",\"sb\":1,\"bb\":2,\"to_act\":0,\"button\":1,\"stacks\":[98,100],"
+      "\"committed_total\":[1,2],\"committed_on_street\":[1,2],"
+      "\"discretization\":{\"pot_fracs\":[1.0],\"include_min\":true,\"include_all_in\":false}}",
+      "{\"street\":\"flop\",\"sb\":0.5,\"bb\":1,\"to_act\":1,\"button\":0,\"stacks\":[90.25,80,70],"
+      "\"committed_total\":[10,10,10],\"committed_on_street\":[0,0,0],\"board\":[0,13,26],"
+      "\"min_bet_rule\":\"OneChip\",\"solver\":{\"iters\":50,\"win_prob\":0.6}}",
+  };
+  std::vector<quasar::SpotRequest> reqs(2);
+  for (int i = 0; i < 2; ++i) {
+    bool ok = quasar::parse_spot_json(spots[i], reqs[i]);
+    assert(ok);
+    (void)ok;
+  }
+
+  // Record round trip keeps every field the solver reads.
+  quasar::WireSpot w;
+  quasar::SpotRequest back;
+  for (const auto& r : reqs) {
+    bool ok = quasar::encode_spot(r.state, r.config, w) && quasar::decode_spot(w, back);
+    assert(ok);
+    (void)ok;
+    assert(back.state.stacks == r.state.stacks && back.state.board == r.state.board);
+    assert(back.state.committed_on_street == r.state.committed_on_street);
+    assert(back.config.discretization.pot_fracs == r.config.discretization.pot_fracs);
+    assert(back.config.rules.min_bet_rule == r.config.rules.min_bet_rule);
+    assert(back.config.cfr_iters == r.config.cfr_iters && back.config.eval.win_prob == r.config.eval.win_prob);
+    assert(response(quasar::solve_one(back.state, back.config)) == response(quasar::solve_one(r.state, r.config)));
+  }
+
+  // Batch: one buffer of fixed-size records; solving it matches solve_one.
+  reqs.push_back(reqs[0]);
+  reqs.back().state.stacks.assign(10, 100.0);  // too many players: zero record
+  std::string batch;
+  quasar::write_spot_batch(reqs.data(), reqs.size(), batch);
+  assert(batch.size() == sizeof(quasar::WireHeader) + 3 * sizeof(quasar::WireSpot));
+  assert(quasar::is_wire_buffer(batch) && !quasar::is_wire_buffer(spots[0]));
+  std::vector<quasar::SpotRequest> decoded;
+  std::vector<bool> ok;
+  bool good = quasar::read_spot_batch(batch, decoded, &ok);
+  assert(good && decoded.size() == 3 && ok[0] && ok[1] && !ok[2]);
+
+  std::string results;
+  good = quasar::solve_wire_batch(batch, results);
+  assert(good && results.size() == sizeof(quasar::WireHeader) + 3 * sizeof(quasar::WireResult));
+  std::vector<quasar::SolveOneResult> out;
+  good = quasar::read_result_batch(results, out, &ok);
+  assert(good && out.size() == 3 && ok[0] && ok[1] && !ok[2]);
+  for (int i = 0; i < 2; ++i) assert(response(out[i]) == response(quasar::solve_one(reqs[i].state, reqs[i].config)));
+
+  // write_result_batch produces the same bytes as the batch solver.
+  std::vector<quasar::SolveOneResult> direct = {quasar::solve_one(reqs[0].state, reqs[0].config),
+                                                quasar::solve_one(reqs[1].state, reqs[1].config),
+                                                quasar::SolveOneResult{}};
+  direct[2].actions.resize(quasar::kWireMaxActions + 1);  // does not fit: zero record
+  direct[2].probabilities.resize(direct[2].actions.size());
+  std::string written;
+  quasar::write_result_batch(direct.data(), direct.size(), written);
+  assert(written == results);
+
+  // A spot that fails to parse is written as the invalid record, not as
+  // whatever the parser left in its request.
+  std::vector<quasar::SpotRequest> mixed = {reqs[0], reqs[0], reqs[1]};
+  std::vector<bool> parsed = {true, quasar::parse_spot_json("{\"stacks\": [100, 100], \"board\": [", mixed[1]), true};
+  assert(!parsed[1]);
+  std::string mixed_batch;
+  quasar::write_spot_batch(mixed.data(), mixed.size(), mixed_batch, &parsed);
+  good = quasar::read_spot_batch(mixed_batch, decoded, &ok);
+  assert(good && decoded.size() == 3 && ok[0] && !ok[1] && ok[2]);
+  const char* rec = mixed_batch.data() + sizeof(quasar::WireHeader) + sizeof(quasar::WireSpot);
+  assert(std::all_of(rec, rec + sizeof(quasar::WireSpot), [](char c) { return c == 0; }));
+
+  // Header checks: wrong kind, version, truncated size.
+  assert(!quasar::read_result_batch(batch, out));
+  std::string bad = batch;
+  bad[4] = 9;
+  assert(!quasar::read_spot_batch(bad, decoded));
+  bad = batch.substr(0, batch.size() - 1);
+  assert(!quasar::read_spot_batch(bad, decoded));
+  assert(!quasar::solve_wire_batch("{}", results));
+  (void)good;
+
+  std::cout << "Wire format tests passed" << std::endl;
+  return 0;
+}